@@ -263,7 +263,11 @@ void TCKHostApplication::handle_prompt_specific(const std::string& message) {
       if (node_state_opt) {
         const auto& node_state = node_state_opt->get();
         if (!node_state.alias_map.empty()) {
-          metric_name = node_state.alias_map.begin()->second;
+          node_state.alias_map.for_each([&](uint64_t, std::string_view name) {
+            if (metric_name.empty()) {
+              metric_name = name;
+            }
+          });
           log("INFO",
               "Found metric '" + metric_name + "' from NBIRTH, using for command");
         }
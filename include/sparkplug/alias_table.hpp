@@ -0,0 +1,148 @@
+// include/sparkplug/alias_table.hpp
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace sparkplug {
+
+/**
+ * @brief Append-only pool of interned strings with stable addresses.
+ *
+ * Strings are copied once into large blocks and deduplicated, so every node reporting
+ * a metric called "Temperature" shares one copy, and re-interning a known name (e.g.,
+ * during a rebirth storm) is a hash lookup without allocation. Interned strings live
+ * as long as the pool; nothing is ever removed.
+ *
+ * @note Not thread-safe; the owner serializes access.
+ */
+class StringPool {
+public:
+  StringPool() = default;
+  StringPool(const StringPool&) = delete;
+  StringPool& operator=(const StringPool&) = delete;
+  StringPool(StringPool&&) noexcept = default;
+  StringPool& operator=(StringPool&&) noexcept = default;
+
+  /**
+   * @brief Returns the pooled copy of a string, adding it if needed.
+   *
+   * @return View that stays valid for the lifetime of the pool
+   */
+  std::string_view intern(std::string_view str);
+
+  /// Number of distinct strings
+  [[nodiscard]] size_t size() const noexcept {
+    return strings_.size();
+  }
+
+  /// Approximate heap memory held by the pool, in bytes
+  [[nodiscard]] size_t memory_bytes() const noexcept;
+
+private:
+  static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+  std::vector<std::unique_ptr<char[]>> blocks_;       // BLOCK_SIZE each, last one open
+  std::vector<std::unique_ptr<char[]>> large_blocks_; // One per oversized string
+  size_t block_used_{0};  // Bytes used in blocks_.back()
+  size_t block_bytes_{0}; // Total bytes allocated for blocks
+  std::unordered_set<std::string_view> strings_;
+};
+
+/**
+ * @brief Flat alias -> metric name table for one node or device.
+ *
+ * Aliases are usually small and dense, so they index a vector directly; aliases
+ * beyond the dense range (sized from the birth's metric count) fall back to a hash
+ * map. Names are views into a StringPool, so a lookup is an array index and
+ * rebuilding the table on a rebirth reuses its existing capacity.
+ *
+ * @par Example Usage
+ * @code
+ * table.reset(birth.metric_count());
+ * for (const auto& metric : birth.metrics()) {
+ *   table.insert(*metric.alias, pool.intern(metric.name));
+ * }
+ * auto name = table.find(7);  // std::optional<std::string_view>
+ * @endcode
+ */
+class AliasTable {
+public:
+  /**
+   * @brief Removes all entries (keeping capacity) and sizes the dense range.
+   *
+   * @param expected_aliases Number of aliases about to be inserted
+   */
+  void reset(size_t expected_aliases = 0) noexcept;
+
+  /**
+   * @brief Maps an alias to a name, replacing any previous mapping.
+   *
+   * @param alias Metric alias
+   * @param name Metric name; must outlive the table (normally from a StringPool)
+   */
+  void insert(uint64_t alias, std::string_view name);
+
+  /**
+   * @brief Looks up the name of an alias.
+   */
+  [[nodiscard]] std::optional<std::string_view> find(uint64_t alias) const noexcept {
+    if (alias < dense_.size()) {
+      if (dense_[alias].data() != nullptr) {
+        return dense_[alias];
+      }
+      return std::nullopt;
+    }
+    if (sparse_.empty()) {
+      return std::nullopt;
+    }
+    auto it = sparse_.find(alias);
+    if (it == sparse_.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  /// Number of mapped aliases
+  [[nodiscard]] size_t size() const noexcept {
+    return size_;
+  }
+
+  [[nodiscard]] bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  /**
+   * @brief Calls f(alias, name) for every entry, dense aliases first in ascending order.
+   */
+  template <typename F>
+  void for_each(F&& f) const {
+    for (size_t alias = 0; alias < dense_.size(); alias++) {
+      if (dense_[alias].data() != nullptr) {
+        f(static_cast<uint64_t>(alias), dense_[alias]);
+      }
+    }
+    for (const auto& [alias, name] : sparse_) {
+      f(alias, name);
+    }
+  }
+
+  /// Approximate heap memory held by the table (excluding the pooled names), in bytes
+  [[nodiscard]] size_t memory_bytes() const noexcept;
+
+private:
+  static constexpr size_t MIN_DENSE_ALIASES = 64;
+
+  std::vector<std::string_view> dense_; // Indexed by alias; null data() = unmapped
+  std::unordered_map<uint64_t, std::string_view> sparse_;
+  size_t dense_limit_{MIN_DENSE_ALIASES};
+  size_t size_{0};
+};
+
+} // namespace sparkplug
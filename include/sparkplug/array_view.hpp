@@ -0,0 +1,372 @@
+// include/sparkplug/array_view.hpp
+#pragma once
+
+#include "datatype.hpp"
+#include "detail/compat.hpp"
+#include "payload_builder.hpp"
+#include "sparkplug_b.pb.h"
+
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sparkplug {
+
+namespace detail {
+
+/// Random-access iterator over any view with size() and a by-value operator[]
+template <typename View>
+class IndexIterator {
+public:
+  using iterator_concept = std::random_access_iterator_tag;
+  using iterator_category = std::input_iterator_tag; // Elements are returned by value
+  using value_type = typename View::value_type;
+  using difference_type = std::ptrdiff_t;
+
+  IndexIterator() = default;
+  IndexIterator(const View* view, size_t index) : view_(view), index_(index) {
+  }
+
+  value_type operator*() const {
+    return (*view_)[index_];
+  }
+  value_type operator[](difference_type n) const {
+    return (*view_)[index_ + n];
+  }
+
+  IndexIterator& operator++() {
+    ++index_;
+    return *this;
+  }
+  IndexIterator operator++(int) {
+    auto copy = *this;
+    ++index_;
+    return copy;
+  }
+  IndexIterator& operator--() {
+    --index_;
+    return *this;
+  }
+  IndexIterator operator--(int) {
+    auto copy = *this;
+    --index_;
+    return copy;
+  }
+  IndexIterator& operator+=(difference_type n) {
+    index_ += n;
+    return *this;
+  }
+  IndexIterator& operator-=(difference_type n) {
+    index_ -= n;
+    return *this;
+  }
+  friend IndexIterator operator+(IndexIterator it, difference_type n) {
+    return it += n;
+  }
+  friend IndexIterator operator+(difference_type n, IndexIterator it) {
+    return it += n;
+  }
+  friend IndexIterator operator-(IndexIterator it, difference_type n) {
+    return it -= n;
+  }
+  friend difference_type operator-(const IndexIterator& a, const IndexIterator& b) {
+    return static_cast<difference_type>(a.index_) -
+           static_cast<difference_type>(b.index_);
+  }
+  friend bool operator==(const IndexIterator& a, const IndexIterator& b) {
+    return a.index_ == b.index_;
+  }
+  friend auto operator<=>(const IndexIterator& a, const IndexIterator& b) {
+    return a.index_ <=> b.index_;
+  }
+
+private:
+  const View* view_{nullptr};
+  size_t index_{0};
+};
+
+template <typename T>
+T load_array_element(const uint8_t* data) noexcept {
+  array_word_t<T> word;
+  std::memcpy(&word, data, sizeof(T));
+  if constexpr (std::endian::native == std::endian::big && sizeof(T) > 1) {
+    word = std::byteswap(word);
+  }
+  return std::bit_cast<T>(word);
+}
+
+} // namespace detail
+
+/**
+ * @brief Zero-copy view of a packed fixed-width array metric.
+ *
+ * Elements are read straight from the metric's bytes_value. Because that buffer carries
+ * no alignment guarantee, elements are returned by value (an unaligned load) rather
+ * than by reference. copy_to() moves the whole array with one memcpy on little-endian
+ * hosts.
+ *
+ * The view does not own its bytes: the metric (or buffer) must outlive it.
+ *
+ * @tparam T Element type: an integer, float, double or sparkplug::DateTime
+ *
+ * @see get_array()
+ */
+template <typename T>
+class ArrayView {
+public:
+  using value_type = T;
+  using iterator = detail::IndexIterator<ArrayView>;
+
+  ArrayView() = default;
+  explicit ArrayView(std::span<const uint8_t> bytes) noexcept : bytes_(bytes) {
+  }
+
+  [[nodiscard]] size_t size() const noexcept {
+    return bytes_.size() / sizeof(T);
+  }
+  [[nodiscard]] bool empty() const noexcept {
+    return size() == 0;
+  }
+
+  [[nodiscard]] T operator[](size_t index) const noexcept {
+    return detail::load_array_element<T>(bytes_.data() + index * sizeof(T));
+  }
+
+  [[nodiscard]] iterator begin() const noexcept {
+    return {this, 0};
+  }
+  [[nodiscard]] iterator end() const noexcept {
+    return {this, size()};
+  }
+
+  /**
+   * @brief Copies all elements into a caller-owned buffer.
+   *
+   * @param out Destination (must hold at least size() elements)
+   *
+   * @return Number of elements copied
+   */
+  size_t copy_to(std::span<T> out) const noexcept {
+    size_t count = std::min(out.size(), size());
+    if constexpr (std::endian::native == std::endian::little || sizeof(T) == 1) {
+      if (count > 0) {
+        std::memcpy(out.data(), bytes_.data(), count * sizeof(T));
+      }
+    } else {
+      for (size_t i = 0; i < count; i++) {
+        out[i] = (*this)[i];
+      }
+    }
+    return count;
+  }
+
+  [[nodiscard]] std::vector<T> to_vector() const {
+    std::vector<T> values(size());
+    copy_to(values);
+    return values;
+  }
+
+  /// Raw packed little-endian bytes
+  [[nodiscard]] std::span<const uint8_t> bytes() const noexcept {
+    return bytes_;
+  }
+
+private:
+  std::span<const uint8_t> bytes_;
+};
+
+/**
+ * @brief Zero-copy view of a BooleanArray (4-byte count, then bits packed MSB first).
+ */
+template <>
+class ArrayView<bool> {
+public:
+  using value_type = bool;
+  using iterator = detail::IndexIterator<ArrayView>;
+
+  ArrayView() = default;
+  ArrayView(uint32_t count, std::span<const uint8_t> bits) noexcept
+      : count_(count), bits_(bits) {
+  }
+
+  [[nodiscard]] size_t size() const noexcept {
+    return count_;
+  }
+  [[nodiscard]] bool empty() const noexcept {
+    return count_ == 0;
+  }
+
+  [[nodiscard]] bool operator[](size_t index) const noexcept {
+    return (bits_[index / 8] >> (7 - index % 8)) & 1;
+  }
+
+  [[nodiscard]] iterator begin() const noexcept {
+    return {this, 0};
+  }
+  [[nodiscard]] iterator end() const noexcept {
+    return {this, size()};
+  }
+
+  size_t copy_to(std::span<bool> out) const noexcept {
+    size_t count = std::min(out.size(), size());
+    for (size_t i = 0; i < count; i++) {
+      out[i] = (*this)[i];
+    }
+    return count;
+  }
+
+private:
+  uint32_t count_{0};
+  std::span<const uint8_t> bits_;
+};
+
+/**
+ * @brief Zero-copy view of a StringArray (null-terminated UTF-8 strings).
+ *
+ * Iteration yields std::string_view elements pointing into the metric's bytes.
+ */
+template <>
+class ArrayView<std::string_view> {
+public:
+  using value_type = std::string_view;
+
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() = default;
+    explicit iterator(std::string_view rest) noexcept : rest_(rest) {
+    }
+
+    std::string_view operator*() const noexcept {
+      return rest_.substr(0, rest_.find('\0'));
+    }
+    iterator& operator++() noexcept {
+      rest_.remove_prefix(std::min(rest_.size(), rest_.find('\0') + 1));
+      return *this;
+    }
+    iterator operator++(int) noexcept {
+      auto copy = *this;
+      ++*this;
+      return copy;
+    }
+    // Iterators of one view share the end of the buffer, so the remaining size
+    // identifies the position
+    friend bool operator==(const iterator& a, const iterator& b) noexcept {
+      return a.rest_.size() == b.rest_.size();
+    }
+
+  private:
+    std::string_view rest_;
+  };
+
+  ArrayView() = default;
+  explicit ArrayView(std::string_view bytes) noexcept : bytes_(bytes) {
+  }
+
+  /// Number of strings (counts terminators)
+  [[nodiscard]] size_t size() const noexcept {
+    return static_cast<size_t>(std::count(bytes_.begin(), bytes_.end(), '\0'));
+  }
+  [[nodiscard]] bool empty() const noexcept {
+    return bytes_.empty();
+  }
+
+  [[nodiscard]] iterator begin() const noexcept {
+    return iterator(bytes_);
+  }
+  [[nodiscard]] iterator end() const noexcept {
+    return iterator(bytes_.substr(bytes_.size()));
+  }
+
+private:
+  std::string_view bytes_;
+};
+
+/**
+ * @brief Decodes an array metric into a typed, non-allocating view.
+ *
+ * @tparam T Element type matching the metric's array datatype: an integer, float,
+ *           double, bool, sparkplug::DateTime or std::string_view (StringArray)
+ * @param datatype Metric datatype
+ * @param bytes Metric bytes_value
+ *
+ * @return View over the bytes, or an error if the datatype does not match T or the
+ *         bytes are malformed
+ */
+template <typename T>
+  requires SparkplugArrayElement<T> && (!std::same_as<T, std::string>)
+stdx::expected<ArrayView<T>, std::string> get_array(DataType datatype,
+                                                    std::span<const uint8_t> bytes) {
+  constexpr DataType expected_type = detail::get_array_datatype<T>();
+  if (datatype != expected_type) {
+    return stdx::unexpected(std::format("Array datatype mismatch: expected {}, got {}",
+                                        std::to_underlying(expected_type),
+                                        std::to_underlying(datatype)));
+  }
+
+  if constexpr (std::is_same_v<T, bool>) {
+    if (bytes.size() < 4) {
+      return stdx::unexpected("BooleanArray is missing its 4-byte element count");
+    }
+    auto count = detail::load_array_element<uint32_t>(bytes.data());
+    if (bytes.size() - 4 < (static_cast<size_t>(count) + 7) / 8) {
+      return stdx::unexpected(std::format("BooleanArray truncated: {} values in {} bytes",
+                                          count, bytes.size()));
+    }
+    return ArrayView<bool>(count, bytes.subspan(4));
+  } else if constexpr (std::is_same_v<T, std::string_view>) {
+    if (!bytes.empty() && bytes.back() != 0) {
+      return stdx::unexpected("StringArray is not null-terminated");
+    }
+    return ArrayView<std::string_view>(
+        std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size()));
+  } else {
+    if (bytes.size() % sizeof(T) != 0) {
+      return stdx::unexpected(std::format(
+          "Array size {} is not a multiple of the {}-byte element", bytes.size(),
+          sizeof(T)));
+    }
+    return ArrayView<T>(bytes);
+  }
+}
+
+/**
+ * @brief Decodes an array metric into a typed, non-allocating view.
+ *
+ * @code
+ * for (const auto& metric : payload.metrics()) {
+ *   if (auto waveform = sparkplug::get_array<double>(metric)) {
+ *     waveform->copy_to(samples);
+ *   }
+ * }
+ * @endcode
+ *
+ * @note The view points into the metric, which must outlive it.
+ */
+template <typename T>
+  requires SparkplugArrayElement<T> && (!std::same_as<T, std::string>)
+stdx::expected<ArrayView<T>, std::string>
+get_array(const org::eclipse::tahu::protobuf::Payload::Metric& metric) {
+  if (metric.value_case() != org::eclipse::tahu::protobuf::Payload::Metric::kBytesValue) {
+    return stdx::unexpected("Array metric has no bytes_value");
+  }
+  const auto& bytes = metric.bytes_value();
+  const std::span data(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+  return get_array<T>(static_cast<DataType>(metric.datatype()), data);
+}
+
+} // namespace sparkplug
@@ -0,0 +1,76 @@
+// include/sparkplug/clock.hpp
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+namespace sparkplug {
+
+/**
+ * @brief Source of Sparkplug timestamps (milliseconds since Unix epoch).
+ *
+ * - system(): std::chrono::system_clock (default)
+ * - coarse(): CLOCK_REALTIME_COARSE where available. It is much cheaper to read and has
+ *   a resolution of one scheduler tick (typically 1-4 ms). Falls back to system() on
+ *   platforms without it.
+ * - custom(): caller-injected function, e.g. a scan-cycle time or a fake clock that
+ *   makes tests and benchmarks deterministic
+ *
+ * @par Example Usage
+ * @code
+ * uint64_t fake_now = 1700000000000;
+ * auto fake_clock = sparkplug::Clock::custom([&] { return fake_now; });
+ * sparkplug::PayloadBuilder data({.clock = fake_clock});
+ * @endcode
+ */
+class Clock {
+public:
+  /// Returns the current time in milliseconds since Unix epoch
+  using Function = std::function<uint64_t()>;
+
+  enum class Source : uint8_t {
+    System, ///< std::chrono::system_clock
+    Coarse, ///< CLOCK_REALTIME_COARSE (system_clock where unavailable)
+    Custom, ///< Caller-injected function
+  };
+
+  /**
+   * @brief Constructs a system clock.
+   */
+  Clock() = default;
+
+  [[nodiscard]] static Clock system() {
+    return Clock{};
+  }
+
+  [[nodiscard]] static Clock coarse() {
+    Clock clock;
+    clock.source_ = Source::Coarse;
+    return clock;
+  }
+
+  [[nodiscard]] static Clock custom(Function now_ms) {
+    Clock clock;
+    clock.source_ = Source::Custom;
+    clock.now_ms_ = std::move(now_ms);
+    return clock;
+  }
+
+  /**
+   * @brief Reads the clock.
+   *
+   * @return Current time in milliseconds since Unix epoch
+   */
+  [[nodiscard]] uint64_t now_ms() const;
+
+  [[nodiscard]] Source source() const noexcept {
+    return source_;
+  }
+
+private:
+  Source source_{Source::System};
+  Function now_ms_; // Set for Source::Custom
+};
+
+} // namespace sparkplug
@@ -0,0 +1,408 @@
+// include/sparkplug/dataset.hpp
+#pragma once
+
+#include "datatype.hpp"
+#include "detail/compat.hpp"
+#include "payload_builder.hpp"
+#include "sparkplug_b.pb.h"
+#include "wire.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace sparkplug {
+
+/// Cell types supported by Sparkplug B DataSet columns
+template <typename T>
+concept SparkplugDataSetElement =
+    SparkplugNumeric<T> || SparkplugBoolean<T> ||
+    std::same_as<std::remove_cvref_t<T>, std::string> ||
+    std::same_as<std::remove_cvref_t<T>, std::string_view> ||
+    std::same_as<std::remove_cvref_t<T>, DateTime>;
+
+/// Contiguous column storage that outlives the call (lvalues and views such as std::span)
+template <typename R>
+concept SparkplugDataSetColumn =
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+    std::ranges::borrowed_range<R> &&
+    SparkplugDataSetElement<std::ranges::range_value_t<R>>;
+
+namespace detail {
+
+// Cells stored as DataSetValue.string_value
+template <typename T>
+inline constexpr bool is_dataset_string =
+    std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+
+template <typename T>
+consteval DataType get_dataset_datatype() noexcept {
+  if constexpr (std::is_same_v<T, DateTime>)
+    return DataType::DateTime;
+  else if constexpr (std::is_same_v<T, std::string_view>)
+    return DataType::String;
+  else
+    return get_datatype<T>();
+}
+
+// Protobuf encoding of one DataSetValue: oneof field plus its integer representation
+template <typename T>
+constexpr uint32_t dataset_value_field() noexcept {
+  if constexpr (std::is_same_v<T, float>)
+    return wire::dataset_value_field::FLOAT_VALUE;
+  else if constexpr (std::is_same_v<T, double>)
+    return wire::dataset_value_field::DOUBLE_VALUE;
+  else if constexpr (std::is_same_v<T, bool>)
+    return wire::dataset_value_field::BOOLEAN_VALUE;
+  else if constexpr (is_dataset_string<T>)
+    return wire::dataset_value_field::STRING_VALUE;
+  else if constexpr (std::is_same_v<T, DateTime> || sizeof(T) == 8)
+    return wire::dataset_value_field::LONG_VALUE;
+  else
+    return wire::dataset_value_field::INT_VALUE;
+}
+
+template <typename T>
+uint64_t dataset_varint(const T& value) noexcept {
+  if constexpr (std::is_same_v<T, DateTime>)
+    return static_cast<uint64_t>(value.time_since_epoch().count());
+  else if constexpr (std::is_same_v<T, bool>)
+    return value ? 1 : 0;
+  else if constexpr (sizeof(T) == 8)
+    return static_cast<uint64_t>(value);
+  else
+    return static_cast<uint32_t>(value); // Matches protobuf's uint32 int_value
+}
+
+// Encoded size of a Row.elements entry (key, length and DataSetValue body)
+template <typename T>
+size_t dataset_cell_size(const void* data, size_t row) noexcept {
+  const T& value = static_cast<const T*>(data)[row];
+  size_t body;
+  if constexpr (std::is_same_v<T, float>) {
+    body = 1 + 4;
+  } else if constexpr (std::is_same_v<T, double>) {
+    body = 1 + 8;
+  } else if constexpr (is_dataset_string<T>) {
+    body = 1 + wire::varint_size(value.size()) + value.size();
+  } else {
+    body = 1 + wire::varint_size(dataset_varint(value));
+  }
+  return 1 + wire::varint_size(body) + body;
+}
+
+template <typename T>
+uint8_t* write_dataset_cell(uint8_t* out, const void* data, size_t row) noexcept {
+  const T& value = static_cast<const T*>(data)[row];
+  constexpr uint32_t field = dataset_value_field<T>();
+
+  *out++ = static_cast<uint8_t>(
+      wire::make_tag(wire::dataset_field::ROW_ELEMENTS, wire::WireType::LengthDelimited));
+  if constexpr (std::is_same_v<T, float>) {
+    *out++ = 5;
+    *out++ = static_cast<uint8_t>(wire::make_tag(field, wire::WireType::Fixed32));
+    return wire::write_fixed32(out, std::bit_cast<uint32_t>(value));
+  } else if constexpr (std::is_same_v<T, double>) {
+    *out++ = 9;
+    *out++ = static_cast<uint8_t>(wire::make_tag(field, wire::WireType::Fixed64));
+    return wire::write_fixed64(out, std::bit_cast<uint64_t>(value));
+  } else if constexpr (is_dataset_string<T>) {
+    size_t body = 1 + wire::varint_size(value.size()) + value.size();
+    out = wire::write_varint(out, body);
+    *out++ = static_cast<uint8_t>(wire::make_tag(field, wire::WireType::LengthDelimited));
+    out = wire::write_varint(out, value.size());
+    if (!value.empty()) {
+      std::memcpy(out, value.data(), value.size());
+    }
+    return out + value.size();
+  } else {
+    uint64_t varint = dataset_varint(value);
+    *out++ = static_cast<uint8_t>(1 + wire::varint_size(varint));
+    *out++ = static_cast<uint8_t>(wire::make_tag(field, wire::WireType::Varint));
+    return wire::write_varint(out, varint);
+  }
+}
+
+template <typename T>
+void set_dataset_cell(org::eclipse::tahu::protobuf::Payload::DataSet::DataSetValue* cell,
+                      const void* data,
+                      size_t row) {
+  const T& value = static_cast<const T*>(data)[row];
+  if constexpr (std::is_same_v<T, float>) {
+    cell->set_float_value(value);
+  } else if constexpr (std::is_same_v<T, double>) {
+    cell->set_double_value(value);
+  } else if constexpr (std::is_same_v<T, bool>) {
+    cell->set_boolean_value(value);
+  } else if constexpr (is_dataset_string<T>) {
+    cell->mutable_string_value()->assign(value.data(), value.size());
+  } else if constexpr (dataset_value_field<T>() ==
+                       wire::dataset_value_field::LONG_VALUE) {
+    cell->set_long_value(dataset_varint(value));
+  } else {
+    cell->set_int_value(static_cast<uint32_t>(dataset_varint(value)));
+  }
+}
+
+} // namespace detail
+
+/**
+ * @brief Columnar builder for Sparkplug B DataSet metrics.
+ *
+ * Columns are added whole, as contiguous arrays. The builder keeps only a view of each
+ * column, so no per-cell objects are created. encode_into() sizes the table and then
+ * writes the Payload.DataSet wire format row by row in a single pass into one
+ * preallocated buffer. PayloadBuilder::add_dataset() embeds those same bytes in the
+ * metric. Encoding keeps no state in the builder, so a const builder may be encoded from
+ * several threads at once.
+ *
+ * @par Example Usage
+ * @code
+ * std::vector<int64_t> batch_ids = ...;
+ * std::vector<double> weights = ...;
+ * std::vector<std::string> operators = ...;
+ *
+ * sparkplug::DataSetBuilder table;
+ * table.add_column("BatchId", batch_ids);
+ * table.add_column("Weight", weights);
+ * table.add_column("Operator", operators);
+ *
+ * sparkplug::PayloadBuilder data;
+ * data.add_dataset_by_alias(20, table);
+ * @endcode
+ *
+ * @note Column data is referenced, not copied: it must outlive every encode_into() or
+ *       add_dataset() call that uses this builder.
+ */
+class DataSetBuilder {
+public:
+  /**
+   * @brief Appends a column.
+   *
+   * @tparam R Contiguous range of a DataSet cell type (std::span, std::vector, ...)
+   * @param name Column name
+   * @param values Column cells, one per row
+   *
+   * @return void on success, error message if the row count differs from the columns
+   *         added before
+   */
+  template <typename R>
+    requires SparkplugDataSetColumn<R>
+  stdx::expected<void, std::string> add_column(std::string_view name, R&& values) {
+    using T = std::ranges::range_value_t<R>;
+    return add_column(Column{.name = std::string(name),
+                             .type = detail::get_dataset_datatype<T>(),
+                             .data = std::ranges::data(values),
+                             .rows = std::ranges::size(values),
+                             .cell_size = &detail::dataset_cell_size<T>,
+                             .write_cell = &detail::write_dataset_cell<T>,
+                             .set_cell = &detail::set_dataset_cell<T>});
+  }
+
+  [[nodiscard]] size_t num_columns() const noexcept {
+    return columns_.size();
+  }
+  [[nodiscard]] size_t num_rows() const noexcept {
+    return columns_.empty() ? 0 : columns_.front().rows;
+  }
+
+  /**
+   * @brief Removes all columns (capacity is kept).
+   */
+  void clear() noexcept;
+
+  /**
+   * @brief Returns the exact size of the encoded Payload.DataSet message.
+   */
+  [[nodiscard]] size_t encoded_size() const;
+
+  /**
+   * @brief Encodes the Payload.DataSet message into a reusable vector.
+   *
+   * The output is byte-identical to serializing the protobuf DataSet that
+   * PayloadBuilder::add_dataset() produces. Embed it in a wire::Encoder payload with
+   * wire::DataSetBytes.
+   */
+  void encode_into(std::vector<uint8_t>& buffer) const;
+
+  /**
+   * @brief Encodes the Payload.DataSet message into a reusable string (e.g., the
+   *        contents of a protobuf bytes or unknown field).
+   */
+  void encode_into(std::string& buffer) const;
+
+  /**
+   * @brief Encodes the Payload.DataSet message into a caller-owned buffer.
+   *
+   * @return Number of bytes written, or an error if the buffer is too small
+   */
+  [[nodiscard]] stdx::expected<size_t, std::string>
+  encode_into(std::span<uint8_t> buffer) const;
+
+  /**
+   * @brief Fills a protobuf DataSet with this table (rows and cells reserved up front).
+   */
+  void fill(org::eclipse::tahu::protobuf::Payload::DataSet& dataset) const;
+
+private:
+  struct Column {
+    std::string name;
+    DataType type;
+    const void* data;
+    size_t rows;
+    size_t (*cell_size)(const void* data, size_t row) noexcept;
+    uint8_t* (*write_cell)(uint8_t* out, const void* data, size_t row) noexcept;
+    void (*set_cell)(org::eclipse::tahu::protobuf::Payload::DataSet::DataSetValue* cell,
+                     const void* data,
+                     size_t row);
+  };
+
+  stdx::expected<void, std::string> add_column(Column column);
+  // Encoded size of one Row message body (all its cells)
+  size_t row_size(size_t row) const noexcept;
+  void write(uint8_t* out) const noexcept;
+
+  std::vector<Column> columns_;
+};
+
+/**
+ * @brief Read-only columnar view of a Sparkplug B DataSet.
+ *
+ * Each column is decoded once into its own contiguous typed array, so analytics code
+ * can use std::span<const double> and friends directly. Decoding from wire bytes does
+ * not build any protobuf objects; decoding from a parsed protobuf DataSet transposes it
+ * column by column.
+ *
+ * String cells are std::string_view into the source bytes or message, which must
+ * outlive the view.
+ *
+ * @par Example Usage
+ * @code
+ * auto table = sparkplug::DataSetView::from(metric.dataset_value());
+ * if (table) {
+ *   auto weights = table->column<double>("Weight");
+ *   double total = std::accumulate(weights->begin(), weights->end(), 0.0);
+ * }
+ * @endcode
+ */
+class DataSetView {
+public:
+  /**
+   * @brief Decodes an encoded Payload.DataSet message.
+   *
+   * @param bytes DataSet message bytes (e.g., the contents of Metric.dataset_value)
+   *
+   * @return Columnar view on success, error message on malformed or unsupported input
+   */
+  [[nodiscard]] static stdx::expected<DataSetView, std::string>
+  parse(std::span<const uint8_t> bytes);
+
+  /**
+   * @brief Transposes a parsed protobuf DataSet into columns.
+   */
+  [[nodiscard]] static stdx::expected<DataSetView, std::string>
+  from(const org::eclipse::tahu::protobuf::Payload::DataSet& dataset);
+
+  [[nodiscard]] size_t num_columns() const noexcept {
+    return columns_.size();
+  }
+  [[nodiscard]] size_t num_rows() const noexcept {
+    return num_rows_;
+  }
+
+  [[nodiscard]] std::string_view column_name(size_t index) const noexcept {
+    return columns_[index].name;
+  }
+  [[nodiscard]] DataType column_type(size_t index) const noexcept {
+    return columns_[index].type;
+  }
+
+  /**
+   * @brief Finds a column by name.
+   */
+  [[nodiscard]] std::optional<size_t> column_index(std::string_view name) const noexcept;
+
+  /**
+   * @brief Returns a column as a contiguous typed array.
+   *
+   * @tparam T Cell type matching the column datatype: the integer type of the column,
+   *           float, double, bool, sparkplug::DateTime, or std::string_view for String
+   *           and Text columns
+   *
+   * @return Column cells, or an error on bad index or type mismatch
+   */
+  template <typename T>
+  [[nodiscard]] stdx::expected<std::span<const T>, std::string>
+  column(size_t index) const {
+    if (index >= columns_.size()) {
+      return stdx::unexpected(std::format("Column index {} out of range ({} columns)",
+                                          index, columns_.size()));
+    }
+    if constexpr (std::is_same_v<T, bool>) {
+      if (const auto* bools = std::get_if<BoolColumn>(&columns_[index].cells)) {
+        return std::span<const bool>(bools->data.get(), bools->size);
+      }
+    } else {
+      if (const auto* cells = std::get_if<std::vector<T>>(&columns_[index].cells)) {
+        return std::span<const T>(*cells);
+      }
+    }
+    return stdx::unexpected(std::format("Column '{}' type mismatch (datatype {})",
+                                        columns_[index].name,
+                                        std::to_underlying(columns_[index].type)));
+  }
+
+  template <typename T>
+  [[nodiscard]] stdx::expected<std::span<const T>, std::string>
+  column(std::string_view name) const {
+    auto index = column_index(name);
+    if (!index) {
+      return stdx::unexpected(std::format("No column named '{}'", name));
+    }
+    return column<T>(*index);
+  }
+
+private:
+  struct BoolColumn {
+    std::unique_ptr<bool[]> data; // std::vector<bool> is not contiguous
+    size_t size{0};
+  };
+
+  using Cells = std::variant<std::vector<int8_t>,
+                             std::vector<int16_t>,
+                             std::vector<int32_t>,
+                             std::vector<int64_t>,
+                             std::vector<uint8_t>,
+                             std::vector<uint16_t>,
+                             std::vector<uint32_t>,
+                             std::vector<uint64_t>,
+                             std::vector<float>,
+                             std::vector<double>,
+                             BoolColumn,
+                             std::vector<std::string_view>,
+                             std::vector<DateTime>>;
+
+  struct Column {
+    std::string_view name;
+    DataType type;
+    Cells cells;
+  };
+
+  static stdx::expected<Cells, std::string> make_cells(DataType type, size_t rows);
+
+  std::vector<Column> columns_;
+  size_t num_rows_{0};
+};
+
+} // namespace sparkplug
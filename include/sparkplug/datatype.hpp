@@ -1,6 +1,7 @@
 // include/sparkplug/datatype.hpp
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 
 namespace sparkplug {
@@ -27,7 +28,24 @@ enum class DataType : uint32_t {
   File = 18,
   Template = 19,
   PropertySet = 20,
-  PropertySetList = 21
+  PropertySetList = 21,
+  // Sparkplug 3.0 packed array types (little-endian, carried in bytes_value)
+  Int8Array = 22,
+  Int16Array = 23,
+  Int32Array = 24,
+  Int64Array = 25,
+  UInt8Array = 26,
+  UInt16Array = 27,
+  UInt32Array = 28,
+  UInt64Array = 29,
+  FloatArray = 30,
+  DoubleArray = 31,
+  BooleanArray = 32,
+  StringArray = 33,
+  DateTimeArray = 34
 };
 
+/// Element type of DateTimeArray metrics (milliseconds since Unix epoch)
+using DateTime = std::chrono::sys_time<std::chrono::milliseconds>;
+
 }
\ No newline at end of file
@@ -0,0 +1,197 @@
+// include/sparkplug/deadband_filter.hpp
+#pragma once
+
+#include "clock.hpp"
+#include "datatype.hpp"
+#include "detail/compat.hpp"
+#include "payload_builder.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace sparkplug {
+
+/**
+ * @brief Optional Report by Exception stage: decides which metrics go into NDATA.
+ *
+ * Metrics are registered by alias with their own thresholds. The application feeds
+ * every sample through update(); collect() then adds only the metrics that moved
+ * beyond their deadband, or stayed silent too long, to an NDATA PayloadBuilder.
+ *
+ * Samples are kept in contiguous per-type tables (floating point, integer, boolean,
+ * string). collect() compares each table against its last-sent values in one
+ * branch-free pass that the compiler can vectorize, so filtering tens of thousands
+ * of tags per cycle costs a few microseconds.
+ *
+ * A metric is reported when it has a sample and any of these holds:
+ * - it has never been reported (or invalidate() was called)
+ * - |value - last_sent| > max(absolute, percent / 100 * |last_sent|); with both
+ *   thresholds at 0 any change is reported. Booleans and strings report any change.
+ * - max_silence is non-zero and at least that long has passed since it was last sent
+ *
+ * The thresholds remain the application's decision; the filter only applies them.
+ *
+ * @par Example Usage
+ * @code
+ * sparkplug::DeadbandFilter rbe;
+ * rbe.add_metric<double>(1, {.absolute = 0.5, .max_silence = std::chrono::minutes(5)});
+ * rbe.add_metric<int32_t>(2, {.percent = 2.0});
+ *
+ * // Scan loop
+ * rbe.update(1, read_temperature());
+ * rbe.update(2, read_speed());
+ *
+ * sparkplug::PayloadBuilder data;
+ * auto changed = edge_node.publish_changed(rbe, data);  // collect + publish + commit
+ * @endcode
+ *
+ * @note Not thread-safe; use one filter per scan thread.
+ */
+class DeadbandFilter {
+public:
+  /**
+   * @brief Per-metric reporting thresholds.
+   */
+  struct Deadband {
+    double absolute{0.0}; ///< Minimum absolute change to report (numeric metrics)
+    double percent{0.0};  ///< Minimum change in percent of the last sent value
+    std::chrono::milliseconds max_silence{0}; ///< Re-report after this long (0 = never)
+  };
+
+  struct Options {
+    Clock clock{}; ///< Time source for max_silence
+  };
+
+  DeadbandFilter() = default;
+  explicit DeadbandFilter(Options options) : options_(std::move(options)) {
+  }
+
+  /**
+   * @brief Registers a metric.
+   *
+   * @tparam T Metric value type (determines the reported datatype)
+   * @param alias Metric alias, as established in NBIRTH
+   * @param deadband Reporting thresholds
+   *
+   * @return void on success, error message if the alias is already registered or the
+   *         thresholds are negative
+   */
+  template <SparkplugMetricType T>
+  stdx::expected<void, std::string> add_metric(uint64_t alias, Deadband deadband = {}) {
+    return add_slot(alias, detail::get_datatype<T>(), deadband);
+  }
+
+  /**
+   * @brief Stages a new sample.
+   *
+   * @return void on success, error message on unknown alias or datatype mismatch
+   */
+  template <SparkplugMetricType T>
+  stdx::expected<void, std::string> update(uint64_t alias, const T& value) {
+    auto slot = find_slot(alias, detail::get_datatype<T>());
+    if (!slot) {
+      return stdx::unexpected(slot.error());
+    }
+    using BaseT = std::remove_cvref_t<T>;
+    if constexpr (SparkplugFloat<BaseT>) {
+      floats_.current[slot->index] = static_cast<double>(value);
+      floats_.state[slot->index] |= HAS_VALUE;
+    } else if constexpr (SparkplugBoolean<BaseT>) {
+      bools_.current[slot->index] = value ? 1 : 0;
+      bools_.state[slot->index] |= HAS_VALUE;
+    } else if constexpr (SparkplugSignedInteger<BaseT>) {
+      ints_.current[slot->index] = static_cast<uint64_t>(static_cast<int64_t>(value));
+      ints_.state[slot->index] |= HAS_VALUE;
+    } else if constexpr (SparkplugUnsignedInteger<BaseT>) {
+      ints_.current[slot->index] = static_cast<uint64_t>(value);
+      ints_.state[slot->index] |= HAS_VALUE;
+    } else {
+      std::string_view str(value);
+      strings_.current[slot->index].assign(str.data(), str.size());
+      strings_.state[slot->index] |= HAS_VALUE;
+    }
+    return {};
+  }
+
+  /**
+   * @brief Adds every metric that needs reporting to an NDATA payload (by alias).
+   *
+   * The reported metrics are remembered until commit(), which records them as sent.
+   * Calling collect() again without commit() reports them again.
+   *
+   * @param payload Destination builder
+   *
+   * @return Number of metrics added
+   */
+  size_t collect(PayloadBuilder& payload);
+
+  /**
+   * @brief Records the metrics from the last collect() as sent.
+   *
+   * Call after the NDATA was published successfully.
+   */
+  void commit();
+
+  /**
+   * @brief Forces every metric with a sample to be reported by the next collect().
+   *
+   * Use after a rebirth if the NBIRTH did not carry the current values.
+   */
+  void invalidate() noexcept;
+
+  /// Number of registered metrics
+  [[nodiscard]] size_t size() const noexcept {
+    return slots_.size();
+  }
+
+private:
+  static constexpr uint8_t HAS_VALUE = 1; // A sample has been staged
+  static constexpr uint8_t SENT = 2;      // last_sent/last_sent_ms are valid
+
+  enum class Lane : uint8_t { Float, Integer, Boolean, String };
+
+  struct Slot {
+    Lane lane;
+    uint32_t index;
+    DataType type;
+  };
+
+  // Structure-of-arrays table for one value representation
+  template <typename V>
+  struct Table {
+    std::vector<V> current;
+    std::vector<V> last_sent;
+    std::vector<double> absolute;
+    std::vector<double> percent;
+    std::vector<uint64_t> max_silence_ms;
+    std::vector<uint64_t> last_sent_ms;
+    std::vector<uint8_t> state;
+    std::vector<uint8_t> report; // Scratch output of the comparison pass
+    std::vector<uint64_t> alias;
+    std::vector<DataType> type;
+
+    uint32_t push(uint64_t alias_value, DataType datatype, const Deadband& deadband);
+  };
+
+  stdx::expected<void, std::string>
+  add_slot(uint64_t alias, DataType type, const Deadband& deadband);
+  stdx::expected<Slot, std::string> find_slot(uint64_t alias, DataType type) const;
+
+  Options options_;
+  std::unordered_map<uint64_t, Slot> slots_;
+  Table<double> floats_;
+  Table<uint64_t> ints_;  // Two's complement bit patterns of signed and unsigned values
+  Table<uint8_t> bools_;
+  Table<std::string> strings_;
+  std::vector<Slot> pending_; // Reported by the last collect(), awaiting commit()
+  uint64_t collect_ms_{0};    // Clock reading of the last collect()
+};
+
+} // namespace sparkplug
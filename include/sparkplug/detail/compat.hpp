@@ -20,3 +20,54 @@ using tl::expected;
 using tl::unexpected;
 } // namespace sparkplug::stdx
 #endif
+
+// std::atomic<std::shared_ptr> compatibility
+// Feature test macro from: https://en.cppreference.com/w/cpp/feature_test
+#include <atomic>
+#include <memory>
+#if __cpp_lib_atomic_shared_ptr >= 201711L
+namespace sparkplug::stdx {
+template <typename T>
+using atomic_shared_ptr = std::atomic<std::shared_ptr<T>>;
+} // namespace sparkplug::stdx
+#else
+// Fallback for stdlibs without it (e.g., libc++): a spinlock held only while the
+// pointer itself is copied or swapped; the previous object is released outside it
+#  include <thread>
+namespace sparkplug::stdx {
+template <typename T>
+class atomic_shared_ptr {
+public:
+  atomic_shared_ptr() noexcept = default;
+  atomic_shared_ptr(const atomic_shared_ptr&) = delete;
+  atomic_shared_ptr& operator=(const atomic_shared_ptr&) = delete;
+
+  [[nodiscard]] std::shared_ptr<T> load() const noexcept {
+    lock();
+    std::shared_ptr<T> copy = ptr_;
+    unlock();
+    return copy;
+  }
+
+  void store(std::shared_ptr<T> desired) noexcept {
+    lock();
+    ptr_.swap(desired);
+    unlock();
+  }
+
+private:
+  void lock() const noexcept {
+    while (busy_.test_and_set(std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+  }
+
+  void unlock() const noexcept {
+    busy_.clear(std::memory_order_release);
+  }
+
+  mutable std::atomic_flag busy_;
+  std::shared_ptr<T> ptr_;
+};
+} // namespace sparkplug::stdx
+#endif
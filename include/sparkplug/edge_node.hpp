@@ -1,18 +1,29 @@
 #pragma once
 
+#include "clock.hpp"
+#include "deadband_filter.hpp"
 #include "detail/compat.hpp"
+#include "frozen_payload.hpp"
 #include "logging.hpp"
 #include "mqtt_handle.hpp"
 #include "payload_builder.hpp"
+#include "publish_sequencer.hpp"
+#include "publish_tracker.hpp"
 #include "sparkplug_b.pb.h"
+#include "store_forward_buffer.hpp"
+#include "template.hpp"
 #include "topic.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <span>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -40,25 +51,55 @@ using CommandCallback =
  * - Birth/Death sequence (bdSeq) tracking for session management
  *
  * @par Thread Safety
- * This class is fully thread-safe with coarse-grained locking:
- * - All public methods use a single internal mutex to protect shared state
- * - Methods can be safely called from any thread concurrently
- * - Callbacks (e.g., command_callback) are invoked on MQTT thread WITHOUT holding mutex
- * - Mutex is released before MQTT publish to prevent callback deadlocks
- * - Performance: Suitable for typical IIoT applications; not optimized for
- * ultra-high-frequency
- *   (>10kHz) publishing from multiple threads
+ * This class is thread-safe; methods can be called from any thread concurrently:
+ * - One internal mutex guards the node's state, and is held only to check it and copy
+ * out what a call needs, never across encoding or MQTT operations
+ * - Session setup (connect() and automatic reconnects) is serialized by a mutex of its
+ * own, so publishes are not held up while the broker is slow or down
+ * - The send path is a lock-free queue drained by one writer at a time, so publishing
+ * threads encode concurrently and wait only while the queue is full
+ * - Callbacks (e.g., command_callback) are invoked on MQTT thread WITHOUT holding a lock
  *
  * @par Threading Model
  * - **Application threads**: Call EdgeNode methods (connect, publish_*, disconnect)
  * - **MQTT client thread**: Paho async library handles network I/O and invokes callbacks
- * - **Synchronization**: Single std::mutex protects all mutable state (seq_num_,
- * bd_seq_num_, device_states_, last_birth_payload_, etc.)
- * - **Lock acquisition**: Methods acquire mutex, prepare data, release before MQTT
- * operations
+ * - **Synchronization**: std::mutex mutex_ protects the mutable state (bd_seq_num_,
+ * device_states_, last_birth_payload_, etc.); session_mutex_ serializes open_session()
+ * - **Send path**: Payloads are encoded on the calling thread; every message that
+ * carries the node seq then goes through one writer (PublishSequencer) that assigns
+ * the seq and sends it, so wire order always matches seq order
+ * - **Lock acquisition**: Methods hold the mutex only to check state and copy out the
+ * topic, client and QoS (plus bdSeq and templates for births); building, encoding and
+ * MQTT operations run after it is released
  * - **Callback safety**: User callbacks invoked without mutex held (safe to call EdgeNode
  * methods)
  * - **Blocking operations**: connect() and disconnect() block until completion or timeout
+ * - **Replay thread**: With Config::store_forward, connect() starts one thread that
+ * replays stored messages; it stops when the EdgeNode is destroyed
+ * - **Reconnect thread**: With Config::auto_reconnect, connect() starts one thread that
+ * re-establishes lost sessions; it stops when the EdgeNode is destroyed
+ *
+ * @par Store and Forward
+ * With Config::store_forward set, NDATA/DDATA published while the node is offline
+ * (not connected, primary host offline, or no NBIRTH yet in this MQTT session) are
+ * encoded into a StoreForwardBuffer and the publish succeeds. Once the node is online
+ * again and has published NBIRTH (publish_birth() or rebirth()), the stored messages
+ * are replayed oldest first, with every metric flagged is_historical and a new seq, at
+ * most Config::store_forward_drain_rate per second so live data keeps flowing. A DDATA
+ * is replayed once its device has been born again, and waits behind the other stored
+ * messages until then; it is dropped if that does not happen within 30 seconds. A
+ * message whose send fails is retried a few times before it is dropped. The buffer is
+ * opened by the first connect().
+ *
+ * @par Automatic Reconnect
+ * With Config::auto_reconnect set, a lost connection is re-established by the node
+ * itself: attempts are spaced by exponential backoff with jitter, each with a new
+ * NDEATH Will carrying the next bdSeq. NCMD, STATE and the DCMD of every online device
+ * are subscribed in one request; then, once the primary host (if any) is online, the
+ * last NBIRTH is re-sent with the new bdSeq and every online device's last DBIRTH is
+ * re-sent as it was encoded. Until then publish_birth() and publish_device_birth()
+ * fail and NDATA/DDATA fail or are stored. The application only calls connect() once
+ * and disconnect() to stop; last_reconnect() reports how long recovery took.
  *
  * @par Rust FFI Compatibility
  * - Implements Send: Can transfer between threads safely (all state mutex-protected)
@@ -108,6 +149,20 @@ public:
     bool enable_server_cert_auth = true; ///< Verify server certificate (default: true)
   };
 
+  /**
+   * @brief Backoff between automatic reconnect attempts (see Config::auto_reconnect).
+   *
+   * The n-th attempt waits initial_delay * multiplier^(n-1), capped at max_delay, scaled
+   * by a random factor in [1 - jitter, 1 + jitter] so that nodes dropped together by a
+   * broker restart do not all reconnect at the same moment.
+   */
+  struct ReconnectOptions {
+    std::chrono::milliseconds initial_delay{100}; ///< Wait before the first attempt
+    std::chrono::milliseconds max_delay{30000};   ///< Longest wait between attempts
+    double multiplier{2.0};                       ///< Growth of the wait per attempt
+    double jitter{0.2}; ///< Relative random spread of each wait (0 = none)
+  };
+
   /**
    * @brief Configuration parameters for the Sparkplug B Edge Node.
    */
@@ -132,6 +187,33 @@ public:
     std::optional<CommandCallback> command_callback{};
     std::optional<std::string> primary_host_id{};
     std::optional<LogCallback> log_callback{};
+    Clock clock{}; ///< Timestamp source for payloads the node builds itself (NDEATH,
+                   ///< DDEATH). Pass the same clock to PayloadBuilder::Options.
+    size_t max_payload_bytes{0}; ///< Broker maximum packet size (0 = unlimited). The
+                                 ///< topic and MQTT header are taken out of it, and
+                                 ///< NDATA/DDATA whose payload does not fit in the rest
+                                 ///< are split into several messages; BIRTHs are errors.
+    size_t max_pending_publishes{1024}; ///< Asynchronous publishes awaiting completion;
+                                        ///< further publish_*_async() calls wait for one
+    std::optional<StoreForwardBuffer::Options>
+        store_forward{}; ///< Store NDATA/DDATA published while offline (see
+                         ///< "Store and Forward" below); unset: they fail
+    size_t store_forward_drain_rate{100}; ///< Stored messages replayed per second
+                                          ///< (0 = as fast as possible)
+    std::optional<ReconnectOptions>
+        auto_reconnect{}; ///< Re-establish lost sessions (see "Automatic Reconnect"
+                          ///< below); unset: the application calls connect() again
+  };
+
+  /**
+   * @brief Timings of the last automatic reconnect (see last_reconnect()).
+   */
+  struct ReconnectReport {
+    uint32_t attempts{0}; ///< Connection attempts, the successful one included
+    std::chrono::milliseconds outage{0}; ///< From connection loss to the broker's CONNACK
+    std::chrono::microseconds session_ready{0}; ///< From CONNACK to births re-sent
+    std::optional<std::chrono::microseconds>
+        first_data{}; ///< From CONNACK to the first NDATA/DDATA sent (unset until then)
   };
 
   /**
@@ -186,6 +268,8 @@ public:
    * @return void on success, error message on failure
    *
    * @note Must be called before publish_birth().
+   * @note With Config::auto_reconnect, later connection losses are handled by the node;
+   *       call connect() only once.
    * @warning The EdgeNode must remain in scope while connected, or NDEATH
    *          may not be delivered properly.
    */
@@ -216,13 +300,43 @@ public:
    *       - All metrics with both name and alias (for NDATA to use aliases)
    *       - bdSeq metric (automatically managed if using rebirth())
    *       - Any metadata or properties
+   *       Definitions registered with register_template() are appended automatically
+   *       unless the payload already carries them.
+   * @note The bdSeq and template metrics are added to a copy; payload is not modified.
    *
    * @warning Must be called after connect() and before any publish_data() calls.
    *
    * @see publish_data() for subsequent updates
    * @see rebirth() for publishing a new NBIRTH during runtime
    */
-  [[nodiscard]] stdx::expected<void, std::string> publish_birth(PayloadBuilder& payload);
+  [[nodiscard]] stdx::expected<void, std::string>
+  publish_birth(const PayloadBuilder& payload);
+
+  /**
+   * @brief Registers a Template (UDT) definition to publish in every NBIRTH.
+   *
+   * Definitions are stored once and emitted as "_types_/<name>" metrics with
+   * is_definition set. Instances then only carry values plus a template_ref.
+   *
+   * @param definition Template definition (e.g., TemplateLayout::definition())
+   *
+   * @return void on success, error message if a different definition with the same name
+   *         is already registered
+   *
+   * @note Register before publish_birth(); rebirth() republishes the last NBIRTH.
+   *
+   * @par Example Usage
+   * @code
+   * sparkplug::TemplateLayout<double, bool> motor("Motor", {"Speed", "Running"});
+   * edge_node.register_template(motor.definition());
+   *
+   * sparkplug::PayloadBuilder birth;
+   * birth.add_template_with_alias("Motor1", 30, motor, {0.0, false});
+   * edge_node.publish_birth(birth);
+   * @endcode
+   */
+  [[nodiscard]] stdx::expected<void, std::string>
+  register_template(const TemplateDefinition& definition);
 
   /**
    * @brief Publishes an NDATA (Node Data) message.
@@ -240,6 +354,9 @@ public:
    * @note Sequence number is automatically incremented (0-255, wraps at 256).
    * @note Timestamp is automatically added if not explicitly set.
    * @note The library provides the transport mechanism; you provide the RBE logic.
+   * @note With Config::max_payload_bytes set, a payload that does not fit is sent as
+   *       several NDATA messages with consecutive seq numbers (an explicitly set seq
+   *       is then ignored). Each carries a run of whole metrics and the same timestamp.
    *
    * @warning Must call publish_birth() before the first publish_data().
    *
@@ -247,6 +364,76 @@ public:
    */
   [[nodiscard]] stdx::expected<void, std::string> publish_data(PayloadBuilder& payload);
 
+  /**
+   * @brief Publishes an NDATA message from a pre-encoded frozen payload.
+   *
+   * The sequence number is patched into the frozen bytes, which are then published
+   * without re-serializing the payload.
+   *
+   * @param payload Frozen payload holding the current values
+   *
+   * @return void on success, error message on failure
+   *
+   * @note The payload timestamp is not refreshed; call FrozenPayload::set_timestamp()
+   *       each cycle.
+   *
+   * @see FrozenPayload
+   */
+  [[nodiscard]] stdx::expected<void, std::string> publish_data(FrozenPayload& payload);
+
+  /**
+   * @brief Publishes an NDATA message and reports when the MQTT client has sent it.
+   *
+   * Same as publish_data(), but the returned token (and on_complete, if set) report
+   * the outcome once the MQTT client has written the message (QoS 0) or had it
+   * acknowledged (QoS 1/2), so thousands of publishes can be in flight at once. A
+   * split payload completes when its last chunk does. At most
+   * Config::max_pending_publishes can be pending; further calls wait up to 5 s for
+   * one to complete, then fail.
+   *
+   * @param payload PayloadBuilder containing changed metrics
+   * @param on_complete Called once with the outcome, on the MQTT client thread
+   *
+   * @return Token for the outcome, or the error if the message was not sent (then
+   *         on_complete is never called)
+   *
+   * @par Example Usage
+   * @code
+   * auto token = edge_node.publish_data_async(data, [](const auto& result) {
+   *   if (!result) {
+   *     std::cerr << "NDATA lost: " << result.error() << "\n";
+   *   }
+   * });
+   * @endcode
+   */
+  [[nodiscard]] stdx::expected<PublishToken, std::string>
+  publish_data_async(PayloadBuilder& payload, PublishCallback on_complete = {});
+
+  /**
+   * @brief Publishes an NDATA message from a frozen payload, reporting completion.
+   *
+   * @see publish_data_async(PayloadBuilder&, PublishCallback)
+   */
+  [[nodiscard]] stdx::expected<PublishToken, std::string>
+  publish_data_async(FrozenPayload& payload, PublishCallback on_complete = {});
+
+  /**
+   * @brief Publishes an NDATA message with only the metrics a DeadbandFilter reports.
+   *
+   * Resets the payload, collects the changed metrics into it and publishes it. The
+   * filter records them as sent only if the publish succeeds. Nothing is published
+   * when no metric changed.
+   *
+   * @param filter Report by Exception stage holding the latest samples
+   * @param payload Reusable builder for the NDATA payload
+   *
+   * @return Number of metrics published (0 if nothing changed), error message on failure
+   *
+   * @see DeadbandFilter
+   */
+  [[nodiscard]] stdx::expected<size_t, std::string>
+  publish_changed(DeadbandFilter& filter, PayloadBuilder& payload);
+
   /**
    * @brief Publishes an NDEATH (Node Death) message.
    *
@@ -284,8 +471,7 @@ public:
    * @note Useful for monitoring and debugging.
    */
   [[nodiscard]] uint64_t get_seq() const {
-    std::scoped_lock lock(mutex_);
-    return seq_num_;
+    return sequencer_->seq();
   }
 
   /**
@@ -314,6 +500,22 @@ public:
     return primary_host_online_;
   }
 
+  /**
+   * @brief Gets the state of the store-and-forward buffer.
+   *
+   * @return Record counts and sizes; all zero if Config::store_forward is not set or
+   *         connect() has not been called yet
+   */
+  [[nodiscard]] StoreForwardBuffer::Stats store_forward_stats() const;
+
+  /**
+   * @brief Gets the timings of the last automatic reconnect.
+   *
+   * @return The report, or std::nullopt if Config::auto_reconnect is not set or no lost
+   *         session has been re-established yet
+   */
+  [[nodiscard]] std::optional<ReconnectReport> last_reconnect() const;
+
   /**
    * @brief Publishes a DBIRTH (Device Birth) message.
    *
@@ -351,12 +553,46 @@ public:
    * @note Sequence number is automatically incremented per device (0-255, wraps at 256).
    * @note Must call publish_device_birth() before the first publish_device_data().
    * @note The library provides the transport mechanism; you provide the RBE logic.
+   * @note Oversized payloads are split as in publish_data() (Config::max_payload_bytes).
    *
    * @see publish_device_birth() for establishing aliases
    */
   [[nodiscard]] stdx::expected<void, std::string>
   publish_device_data(std::string_view device_id, PayloadBuilder& payload);
 
+  /**
+   * @brief Publishes a DDATA message from a pre-encoded frozen payload.
+   *
+   * @param device_id The device identifier
+   * @param payload Frozen payload holding the current values
+   *
+   * @return void on success, error message on failure
+   *
+   * @see publish_data(FrozenPayload&)
+   */
+  [[nodiscard]] stdx::expected<void, std::string>
+  publish_device_data(std::string_view device_id, FrozenPayload& payload);
+
+  /**
+   * @brief Publishes a DDATA message, reporting completion.
+   *
+   * @see publish_data_async(PayloadBuilder&, PublishCallback)
+   */
+  [[nodiscard]] stdx::expected<PublishToken, std::string>
+  publish_device_data_async(std::string_view device_id,
+                            PayloadBuilder& payload,
+                            PublishCallback on_complete = {});
+
+  /**
+   * @brief Publishes a DDATA message from a frozen payload, reporting completion.
+   *
+   * @see publish_data_async(PayloadBuilder&, PublishCallback)
+   */
+  [[nodiscard]] stdx::expected<PublishToken, std::string>
+  publish_device_data_async(std::string_view device_id,
+                            FrozenPayload& payload,
+                            PublishCallback on_complete = {});
+
   /**
    * @brief Publishes a DDEATH (Device Death) message.
    *
@@ -425,28 +661,60 @@ public:
   void log(LogLevel level, std::string_view message) const noexcept;
 
 private:
+  // Topic strings of one device, rendered once
+  struct DeviceTopics {
+    std::string birth;   // DBIRTH
+    std::string data;    // DDATA
+    std::string death;   // DDEATH
+    std::string command; // DCMD (subscribed before each DBIRTH)
+  };
+
   /**
    * @brief Tracks state for an individual device attached to this edge node.
    */
   struct DeviceState {
-    std::vector<uint8_t> last_birth_payload; // Last DBIRTH for rebirth
+    std::vector<uint8_t> last_birth_payload; // Last DBIRTH, without its seq
     bool is_online{false};                   // True if DBIRTH sent and device online
+    uint64_t birth_bd_seq{0}; // bdSeq of the MQTT session of the last DBIRTH
+    DeviceTopics topics; // Rendered before the first DBIRTH, then never modified
+  };
+
+  // Topic strings of this edge node, rendered once
+  struct NodeTopics {
+    std::string birth;   // NBIRTH
+    std::string data;    // NDATA
+    std::string death;   // NDEATH (also the MQTT Will topic)
+    std::string command; // NCMD
   };
 
   Config config_;
-  MQTTAsyncHandle client_;
-  uint64_t seq_num_{0};    // Node message sequence (0-255)
+  // Completion slots for publish_*_async(); shared with the PublishTokens handed out
+  std::shared_ptr<PublishTracker> publishes_;
+  // Single writer of every message carrying the node seq (0-255), which it assigns
+  std::unique_ptr<PublishSequencer> sequencer_;
+  // Replaced by each open_session(); publishes hold their own reference until sent
+  std::shared_ptr<MQTTAsyncHandle> client_;
   uint64_t bd_seq_num_{0}; // Birth/Death sequence
 
+  // Serializes open_session() and guards the three members below, which it uses
+  // without mutex_ while it waits for the broker
+  std::mutex session_mutex_;
+
   // Store the NDEATH payload for the MQTT Will
   std::vector<uint8_t> death_payload_data_;
-  std::string death_topic_str_; // Topic string for MQTT Will (must outlive async connect)
   MQTTAsync_willOptions will_opts_; // Will options struct (must outlive async connect)
   MQTTAsync_SSLOptions ssl_opts_{};
 
+  // Rendered on the first connect(); the group and edge node IDs never change, so
+  // publishes read these outside mutex_ (and the Will topic outlives async connect)
+  NodeTopics node_topics_;
+
   // Store last NBIRTH for rebirth command
   std::vector<uint8_t> last_birth_payload_;
 
+  // Template definitions added to every NBIRTH
+  std::vector<TemplateDefinition> templates_;
+
   // Hash and equality functors that support heterogeneous lookup (string_view)
   struct StringHash {
     using is_transparent = void;
@@ -469,16 +737,107 @@ private:
   bool is_connected_{false};
   bool primary_host_online_{
       false}; // True if primary host is online (or no primary host configured)
+  bool birth_sent_{false}; // NBIRTH published since the MQTT session started
+
+  // Automatic reconnect (Config::auto_reconnect): connection_lost_ is set when the
+  // connection drops and cleared once the reconnect thread (or the application's
+  // connect()/disconnect()) takes over; reconnecting_ stays set until births are re-sent
+  bool connection_lost_{false};
+  bool reconnecting_{false};
+  std::chrono::steady_clock::time_point lost_at_;
+  std::chrono::steady_clock::time_point connected_at_; // CONNACK of the current session
+  std::optional<ReconnectReport> last_reconnect_;
+  // Set when a reconnect completes, until the first NDATA/DDATA is timed
+  std::atomic<bool> awaiting_first_data_{false};
+  // Wakes the reconnect thread on connection loss and when the primary host comes online
+  std::condition_variable_any reconnect_wake_;
+
+  // Opened by connect() when Config::store_forward is set; has its own synchronization
+  std::unique_ptr<StoreForwardBuffer> store_forward_;
+  // Wakes the replay thread when the node comes online or a device is born
+  std::condition_variable_any replay_wake_;
 
   // Mutex for thread-safe access to all mutable state
   mutable std::mutex mutex_;
 
-  [[nodiscard]] static stdx::expected<void, std::string>
-  publish_message(MQTTAsync client,
-                  const std::string& topic_str,
-                  std::span<const uint8_t> payload_data,
-                  int qos,
-                  bool retain);
+  // Replays store_forward_; started by connect(), stopped before anything it uses
+  std::jthread replay_thread_;
+  // Re-establishes lost sessions; started by connect(), stopped like replay_thread_
+  std::jthread reconnect_thread_;
+
+  // Publishes an oversized NDATA or DDATA to route as split() chunks
+  [[nodiscard]] stdx::expected<void, std::string>
+  publish_chunks(PayloadBuilder& payload,
+                 std::span<const PayloadBuilder::Chunk> chunks,
+                 const PublishSequencer::Route& route);
+
+  // Bodies of publish_data() and publish_device_data(); sends are reported to token
+  // (the publish_*_async() variants) if it is not null. While offline they are stored
+  // in store_forward_ if set, unless may_store is false (replay)
+  [[nodiscard]] stdx::expected<void, std::string>
+  send_data(PayloadBuilder& payload, const PublishToken* token, bool may_store = true);
+  [[nodiscard]] stdx::expected<void, std::string> send_data(FrozenPayload& payload,
+                                                            const PublishToken* token);
+  [[nodiscard]] stdx::expected<void, std::string>
+  send_device_data(std::string_view device_id,
+                   PayloadBuilder& payload,
+                   const PublishToken* token,
+                   bool may_store = true);
+  [[nodiscard]] stdx::expected<void, std::string>
+  send_device_data(std::string_view device_id,
+                   FrozenPayload& payload,
+                   const PublishToken* token);
+
+  [[nodiscard]] NodeTopics render_node_topics() const;
+  [[nodiscard]] DeviceTopics render_device_topics(std::string_view device_id) const;
+
+  // Config::max_payload_bytes less the rest of a PUBLISH packet to topic at qos: the
+  // largest payload it can carry (std::nullopt: unlimited)
+  [[nodiscard]] std::optional<size_t> payload_budget(std::string_view topic,
+                                                     int qos) const;
+
+  // Fails if a message that cannot be split does not fit payload_budget()
+  [[nodiscard]] stdx::expected<void, std::string> check_payload_size(
+      std::string_view message_type, std::string_view topic, int qos, size_t size) const;
+
+  // Whether a DATA message for device_id (empty: the node) goes to store_forward_
+  // rather than the broker: the node is offline and the device has been born; needs
+  // mutex_, held across the connection check so the two cannot disagree
+  [[nodiscard]] bool should_store(std::string_view device_id) const;
+  [[nodiscard]] stdx::expected<void, std::string>
+  store_data(std::string_view device_id, std::span<const uint8_t> payload_data);
+
+  // Online: connected, primary host online and NBIRTH sent; needs mutex_
+  [[nodiscard]] bool is_online() const noexcept;
+
+  // Failed: the send failed while online (kept at the front and retried)
+  enum class ReplayResult { Sent, Offline, DeviceNotBorn, Failed, Dropped };
+
+  // Start (if configured) and stop replay_thread_ and reconnect_thread_
+  void start_threads();
+  void stop_threads();
+  void replay_stored(std::stop_token stop);
+  ReplayResult replay(std::string_view device_id, std::span<const uint8_t> payload_data);
+
+  // New client, Will with the next bdSeq, CONNACK, then every subscription in one
+  // SUBSCRIBE. Waits for the broker without mutex_ and installs the client under it
+  // once the session is up; from the reconnect thread (reconnect), only if
+  // connect() or disconnect() has not taken over meanwhile
+  [[nodiscard]] stdx::expected<void, std::string> open_session(bool reconnect);
+
+  // Body of reconnect_thread_: waits for a lost connection, retries open_session() with
+  // backoff, then re-sends the births
+  void reconnect_loop(std::stop_token stop);
+  // Re-sends the last NBIRTH (new bdSeq) and the last DBIRTH of each online device
+  [[nodiscard]] stdx::expected<void, std::string> replay_births(std::stop_token stop);
+  // Called after each NDATA/DDATA sent; times the first one after a reconnect
+  void note_data_sent();
+
+  // Sends one payload through sequencer_, which appends its seq (restart_seq: 0)
+  [[nodiscard]] stdx::expected<void, std::string>
+  send_in_sequence(const PublishSequencer::Route& route,
+                   PublishSequencer::Part part,
+                   bool restart_seq = false);
 
   // Static MQTT callback for message arrived (NCMD)
   static int on_message_arrived(void* context,
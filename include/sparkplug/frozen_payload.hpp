@@ -0,0 +1,174 @@
+// include/sparkplug/frozen_payload.hpp
+#pragma once
+
+#include "datatype.hpp"
+#include "detail/compat.hpp"
+#include "payload_builder.hpp"
+#include "wire.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sparkplug {
+
+/**
+ * @brief Pre-encoded NDATA payload whose metric values are patched in place.
+ *
+ * After NBIRTH, NDATA messages usually keep the same shape on every cycle: the same
+ * aliases, datatypes and order, with only values and timestamps changing. A
+ * FrozenPayload captures that shape once from a PayloadBuilder and keeps the encoded
+ * bytes together with the byte offset and width of every value, metric timestamp,
+ * payload timestamp and seq field.
+ *
+ * Updating a field whose encoded width does not change (float, double, bool, a varint
+ * that stays within the same number of bytes, a string of the same length) overwrites
+ * the bytes in place. Any other update marks the payload for a single re-encode, which
+ * happens lazily on the next bytes() call. The encoded bytes are always identical to
+ * what PayloadBuilder::build() would produce for the same content.
+ *
+ * @par Example Usage
+ * @code
+ * sparkplug::PayloadBuilder shape;
+ * shape.add_metric_by_alias(1, 0.0);             // Temperature
+ * shape.add_metric_by_alias(2, int32_t{0});      // Counter
+ * auto frozen = sparkplug::FrozenPayload::freeze(shape);
+ *
+ * while (running) {
+ *   frozen->set_timestamp(now_ms);
+ *   frozen->set(0, read_temperature(), now_ms);
+ *   frozen->set(1, read_counter(), now_ms);
+ *   edge_node.publish_data(*frozen);
+ * }
+ * @endcode
+ *
+ * @note Not thread-safe. Use one FrozenPayload per publishing thread.
+ *
+ * @see EdgeNode::publish_data(FrozenPayload&)
+ */
+class FrozenPayload {
+public:
+  /**
+   * @brief Captures the current content of a builder as a frozen payload.
+   *
+   * The builder's metrics, in order, become the indexed slots of the frozen payload.
+   * A seq field is always reserved (0 if the builder has none) so it can be patched on
+   * publish. A builder without a payload timestamp is stamped from its Options::clock.
+   *
+   * @param builder Builder holding the NDATA shape and initial values
+   *
+   * @return Frozen payload on success, error message if the builder holds content that
+   *         cannot be frozen (metadata, properties, DataSet, Template, uuid, body, ...)
+   */
+  [[nodiscard]] static stdx::expected<FrozenPayload, std::string>
+  freeze(const PayloadBuilder& builder);
+
+  /**
+   * @brief Sets the value of the metric at the given index.
+   *
+   * @tparam T Value type; must map to the metric's frozen datatype
+   * @param index Metric index (order of the source builder)
+   * @param value New value
+   *
+   * @return void on success, error message on bad index, datatype mismatch or a metric
+   *         frozen without a value
+   */
+  template <SparkplugMetricType T>
+  stdx::expected<void, std::string> set(size_t index, const T& value) {
+    return set_value(index, detail::get_datatype<T>(), detail::to_wire_value(value),
+                     std::nullopt);
+  }
+
+  /**
+   * @brief Sets the value and timestamp of the metric at the given index.
+   *
+   * @tparam T Value type; must map to the metric's frozen datatype
+   * @param index Metric index (order of the source builder)
+   * @param value New value
+   * @param timestamp_ms Metric timestamp in milliseconds since Unix epoch
+   *
+   * @return void on success, error message on bad index, datatype mismatch or a metric
+   *         frozen without a value or timestamp
+   */
+  template <SparkplugMetricType T>
+  stdx::expected<void, std::string>
+  set(size_t index, const T& value, uint64_t timestamp_ms) {
+    return set_value(index, detail::get_datatype<T>(), detail::to_wire_value(value),
+                     timestamp_ms);
+  }
+
+  /**
+   * @brief Sets the payload-level timestamp.
+   */
+  FrozenPayload& set_timestamp(uint64_t timestamp_ms) noexcept;
+
+  /**
+   * @brief Sets the payload sequence number.
+   */
+  FrozenPayload& set_seq(uint64_t seq) noexcept;
+
+  /**
+   * @brief Returns the encoded payload, re-encoding first if a width changed.
+   *
+   * @return View of the encoded bytes, valid until the next non-const call
+   */
+  [[nodiscard]] std::span<const uint8_t> bytes();
+
+  /**
+   * @brief Returns the number of metric slots.
+   */
+  [[nodiscard]] size_t metric_count() const noexcept {
+    return slots_.size();
+  }
+
+  /**
+   * @brief Returns how many times the payload had to be fully re-encoded.
+   *
+   * Useful to verify that a fixed-schema cycle stays on the in-place patching path.
+   */
+  [[nodiscard]] size_t reencode_count() const noexcept {
+    return reencode_count_;
+  }
+
+private:
+  // Location of an encoded field inside bytes_
+  struct Field {
+    size_t offset{0};
+    size_t width{0};
+  };
+
+  struct Slot {
+    wire::Metric metric;   // name and string value are views refreshed from storage
+    std::string name;      // Owned metric name
+    std::string text;      // Owned string/bytes value
+    Field value;           // Encoded value bytes (without tag)
+    Field timestamp;       // Encoded metric timestamp (without tag)
+  };
+
+  FrozenPayload() = default;
+
+  stdx::expected<void, std::string> set_value(size_t index,
+                                              DataType datatype,
+                                              const wire::MetricValue& value,
+                                              std::optional<uint64_t> timestamp_ms);
+  bool patch_varint(const Field& field, uint64_t value) noexcept;
+  void encode();
+
+  std::vector<Slot> slots_;
+  std::optional<uint64_t> timestamp_;
+  uint64_t seq_{0};
+  Field timestamp_field_;
+  Field seq_field_;
+  std::vector<uint8_t> bytes_;
+  wire::Encoder encoder_;
+  bool dirty_{false};
+  size_t reencode_count_{0};
+};
+
+} // namespace sparkplug
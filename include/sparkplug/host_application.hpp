@@ -1,10 +1,17 @@
 #pragma once
 
+#include "alias_table.hpp"
 #include "detail/compat.hpp"
+#include "ingest_queue.hpp"
+#include "last_value_cache.hpp"
 #include "logging.hpp"
 #include "mqtt_handle.hpp"
+#include "name_interner.hpp"
 #include "payload_builder.hpp"
+#include "payload_view.hpp"
+#include "publish_tracker.hpp"
 #include "sparkplug_b.pb.h"
+#include "striped_map.hpp"
 #include "topic.hpp"
 
 #include <functional>
@@ -14,6 +21,7 @@
 #include <span>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <MQTTAsync.h>
 
@@ -29,6 +37,24 @@ namespace sparkplug {
 using MessageCallback =
     std::function<void(const Topic&, const org::eclipse::tahu::protobuf::Payload&)>;
 
+/**
+ * @brief Callback function type for receiving Sparkplug B messages without decoding.
+ *
+ * @param topic Parsed Sparkplug B topic
+ * @param payload Zero-copy view of the payload; it references the MQTT message buffer
+ *                and is only valid for the duration of the call
+ */
+using PayloadViewCallback = std::function<void(const Topic&, const PayloadView&)>;
+
+/**
+ * @brief Predicate selecting which messages are decoded and passed to the callbacks.
+ *
+ * @param topic Parsed Sparkplug B topic
+ *
+ * @return true to decode the payload and invoke the message callbacks
+ */
+using InterestFilter = std::function<bool(const Topic&)>;
+
 /**
  * @brief Sparkplug B Host Application for SCADA/Primary Applications.
  *
@@ -45,8 +71,11 @@ Applications:
 commands.
  *
  * @par Thread Safety
- * This class is fully thread-safe with coarse-grained locking:
- * - All public methods use a single internal mutex to protect shared state
+ * This class is fully thread-safe:
+ * - Connection state and config are guarded by one internal mutex
+ * - Node state is split over independently locked stripes keyed by (group_id,
+ *   edge_node_id), so message validation does not contend with publishes or with
+ *   validation of other nodes
  * - Methods can be safely called from any thread concurrently
  * - Callbacks (message_callback, log_callback) invoked on MQTT thread WITHOUT holding
 mutex
@@ -116,8 +145,7 @@ public:
     bool birth_received{false};    ///< True if DBIRTH has been received
     uint64_t offline_timestamp{0}; ///< Timestamp when device went offline (from DDEATH)
     bool metrics_stale{false};     ///< True if metrics marked stale after DDEATH
-    std::unordered_map<uint64_t, std::string>
-        alias_map; ///< Maps metric alias to name (from DBIRTH)
+    AliasTable alias_map; ///< Maps metric alias to name (from DBIRTH)
   };
 
   /**
@@ -145,8 +173,57 @@ public:
     bool birth_received{false};  ///< True if NBIRTH has been received
     std::unordered_map<std::string, DeviceState, TransparentStringHash, std::equal_to<>>
         devices; ///< Attached devices (device_id -> state)
-    std::unordered_map<uint64_t, std::string>
-        alias_map; ///< Maps metric alias to name (from NBIRTH)
+    AliasTable alias_map; ///< Maps metric alias to name (from NBIRTH)
+  };
+
+  /**
+   * @brief Immutable copy of a device's state, published in a NodeSnapshot.
+   */
+  struct DeviceSnapshot {
+    std::string device_id;         ///< Device identifier
+    bool is_online{false};         ///< True if DBIRTH received and device is online
+    bool birth_received{false};    ///< True if DBIRTH has been received
+    bool metrics_stale{false};     ///< True if metrics marked stale after DDEATH
+    uint64_t offline_timestamp{0}; ///< Timestamp when device went offline (from DDEATH)
+  };
+
+  /**
+   * @brief Immutable, reference-counted copy of an edge node's state.
+   *
+   * A new snapshot is published after every message applied to the node and never
+   * changes afterwards, so it can be read on any thread for as long as it is held.
+   * Alias maps are not included; use get_metric_name() to resolve aliases.
+   */
+  struct NodeSnapshot {
+    bool is_online{false};       ///< True if NBIRTH received and node is online
+    uint64_t last_seq{255};      ///< Last received node sequence number
+    uint64_t bd_seq{0};          ///< Current birth/death sequence number
+    uint64_t birth_timestamp{0}; ///< Timestamp of last NBIRTH
+    bool birth_received{false};  ///< True if NBIRTH has been received
+    uint64_t version{0};         ///< Incremented for every message applied to the node
+    std::shared_ptr<const std::vector<DeviceSnapshot>>
+        devices; ///< Attached devices; shared with earlier snapshots until one changes
+
+    /// Returns the device's state, or nullptr if it has not been seen
+    [[nodiscard]] const DeviceSnapshot* find_device(std::string_view device_id) const {
+      if (devices) {
+        for (const auto& device : *devices) {
+          if (device.device_id == device_id) {
+            return &device;
+          }
+        }
+      }
+      return nullptr;
+    }
+  };
+
+  /**
+   * @brief A node's identity together with its current snapshot.
+   */
+  struct NodeSnapshotEntry {
+    std::string group_id;                         ///< Group ID
+    std::string edge_node_id;                     ///< Edge node ID
+    std::shared_ptr<const NodeSnapshot> snapshot; ///< State when listed
   };
 
   /**
@@ -172,6 +249,17 @@ public:
     std::optional<std::string>
         password{};                     ///< MQTT password for authentication (optional)
     MessageCallback message_callback{}; ///< Callback for received Sparkplug messages
+    PayloadViewCallback
+        payload_view_callback{}; ///< Zero-copy callback for received Sparkplug messages
+    InterestFilter interest_filter{}; ///< Messages to decode for the callbacks (empty:
+                                      ///< all); others are only sequence-validated
+    bool last_value_cache = false; ///< Maintain last_values() from every message
+    size_t ingest_workers = 0; ///< Threads that decode, validate and dispatch messages
+                               ///< (0: all on the MQTT callback thread)
+    size_t ingest_queue_capacity =
+        4096; ///< Queued messages per ingest worker before new ones are dropped
+    size_t max_pending_publishes{1024}; ///< Asynchronous publishes awaiting completion;
+                                        ///< further publish_*_async() calls wait for one
     LogCallback log_callback{};         ///< Optional callback for library log messages
   };
 
@@ -225,6 +313,34 @@ public:
    */
   void set_message_callback(MessageCallback callback);
 
+  /**
+   * @brief Sets the zero-copy callback for receiving Sparkplug messages.
+   *
+   * The callback receives a PayloadView over the MQTT message buffer instead of a
+   * decoded protobuf Payload. When only this callback is set, received payloads are
+   * never materialized as protobuf messages. If both callbacks are set, both are
+   * invoked (view first).
+   *
+   * @param callback Callback function to invoke for received messages
+   *
+   * @note Must be called before connect().
+   */
+  void set_payload_view_callback(PayloadViewCallback callback);
+
+  /**
+   * @brief Limits which messages are decoded and delivered to the message callbacks.
+   *
+   * Sequence and liveness tracking still sees every message, but runs on the payload
+   * header (seq, timestamp and, for NBIRTH/NDEATH, bdSeq) extracted straight from the
+   * wire bytes. Payloads the filter rejects are never decoded further, except births,
+   * whose alias maps are always recorded.
+   *
+   * @param filter Predicate on the message topic (empty to deliver everything)
+   *
+   * @note Must be called before connect().
+   */
+  void set_interest_filter(InterestFilter filter);
+
   /**
    * @brief Sets the log callback for receiving library diagnostic messages.
    *
@@ -254,6 +370,7 @@ public:
    *
    * @note You should call publish_state_death() before disconnect() to properly
    *       signal that the Host Application is going offline.
+   * @note With ingest workers, messages still queued are processed before this returns.
    */
   [[nodiscard]] stdx::expected<void, std::string> disconnect();
 
@@ -326,10 +443,48 @@ public:
    * @return NodeState if the node has been seen, std::nullopt otherwise
    *
    * @note Useful for monitoring node online/offline status and bdSeq.
+   * @warning The referenced state keeps being updated as messages arrive, so reading it
+   *          while the node is active is a data race. Use get_node_snapshot() instead
+   *          from threads other than the message callbacks.
    */
   [[nodiscard]] std::optional<std::reference_wrapper<const NodeState>>
   get_node_state(std::string_view group_id, std::string_view edge_node_id) const;
 
+  /**
+   * @brief Gets an immutable snapshot of an edge node's state.
+   *
+   * Snapshots are published by message validation, so nodes only appear once
+   * Config::validate_sequence is enabled and they have sent a message. Reading one
+   * never waits for message processing: it copies a reference-counted pointer, and
+   * the snapshot stays consistent and valid for as long as the caller holds it.
+   *
+   * @param group_id The group ID
+   * @param edge_node_id The edge node ID to query
+   *
+   * @return The latest snapshot, or nullptr if the node has not been seen
+   *
+   * @par Example Usage
+   * @code
+   * if (auto node = host_app.get_node_snapshot("Energy", "Gateway01")) {
+   *   std::cout << (node->is_online ? "online" : "offline") << " seq=" << node->last_seq;
+   *   if (const auto* motor = node->find_device("Motor01")) {
+   *     std::cout << (motor->metrics_stale ? " (motor stale)" : "");
+   *   }
+   * }
+   * @endcode
+   */
+  [[nodiscard]] std::shared_ptr<const NodeSnapshot>
+  get_node_snapshot(std::string_view group_id, std::string_view edge_node_id) const;
+
+  /**
+   * @brief Lists the latest snapshot of every edge node seen.
+   *
+   * @return One entry per node, in no particular order
+   *
+   * @see get_node_snapshot()
+   */
+  [[nodiscard]] std::vector<NodeSnapshotEntry> get_node_snapshots() const;
+
   /**
    * @brief Resolves a metric alias to its name for a specific node or device.
    *
@@ -345,6 +500,8 @@ public:
    *
    * @note Returns std::nullopt if the node/device hasn't sent a birth message yet,
    *       or if the alias is not found in the birth message.
+   * @note Names are interned for the lifetime of the HostApplication, so the returned
+   *       view stays valid across rebirths.
    */
   [[nodiscard]] std::optional<std::string_view>
   get_metric_name(std::string_view group_id,
@@ -352,6 +509,38 @@ public:
                   std::string_view device_id,
                   uint64_t alias) const;
 
+  /**
+   * @brief Returns the cache of current metric values.
+   *
+   * Populated from births and DATA messages of every subscribed node when
+   * Config::last_value_cache is enabled (empty otherwise). Queries never block message
+   * ingest and may be made from any thread.
+   *
+   * @par Example Usage
+   * @code
+   * std::vector<sparkplug::LastValueCache::MetricSnapshot> metrics;
+   * host_app.last_values().snapshot("Energy", "Gateway01", "", metrics);
+   * @endcode
+   *
+   * @note A moved-from HostApplication returns an empty cache.
+   */
+  [[nodiscard]] const LastValueCache& last_values() const noexcept;
+
+  /**
+   * @brief Returns the ingest worker queue counters.
+   *
+   * With Config::ingest_workers > 0, the MQTT callback thread only queues each message
+   * on a worker chosen by (group_id, edge_node_id), so every node's messages are still
+   * processed in order while different nodes are processed in parallel. Messages
+   * arriving at a full queue are dropped and counted; sequence validation then sees
+   * the gap and requests a rebirth as usual.
+   *
+   * @return Counters, all zero when messages are processed on the MQTT thread
+   *
+   * @note Callbacks for different edge nodes may run concurrently on different workers.
+   */
+  [[nodiscard]] IngestStats ingest_stats() const;
+
   /**
    * @brief Publishes a STATE birth message to indicate Host Application is online.
    *
@@ -466,6 +655,50 @@ public:
                          std::string_view target_device_id,
                          PayloadBuilder& payload);
 
+  /**
+   * @brief Publishes an NCMD message and reports when the MQTT client has sent it.
+   *
+   * Same as publish_node_command(), but the returned token (and on_complete, if set)
+   * report the outcome once the MQTT client has written the message. At most
+   * Config::max_pending_publishes can be pending; further calls wait up to 5 s for
+   * one to complete, then fail.
+   *
+   * @param group_id The Sparkplug group ID containing the target Edge Node
+   * @param target_edge_node_id The target Edge Node identifier
+   * @param payload PayloadBuilder containing command metrics
+   * @param on_complete Called once with the outcome, on the MQTT client thread
+   *
+   * @return Token for the outcome, or the error if the message was not sent (then
+   *         on_complete is never called)
+   *
+   * @par Example Usage
+   * @code
+   * std::vector<sparkplug::PublishToken> tokens;
+   * for (const auto& node : nodes) {
+   *   if (auto token = host_app.publish_node_command_async("Energy", node, cmd)) {
+   *     tokens.push_back(std::move(*token));
+   *   }
+   * }
+   * @endcode
+   */
+  [[nodiscard]] stdx::expected<PublishToken, std::string>
+  publish_node_command_async(std::string_view group_id,
+                             std::string_view target_edge_node_id,
+                             PayloadBuilder& payload,
+                             PublishCallback on_complete = {});
+
+  /**
+   * @brief Publishes a DCMD message, reporting completion.
+   *
+   * @see publish_node_command_async()
+   */
+  [[nodiscard]] stdx::expected<PublishToken, std::string>
+  publish_device_command_async(std::string_view group_id,
+                               std::string_view target_edge_node_id,
+                               std::string_view target_device_id,
+                               PayloadBuilder& payload,
+                               PublishCallback on_complete = {});
+
   /**
    * @brief Internal logging method accessible from C bindings.
    *
@@ -476,56 +709,69 @@ public:
 
 private:
   Config config_;
+  // Completion slots for every publish; shared with the PublishTokens handed out
+  std::shared_ptr<PublishTracker> publishes_;
   MQTTAsyncHandle client_;
   bool is_connected_{false};
 
   // MQTT connection options that must outlive async operations
   MQTTAsync_SSLOptions ssl_opts_{};
 
-  // Node state tracking
+  // Node state tracking, keyed by group and edge node IDs from node_names_
   struct NodeKey {
-    std::string group_id;
-    std::string edge_node_id;
+    NameInterner::Id group_id;
+    NameInterner::Id edge_node_id;
 
-    [[nodiscard]] bool operator==(const NodeKey& other) const noexcept {
-      return group_id == other.group_id && edge_node_id == other.edge_node_id;
-    }
+    [[nodiscard]] bool operator==(const NodeKey& other) const noexcept = default;
   };
 
   struct NodeKeyHash {
-    using is_transparent = void;
     [[nodiscard]] size_t operator()(const NodeKey& key) const noexcept {
-      size_t h1 = std::hash<std::string>{}(key.group_id);
-      size_t h2 = std::hash<std::string>{}(key.edge_node_id);
-      return h1 ^ (h2 << 1);
-    }
-    [[nodiscard]] size_t
-    operator()(std::pair<std::string_view, std::string_view> key) const noexcept {
-      size_t h1 = std::hash<std::string_view>{}(key.first);
-      size_t h2 = std::hash<std::string_view>{}(key.second);
-      return h1 ^ (h2 << 1);
+      return static_cast<size_t>((static_cast<uint64_t>(key.group_id) << 32) |
+                                 key.edge_node_id);
     }
   };
 
-  struct NodeKeyEqual {
-    using is_transparent = void;
-    [[nodiscard]] bool operator()(const NodeKey& lhs, const NodeKey& rhs) const noexcept {
-      return lhs == rhs;
-    }
-    [[nodiscard]] bool
-    operator()(const NodeKey& lhs,
-               std::pair<std::string_view, std::string_view> rhs) const noexcept {
-      return lhs.group_id == rhs.first && lhs.edge_node_id == rhs.second;
-    }
-    [[nodiscard]] bool operator()(std::pair<std::string_view, std::string_view> lhs,
-                                  const NodeKey& rhs) const noexcept {
-      return lhs.first == rhs.group_id && lhs.second == rhs.edge_node_id;
-    }
+  // Interned on first sight of each group and edge node ID on the receive path
+  NameInterner node_names_;
+
+  using SnapshotCell = stdx::atomic_shared_ptr<const NodeSnapshot>;
+
+  struct NodeEntry {
+    NodeState state;
+    std::shared_ptr<SnapshotCell> snapshot; // Created with the entry, then republished
   };
 
-  std::unordered_map<NodeKey, NodeState, NodeKeyHash, NodeKeyEqual> node_states_;
+  // Data plane: each stripe has its own lock, so messages of different nodes are
+  // validated in parallel and never wait for publishes or config changes
+  StripedMap<NodeKey, NodeEntry, NodeKeyHash> node_states_;
 
-  // Mutex for thread-safe access to all mutable state
+  // Read side of the node snapshots. Ingest only locks these stripes to add a node;
+  // snapshot readers only ever lock these, never node_states_'s
+  StripedMap<NodeKey, std::shared_ptr<const SnapshotCell>, NodeKeyHash> node_snapshots_;
+
+  // Interned metric names shared by every node's and device's alias table; births
+  // intern under metric_names_mutex_ while holding their node's stripe lock
+  StringPool metric_names_;
+  std::mutex metric_names_mutex_;
+
+  // Has its own synchronization; fed from the MQTT thread outside mutex_
+  std::unique_ptr<LastValueCache> last_values_;
+
+  // A received MQTT message, owned by the queue until a worker processes it
+  struct IngestMessage {
+    char* topic_name{nullptr};
+    int topic_len{0};
+    MQTTAsync_message* message{nullptr};
+  };
+
+  // Started by connect() when Config::ingest_workers > 0. Guarded by ingest_mutex_,
+  // which the MQTT thread holds while it submits, so stop_ingest() cannot destroy the
+  // queue under a late message (Paho rejects clearing the message callback)
+  std::unique_ptr<IngestQueue<IngestMessage>> ingest_;
+  mutable std::mutex ingest_mutex_;
+
+  // Control plane: guards the connection state and config, not node_states_
   mutable std::mutex mutex_;
 
   [[nodiscard]] stdx::expected<void, std::string>
@@ -534,11 +780,47 @@ private:
                       int qos,
                       bool retain);
 
+  // Sends one message; the send is reported to token if it is not null
+  [[nodiscard]] stdx::expected<void, std::string>
+  send_message(std::string_view topic,
+               std::span<const uint8_t> payload_data,
+               int qos,
+               bool retain,
+               const PublishToken* token);
+
+  // Bodies of publish_node_command() and publish_device_command()
   [[nodiscard]] stdx::expected<void, std::string>
-  publish_command_message(std::string_view topic, std::span<const uint8_t> payload_data);
+  send_command(std::string_view group_id,
+               std::string_view target_edge_node_id,
+               std::string_view target_device_id,
+               PayloadBuilder& payload,
+               const PublishToken* token);
+
+  [[nodiscard]] stdx::expected<void, std::string> disconnect_client();
+
+  // Drains queued messages and stops the workers; must be called without mutex_
+  void stop_ingest();
+
+  // Decodes, validates and dispatches one message, then frees it
+  void process_message(char* topic_name, int topic_len, MQTTAsync_message* message);
+
+  // Resolves a node's key from its names without interning them
+  [[nodiscard]] std::optional<NodeKey> find_node_key(std::string_view group_id,
+                                                     std::string_view edge_node_id) const;
+
+  // payload is required for NBIRTH/DBIRTH (alias maps) and may be null otherwise
+  bool validate_message(const TopicView& topic,
+                        const PayloadHeader& header,
+                        const PayloadView* payload);
+
+  // Publishes the entry's current state; runs with the node's stripe locked
+  void publish_snapshot(const NodeKey& key, NodeEntry& entry, MessageType type);
 
-  bool validate_message(const Topic& topic,
-                        const org::eclipse::tahu::protobuf::Payload& payload);
+  // Applies one message to its node's state; runs with the node's stripe locked
+  bool validate_node_message(NodeState& state,
+                             const TopicView& topic,
+                             const PayloadHeader& header,
+                             const PayloadView* payload);
 
   // Static MQTT callback for message arrived
   static int on_message_arrived(void* context,
@@ -0,0 +1,272 @@
+// include/sparkplug/ingest_queue.hpp
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace sparkplug {
+
+/**
+ * @brief Bounded lock-free multi-producer, single-consumer ring buffer.
+ *
+ * Each slot carries a sequence number telling producers and the consumer whose turn it
+ * is, so a push is one compare-and-swap on the head and a pop touches no shared
+ * counter. The capacity is fixed at construction (rounded up to a power of two);
+ * nothing is allocated afterwards.
+ *
+ * @tparam T Element type (default-constructible and move-assignable)
+ *
+ * @note try_pop() must only be called from one thread at a time.
+ */
+template <typename T>
+class MpscRing {
+public:
+  explicit MpscRing(size_t capacity)
+      : mask_(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1),
+        slots_(std::make_unique<Slot[]>(mask_ + 1)) {
+    for (size_t i = 0; i <= mask_; i++) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpscRing(const MpscRing&) = delete;
+  MpscRing& operator=(const MpscRing&) = delete;
+
+  /**
+   * @brief Appends an element unless the ring is full.
+   *
+   * @return true if the element was moved in, false if the ring is full (the element
+   *         is left untouched)
+   */
+  bool try_push(T&& value) {
+    size_t pos = head_.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+      slot = &slots_[pos & mask_];
+      const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      const auto diff =
+          static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false; // The consumer has not freed this slot yet
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+    slot->value = std::move(value);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Removes the oldest element, if any (consumer only).
+   */
+  std::optional<T> try_pop() {
+    const size_t pos = tail_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[pos & mask_];
+    if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+      return std::nullopt;
+    }
+    std::optional<T> value(std::move(slot.value));
+    slot.sequence.store(pos + mask_ + 1, std::memory_order_release);
+    tail_.store(pos + 1, std::memory_order_relaxed);
+    return value;
+  }
+
+  /// Approximate number of queued elements
+  [[nodiscard]] size_t size() const noexcept {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    return head > tail ? head - tail : 0;
+  }
+
+  [[nodiscard]] size_t capacity() const noexcept {
+    return mask_ + 1;
+  }
+
+private:
+  struct Slot {
+    std::atomic<size_t> sequence{0};
+    T value{};
+  };
+
+  const size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+  alignas(64) std::atomic<size_t> head_{0}; // Next position to claim (producers)
+  alignas(64) std::atomic<size_t> tail_{0}; // Next position to read (consumer)
+};
+
+/**
+ * @brief Counters of an IngestQueue.
+ */
+struct IngestStats {
+  size_t workers{0};             ///< Number of worker threads (0: inline processing)
+  size_t queue_depth{0};         ///< Messages currently queued across all workers
+  size_t max_worker_depth{0};    ///< Deepest single worker queue
+  size_t capacity_per_worker{0}; ///< Capacity of each worker queue
+  uint64_t processed{0};         ///< Messages handled by the workers
+  uint64_t dropped{0};           ///< Messages discarded because their queue was full
+  std::vector<size_t> worker_depths{}; ///< Current depth of each worker queue
+};
+
+/**
+ * @brief Fixed pool of worker threads, each draining its own bounded MpscRing.
+ *
+ * Producers submit items with a shard key; items with the same key always go to the
+ * same worker and are handled in submission order. When the target queue is full the
+ * item is rejected and counted as dropped, so producers never block.
+ *
+ * @tparam T Queued element type (default-constructible and move-assignable)
+ *
+ * @par Example Usage
+ * @code
+ * sparkplug::IngestQueue<Message> queue(4, 4096, [](Message& msg) { handle(msg); });
+ * if (!queue.submit(std::hash<std::string>{}(msg.node), std::move(msg))) {
+ *   release(msg);  // Dropped: msg is still owned by the caller
+ * }
+ * @endcode
+ */
+template <typename T>
+class IngestQueue {
+public:
+  using Handler = std::function<void(T&)>;
+
+  /**
+   * @brief Starts the workers.
+   *
+   * @param workers Number of worker threads (at least 1)
+   * @param capacity_per_worker Queue capacity of each worker (rounded up to a power of 2)
+   * @param handler Called on a worker thread for every item; exceptions are ignored
+   */
+  IngestQueue(size_t workers, size_t capacity_per_worker, Handler handler)
+      : handler_(std::move(handler)) {
+    workers = std::max<size_t>(workers, 1);
+    shards_.reserve(workers);
+    for (size_t i = 0; i < workers; i++) {
+      shards_.push_back(std::make_unique<Shard>(capacity_per_worker));
+    }
+    for (auto& shard : shards_) {
+      shard->thread = std::thread([this, raw = shard.get()] { run(*raw); });
+    }
+  }
+
+  /**
+   * @brief Handles all queued items, then stops the workers.
+   */
+  ~IngestQueue() {
+    stopping_.store(true, std::memory_order_release);
+    for (auto& shard : shards_) {
+      wake(*shard);
+    }
+    for (auto& shard : shards_) {
+      if (shard->thread.joinable()) {
+        shard->thread.join();
+      }
+    }
+  }
+
+  IngestQueue(const IngestQueue&) = delete;
+  IngestQueue& operator=(const IngestQueue&) = delete;
+
+  /**
+   * @brief Queues an item on the worker selected by shard_key.
+   *
+   * @return true if queued, false if that worker's queue is full (the item is left
+   *         with the caller and counted as dropped)
+   */
+  bool submit(uint64_t shard_key, T&& item) {
+    Shard& shard = *shards_[shard_key % shards_.size()];
+    if (!shard.ring.try_push(std::move(item))) {
+      shard.dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    wake(shard);
+    return true;
+  }
+
+  [[nodiscard]] IngestStats stats() const {
+    IngestStats stats{.workers = shards_.size(),
+                      .capacity_per_worker = shards_.front()->ring.capacity()};
+    stats.worker_depths.reserve(shards_.size());
+    for (const auto& shard : shards_) {
+      const size_t depth = shard->ring.size();
+      stats.worker_depths.push_back(depth);
+      stats.queue_depth += depth;
+      stats.max_worker_depth = std::max(stats.max_worker_depth, depth);
+      stats.processed += shard->processed.load(std::memory_order_relaxed);
+      stats.dropped += shard->dropped.load(std::memory_order_relaxed);
+    }
+    return stats;
+  }
+
+private:
+  static constexpr int SPIN_ATTEMPTS = 64;
+
+  struct alignas(64) Shard {
+    explicit Shard(size_t capacity) : ring(capacity) {
+    }
+    MpscRing<T> ring;
+    std::atomic<uint32_t> signal{0}; // Bumped on every push; workers wait on it
+    std::atomic<uint64_t> processed{0};
+    std::atomic<uint64_t> dropped{0};
+    std::thread thread;
+  };
+
+  static void wake(Shard& shard) noexcept {
+    shard.signal.fetch_add(1, std::memory_order_release);
+    shard.signal.notify_one();
+  }
+
+  bool drain(Shard& shard) {
+    bool any = false;
+    while (auto item = shard.ring.try_pop()) {
+      try {
+        handler_(*item);
+      } catch (...) {
+      }
+      shard.processed.fetch_add(1, std::memory_order_relaxed);
+      any = true;
+    }
+    return any;
+  }
+
+  void run(Shard& shard) {
+    int idle = 0;
+    for (;;) {
+      const uint32_t seen = shard.signal.load(std::memory_order_acquire);
+      if (drain(shard)) {
+        idle = 0;
+        continue;
+      }
+      if (stopping_.load(std::memory_order_acquire)) {
+        drain(shard);
+        return;
+      }
+      // Bursts usually arrive back to back; spin briefly before sleeping
+      if (++idle < SPIN_ATTEMPTS) {
+        std::this_thread::yield();
+        continue;
+      }
+      shard.signal.wait(seen, std::memory_order_acquire);
+      idle = 0;
+    }
+  }
+
+  Handler handler_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::atomic<bool> stopping_{false};
+};
+
+} // namespace sparkplug
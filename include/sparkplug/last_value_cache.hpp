@@ -0,0 +1,208 @@
+// include/sparkplug/last_value_cache.hpp
+#pragma once
+
+#include "alias_table.hpp"
+#include "datatype.hpp"
+#include "detail/compat.hpp"
+#include "payload_view.hpp"
+#include "topic.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace sparkplug {
+
+/**
+ * @brief Current value of every metric, per edge node and device.
+ *
+ * The cache is populated from NBIRTH/DBIRTH (which define each source's metrics) and
+ * updated by NDATA/DDATA through aliases or names; NDEATH/DDEATH mark the affected
+ * metrics stale. It is fed by HostApplication when Config::last_value_cache is set,
+ * or directly through apply().
+ *
+ * Each node or device is stored as typed columns (value, timestamp, quality, flags)
+ * sized once per birth, so memory is a fixed cost per metric (about 55 bytes plus
+ * its interned name) regardless of update rate. String values are held as immutable
+ * shared strings.
+ *
+ * Readers never block ingest: each source is guarded by a sequence lock, so a
+ * snapshot copies the columns and retries if an update raced with it. Births and
+ * deaths take a short exclusive lock on the source registry.
+ *
+ * @par Example Usage
+ * @code
+ * sparkplug::HostApplication::Config config{..., .last_value_cache = true};
+ * sparkplug::HostApplication host(std::move(config));
+ * ...
+ * if (auto temp = host.last_values().find("Energy", "Node1", "", "Temperature")) {
+ *   if (!temp->stale && temp->quality == sparkplug::LastValueCache::Quality::Good) {
+ *     show(std::get<double>(temp->value));
+ *   }
+ * }
+ * @endcode
+ *
+ * @note Messages of one edge node and its devices must be applied from one thread at a
+ *       time (different nodes may be applied concurrently); queries are safe from any
+ *       thread.
+ */
+class LastValueCache {
+public:
+  /**
+   * @brief Quality of a cached value.
+   */
+  enum class Quality : uint8_t {
+    Uncertain, ///< Defined by a birth without a value, none received since
+    Good,      ///< Last reported value
+    Bad,       ///< Last report flagged the metric as null (is_null)
+  };
+
+  /**
+   * @brief Cached value, widened per datatype family.
+   *
+   * Signed integers are int64_t, unsigned integers and DateTime are uint64_t, Float and
+   * Double are double, String/Text/UUID are std::string. Other datatypes (Bytes, File,
+   * DataSet, Template, arrays) are tracked for timestamp and quality only.
+   */
+  using Value =
+      std::variant<std::monostate, int64_t, uint64_t, double, bool, std::string>;
+
+  /**
+   * @brief Copy of one metric's cached state.
+   */
+  struct MetricSnapshot {
+    std::string_view name;         ///< Metric name (valid for the cache's lifetime)
+    std::optional<uint64_t> alias; ///< Alias from the birth, if any
+    DataType datatype{DataType::Unknown};
+    Value value{};
+    uint64_t timestamp{0}; ///< Metric timestamp, or the payload's if it had none
+    Quality quality{Quality::Uncertain};
+    bool stale{false}; ///< Set by NDEATH/DDEATH (or NBIRTH for devices) until rebirth
+  };
+
+  LastValueCache();
+  ~LastValueCache();
+
+  LastValueCache(const LastValueCache&) = delete;
+  LastValueCache& operator=(const LastValueCache&) = delete;
+
+  /**
+   * @brief Applies a received message.
+   *
+   * @param topic Parsed topic or TopicView (NBIRTH, DBIRTH, NDATA, DDATA, NDEATH,
+   *              DDEATH; other message types are ignored)
+   * @param payload Decoded payload
+   *
+   * @return void on success, error message for DATA before a birth or for metrics the
+   *         birth did not define (the remaining metrics are still applied)
+   */
+  stdx::expected<void, std::string> apply(const TopicView& topic,
+                                          const PayloadView& payload);
+
+  /**
+   * @brief Copies the current state of all metrics of a node or device.
+   *
+   * @param group_id Group ID
+   * @param edge_node_id Edge node ID
+   * @param device_id Device ID (empty for node-level metrics)
+   * @param out Replaced with one entry per metric, in birth order
+   *
+   * @return false if the source has not sent a birth
+   */
+  bool snapshot(std::string_view group_id,
+                std::string_view edge_node_id,
+                std::string_view device_id,
+                std::vector<MetricSnapshot>& out) const;
+
+  /**
+   * @brief Copies the current state of one metric by name.
+   */
+  [[nodiscard]] std::optional<MetricSnapshot> find(std::string_view group_id,
+                                                   std::string_view edge_node_id,
+                                                   std::string_view device_id,
+                                                   std::string_view metric_name) const;
+
+  /**
+   * @brief Lists the devices of a node that have sent a DBIRTH.
+   */
+  [[nodiscard]] std::vector<std::string> devices(std::string_view group_id,
+                                                 std::string_view edge_node_id) const;
+
+  /// Number of cached metrics across all sources
+  [[nodiscard]] size_t metric_count() const;
+
+  /// Approximate heap memory held by the cache, in bytes
+  [[nodiscard]] size_t memory_bytes() const;
+
+private:
+  struct Source; // Columns of one node or device, defined in last_value_cache.cpp
+
+  struct SourceKey {
+    std::string group_id;
+    std::string edge_node_id;
+    std::string device_id;
+  };
+
+  using SourceRef = std::tuple<std::string_view, std::string_view, std::string_view>;
+
+  struct SourceKeyHash {
+    using is_transparent = void;
+    [[nodiscard]] size_t operator()(const SourceKey& key) const noexcept {
+      return (*this)(SourceRef{key.group_id, key.edge_node_id, key.device_id});
+    }
+    [[nodiscard]] size_t operator()(const SourceRef& key) const noexcept {
+      size_t h1 = std::hash<std::string_view>{}(std::get<0>(key));
+      size_t h2 = std::hash<std::string_view>{}(std::get<1>(key));
+      size_t h3 = std::hash<std::string_view>{}(std::get<2>(key));
+      return h1 ^ (h2 << 1) ^ (h3 << 2);
+    }
+  };
+
+  struct SourceKeyEqual {
+    using is_transparent = void;
+    [[nodiscard]] static SourceRef ref(const SourceKey& key) noexcept {
+      return {key.group_id, key.edge_node_id, key.device_id};
+    }
+    [[nodiscard]] bool operator()(const SourceKey& lhs,
+                                  const SourceKey& rhs) const noexcept {
+      return ref(lhs) == ref(rhs);
+    }
+    [[nodiscard]] bool operator()(const SourceKey& lhs,
+                                  const SourceRef& rhs) const noexcept {
+      return ref(lhs) == rhs;
+    }
+    [[nodiscard]] bool operator()(const SourceRef& lhs,
+                                  const SourceKey& rhs) const noexcept {
+      return lhs == ref(rhs);
+    }
+  };
+
+  using SourceMap = std::unordered_map<SourceKey, std::shared_ptr<Source>, SourceKeyHash,
+                                       SourceKeyEqual>;
+  using NodeSources = std::vector<SourceMap::value_type*>;
+
+  [[nodiscard]] std::shared_ptr<Source> find_source(const SourceRef& key) const;
+  // Sources of an edge node and its devices; needs sources_mutex_
+  [[nodiscard]] const NodeSources* find_node(std::string_view group_id,
+                                             std::string_view edge_node_id) const;
+  void apply_birth(const TopicView& topic, const PayloadView& payload);
+  void mark_stale(const TopicView& topic);
+
+  mutable std::shared_mutex sources_mutex_; // Guards the maps, not the columns
+  SourceMap sources_;
+  // Entries of sources_ by edge node (keyed with an empty device_id), so births and
+  // deaths only visit that node's sources; map elements never move or go away
+  std::unordered_map<SourceKey, NodeSources, SourceKeyHash, SourceKeyEqual> nodes_;
+  StringPool names_; // Metric names; interned under the exclusive lock
+};
+
+} // namespace sparkplug
@@ -0,0 +1,83 @@
+// include/sparkplug/name_interner.hpp
+#pragma once
+
+#include "alias_table.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace sparkplug {
+
+/**
+ * @brief Thread-safe map from names (group, edge node, device IDs) to small integers.
+ *
+ * A name gets an ID the first time it is interned and keeps it for the lifetime of the
+ * interner, so state can be keyed by integers instead of strings. Names are spread over
+ * independently locked stripes by hash, and the stripe is encoded in the low bits of
+ * the ID, so threads looking up different names rarely touch the same lock. Lookups of
+ * known names take their stripe's shared lock and never allocate; only the first
+ * sighting of a name takes the exclusive lock and copies it into the stripe's
+ * StringPool.
+ *
+ * @par Example Usage
+ * @code
+ * sparkplug::NameInterner names;
+ * auto group = names.intern("Energy");
+ * auto node = names.intern("Gateway01");
+ * assert(names.intern("Energy") == group);
+ * assert(names.name(node) == "Gateway01");
+ * @endcode
+ */
+class NameInterner {
+public:
+  using Id = uint32_t;
+
+  NameInterner() = default;
+  NameInterner(const NameInterner&) = delete;
+  NameInterner& operator=(const NameInterner&) = delete;
+
+  /**
+   * @brief Returns the ID of a name, assigning a new one on first sight.
+   */
+  Id intern(std::string_view name);
+
+  /**
+   * @brief Returns the ID of a name without adding it.
+   *
+   * @return The ID, or std::nullopt if the name has never been interned
+   */
+  [[nodiscard]] std::optional<Id> find(std::string_view name) const;
+
+  /**
+   * @brief Returns the name of an ID returned by intern().
+   *
+   * @return View valid for the lifetime of the interner (empty for unknown IDs)
+   */
+  [[nodiscard]] std::string_view name(Id id) const;
+
+  /// Number of distinct names (not atomic across stripes)
+  [[nodiscard]] size_t size() const;
+
+private:
+  static constexpr unsigned STRIPE_BITS = 4;
+  static constexpr size_t STRIPES = size_t{1} << STRIPE_BITS;
+
+  struct alignas(64) Stripe {
+    mutable std::shared_mutex mutex;
+    StringPool pool;
+    std::unordered_map<std::string_view, Id> ids;
+    std::vector<std::string_view> names; // Indexed by ID >> STRIPE_BITS
+  };
+
+  [[nodiscard]] static size_t stripe_index(std::string_view name) noexcept;
+
+  std::array<Stripe, STRIPES> stripes_;
+};
+
+} // namespace sparkplug
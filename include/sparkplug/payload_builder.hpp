@@ -1,15 +1,24 @@
 // include/sparkplug/payload_builder.hpp
 #pragma once
 
+#include "clock.hpp"
 #include "datatype.hpp"
+#include "detail/compat.hpp"
 #include "sparkplug_b.pb.h"
+#include "wire.hpp"
 
-#include <chrono>
+#include <bit>
 #include <concepts>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <memory>
 #include <optional>
+#include <ranges>
+#include <span>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -59,8 +68,170 @@ template <typename T>
 concept SparkplugMetricType =
     SparkplugInteger<T> || SparkplugFloat<T> || SparkplugBoolean<T> || SparkplugString<T>;
 
+/// Element types of the Sparkplug B packed array datatypes (Int8Array..DateTimeArray)
+template <typename T>
+concept SparkplugArrayElement =
+    SparkplugNumeric<T> || SparkplugBoolean<T> ||
+    std::same_as<std::remove_cvref_t<T>, std::string> ||
+    std::same_as<std::remove_cvref_t<T>, std::string_view> ||
+    std::same_as<std::remove_cvref_t<T>, DateTime>;
+
+/// Contiguous ranges of array elements (std::span, std::vector, std::array, C arrays)
+template <typename R>
+concept SparkplugArray =
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+    SparkplugArrayElement<std::ranges::range_value_t<R>>;
+
 namespace detail {
 
+template <SparkplugArrayElement T>
+consteval DataType get_array_datatype() noexcept {
+  using BaseT = std::remove_cvref_t<T>;
+  if constexpr (std::is_same_v<BaseT, int8_t>)
+    return DataType::Int8Array;
+  else if constexpr (std::is_same_v<BaseT, int16_t>)
+    return DataType::Int16Array;
+  else if constexpr (std::is_same_v<BaseT, int32_t>)
+    return DataType::Int32Array;
+  else if constexpr (std::is_same_v<BaseT, int64_t>)
+    return DataType::Int64Array;
+  else if constexpr (std::is_same_v<BaseT, uint8_t>)
+    return DataType::UInt8Array;
+  else if constexpr (std::is_same_v<BaseT, uint16_t>)
+    return DataType::UInt16Array;
+  else if constexpr (std::is_same_v<BaseT, uint32_t>)
+    return DataType::UInt32Array;
+  else if constexpr (std::is_same_v<BaseT, uint64_t>)
+    return DataType::UInt64Array;
+  else if constexpr (std::is_same_v<BaseT, float>)
+    return DataType::FloatArray;
+  else if constexpr (std::is_same_v<BaseT, double>)
+    return DataType::DoubleArray;
+  else if constexpr (std::is_same_v<BaseT, bool>)
+    return DataType::BooleanArray;
+  else if constexpr (std::is_same_v<BaseT, DateTime>)
+    return DataType::DateTimeArray;
+  else
+    return DataType::StringArray;
+}
+
+/// Unsigned integer of the same size as T, used to byte-swap on big-endian hosts
+template <typename T>
+using array_word_t = std::conditional_t<
+    sizeof(T) == 1,
+    uint8_t,
+    std::conditional_t<sizeof(T) == 2,
+                       uint16_t,
+                       std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>;
+
+/**
+ * @brief Encodes a fixed-width array in the packed little-endian layout.
+ *
+ * On little-endian hosts this is a single memcpy of the whole array.
+ */
+template <typename T>
+void encode_packed_array(std::string& out, const T* values, size_t count) {
+  out.resize(count * sizeof(T));
+  if (count == 0) {
+    return;
+  }
+  if constexpr (std::endian::native == std::endian::little || sizeof(T) == 1) {
+    std::memcpy(out.data(), values, count * sizeof(T));
+  } else {
+    for (size_t i = 0; i < count; i++) {
+      auto word = std::byteswap(std::bit_cast<array_word_t<T>>(values[i]));
+      std::memcpy(out.data() + i * sizeof(T), &word, sizeof(T));
+    }
+  }
+}
+
+/**
+ * @brief Encodes a BooleanArray: 4-byte little-endian count, then bits packed MSB first.
+ */
+inline void encode_boolean_array(std::string& out, const bool* values, size_t count) {
+  out.resize(4 + (count + 7) / 8);
+  auto* bytes = reinterpret_cast<uint8_t*>(out.data());
+  auto count32 = static_cast<uint32_t>(count);
+  for (int i = 0; i < 4; i++) {
+    bytes[i] = static_cast<uint8_t>(count32 >> (8 * i));
+  }
+
+  // Branch-free packing of whole bytes, then the partial tail
+  size_t full = count / 8;
+  for (size_t b = 0; b < full; b++) {
+    const bool* v = values + b * 8;
+    bytes[4 + b] = static_cast<uint8_t>((v[0] << 7) | (v[1] << 6) | (v[2] << 5) |
+                                        (v[3] << 4) | (v[4] << 3) | (v[5] << 2) |
+                                        (v[6] << 1) | v[7]);
+  }
+  if (size_t rest = count % 8; rest != 0) {
+    uint8_t last = 0;
+    for (size_t i = 0; i < rest; i++) {
+      last |= static_cast<uint8_t>(values[full * 8 + i] << (7 - i));
+    }
+    bytes[4 + full] = last;
+  }
+}
+
+/**
+ * @brief Encodes a StringArray: UTF-8 strings, each followed by a null terminator.
+ */
+template <typename S>
+void encode_string_array(std::string& out, const S* values, size_t count) {
+  size_t total = count;
+  for (size_t i = 0; i < count; i++) {
+    total += std::string_view(values[i]).size();
+  }
+  out.resize(total);
+
+  char* pos = out.data();
+  for (size_t i = 0; i < count; i++) {
+    std::string_view str(values[i]);
+    std::memcpy(pos, str.data(), str.size());
+    pos += str.size();
+    *pos++ = '\0';
+  }
+}
+
+template <SparkplugArray R>
+void set_array_value(org::eclipse::tahu::protobuf::Payload::Metric* metric,
+                     const R& values) {
+  using E = std::ranges::range_value_t<R>;
+  auto* out = metric->mutable_bytes_value();
+  const auto* data = std::ranges::data(values);
+  const size_t count = std::ranges::size(values);
+
+  if constexpr (std::is_same_v<E, bool>) {
+    encode_boolean_array(*out, data, count);
+  } else if constexpr (std::is_same_v<E, std::string> ||
+                       std::is_same_v<E, std::string_view>) {
+    encode_string_array(*out, data, count);
+  } else {
+    encode_packed_array(*out, data, count);
+  }
+}
+
+template <SparkplugArray R>
+void add_array_metric_to_payload(org::eclipse::tahu::protobuf::Payload& payload,
+                                 std::string_view name,
+                                 const R& values,
+                                 std::optional<uint64_t> alias,
+                                 uint64_t timestamp_ms) {
+  auto* metric = payload.add_metrics();
+
+  if (!name.empty()) {
+    metric->mutable_name()->assign(name.data(), name.size());
+  }
+  if (alias.has_value()) {
+    metric->set_alias(*alias);
+  }
+
+  metric->set_datatype(
+      std::to_underlying(get_array_datatype<std::ranges::range_value_t<R>>()));
+  set_array_value(metric, values);
+  metric->set_timestamp(timestamp_ms);
+}
+
 template <SparkplugMetricType T>
 consteval DataType get_datatype() noexcept {
   using BaseT = std::remove_cvref_t<T>;
@@ -108,8 +279,9 @@ void set_metric_value(org::eclipse::tahu::protobuf::Payload::Metric* metric, T&&
   } else if constexpr (std::is_same_v<BaseT, bool>) {
     metric->set_boolean_value(value);
   } else {
-    // Handle all string-like types
-    metric->set_string_value(std::string(value));
+    // Handle all string-like types (assign in place to reuse any existing buffer)
+    std::string_view str(value);
+    metric->mutable_string_value()->assign(str.data(), str.size());
   }
 }
 
@@ -118,11 +290,11 @@ void add_metric_to_payload(org::eclipse::tahu::protobuf::Payload& payload,
                            std::string_view name,
                            T&& value,
                            std::optional<uint64_t> alias,
-                           std::optional<uint64_t> timestamp_ms) {
+                           uint64_t timestamp_ms) {
   auto* metric = payload.add_metrics();
 
   if (!name.empty()) {
-    metric->set_name(std::string(name));
+    metric->mutable_name()->assign(name.data(), name.size());
   }
   if (alias.has_value()) {
     metric->set_alias(*alias);
@@ -130,21 +302,41 @@ void add_metric_to_payload(org::eclipse::tahu::protobuf::Payload& payload,
 
   metric->set_datatype(std::to_underlying(get_datatype<T>()));
   set_metric_value(metric, std::forward<T>(value));
+  metric->set_timestamp(timestamp_ms);
+}
+
+template <SparkplugMetricType T>
+wire::MetricValue to_wire_value(const T& value) noexcept {
+  using BaseT = std::remove_cvref_t<T>;
 
-  // Use provided timestamp or current time
-  uint64_t ts;
-  if (timestamp_ms.has_value()) {
-    ts = *timestamp_ms;
+  if constexpr (std::is_same_v<BaseT, int64_t> || std::is_same_v<BaseT, uint64_t>) {
+    return static_cast<uint64_t>(value);
+  } else if constexpr (SparkplugInteger<BaseT>) {
+    // Matches protobuf's uint32 int_value conversion (two's complement for negatives)
+    return static_cast<uint32_t>(value);
+  } else if constexpr (SparkplugFloat<BaseT> || SparkplugBoolean<BaseT>) {
+    return value;
   } else {
-    auto now = std::chrono::system_clock::now();
-    ts = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch())
-             .count();
+    return std::string_view(value);
   }
-  metric->set_timestamp(ts);
 }
 
+/**
+ * @brief Describes a protobuf metric as a non-owning wire::Metric.
+ *
+ * @return false if the metric has content the wire encoder does not handle (metadata,
+ *         properties, DataSet/Template/extension values, unknown fields)
+ */
+bool to_wire_metric(const org::eclipse::tahu::protobuf::Payload::Metric& metric,
+                    wire::Metric& out);
+
 } // namespace detail
 
+class DataSetBuilder;
+class TemplateDefinition;
+template <SparkplugMetricType... Ts>
+class TemplateLayout;
+
 /**
  * @brief Type-safe builder for Sparkplug B payloads with automatic type detection.
  *
@@ -159,6 +351,11 @@ void add_metric_to_payload(org::eclipse::tahu::protobuf::Payload& payload,
  * - Floating-point: float, double
  * - Boolean: bool
  * - String: std::string, std::string_view, const char*
+ * - Arrays: contiguous ranges (std::span, std::vector, std::array) of any of the above
+ *   except const char*, or of sparkplug::DateTime, encoded as the packed Sparkplug 3.0
+ *   array datatypes (Int8Array..DateTimeArray). See get_array() for decoding.
+ * - DataSets: columnar tables built with DataSetBuilder (see add_dataset())
+ * - Templates: instances of a TemplateLayout (see add_template())
  *
  * @par Usage Patterns
  *
@@ -181,16 +378,96 @@ void add_metric_to_payload(org::eclipse::tahu::protobuf::Payload& payload,
  * publisher.publish_data(data);       // (Pressure unchanged, not included)
  * @endcode
  *
+ * **Steady-state publishing:**
+ * Keep one long-lived builder and call reset() at the start of every scan cycle.
+ * With Options::use_arena the payload lives on a protobuf Arena whose initial block is
+ * retained across reset(), so refilling the builder does not touch the global allocator.
+ * @code
+ * sparkplug::PayloadBuilder data({.use_arena = true});
+ * while (running) {
+ *   data.reset();
+ *   data.add_metric_by_alias(1, read_temperature());
+ *   edge_node.publish_data(data);
+ * }
+ * @endcode
+ *
  * @see Publisher::publish_birth()
  * @see Publisher::publish_data()
  */
 class PayloadBuilder {
 public:
+  /**
+   * @brief Serializer used by build() and build_into().
+   */
+  enum class Encoding : uint8_t {
+    Protobuf, ///< libprotobuf SerializeToArray
+    Wire,     ///< sparkplug::wire::Encoder (scalar metrics, byte-identical output)
+  };
+
+  /**
+   * @brief How metrics added without an explicit timestamp are stamped.
+   */
+  enum class TimestampMode : uint8_t {
+    PerMetric, ///< Read the clock for every metric
+    Snapshot,  ///< Read the clock once per payload (construction or reset())
+  };
+
+  /**
+   * @brief Memory, encoding and timestamp options for the underlying protobuf payload.
+   */
+  struct Options {
+    bool use_arena = false; ///< Allocate the payload on a protobuf Arena
+    size_t arena_block_size =
+        64 * 1024; ///< Initial arena block, retained across reset() (bytes)
+    Encoding encoding = Encoding::Protobuf; ///< Serializer used when building
+    Clock clock{};                          ///< Source of generated timestamps
+    TimestampMode timestamp_mode = TimestampMode::PerMetric; ///< Clock reads per payload
+  };
+
   /**
    * @brief Constructs an empty payload.
    */
   PayloadBuilder();
 
+  /**
+   * @brief Constructs an empty payload with the given memory options.
+   *
+   * @param options Memory options (e.g., arena-backed storage)
+   *
+   * @note With use_arena, everything the payload allocates comes from a single arena
+   *       whose first block is owned by the builder. Size arena_block_size to fit one
+   *       cycle's payload to keep reset()/refill cycles free of global allocations.
+   * @note With TimestampMode::Snapshot the clock is read once, here and in reset(), and
+   *       that time stamps the payload and every metric added without a timestamp.
+   */
+  explicit PayloadBuilder(const Options& options);
+
+  ~PayloadBuilder();
+
+  PayloadBuilder(const PayloadBuilder& other);
+  PayloadBuilder& operator=(const PayloadBuilder& other);
+
+  /**
+   * @note The moved-from builder is left empty, with default Options, ready to be
+   *       refilled. Moving does not allocate; its next message is made on first use.
+   */
+  PayloadBuilder(PayloadBuilder&& other) noexcept;
+  PayloadBuilder& operator=(PayloadBuilder&& other) noexcept;
+
+  /**
+   * @brief Clears all metrics, seq and timestamp so the builder can be refilled.
+   *
+   * Capacity is kept: heap-backed builders reuse their metric objects and name
+   * buffers, arena-backed builders rewind the arena to its initial block. The payload
+   * timestamp is re-stamped with the current time, as on construction.
+   *
+   * @return Reference to this builder for method chaining
+   *
+   * @note String metric values longer than the small-string buffer are still heap
+   *       allocated by std::string, even in arena mode.
+   */
+  PayloadBuilder& reset();
+
   /**
    * @brief Adds a metric by name only (for NBIRTH without aliases).
    *
@@ -204,8 +481,8 @@ public:
    */
   template <SparkplugMetricType T>
   PayloadBuilder& add_metric(std::string_view name, T&& value) {
-    detail::add_metric_to_payload(payload_, name, std::forward<T>(value), std::nullopt,
-                                  std::nullopt);
+    add_scalar(name, std::forward<T>(value), std::nullopt,
+                                  metric_timestamp());
     return *this;
   }
 
@@ -223,7 +500,7 @@ public:
    */
   template <SparkplugMetricType T>
   PayloadBuilder& add_metric(std::string_view name, T&& value, uint64_t timestamp_ms) {
-    detail::add_metric_to_payload(payload_, name, std::forward<T>(value), std::nullopt,
+    add_scalar(name, std::forward<T>(value), std::nullopt,
                                   timestamp_ms);
     return *this;
   }
@@ -243,8 +520,8 @@ public:
   template <SparkplugMetricType T>
   PayloadBuilder&
   add_metric_with_alias(std::string_view name, uint64_t alias, T&& value) {
-    detail::add_metric_to_payload(payload_, name, std::forward<T>(value), alias,
-                                  std::nullopt);
+    add_scalar(name, std::forward<T>(value), alias,
+                                  metric_timestamp());
     return *this;
   }
 
@@ -267,7 +544,7 @@ public:
                                         uint64_t alias,
                                         T&& value,
                                         uint64_t timestamp_ms) {
-    detail::add_metric_to_payload(payload_, name, std::forward<T>(value), alias,
+    add_scalar(name, std::forward<T>(value), alias,
                                   timestamp_ms);
     return *this;
   }
@@ -288,8 +565,8 @@ public:
    */
   template <SparkplugMetricType T>
   PayloadBuilder& add_metric_by_alias(uint64_t alias, T&& value) {
-    detail::add_metric_to_payload(payload_, "", std::forward<T>(value), alias,
-                                  std::nullopt);
+    add_scalar("", std::forward<T>(value), alias,
+                                  metric_timestamp());
     return *this;
   }
 
@@ -307,11 +584,172 @@ public:
    */
   template <SparkplugMetricType T>
   PayloadBuilder& add_metric_by_alias(uint64_t alias, T&& value, uint64_t timestamp_ms) {
-    detail::add_metric_to_payload(payload_, "", std::forward<T>(value), alias,
+    add_scalar("", std::forward<T>(value), alias,
                                   timestamp_ms);
     return *this;
   }
 
+  /**
+   * @brief Adds an array metric by name (Int8Array..DateTimeArray).
+   *
+   * The values are encoded into bytes_value in the packed little-endian layout of the
+   * Sparkplug 3.0 specification with bulk copies rather than per-element conversions.
+   *
+   * @tparam R Contiguous range type (must satisfy SparkplugArray)
+   * @param name Metric name
+   * @param values Array elements
+   *
+   * @return Reference to this builder for method chaining
+   *
+   * @code
+   * std::array<double, 1024> waveform = sample_vibration();
+   * birth.add_metric_with_alias("Vibration", 10, waveform);
+   * data.add_metric_by_alias(10, std::span<const double>(waveform));
+   * @endcode
+   */
+  template <SparkplugArray R>
+  PayloadBuilder& add_metric(std::string_view name, const R& values) {
+    detail::add_array_metric_to_payload(message(), name, values, std::nullopt,
+                                        metric_timestamp());
+    return *this;
+  }
+
+  /**
+   * @brief Adds an array metric by name with a custom timestamp.
+   */
+  template <SparkplugArray R>
+  PayloadBuilder& add_metric(std::string_view name,
+                             const R& values,
+                             uint64_t timestamp_ms) {
+    detail::add_array_metric_to_payload(message(), name, values, std::nullopt,
+                                        timestamp_ms);
+    return *this;
+  }
+
+  /**
+   * @brief Adds an array metric with both name and alias (for NBIRTH messages).
+   */
+  template <SparkplugArray R>
+  PayloadBuilder&
+  add_metric_with_alias(std::string_view name, uint64_t alias, const R& values) {
+    detail::add_array_metric_to_payload(message(), name, values, alias,
+                                        metric_timestamp());
+    return *this;
+  }
+
+  /**
+   * @brief Adds an array metric with name, alias, and custom timestamp.
+   */
+  template <SparkplugArray R>
+  PayloadBuilder& add_metric_with_alias(std::string_view name,
+                                        uint64_t alias,
+                                        const R& values,
+                                        uint64_t timestamp_ms) {
+    detail::add_array_metric_to_payload(message(), name, values, alias, timestamp_ms);
+    return *this;
+  }
+
+  /**
+   * @brief Adds an array metric by alias only (for NDATA messages).
+   */
+  template <SparkplugArray R>
+  PayloadBuilder& add_metric_by_alias(uint64_t alias, const R& values) {
+    detail::add_array_metric_to_payload(message(), "", values, alias, metric_timestamp());
+    return *this;
+  }
+
+  /**
+   * @brief Adds an array metric by alias with a custom timestamp.
+   */
+  template <SparkplugArray R>
+  PayloadBuilder& add_metric_by_alias(uint64_t alias,
+                                      const R& values,
+                                      uint64_t timestamp_ms) {
+    detail::add_array_metric_to_payload(message(), "", values, alias, timestamp_ms);
+    return *this;
+  }
+
+  /**
+   * @brief Adds a DataSet metric by name.
+   *
+   * The table is encoded once with DataSetBuilder::encode_into() and stored as the
+   * metric's serialized dataset_value, without a protobuf object per row or cell.
+   *
+   * @note payload() holds the table as an unknown field (number 17), so its
+   *       dataset_value() is empty; decode the built bytes with DataSetView::parse().
+   *
+   * @param name Metric name
+   * @param table Columnar table (see DataSetBuilder)
+   *
+   * @return Reference to this builder for method chaining
+   */
+  PayloadBuilder& add_dataset(std::string_view name, const DataSetBuilder& table);
+
+  /**
+   * @brief Adds a DataSet metric with both name and alias (for NBIRTH messages).
+   */
+  PayloadBuilder& add_dataset_with_alias(std::string_view name,
+                                         uint64_t alias,
+                                         const DataSetBuilder& table);
+
+  /**
+   * @brief Adds a DataSet metric by alias only (for NDATA messages).
+   */
+  PayloadBuilder& add_dataset_by_alias(uint64_t alias, const DataSetBuilder& table);
+
+  /**
+   * @brief Adds a template definition metric ("_types_/<name>", is_definition set).
+   *
+   * @note EdgeNode adds registered definitions to NBIRTH automatically.
+   */
+  PayloadBuilder& add_template_definition(const TemplateDefinition& definition);
+
+  /**
+   * @brief Adds a template instance by name.
+   *
+   * @param name Instance metric name
+   * @param layout Registered template layout
+   * @param values Member values in member order
+   *
+   * @return Reference to this builder for method chaining
+   *
+   * @code
+   * birth.add_template("Motor1", motor, {1500.0, true, 0});
+   * @endcode
+   */
+  template <typename... Ts>
+  PayloadBuilder& add_template(std::string_view name,
+                               const TemplateLayout<Ts...>& layout,
+                               const std::type_identity_t<std::tuple<Ts...>>& values) {
+    layout.fill_instance(add_template_metric(name, std::nullopt), values);
+    return *this;
+  }
+
+  /**
+   * @brief Adds a template instance with both name and alias (for NBIRTH messages).
+   */
+  template <typename... Ts>
+  PayloadBuilder&
+  add_template_with_alias(std::string_view name,
+                          uint64_t alias,
+                          const TemplateLayout<Ts...>& layout,
+                          const std::type_identity_t<std::tuple<Ts...>>& values) {
+    layout.fill_instance(add_template_metric(name, alias), values);
+    return *this;
+  }
+
+  /**
+   * @brief Adds a template instance by alias only (for NDATA messages).
+   */
+  template <typename... Ts>
+  PayloadBuilder&
+  add_template_by_alias(uint64_t alias,
+                        const TemplateLayout<Ts...>& layout,
+                        const std::type_identity_t<std::tuple<Ts...>>& values) {
+    layout.fill_instance(add_template_metric("", alias), values);
+    return *this;
+  }
+
   /**
    * @brief Sets the payload-level timestamp.
    *
@@ -322,7 +760,7 @@ public:
    * @note Usually not needed; Publisher adds this automatically.
    */
   PayloadBuilder& set_timestamp(uint64_t ts) {
-    payload_.set_timestamp(ts);
+    fields().set_timestamp(ts);
     timestamp_explicitly_set_ = true;
     return *this;
   }
@@ -337,11 +775,24 @@ public:
    * @warning Do not use in normal operation; Publisher manages this automatically.
    */
   PayloadBuilder& set_seq(uint64_t seq) {
-    payload_.set_seq(seq);
+    fields().set_seq(seq);
     seq_explicitly_set_ = true;
     return *this;
   }
 
+  /**
+   * @brief Removes the sequence number, so EdgeNode assigns one when publishing.
+   *
+   * @return Reference to this builder for method chaining
+   */
+  PayloadBuilder& clear_seq() noexcept {
+    if (payload_) {
+      payload_->clear_seq();
+    }
+    seq_explicitly_set_ = false;
+    return *this;
+  }
+
   // Add Node Control metrics (convenience methods for NBIRTH)
   PayloadBuilder& add_node_control_rebirth(bool value = false) {
     add_metric("Node Control/Rebirth", value);
@@ -363,6 +814,29 @@ public:
     return *this;
   }
 
+  /**
+   * @brief Selects the serializer used by build() and build_into().
+   *
+   * With Encoding::Wire, scalar metrics are recorded as wire::Metric descriptions
+   * instead of protobuf objects, and build_into() writes them with
+   * sparkplug::wire::Encoder in one pass, without libprotobuf. Anything else (arrays,
+   * DataSets, Templates, mutable_payload(), split()) moves the recorded metrics into
+   * the protobuf message, which serializes the payload until the next reset(). Both
+   * produce identical bytes.
+   *
+   * @note Takes effect at once on an empty payload, otherwise from the next reset().
+   * @note payload() also moves the recorded metrics into the protobuf message.
+   *
+   * @param encoding Serializer to use
+   *
+   * @return Reference to this builder for method chaining
+   */
+  PayloadBuilder& set_encoding(Encoding encoding);
+
+  [[nodiscard]] Encoding encoding() const noexcept {
+    return options_.encoding;
+  }
+
   // Query methods
   [[nodiscard]] bool has_seq() const noexcept {
     return seq_explicitly_set_;
@@ -370,18 +844,179 @@ public:
   [[nodiscard]] bool has_timestamp() const noexcept {
     return timestamp_explicitly_set_;
   }
+  [[nodiscard]] const Options& options() const noexcept {
+    return options_;
+  }
 
   // Build and access
   [[nodiscard]] std::vector<uint8_t> build() const;
-  [[nodiscard]] const org::eclipse::tahu::protobuf::Payload& payload() const noexcept;
-  [[nodiscard]] org::eclipse::tahu::protobuf::Payload& mutable_payload() noexcept {
-    return payload_;
+
+  /**
+   * @brief Serializes the payload directly into a caller-owned buffer.
+   *
+   * Unlike build(), the payload is serialized straight from the builder without
+   * copying the protobuf message and without allocating.
+   *
+   * @param buffer Destination buffer (must hold at least the encoded payload size)
+   *
+   * @return Number of bytes written on success, error message if the buffer is too small
+   *
+   * @note If the payload timestamp was cleared via mutable_payload(), the current time
+   *       is stored in the builder before serializing.
+   */
+  [[nodiscard]] stdx::expected<size_t, std::string> build_into(std::span<uint8_t> buffer);
+
+  /**
+   * @brief Serializes the payload into a reusable byte vector.
+   *
+   * The vector is resized to the encoded payload size. Its capacity is kept, so a
+   * buffer reused across calls stops allocating once it has grown to fit the largest
+   * payload.
+   *
+   * @param buffer Destination vector (contents are replaced)
+   *
+   * @note If the payload timestamp was cleared via mutable_payload(), the current time
+   *       is stored in the builder before serializing.
+   */
+  void build_into(std::vector<uint8_t>& buffer);
+
+  /**
+   * @brief A run of consecutive metrics that is sent as one message (see split()).
+   */
+  struct Chunk {
+    size_t first_metric{0};
+    size_t metric_count{0};
+  };
+
+  /**
+   * @brief Returns a running estimate of the encoded payload size in bytes.
+   *
+   * Each metric is measured once, the first time this is called after it was added,
+   * so polling encoded_size() while adding metrics costs O(1) per metric. The result
+   * is exact unless a metric that was already measured is later modified in place.
+   *
+   * @note mutable_payload() and reset() restart the measurement.
+   */
+  [[nodiscard]] size_t encoded_size() const;
+
+  /**
+   * @brief Partitions the metrics into chunks whose messages fit in max_bytes.
+   *
+   * Metrics keep their order and are never split. Every chunk carries the payload
+   * timestamp and its own seq (see build_chunk_into()), so an oversized NDATA/DDATA
+   * can be sent as several valid DATA messages.
+   *
+   * @param max_bytes Maximum encoded size of one message
+   * @param chunks Output (contents are replaced; a payload that fits yields one chunk)
+   *
+   * @return void on success, error message if a single metric exceeds max_bytes, or if
+   *         the payload needs splitting but has uuid, body or unknown fields
+   */
+  stdx::expected<void, std::string> split(size_t max_bytes, std::vector<Chunk>& chunks);
+
+  /**
+   * @brief Encodes one chunk from split() as a standalone payload.
+   *
+   * @param chunk Chunk to encode
+   * @param seq Sequence number of this message, or std::nullopt to leave the seq field
+   *            out (for a send path that appends it)
+   * @param buffer Destination vector (contents are replaced)
+   */
+  void build_chunk_into(const Chunk& chunk,
+                        std::optional<uint64_t> seq,
+                        std::vector<uint8_t>& buffer) const;
+
+  [[nodiscard]] const org::eclipse::tahu::protobuf::Payload& payload() const;
+  [[nodiscard]] org::eclipse::tahu::protobuf::Payload& mutable_payload() {
+    sized_metrics_ = 0; // Caller may change metrics that were already measured
+    sized_bytes_ = 0;
+    return message();
   }
 
 private:
-  org::eclipse::tahu::protobuf::Payload payload_;
+  // Appends a Template-typed metric and returns its (empty) template_value
+  org::eclipse::tahu::protobuf::Payload::Template&
+  add_template_metric(std::string_view name, std::optional<uint64_t> alias);
+
+  struct ArenaStorage;
+
+  // Leaves a moved-from builder with default Options and no message
+  void leave_empty() noexcept;
+
+  // Makes payload_ a new, empty message in arena_ (if set) or owned_
+  void create_payload();
+
+  // The message for payload-level fields (timestamp, seq); recorded wire metrics stay
+  // where they are. A moved-from builder gets a new message on first use.
+  org::eclipse::tahu::protobuf::Payload& fields() {
+    if (!payload_) [[unlikely]] {
+      create_payload();
+    }
+    return *payload_;
+  }
+
+  // The message with every metric in it
+  org::eclipse::tahu::protobuf::Payload& message() {
+    fields();
+    leave_wire();
+    return *payload_;
+  }
+  // Without the recorded wire metrics
+  [[nodiscard]] const org::eclipse::tahu::protobuf::Payload& message() const noexcept {
+    return payload_ ? *payload_
+                    : org::eclipse::tahu::protobuf::Payload::default_instance();
+  }
+
+  template <SparkplugMetricType T>
+  void add_scalar(std::string_view name,
+                  T&& value,
+                  std::optional<uint64_t> alias,
+                  uint64_t timestamp_ms) {
+    if (wire_active_) {
+      record_wire({.name = name,
+                   .alias = alias,
+                   .timestamp = timestamp_ms,
+                   .datatype = detail::get_datatype<T>(),
+                   .value = detail::to_wire_value(value)});
+    } else {
+      detail::add_metric_to_payload(message(), name, std::forward<T>(value), alias,
+                                    timestamp_ms);
+    }
+  }
+
+  // Encoding::Wire: appends a metric, its name and string value copied to wire_text_
+  void record_wire(wire::Metric metric);
+  // Makes room for size more bytes of wire_text_, repointing the recorded metrics
+  void reserve_wire_text(size_t size);
+  std::string_view append_wire_text(std::string_view text);
+  // Repoints the recorded metrics' text from a buffer at old_base to wire_text_
+  void rebase_wire_text(const char* old_base) noexcept;
+  // Moves the recorded metrics into the protobuf message and stops recording until
+  // reset(); const because payload() needs it, and the payload's content is unchanged
+  void leave_wire() const;
+  // Loads encoder with the payload: message fields plus the recorded metrics
+  void load_wire(wire::Encoder& encoder) const;
+
+  [[nodiscard]] uint64_t metric_timestamp() const {
+    return options_.timestamp_mode == TimestampMode::Snapshot ? snapshot_ms_
+                                                              : options_.clock.now_ms();
+  }
+
+  Options options_;
+  std::unique_ptr<ArenaStorage> arena_;                          // Set in arena mode
+  std::unique_ptr<org::eclipse::tahu::protobuf::Payload> owned_; // Set in heap mode
+  org::eclipse::tahu::protobuf::Payload* payload_{nullptr};
+  // Encoding::Wire: scalar metrics added since reset() while wire_active_, in order and
+  // ahead of any metric in the protobuf message; names and strings point into wire_text_
+  mutable std::vector<wire::Metric> wire_metrics_;
+  mutable std::vector<char> wire_text_;
+  mutable bool wire_active_{false};
+  wire::Encoder encoder_; // Scratch state for Encoding::Wire, reused across builds
   bool seq_explicitly_set_{false};
   bool timestamp_explicitly_set_{false};
+  uint64_t snapshot_ms_{0}; // Clock reading taken at construction/reset()
+  mutable size_t sized_metrics_{0}; // Metrics measured by encoded_size()
+  mutable size_t sized_bytes_{0};   // Their encoded size, including field keys
 };
 
 } // namespace sparkplug
\ No newline at end of file
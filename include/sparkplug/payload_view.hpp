@@ -0,0 +1,214 @@
+// include/sparkplug/payload_view.hpp
+#pragma once
+
+#include "detail/compat.hpp"
+#include "wire.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace sparkplug {
+
+/**
+ * @brief Decoded metric referencing the payload bytes.
+ *
+ * The same non-owning description the wire encoder consumes: name and string/bytes
+ * values are views into the received buffer. An absent name is empty.
+ *
+ * Integer values are reported as on the wire: uint32_t for int_value (Int8..UInt32,
+ * signed values in two's complement) and uint64_t for long_value (Int64, UInt64,
+ * DateTime). Metric metadata and properties are skipped.
+ */
+using MetricView = wire::Metric;
+
+/**
+ * @brief Lazy, zero-copy decoder for Sparkplug B payloads.
+ *
+ * parse() walks the wire bytes once to check their structure and record the
+ * payload-level fields; no protobuf messages or strings are created. Metrics are
+ * decoded on demand while iterating and reference the original buffer, which must
+ * outlive the view and every MetricView taken from it.
+ *
+ * Unknown fields and known fields with an unexpected wire type are skipped, as
+ * libprotobuf does.
+ *
+ * @par Example Usage
+ * @code
+ * auto view = sparkplug::PayloadView::parse(bytes);
+ * if (!view) {
+ *   return;
+ * }
+ * for (const auto& metric : view->metrics()) {
+ *   if (const auto* value = std::get_if<double>(&metric.value)) {
+ *     store(metric.alias.value_or(0), *value);
+ *   }
+ * }
+ * @endcode
+ */
+class PayloadView {
+public:
+  /**
+   * @brief Forward iterator decoding one metric per step.
+   */
+  class MetricIterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = MetricView;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const MetricView*;
+    using reference = const MetricView&;
+
+    MetricIterator() = default;
+
+    reference operator*() const noexcept {
+      return current_;
+    }
+    pointer operator->() const noexcept {
+      return &current_;
+    }
+
+    MetricIterator& operator++() noexcept {
+      advance();
+      return *this;
+    }
+    MetricIterator operator++(int) noexcept {
+      auto previous = *this;
+      advance();
+      return previous;
+    }
+
+    [[nodiscard]] bool operator==(const MetricIterator& other) const noexcept {
+      return at_end_ == other.at_end_ && (at_end_ || position_ == other.position_);
+    }
+
+  private:
+    friend class PayloadView;
+
+    explicit MetricIterator(std::span<const uint8_t> data) noexcept : reader_(data) {
+      advance();
+    }
+
+    void advance() noexcept;
+
+    wire::Reader reader_;
+    MetricView current_{};
+    const uint8_t* position_{nullptr}; // Start of the current metric field
+    bool at_end_{true};
+  };
+
+  /**
+   * @brief Range over the metrics of a payload, in wire order.
+   */
+  class MetricRange {
+  public:
+    [[nodiscard]] MetricIterator begin() const noexcept {
+      return MetricIterator(data_);
+    }
+    [[nodiscard]] MetricIterator end() const noexcept {
+      return {};
+    }
+    [[nodiscard]] size_t size() const noexcept {
+      return count_;
+    }
+    [[nodiscard]] bool empty() const noexcept {
+      return count_ == 0;
+    }
+
+  private:
+    friend class PayloadView;
+    MetricRange(std::span<const uint8_t> data, size_t count) noexcept
+        : data_(data), count_(count) {
+    }
+
+    std::span<const uint8_t> data_;
+    size_t count_;
+  };
+
+  PayloadView() = default;
+
+  /**
+   * @brief Checks and indexes an encoded Payload message.
+   *
+   * @param bytes Payload bytes (e.g., MQTTAsync_message::payload); not copied
+   *
+   * @return View on success, error message on truncated or malformed input
+   */
+  [[nodiscard]] static stdx::expected<PayloadView, std::string>
+  parse(std::span<const uint8_t> bytes);
+
+  [[nodiscard]] std::optional<uint64_t> timestamp() const noexcept {
+    return timestamp_;
+  }
+  [[nodiscard]] std::optional<uint64_t> seq() const noexcept {
+    return seq_;
+  }
+  [[nodiscard]] std::optional<std::string_view> uuid() const noexcept {
+    return uuid_;
+  }
+  [[nodiscard]] std::optional<std::span<const uint8_t>> body() const noexcept {
+    return body_;
+  }
+
+  /// Metrics in wire order, decoded while iterating
+  [[nodiscard]] MetricRange metrics() const noexcept {
+    return {data_, metric_count_};
+  }
+
+  /// Number of metrics in the payload
+  [[nodiscard]] size_t metric_count() const noexcept {
+    return metric_count_;
+  }
+
+  /// Finds the first metric with the given name
+  [[nodiscard]] std::optional<MetricView> find(std::string_view name) const noexcept;
+
+  /// Finds the first metric with the given alias
+  [[nodiscard]] std::optional<MetricView> find(uint64_t alias) const noexcept;
+
+  /// The encoded payload the view refers to
+  [[nodiscard]] std::span<const uint8_t> bytes() const noexcept {
+    return data_;
+  }
+
+private:
+  std::span<const uint8_t> data_;
+  std::optional<uint64_t> timestamp_;
+  std::optional<uint64_t> seq_;
+  std::optional<std::string_view> uuid_;
+  std::optional<std::span<const uint8_t>> body_;
+  size_t metric_count_{0};
+};
+
+/**
+ * @brief Payload-level fields needed for sequence and liveness tracking.
+ */
+struct PayloadHeader {
+  std::optional<uint64_t> timestamp; ///< Payload timestamp
+  std::optional<uint64_t> seq;       ///< Payload sequence number
+  std::optional<uint64_t> bd_seq;    ///< Value of the bdSeq metric, if it was located
+};
+
+/**
+ * @brief Extracts the payload timestamp and seq without decoding any metric.
+ *
+ * Metric fields are skipped by their length prefix, so the cost depends on the number
+ * of metrics, not their size. With @p locate_bd_seq, each metric's name is compared
+ * against "bdSeq" and the first match's long_value is reported (for NBIRTH/NDEATH).
+ *
+ * Metric bodies are only checked as far as the bdSeq lookup reads them; use
+ * PayloadView::parse() to validate a payload completely.
+ *
+ * @param bytes Encoded Payload message
+ * @param locate_bd_seq Also search the metrics for bdSeq
+ *
+ * @return Header fields on success, error message on truncated or malformed framing
+ */
+[[nodiscard]] stdx::expected<PayloadHeader, std::string>
+scan_payload_header(std::span<const uint8_t> bytes, bool locate_bd_seq = false);
+
+} // namespace sparkplug
@@ -0,0 +1,125 @@
+// include/sparkplug/publish_sequencer.hpp
+#pragma once
+
+#include "detail/compat.hpp"
+#include "frozen_payload.hpp"
+#include "ingest_queue.hpp"
+#include "mqtt_handle.hpp"
+#include "publish_tracker.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <MQTTAsync.h>
+
+namespace sparkplug {
+
+/**
+ * @brief Single-writer send path that puts Sparkplug seq numbers on the wire in order.
+ *
+ * Producers encode their payloads without a seq on their own thread and submit() them.
+ * Submitted messages are queued on a lock-free MpscRing; whichever producer finds no
+ * writer active becomes the writer and drains the ring, giving each message the next
+ * seq and handing it to the send function in queue order. Assigning a seq and sending
+ * is therefore one step, so the wire order of an EdgeNode's messages always matches
+ * their seq, while producers never wait for each other's encoding.
+ *
+ * Internal to EdgeNode.
+ */
+class PublishSequencer {
+public:
+  /// Where and how a message is sent
+  struct Route {
+    /// Shared with the EdgeNode, so a reconnect that replaces its client never frees
+    /// one a queued message is still to be sent on
+    std::shared_ptr<MQTTAsyncHandle> client;
+    const std::string* topic{nullptr};
+    int qos{0};
+    bool retain{false};
+    const PublishToken* token{nullptr}; ///< Reports the send, if not null
+  };
+
+  /// One encoded payload of a message
+  struct Part {
+    /// Encoded without a seq field; the writer appends one (protobuf accepts fields in
+    /// any order, and seq is the last field libprotobuf would write anyway)
+    std::vector<uint8_t>* bytes{nullptr};
+    FrozenPayload* frozen{nullptr}; ///< Instead of bytes: the writer calls set_seq()
+    bool assign_seq{true};          ///< False to send bytes as they are (seq set by
+                                    ///< the caller); no seq number is used up
+  };
+
+  /// A message; parts (the chunks of a split payload) get consecutive seq numbers
+  struct Message {
+    Route route;
+    std::span<Part> parts;
+    bool restart_seq{false}; ///< NBIRTH: the first part gets seq 0
+
+    // Set by the writer
+    uint64_t first_seq{0};   ///< Seq of the first part
+    size_t parts_sent{0};    ///< Parts sent before an error, if any
+    stdx::expected<void, std::string> result{};
+    std::atomic<bool> done{false};
+  };
+
+  using Send = std::function<stdx::expected<void, std::string>(
+      const Route& route, std::span<const uint8_t> bytes)>;
+
+  static constexpr uint64_t SEQ_MODULUS = 256;
+
+  /**
+   * @param capacity Messages that can be queued before producers wait for the writer
+   * @param send Sends one part; called by the writer only, in seq order
+   */
+  PublishSequencer(size_t capacity, Send send);
+
+  PublishSequencer(const PublishSequencer&) = delete;
+  PublishSequencer& operator=(const PublishSequencer&) = delete;
+
+  /**
+   * @brief Queues the message and returns once it has been sent or has failed.
+   *
+   * The message is written by this thread or by another producer, whichever holds the
+   * writer role. A part whose send fails does not use up a seq number, and the parts
+   * after it are not sent.
+   *
+   * @return The send result (also left in msg.result)
+   */
+  stdx::expected<void, std::string> submit(Message& msg);
+
+  /// Seq of the last message sent (0-255)
+  [[nodiscard]] uint64_t seq() const noexcept {
+    return seq_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Sets the seq of the last message sent (the next one gets seq + 1).
+   *
+   * @note Only for use while no message is being submitted.
+   */
+  void set_seq(uint64_t seq) noexcept {
+    seq_.store(seq % SEQ_MODULUS, std::memory_order_relaxed);
+  }
+
+private:
+  // Takes the writer role and drains the ring until it is empty or, once own is
+  // written (or if it is not queued yet), for at most one ring's worth; false if
+  // another thread holds the role
+  bool try_write(const Message& own, bool own_queued);
+  void write(Message& msg);
+
+  Send send_;
+  MpscRing<Message*> ring_;
+  std::atomic<bool> writing_{false};
+  std::atomic<size_t> queued_{0};       // Submitted and not yet written
+  std::atomic<uint32_t> completed_{0}; // Bumped per written message; producers wait on it
+  std::atomic<uint64_t> seq_{0};       // Written by the writer only
+};
+
+} // namespace sparkplug
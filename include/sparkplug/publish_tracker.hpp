@@ -0,0 +1,252 @@
+// include/sparkplug/publish_tracker.hpp
+#pragma once
+
+#include "detail/compat.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <MQTTAsync.h>
+
+namespace sparkplug {
+
+/**
+ * @brief Outcome of an asynchronous publish: void once the MQTT client reports every
+ *        message of it sent (QoS 0) or acknowledged (QoS 1/2), else the first error.
+ */
+using PublishResult = stdx::expected<void, std::string>;
+
+/**
+ * @brief Called once with the outcome of an asynchronous publish.
+ *
+ * @note Runs on the MQTT client thread and must not block.
+ */
+using PublishCallback = std::function<void(const PublishResult&)>;
+
+class PublishTracker;
+
+/**
+ * @brief Handle to the outcome of one asynchronous publish.
+ *
+ * Returned by the publish_*_async() methods of EdgeNode and HostApplication. The
+ * outcome lives in a pooled slot of the publisher, not in a per-call promise; the
+ * slot is reused once the publish has completed and its token is destroyed.
+ *
+ * @par Example Usage
+ * @code
+ * std::vector<sparkplug::PublishToken> in_flight;
+ * for (auto& payload : batch) {
+ *   auto token = edge_node.publish_data_async(payload);
+ *   if (!token) {
+ *     return token.error();
+ *   }
+ *   in_flight.push_back(std::move(*token));
+ * }
+ * for (auto& token : in_flight) {
+ *   if (auto result = token.wait(); !result) {
+ *     log(result.error());
+ *   }
+ * }
+ * @endcode
+ */
+class PublishToken {
+public:
+  /// An empty token, not referring to any publish
+  PublishToken() noexcept = default;
+  ~PublishToken();
+
+  PublishToken(const PublishToken&) = delete;
+  PublishToken& operator=(const PublishToken&) = delete;
+  PublishToken(PublishToken&& other) noexcept;
+  PublishToken& operator=(PublishToken&& other) noexcept;
+
+  /// True if the token refers to a publish
+  [[nodiscard]] bool valid() const noexcept {
+    return tracker_ != nullptr;
+  }
+
+  /// True once the publish has completed (successfully or not)
+  [[nodiscard]] bool ready() const;
+
+  /**
+   * @brief Blocks until the publish completes.
+   *
+   * @return The publish outcome
+   */
+  PublishResult wait() const;
+
+  /**
+   * @brief Blocks until the publish completes or the timeout expires.
+   *
+   * @return The publish outcome, or std::nullopt on timeout
+   */
+  [[nodiscard]] std::optional<PublishResult>
+  wait_for(std::chrono::milliseconds timeout) const;
+
+private:
+  friend class PublishTracker;
+
+  PublishToken(std::shared_ptr<PublishTracker> tracker, uint32_t slot) noexcept
+      : tracker_(std::move(tracker)), slot_(slot) {
+  }
+
+  std::shared_ptr<PublishTracker> tracker_;
+  uint32_t slot_{0};
+};
+
+/**
+ * @brief Fixed pool of completion slots for asynchronous publishes.
+ *
+ * Each publish takes one slot, whose current response context is passed to the MQTT
+ * client with all of its messages (several for a split DATA payload). A context is
+ * stamped with the slot's generation, which moves on when the slot is reused or its
+ * sends are abandoned, so a late report from a replaced client is ignored instead of
+ * landing on an unrelated publish. When every slot is taken, start() blocks until one
+ * frees up, which bounds the number of publishes in flight.
+ *
+ * Internal to EdgeNode and HostApplication; callers only see PublishToken.
+ */
+class PublishTracker : public std::enable_shared_from_this<PublishTracker> {
+public:
+  /**
+   * @param capacity Maximum number of publishes in flight
+   */
+  explicit PublishTracker(size_t capacity);
+
+  PublishTracker(const PublishTracker&) = delete;
+  PublishTracker& operator=(const PublishTracker&) = delete;
+
+  /**
+   * @brief Takes a slot for a new publish, waiting up to timeout for one to free up.
+   *
+   * The publish stays open (cannot complete) until finish() or discard().
+   */
+  [[nodiscard]] stdx::expected<PublishToken, std::string>
+  start(PublishCallback on_complete, std::chrono::milliseconds timeout);
+
+  /**
+   * @brief Runs one tracked publish: start(), then send(token), then finish().
+   *
+   * @param send Callable taking const PublishToken& and returning
+   *             stdx::expected<void, std::string>; prepares and sends the messages
+   *
+   * @return The token, or the error from start() or send(); on error on_complete is
+   *         never called
+   */
+  template <typename Send>
+  [[nodiscard]] stdx::expected<PublishToken, std::string>
+  publish(PublishCallback on_complete, std::chrono::milliseconds timeout, Send&& send) {
+    auto token = start(std::move(on_complete), timeout);
+    if (!token) {
+      return stdx::unexpected(token.error());
+    }
+    if (auto result = std::forward<Send>(send)(std::as_const(*token)); !result) {
+      discard(*token);
+      return stdx::unexpected(result.error());
+    }
+    finish(*token);
+    return std::move(*token);
+  }
+
+  /**
+   * @brief Points opts at the token's slot, for one message about to be sent.
+   */
+  void prepare(const PublishToken& token, MQTTAsync_responseOptions& opts);
+
+  /**
+   * @brief Records that a message prepared for the token was not accepted for sending.
+   */
+  void fail(const PublishToken& token, std::string error);
+
+  /**
+   * @brief Closes the publish; it completes when its prepared messages have.
+   */
+  void finish(const PublishToken& token);
+
+  /**
+   * @brief Closes the publish without ever calling its callback (the caller reports
+   *        the error instead).
+   */
+  void discard(const PublishToken& token);
+
+  /// A completed publish's callback and outcome, to be run without locks held
+  struct Completion {
+    PublishCallback callback;
+    PublishResult result;
+  };
+
+  /**
+   * @brief Fails every message still awaiting the MQTT client.
+   *
+   * For use once the client that was sending them is replaced or destroyed; reports
+   * it still makes on them are ignored. Messages prepared after this call count
+   * normally, so call it before a new client can be published on.
+   *
+   * @return The callbacks of the publishes this completed, for run() once no lock is
+   *         held that a callback might need
+   */
+  [[nodiscard]] std::vector<Completion> abandon(std::string_view reason);
+
+  /// Runs the callbacks returned by abandon()
+  static void run(std::vector<Completion>& completions);
+
+  /// Publishes started and not yet completed
+  [[nodiscard]] size_t in_flight() const;
+
+private:
+  friend class PublishToken;
+
+  // MQTT response context of the sends prepared in one generation of a slot; kept
+  // until the MQTT client has reported all of them, then reused
+  struct Context {
+    PublishTracker* owner{nullptr};
+    uint32_t slot{0};
+    uint32_t generation{0};
+    uint32_t reports{0}; // Sends the MQTT client has still to report
+  };
+
+  struct Slot {
+    uint32_t index{0};
+    uint32_t generation{0};    // Reports from other generations are ignored
+    Context* context{nullptr}; // Current generation's context
+    uint32_t sends{0};         // Prepared messages the MQTT client has not reported yet
+    bool open{false};          // The publishing call may still prepare messages
+    bool done{false};          // Completed; result is final
+    bool held{false};          // A PublishToken refers to the slot
+    PublishResult result;
+    PublishCallback callback;
+  };
+
+  static void on_success(void* context, MQTTAsync_successData* response);
+  static void on_failure(void* context, MQTTAsync_failureData* response);
+
+  // Starts a new generation of the slot, so reports on earlier sends are ignored;
+  // needs mutex_
+  void renew(Slot& slot);
+  // Completes the publish if nothing can add to or report on it any more; needs mutex_
+  [[nodiscard]] Completion settle(Slot& slot);
+  // Counts one reported (or never accepted) send of the context
+  void complete_send(Context& context, std::optional<std::string> error);
+  void release_token(uint32_t slot);
+  static void run(Completion& completion);
+
+  mutable std::mutex mutex_;
+  mutable std::condition_variable changed_; // A slot completed or was freed
+  std::vector<Slot> slots_;
+  std::vector<uint32_t> free_;
+  std::vector<std::unique_ptr<Context>> contexts_; // All contexts, current or not
+  std::vector<Context*> spare_contexts_;            // Fully reported, not current
+  size_t in_flight_{0};
+};
+
+} // namespace sparkplug
@@ -0,0 +1,160 @@
+// include/sparkplug/store_forward_buffer.hpp
+#pragma once
+
+#include "detail/compat.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sparkplug {
+
+/**
+ * @brief Bounded FIFO of encoded NDATA/DDATA payloads kept while an EdgeNode is offline.
+ *
+ * Records (a device ID, empty for the node itself, and an encoded payload) are packed
+ * back to back into a byte ring of fixed capacity, so memory use never grows with the
+ * length of an outage. The ring is either plain memory or a memory-mapped file, which
+ * keeps its records across restarts of the process: reopening the file resumes with
+ * the records that were stored and not yet popped. By default the file is left for the
+ * kernel to write back, which survives a crash of the process but not a power loss
+ * or kernel crash; Options::durable flushes every change to disk instead.
+ *
+ * EdgeNode stores into the buffer when Config::store_forward is set and replays it
+ * (see EdgeNode::Config::store_forward_drain_rate); it can also be used on its own.
+ *
+ * @par Example Usage
+ * @code
+ * auto buffer = sparkplug::StoreForwardBuffer::open(
+ *     {.capacity_bytes = 16 * 1024 * 1024, .file_path = "/var/lib/gateway/backlog"});
+ * if (buffer) {
+ *   (*buffer)->push("Sensor01", encoded_ddata);
+ * }
+ * @endcode
+ *
+ * @note All methods are thread-safe.
+ */
+class StoreForwardBuffer {
+public:
+  /// What push() does when a record does not fit in the free space
+  enum class Eviction {
+    DropOldest, ///< Evict the oldest records until it fits
+    DropNewest, ///< Reject the new record
+  };
+
+  struct Options {
+    size_t capacity_bytes{4 * 1024 * 1024}; ///< Ring size; each record takes 8 bytes
+                                            ///< plus its device ID and payload
+    std::string file_path{}; ///< Memory-mapped backing file (created if missing);
+                             ///< empty keeps the ring in memory only
+    Eviction eviction{Eviction::DropOldest};
+    bool durable{false}; ///< File-backed: msync() the changed pages on every push(),
+                         ///< pop() and requeue(), so records also survive a power loss
+                         ///< (one synchronous disk write per call)
+  };
+
+  struct Stats {
+    size_t records{0};        ///< Records stored and not yet popped
+    size_t bytes{0};          ///< Ring bytes they take up
+    size_t capacity_bytes{0}; ///< Ring size
+    uint64_t evicted{0};      ///< Records dropped to make room (DropOldest) since open()
+    uint64_t rejected{0};     ///< Records refused (DropNewest, or larger than the ring)
+  };
+
+  /**
+   * @brief Creates a buffer, or opens the file of a previous one.
+   *
+   * @param options Capacity, backing file and eviction policy
+   *
+   * @return The buffer, or an error message if the file cannot be created or mapped, or
+   *         was created with a different capacity
+   */
+  [[nodiscard]] static stdx::expected<std::unique_ptr<StoreForwardBuffer>, std::string>
+  open(Options options);
+
+  ~StoreForwardBuffer();
+
+  StoreForwardBuffer(const StoreForwardBuffer&) = delete;
+  StoreForwardBuffer& operator=(const StoreForwardBuffer&) = delete;
+
+  /**
+   * @brief Appends a record, evicting the oldest ones first if needed (DropOldest).
+   *
+   * @return true if stored, false if rejected (DropNewest with too little free space,
+   *         or a record larger than the whole ring)
+   */
+  bool push(std::string_view device_id, std::span<const uint8_t> payload);
+
+  /**
+   * @brief Copies out the oldest record without removing it.
+   *
+   * @return The record's position, to pass to pop(), or std::nullopt if empty
+   */
+  [[nodiscard]] std::optional<uint64_t> front(std::string& device_id,
+                                              std::vector<uint8_t>& payload) const;
+
+  /**
+   * @brief Removes the oldest record if it is still the one at position.
+   *
+   * A record copied out by front() may have been evicted by a push() since; the record
+   * that took its place is then left alone.
+   */
+  void pop(uint64_t position);
+
+  /**
+   * @brief Moves the oldest record, if it is still the one at position, behind the
+   *        newest, so the records after it can be taken first.
+   *
+   * A crash during the move leaves the record at both ends rather than at neither.
+   *
+   * @return false if the record is no longer at the front
+   */
+  bool requeue(uint64_t position);
+
+  [[nodiscard]] bool empty() const;
+  [[nodiscard]] Stats stats() const;
+
+private:
+  // Ring state; at the start of the file when file-backed
+  struct Header {
+    char magic[8];
+    uint64_t capacity;
+    uint64_t read_pos;  // Stream position of the oldest record
+    uint64_t write_pos; // Stream position after the newest record
+    uint64_t records;
+  };
+
+  StoreForwardBuffer(Options options, Header* header, uint8_t* ring, size_t mapped_bytes,
+                     std::unique_ptr<uint8_t[]> memory);
+
+  // Ring I/O at stream positions (taken modulo the capacity, wrapping around the end)
+  void write_at(uint64_t pos, const void* data, size_t size);
+  void read_at(uint64_t pos, void* data, size_t size) const;
+
+  // Size of the record at pos, header included; needs mutex_
+  [[nodiscard]] size_t record_size(uint64_t pos) const;
+  void drop_front();
+
+  // With Options::durable, flushes the ring bytes [pos, pos + size) and the header
+  void sync(uint64_t pos, size_t size);
+
+  // Resets an unreadable ring to empty
+  void recover();
+
+  Options options_;
+  Header* header_;
+  uint8_t* ring_;
+  size_t mapped_bytes_; // Header and ring, if file-backed (0 in memory)
+  std::unique_ptr<uint8_t[]> memory_;
+  uint64_t evicted_{0};
+  uint64_t rejected_{0};
+  mutable std::mutex mutex_;
+};
+
+} // namespace sparkplug
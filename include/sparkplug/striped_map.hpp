@@ -0,0 +1,147 @@
+// include/sparkplug/striped_map.hpp
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace sparkplug {
+
+/**
+ * @brief Hash map split into independently locked stripes.
+ *
+ * Each key hashes to one stripe, which has its own mutex and unordered_map, so
+ * threads working on keys in different stripes never contend. Entries are only ever
+ * accessed through a callback that runs with the stripe lock held.
+ *
+ * @tparam Key Key type
+ * @tparam Value Mapped type (default-constructible)
+ * @tparam Hash Hash functor; must be transparent to look up by a key-like type
+ * @tparam KeyEqual Equality functor; must be transparent likewise
+ *
+ * @par Example Usage
+ * @code
+ * sparkplug::StripedMap<std::string, uint64_t, Hash, std::equal_to<>> counters;
+ * counters.update("Gateway01", [](uint64_t& count) { count++; });
+ *
+ * uint64_t count = 0;
+ * counters.visit(std::string_view("Gateway01"), [&](uint64_t value) { count = value; });
+ * @endcode
+ *
+ * @note Callbacks must not access the same map again (the stripe lock is not
+ *       recursive).
+ */
+template <typename Key,
+          typename Value,
+          typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class StripedMap {
+public:
+  static constexpr size_t DEFAULT_STRIPES = 16;
+
+  /**
+   * @param stripes Number of stripes (rounded up to a power of 2)
+   */
+  explicit StripedMap(size_t stripes = DEFAULT_STRIPES)
+      : stripe_count_(std::bit_ceil(std::max<size_t>(stripes, 1))),
+        stripes_(std::make_unique<Stripe[]>(stripe_count_)) {
+  }
+
+  StripedMap(const StripedMap&) = delete;
+  StripedMap& operator=(const StripedMap&) = delete;
+
+  /**
+   * @brief Calls fn with the entry for key, default-constructing it if needed.
+   *
+   * @return Whatever fn returns
+   */
+  template <typename F>
+  decltype(auto) update(const Key& key, F&& fn) {
+    Stripe& stripe = stripe_for(key);
+    std::scoped_lock lock(stripe.mutex);
+    return std::invoke(std::forward<F>(fn), stripe.map[key]);
+  }
+
+  /**
+   * @brief Calls fn with the entry for key, if there is one.
+   *
+   * @param key Key or any type the transparent Hash and KeyEqual accept
+   *
+   * @return true if the entry exists (and fn was called)
+   */
+  template <typename K, typename F>
+  bool visit(const K& key, F&& fn) const {
+    const Stripe& stripe = stripe_for(key);
+    std::scoped_lock lock(stripe.mutex);
+    auto it = stripe.map.find(key);
+    if (it == stripe.map.end()) {
+      return false;
+    }
+    std::invoke(std::forward<F>(fn), std::as_const(it->second));
+    return true;
+  }
+
+  /**
+   * @brief Calls fn(key, value) for every entry, locking one stripe at a time.
+   */
+  template <typename F>
+  void for_each(F&& fn) const {
+    for (size_t i = 0; i < stripe_count_; i++) {
+      std::scoped_lock lock(stripes_[i].mutex);
+      for (const auto& [key, value] : stripes_[i].map) {
+        fn(key, value);
+      }
+    }
+  }
+
+  /// Number of entries (not atomic across stripes)
+  [[nodiscard]] size_t size() const {
+    size_t total = 0;
+    for (size_t i = 0; i < stripe_count_; i++) {
+      std::scoped_lock lock(stripes_[i].mutex);
+      total += stripes_[i].map.size();
+    }
+    return total;
+  }
+
+  [[nodiscard]] size_t stripe_count() const noexcept {
+    return stripe_count_;
+  }
+
+private:
+  struct alignas(64) Stripe {
+    mutable std::mutex mutex;
+    std::unordered_map<Key, Value, Hash, KeyEqual> map;
+  };
+
+  // The maps bucket on the low hash bits; stripes take the high bits of a mixed hash
+  // so keys spread evenly over both
+  template <typename K>
+  [[nodiscard]] size_t stripe_index(const K& key) const noexcept {
+    const uint64_t mixed = static_cast<uint64_t>(Hash{}(key)) * 0x9e3779b97f4a7c15ULL;
+    return stripe_count_ == 1
+               ? 0
+               : static_cast<size_t>(mixed >> (64 - std::countr_zero(stripe_count_)));
+  }
+
+  template <typename K>
+  [[nodiscard]] Stripe& stripe_for(const K& key) noexcept {
+    return stripes_[stripe_index(key)];
+  }
+
+  template <typename K>
+  [[nodiscard]] const Stripe& stripe_for(const K& key) const noexcept {
+    return stripes_[stripe_index(key)];
+  }
+
+  const size_t stripe_count_;
+  std::unique_ptr<Stripe[]> stripes_;
+};
+
+} // namespace sparkplug
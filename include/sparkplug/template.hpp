@@ -0,0 +1,263 @@
+// include/sparkplug/template.hpp
+#pragma once
+
+#include "datatype.hpp"
+#include "detail/compat.hpp"
+#include "payload_builder.hpp"
+#include "sparkplug_b.pb.h"
+#include "wire.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace sparkplug {
+
+/**
+ * @brief Prefix of the NBIRTH metric that carries a template definition.
+ *
+ * Template definitions are published as "_types_/<name>" so they never collide with
+ * instance metric names; instances reference the bare name through template_ref.
+ */
+inline constexpr std::string_view TEMPLATE_DEFINITION_PREFIX = "_types_/";
+
+/**
+ * @brief Sparkplug B Template (UDT) definition: a named, ordered list of typed members.
+ *
+ * Definitions are registered once with EdgeNode::register_template() and published in
+ * NBIRTH with is_definition set. Instances are encoded against the definition through
+ * a TemplateLayout.
+ */
+class TemplateDefinition {
+public:
+  struct Member {
+    std::string name;
+    DataType type;
+  };
+
+  /**
+   * @brief Constructs an empty definition.
+   *
+   * @param name Template name (referenced by instances through template_ref)
+   * @param version Optional version string
+   */
+  explicit TemplateDefinition(std::string name, std::string version = {})
+      : name_(std::move(name)), version_(std::move(version)) {
+  }
+
+  /**
+   * @brief Appends a member metric.
+   *
+   * @return Reference to this definition for method chaining
+   */
+  TemplateDefinition& add_member(std::string_view name, DataType type) {
+    members_.push_back(Member{.name = std::string(name), .type = type});
+    return *this;
+  }
+
+  [[nodiscard]] const std::string& name() const noexcept {
+    return name_;
+  }
+  [[nodiscard]] const std::string& version() const noexcept {
+    return version_;
+  }
+  [[nodiscard]] std::span<const Member> members() const noexcept {
+    return members_;
+  }
+
+  /// Name of the NBIRTH metric that carries this definition ("_types_/<name>")
+  [[nodiscard]] std::string definition_metric_name() const {
+    return std::string(TEMPLATE_DEFINITION_PREFIX) + name_;
+  }
+
+  /**
+   * @brief Fills a protobuf Template with this definition (is_definition = true).
+   */
+  void fill_definition(org::eclipse::tahu::protobuf::Payload::Template& out) const;
+
+  friend bool operator==(const TemplateDefinition& a, const TemplateDefinition& b);
+
+private:
+  std::string name_;
+  std::string version_;
+  std::vector<Member> members_;
+};
+
+/**
+ * @brief Compile-time typed view of a template definition for encoding instances.
+ *
+ * The member types are fixed by the template arguments, so an instance is just a
+ * std::tuple of values in member order. Member names live once in the definition:
+ * the wire encoder references them instead of copying them per instance, and the
+ * protobuf path assigns them into reused metric objects.
+ *
+ * @tparam Ts Member value types, in member order
+ *
+ * @par Example Usage
+ * @code
+ * sparkplug::TemplateLayout<double, bool, int32_t> motor("Motor",
+ *                                                        {"Speed", "Running", "Faults"});
+ * edge_node.register_template(motor.definition());
+ *
+ * sparkplug::PayloadBuilder birth;
+ * birth.add_template_with_alias("Motor1", 30, motor, {1500.0, true, 0});
+ *
+ * // Direct encoding for wire::Encoder payloads
+ * std::vector<uint8_t> instance;
+ * motor.encode_instance_into(instance, {1480.0, true, 2});
+ * encoder.add_metric({.alias = 30,
+ *                     .datatype = sparkplug::DataType::Template,
+ *                     .value = sparkplug::wire::TemplateBytes{instance}});
+ * @endcode
+ */
+template <SparkplugMetricType... Ts>
+class TemplateLayout {
+public:
+  using Values = std::tuple<Ts...>;
+  static constexpr size_t member_count = sizeof...(Ts);
+
+  TemplateLayout(std::string name,
+                 const std::array<std::string_view, sizeof...(Ts)>& member_names,
+                 std::string version = {})
+      : definition_(std::move(name), std::move(version)) {
+    constexpr std::array<DataType, sizeof...(Ts)> types{detail::get_datatype<Ts>()...};
+    for (size_t i = 0; i < sizeof...(Ts); i++) {
+      definition_.add_member(member_names[i], types[i]);
+    }
+  }
+
+  [[nodiscard]] const TemplateDefinition& definition() const noexcept {
+    return definition_;
+  }
+
+  /**
+   * @brief Fills a protobuf Template with an instance of this layout.
+   */
+  void fill_instance(org::eclipse::tahu::protobuf::Payload::Template& out,
+                     const Values& values) const {
+    if (!definition_.version().empty()) {
+      out.set_version(definition_.version());
+    }
+    out.mutable_metrics()->Reserve(static_cast<int>(sizeof...(Ts)));
+    std::apply(
+        [&](const auto&... value) {
+          size_t i = 0;
+          (fill_member(out.add_metrics(), definition_.members()[i++], value), ...);
+        },
+        values);
+    out.set_template_ref(definition_.name());
+    out.set_is_definition(false);
+  }
+
+  /**
+   * @brief Returns the exact encoded size of an instance's Payload.Template message.
+   */
+  [[nodiscard]] size_t instance_size(const Values& values) const noexcept {
+    return encode_instance(values, nullptr);
+  }
+
+  /**
+   * @brief Encodes an instance's Payload.Template message into a reusable vector.
+   *
+   * The bytes are identical to serializing the Template that fill_instance()
+   * produces. Embed them in a wire::Encoder payload with wire::TemplateBytes.
+   */
+  void encode_instance_into(std::vector<uint8_t>& buffer, const Values& values) const {
+    buffer.resize(instance_size(values));
+    encode_instance(values, buffer.data());
+  }
+
+  /**
+   * @brief Encodes an instance into a caller-owned buffer.
+   *
+   * @return Number of bytes written, or an error if the buffer is too small
+   */
+  [[nodiscard]] stdx::expected<size_t, std::string>
+  encode_instance_into(std::span<uint8_t> buffer, const Values& values) const {
+    size_t size = instance_size(values);
+    if (size > buffer.size()) {
+      return stdx::unexpected(std::format(
+          "Buffer too small for template instance: need {} bytes, have {}", size,
+          buffer.size()));
+    }
+    encode_instance(values, buffer.data());
+    return size;
+  }
+
+private:
+  template <typename T>
+  static void fill_member(org::eclipse::tahu::protobuf::Payload::Metric* metric,
+                          const TemplateDefinition::Member& member,
+                          const T& value) {
+    metric->mutable_name()->assign(member.name);
+    metric->set_datatype(std::to_underlying(member.type));
+    detail::set_metric_value(metric, value);
+  }
+
+  static size_t string_field_size(std::string_view value) noexcept {
+    return 1 + wire::varint_size(value.size()) + value.size();
+  }
+
+  static uint8_t*
+  write_string_field(uint8_t* out, uint32_t field, std::string_view value) {
+    out = wire::write_varint(out, wire::make_tag(field, wire::WireType::LengthDelimited));
+    out = wire::write_varint(out, value.size());
+    std::memcpy(out, value.data(), value.size());
+    return out + value.size();
+  }
+
+  // Sizes the instance and, when out is non-null, writes it. Returns the size.
+  size_t encode_instance(const Values& values, uint8_t* out) const noexcept {
+    const auto& version = definition_.version();
+    size_t size = 0;
+    if (!version.empty()) {
+      size += string_field_size(version);
+      if (out) {
+        out = write_string_field(out, wire::template_field::VERSION, version);
+      }
+    }
+    std::apply(
+        [&](const auto&... value) {
+          size_t i = 0;
+          ((size += encode_member(definition_.members()[i++], value, out)), ...);
+        },
+        values);
+    size += string_field_size(definition_.name()) + 2;
+    if (out) {
+      out = write_string_field(out, wire::template_field::TEMPLATE_REF,
+                               definition_.name());
+      out = wire::write_varint(out, wire::make_tag(wire::template_field::IS_DEFINITION,
+                                                   wire::WireType::Varint));
+      *out = 0;
+    }
+    return size;
+  }
+
+  template <typename T>
+  static size_t
+  encode_member(const TemplateDefinition::Member& member, const T& value, uint8_t*& out) {
+    wire::Metric metric{.name = member.name,
+                        .datatype = member.type,
+                        .value = detail::to_wire_value(value)};
+    size_t body = wire::metric_body_size(metric);
+    if (out) {
+      out = wire::write_varint(out, wire::make_tag(wire::template_field::METRICS,
+                                                   wire::WireType::LengthDelimited));
+      out = wire::write_varint(out, body);
+      out = wire::write_metric_body(out, metric);
+    }
+    return 1 + wire::varint_size(body) + body;
+  }
+
+  TemplateDefinition definition_;
+};
+
+} // namespace sparkplug
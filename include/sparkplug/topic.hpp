@@ -3,8 +3,11 @@
 
 #include "detail/compat.hpp"
 
+#include <algorithm>
+#include <cstddef>
 #include <string>
 #include <string_view>
+#include <utility>
 
 namespace sparkplug {
 
@@ -32,6 +35,101 @@ enum class MessageType {
   STATE   ///< Primary Application State (not part of spBv1.0 namespace)
 };
 
+/**
+ * @brief Returns the topic token for a message type (e.g., "NBIRTH").
+ */
+[[nodiscard]] constexpr std::string_view message_type_name(MessageType type) noexcept {
+  switch (type) {
+  case MessageType::NBIRTH:
+    return "NBIRTH";
+  case MessageType::NDEATH:
+    return "NDEATH";
+  case MessageType::DBIRTH:
+    return "DBIRTH";
+  case MessageType::DDEATH:
+    return "DDEATH";
+  case MessageType::NDATA:
+    return "NDATA";
+  case MessageType::DDATA:
+    return "DDATA";
+  case MessageType::NCMD:
+    return "NCMD";
+  case MessageType::DCMD:
+    return "DCMD";
+  case MessageType::STATE:
+    return "STATE";
+  }
+  std::unreachable();
+}
+
+struct Topic;
+
+/**
+ * @brief Non-owning parsed Sparkplug B MQTT topic.
+ *
+ * Same fields as Topic, but as views into the parsed topic string, so parsing does
+ * not allocate. Used on the receive path, where the topic string is the MQTT
+ * message buffer; the view is only valid while that string is.
+ *
+ * @par Example
+ * @code
+ * auto view = sparkplug::TopicView::parse(topic_str);
+ * if (view && view->message_type == sparkplug::MessageType::NDATA) {
+ *   handle(view->group_id, view->edge_node_id);
+ * }
+ * @endcode
+ */
+struct TopicView {
+  std::string_view group_id;     ///< Group ID (topic namespace)
+  MessageType message_type;      ///< Message type (NBIRTH, NDATA, etc.)
+  std::string_view edge_node_id; ///< Edge node identifier (host_id for STATE)
+  std::string_view device_id;    ///< Device identifier (empty for node-level messages)
+
+  /**
+   * @brief Copies the viewed fields into an owning Topic.
+   */
+  [[nodiscard]] Topic to_topic() const;
+
+  /**
+   * @brief Writes the topic string to out without allocating.
+   *
+   * Writes exactly formatted_size() characters, the same as Topic::to_string().
+   *
+   * @param out Output iterator (e.g., a char buffer or std::back_inserter)
+   *
+   * @return Iterator past the last character written
+   *
+   * @par Example
+   * @code
+   * std::array<char, 256> buffer;
+   * if (view.formatted_size() <= buffer.size()) {
+   *   auto* end = view.format_to(buffer.data());
+   *   publish(std::string_view(buffer.data(), end));
+   * }
+   * @endcode
+   */
+  template <typename OutputIt>
+  OutputIt format_to(OutputIt out) const;
+
+  /**
+   * @brief Returns the length of the topic string.
+   */
+  [[nodiscard]] size_t formatted_size() const noexcept;
+
+  /**
+   * @brief Parses a Sparkplug B topic string without copying it.
+   *
+   * Accepts and rejects exactly the same topics as Topic::parse(), with the same
+   * error messages.
+   *
+   * @param topic_str Topic string to parse; must outlive the returned view
+   *
+   * @return Parsed view on success, error message on failure
+   */
+  [[nodiscard]] static stdx::expected<TopicView, std::string>
+  parse(std::string_view topic_str);
+};
+
 /**
  * @brief Represents a parsed Sparkplug B MQTT topic.
  *
@@ -59,6 +157,26 @@ struct Topic {
    */
   [[nodiscard]] std::string to_string() const;
 
+  /**
+   * @brief Writes the topic string to out without allocating.
+   *
+   * @see TopicView::format_to()
+   */
+  template <typename OutputIt>
+  OutputIt format_to(OutputIt out) const {
+    return TopicView(*this).format_to(std::move(out));
+  }
+
+  /**
+   * @brief Returns a view of this topic's fields, valid while the topic is.
+   */
+  operator TopicView() const noexcept {
+    return {.group_id = group_id,
+            .message_type = message_type,
+            .edge_node_id = edge_node_id,
+            .device_id = device_id};
+  }
+
   /**
    * @brief Parses a Sparkplug B topic string.
    *
@@ -79,4 +197,29 @@ struct Topic {
   parse(std::string_view topic_str);
 };
 
+template <typename OutputIt>
+OutputIt TopicView::format_to(OutputIt out) const {
+  auto append = [&out](std::string_view part) {
+    out = std::ranges::copy(part, std::move(out)).out;
+  };
+  append(NAMESPACE);
+  *out++ = '/';
+  if (message_type == MessageType::STATE) {
+    append("STATE/");
+    append(edge_node_id);
+    return out;
+  }
+
+  append(group_id);
+  *out++ = '/';
+  append(message_type_name(message_type));
+  *out++ = '/';
+  append(edge_node_id);
+  if (!device_id.empty()) {
+    *out++ = '/';
+    append(device_id);
+  }
+  return out;
+}
+
 } // namespace sparkplug
\ No newline at end of file
@@ -0,0 +1,452 @@
+// include/sparkplug/wire.hpp
+#pragma once
+
+#include "datatype.hpp"
+#include "detail/compat.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+/**
+ * @brief Direct access to the Sparkplug B protobuf wire format.
+ *
+ * The functions and types in this namespace read and write the Payload/Metric wire
+ * format declared in proto/sparkplug_b.proto without going through libprotobuf
+ * message objects. Output is byte-identical to Message::SerializeToArray().
+ */
+namespace sparkplug::wire {
+
+/**
+ * @brief Protobuf wire types used by the Sparkplug B payload.
+ */
+enum class WireType : uint8_t {
+  Varint = 0,
+  Fixed64 = 1,
+  LengthDelimited = 2,
+  Fixed32 = 5,
+};
+
+/**
+ * @brief Field numbers of the Payload message.
+ */
+namespace payload_field {
+inline constexpr uint32_t TIMESTAMP = 1;
+inline constexpr uint32_t METRICS = 2;
+inline constexpr uint32_t SEQ = 3;
+inline constexpr uint32_t UUID = 4;
+inline constexpr uint32_t BODY = 5;
+} // namespace payload_field
+
+/**
+ * @brief Field numbers of the Payload.Metric message.
+ */
+namespace metric_field {
+inline constexpr uint32_t NAME = 1;
+inline constexpr uint32_t ALIAS = 2;
+inline constexpr uint32_t TIMESTAMP = 3;
+inline constexpr uint32_t DATATYPE = 4;
+inline constexpr uint32_t IS_HISTORICAL = 5;
+inline constexpr uint32_t IS_TRANSIENT = 6;
+inline constexpr uint32_t IS_NULL = 7;
+inline constexpr uint32_t METADATA = 8;
+inline constexpr uint32_t PROPERTIES = 9;
+inline constexpr uint32_t INT_VALUE = 10;
+inline constexpr uint32_t LONG_VALUE = 11;
+inline constexpr uint32_t FLOAT_VALUE = 12;
+inline constexpr uint32_t DOUBLE_VALUE = 13;
+inline constexpr uint32_t BOOLEAN_VALUE = 14;
+inline constexpr uint32_t STRING_VALUE = 15;
+inline constexpr uint32_t BYTES_VALUE = 16;
+inline constexpr uint32_t DATASET_VALUE = 17;
+inline constexpr uint32_t TEMPLATE_VALUE = 18;
+} // namespace metric_field
+
+/**
+ * @brief Field numbers of the Payload.DataSet message and its nested messages.
+ */
+namespace dataset_field {
+inline constexpr uint32_t NUM_OF_COLUMNS = 1;
+inline constexpr uint32_t COLUMNS = 2;
+inline constexpr uint32_t TYPES = 3;
+inline constexpr uint32_t ROWS = 4;
+inline constexpr uint32_t ROW_ELEMENTS = 1; // Row.elements
+} // namespace dataset_field
+
+/**
+ * @brief Field numbers of the Payload.DataSet.DataSetValue oneof.
+ */
+namespace dataset_value_field {
+inline constexpr uint32_t INT_VALUE = 1;
+inline constexpr uint32_t LONG_VALUE = 2;
+inline constexpr uint32_t FLOAT_VALUE = 3;
+inline constexpr uint32_t DOUBLE_VALUE = 4;
+inline constexpr uint32_t BOOLEAN_VALUE = 5;
+inline constexpr uint32_t STRING_VALUE = 6;
+} // namespace dataset_value_field
+
+/**
+ * @brief Field numbers of the Payload.Template message.
+ */
+namespace template_field {
+inline constexpr uint32_t VERSION = 1;
+inline constexpr uint32_t METRICS = 2;
+inline constexpr uint32_t PARAMETERS = 3;
+inline constexpr uint32_t TEMPLATE_REF = 4;
+inline constexpr uint32_t IS_DEFINITION = 5;
+} // namespace template_field
+
+/**
+ * @brief Returns the encoded field key (tag) for a field number and wire type.
+ */
+[[nodiscard]] constexpr uint64_t make_tag(uint32_t field, WireType type) noexcept {
+  return (static_cast<uint64_t>(field) << 3) | static_cast<uint64_t>(type);
+}
+
+/**
+ * @brief Returns the number of bytes needed to encode a value as a varint (1-10).
+ */
+[[nodiscard]] constexpr size_t varint_size(uint64_t value) noexcept {
+  return static_cast<size_t>((std::bit_width(value | 1) + 6) / 7);
+}
+
+/**
+ * @brief Writes a varint and returns the position just past it.
+ */
+inline uint8_t* write_varint(uint8_t* out, uint64_t value) noexcept {
+  while (value >= 0x80) {
+    *out++ = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  *out++ = static_cast<uint8_t>(value);
+  return out;
+}
+
+/**
+ * @brief Writes a 32-bit little-endian value and returns the position just past it.
+ */
+inline uint8_t* write_fixed32(uint8_t* out, uint32_t value) noexcept {
+  for (int i = 0; i < 4; i++) {
+    out[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+  return out + 4;
+}
+
+/**
+ * @brief Writes a 64-bit little-endian value and returns the position just past it.
+ */
+inline uint8_t* write_fixed64(uint8_t* out, uint64_t value) noexcept {
+  for (int i = 0; i < 8; i++) {
+    out[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+  return out + 8;
+}
+
+/**
+ * @brief Bounds-checked forward reader over protobuf wire-format bytes.
+ *
+ * Every read returns std::nullopt (or false) on truncated or malformed input instead
+ * of reading past the end, so untrusted MQTT payloads can be walked safely.
+ *
+ * @par Example Usage
+ * @code
+ * sparkplug::wire::Reader reader(bytes);
+ * while (auto tag = reader.read_tag()) {
+ *   if (tag->field == 3 && tag->type == sparkplug::wire::WireType::Varint) {
+ *     seq = reader.read_varint();
+ *   } else if (!reader.skip(tag->type)) {
+ *     break;
+ *   }
+ * }
+ * @endcode
+ */
+class Reader {
+public:
+  struct Tag {
+    uint32_t field;
+    WireType type;
+  };
+
+  Reader() = default;
+  explicit Reader(std::span<const uint8_t> data) noexcept
+      : pos_(data.data()), end_(data.data() + data.size()) {
+  }
+
+  [[nodiscard]] bool done() const noexcept {
+    return pos_ == end_;
+  }
+
+  /// Number of unread bytes
+  [[nodiscard]] size_t remaining() const noexcept {
+    return static_cast<size_t>(end_ - pos_);
+  }
+
+  /// Current read position
+  [[nodiscard]] const uint8_t* position() const noexcept {
+    return pos_;
+  }
+
+  [[nodiscard]] std::optional<uint64_t> read_varint() noexcept {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64 && pos_ != end_; shift += 7) {
+      uint8_t byte = *pos_++;
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) {
+        return value;
+      }
+    }
+    return std::nullopt;
+  }
+
+  /// Reads the next field key; std::nullopt at the end of input or on a bad key
+  [[nodiscard]] std::optional<Tag> read_tag() noexcept {
+    if (pos_ == end_) {
+      return std::nullopt;
+    }
+    // Single-byte keys (fields 1-15) are by far the most common
+    uint64_t key = *pos_;
+    if (key < 0x80) {
+      ++pos_;
+    } else if (auto varint = read_varint()) {
+      key = *varint;
+    } else {
+      return std::nullopt;
+    }
+    auto field = static_cast<uint32_t>(key >> 3);
+    if (field == 0 || key > 0xFFFFFFFFULL) {
+      return std::nullopt;
+    }
+    return Tag{field, static_cast<WireType>(key & 0x7)};
+  }
+
+  [[nodiscard]] std::optional<uint32_t> read_fixed32() noexcept {
+    if (remaining() < 4) {
+      return std::nullopt;
+    }
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+      value |= static_cast<uint32_t>(pos_[i]) << (8 * i);
+    }
+    pos_ += 4;
+    return value;
+  }
+
+  [[nodiscard]] std::optional<uint64_t> read_fixed64() noexcept {
+    if (remaining() < 8) {
+      return std::nullopt;
+    }
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+      value |= static_cast<uint64_t>(pos_[i]) << (8 * i);
+    }
+    pos_ += 8;
+    return value;
+  }
+
+  /// Reads a length-delimited field's contents (string, bytes or nested message)
+  [[nodiscard]] std::optional<std::span<const uint8_t>> read_bytes() noexcept {
+    auto length = read_varint();
+    if (!length || *length > remaining()) {
+      return std::nullopt;
+    }
+    std::span<const uint8_t> bytes(pos_, static_cast<size_t>(*length));
+    pos_ += *length;
+    return bytes;
+  }
+
+  [[nodiscard]] std::optional<std::string_view> read_string() noexcept {
+    auto bytes = read_bytes();
+    if (!bytes) {
+      return std::nullopt;
+    }
+    return std::string_view(reinterpret_cast<const char*>(bytes->data()), bytes->size());
+  }
+
+  /// Skips the value of a field whose key was just read
+  [[nodiscard]] bool skip(WireType type) noexcept {
+    switch (type) {
+    case WireType::Varint:
+      return read_varint().has_value();
+    case WireType::Fixed64:
+      return read_fixed64().has_value();
+    case WireType::LengthDelimited:
+      return read_bytes().has_value();
+    case WireType::Fixed32:
+      return read_fixed32().has_value();
+    }
+    return false; // Groups (3, 4) are not used by Sparkplug B
+  }
+
+private:
+  const uint8_t* pos_{nullptr};
+  const uint8_t* end_{nullptr};
+};
+
+/**
+ * @brief Raw bytes for the Metric.bytes_value field (Bytes, File and array types).
+ */
+struct Bytes {
+  std::span<const uint8_t> data;
+};
+
+/**
+ * @brief Pre-encoded Payload.DataSet message for the Metric.dataset_value field.
+ *
+ * @see DataSetBuilder::encode_into()
+ */
+struct DataSetBytes {
+  std::span<const uint8_t> data;
+};
+
+/**
+ * @brief Pre-encoded Payload.Template message for the Metric.template_value field.
+ *
+ * @see TemplateLayout::encode_instance_into()
+ */
+struct TemplateBytes {
+  std::span<const uint8_t> data;
+};
+
+/**
+ * @brief Value of a scalar metric, one alternative per Metric.value oneof field.
+ *
+ * - uint32_t: int_value (Int8/16/32, UInt8/16/32; signed values are stored as their
+ *   two's complement uint32 representation, as protobuf does)
+ * - uint64_t: long_value (Int64, UInt64, DateTime)
+ * - float, double, bool, std::string_view: float/double/boolean/string_value
+ * - Bytes: bytes_value
+ * - DataSetBytes: dataset_value (already encoded)
+ * - TemplateBytes: template_value (already encoded)
+ * - std::monostate: no value
+ */
+using MetricValue = std::variant<std::monostate,
+                                 uint32_t,
+                                 uint64_t,
+                                 float,
+                                 double,
+                                 bool,
+                                 std::string_view,
+                                 Bytes,
+                                 DataSetBytes,
+                                 TemplateBytes>;
+
+/**
+ * @brief Non-owning description of a scalar metric to encode.
+ *
+ * Unset optional fields are omitted from the wire, exactly like unset protobuf fields.
+ * An empty name is omitted as well (alias-only DATA metrics).
+ */
+struct Metric {
+  std::string_view name{};
+  std::optional<uint64_t> alias{};
+  std::optional<uint64_t> timestamp{};
+  std::optional<DataType> datatype{};
+  std::optional<bool> is_historical{};
+  std::optional<bool> is_transient{};
+  std::optional<bool> is_null{};
+  MetricValue value{};
+};
+
+/**
+ * @brief Returns the encoded size of a metric's body (excluding its tag and length).
+ */
+[[nodiscard]] size_t metric_body_size(const Metric& metric) noexcept;
+
+/**
+ * @brief Writes a metric's body (excluding its tag and length).
+ *
+ * @return Position just past the written bytes
+ */
+uint8_t* write_metric_body(uint8_t* out, const Metric& metric) noexcept;
+
+/**
+ * @brief Returns the encoded size of a metric inside a Payload (tag, length and body).
+ */
+[[nodiscard]] inline size_t metric_field_size(size_t body_size) noexcept {
+  return 1 + varint_size(body_size) + body_size;
+}
+
+/**
+ * @brief Purpose-built Sparkplug B payload encoder for scalar metrics.
+ *
+ * The encoder keeps non-owning metric descriptions and a running encoded size, so the
+ * exact payload size is known before any byte is written. encode_into() then writes the
+ * payload in a single forward pass, without building protobuf message objects.
+ *
+ * Metric names and string/bytes values are referenced, not copied: they must outlive
+ * the encode call.
+ *
+ * @par Example Usage
+ * @code
+ * sparkplug::wire::Encoder encoder;
+ * encoder.set_timestamp(now_ms).set_seq(seq);
+ * encoder.add_metric({.alias = 1, .timestamp = now_ms,
+ *                     .datatype = sparkplug::DataType::Double, .value = 20.5});
+ * encoder.encode_into(buffer);
+ * @endcode
+ */
+class Encoder {
+public:
+  /**
+   * @brief Sets the payload-level timestamp.
+   */
+  Encoder& set_timestamp(uint64_t timestamp) noexcept;
+
+  /**
+   * @brief Sets the payload sequence number.
+   */
+  Encoder& set_seq(uint64_t seq) noexcept;
+
+  /**
+   * @brief Appends a metric and adds its encoded size to the running total.
+   */
+  Encoder& add_metric(const Metric& metric);
+
+  /**
+   * @brief Removes all metrics, the timestamp and seq (capacity is kept).
+   */
+  void clear() noexcept;
+
+  /**
+   * @brief Returns the number of metrics added so far.
+   */
+  [[nodiscard]] size_t metric_count() const noexcept {
+    return metrics_.size();
+  }
+
+  /**
+   * @brief Returns the exact size of the encoded payload.
+   */
+  [[nodiscard]] size_t encoded_size() const noexcept;
+
+  /**
+   * @brief Encodes the payload into a reusable vector (resized to encoded_size()).
+   */
+  void encode_into(std::vector<uint8_t>& buffer) const;
+
+  /**
+   * @brief Encodes the payload into a caller-owned buffer.
+   *
+   * @return Number of bytes written, or an error if the buffer is too small
+   */
+  [[nodiscard]] stdx::expected<size_t, std::string>
+  encode_into(std::span<uint8_t> buffer) const;
+
+private:
+  uint8_t* write(uint8_t* out) const noexcept;
+
+  std::optional<uint64_t> timestamp_;
+  std::optional<uint64_t> seq_;
+  std::vector<Metric> metrics_;
+  std::vector<size_t> body_sizes_;
+  size_t metrics_size_{0}; // Encoded size of all metric fields
+};
+
+} // namespace sparkplug::wire
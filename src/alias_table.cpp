@@ -0,0 +1,82 @@
+// src/alias_table.cpp
+#include "sparkplug/alias_table.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace sparkplug {
+
+std::string_view StringPool::intern(std::string_view str) {
+  if (auto it = strings_.find(str); it != strings_.end()) {
+    return *it;
+  }
+
+  char* storage = nullptr;
+  if (str.size() > BLOCK_SIZE / 4) {
+    // Large strings get a block of their own; the open block stays in use
+    large_blocks_.push_back(std::make_unique<char[]>(str.size()));
+    block_bytes_ += str.size();
+    storage = large_blocks_.back().get();
+  } else {
+    if (blocks_.empty() || block_used_ + str.size() > BLOCK_SIZE) {
+      blocks_.push_back(std::make_unique<char[]>(BLOCK_SIZE));
+      block_bytes_ += BLOCK_SIZE;
+      block_used_ = 0;
+    }
+    storage = blocks_.back().get() + block_used_;
+    block_used_ += str.size();
+  }
+
+  std::memcpy(storage, str.data(), str.size());
+  std::string_view pooled(storage, str.size());
+  strings_.insert(pooled);
+  return pooled;
+}
+
+size_t StringPool::memory_bytes() const noexcept {
+  return block_bytes_ +
+         (blocks_.capacity() + large_blocks_.capacity()) *
+             sizeof(std::unique_ptr<char[]>) +
+         strings_.size() * (sizeof(void*) + sizeof(std::string_view) + sizeof(size_t)) +
+         strings_.bucket_count() * sizeof(void*);
+}
+
+void AliasTable::reset(size_t expected_aliases) noexcept {
+  dense_.clear();
+  sparse_.clear();
+  dense_limit_ = std::max(MIN_DENSE_ALIASES, 2 * expected_aliases);
+  size_ = 0;
+}
+
+void AliasTable::insert(uint64_t alias, std::string_view name) {
+  if (name.data() == nullptr) {
+    name = std::string_view("", 0); // Keep null data() as the unmapped marker
+  }
+
+  if (alias < dense_limit_) {
+    if (alias >= dense_.size()) {
+      dense_.resize(alias + 1);
+    }
+    if (dense_[alias].data() == nullptr) {
+      size_++;
+    }
+    dense_[alias] = name;
+    return;
+  }
+
+  auto [it, inserted] = sparse_.insert_or_assign(alias, name);
+  (void)it;
+  if (inserted) {
+    size_++;
+  }
+}
+
+size_t AliasTable::memory_bytes() const noexcept {
+  // Hash map nodes hold a next pointer plus the key/value pair
+  return dense_.capacity() * sizeof(std::string_view) +
+         sparse_.size() *
+             (sizeof(void*) + sizeof(std::pair<const uint64_t, std::string_view>)) +
+         sparse_.bucket_count() * sizeof(void*);
+}
+
+} // namespace sparkplug
@@ -0,0 +1,39 @@
+// src/clock.cpp
+#include "sparkplug/clock.hpp"
+
+#include <chrono>
+#include <ctime>
+
+namespace sparkplug {
+
+namespace {
+
+uint64_t system_now_ms() {
+  auto now = std::chrono::system_clock::now();
+  return std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch())
+      .count();
+}
+
+} // namespace
+
+uint64_t Clock::now_ms() const {
+  switch (source_) {
+  case Source::Coarse: {
+#ifdef CLOCK_REALTIME_COARSE
+    timespec ts{};
+    if (clock_gettime(CLOCK_REALTIME_COARSE, &ts) == 0) {
+      return static_cast<uint64_t>(ts.tv_sec) * 1000 +
+             static_cast<uint64_t>(ts.tv_nsec) / 1'000'000;
+    }
+#endif
+    return system_now_ms();
+  }
+  case Source::Custom:
+    return now_ms_ ? now_ms_() : system_now_ms();
+  case Source::System:
+    break;
+  }
+  return system_now_ms();
+}
+
+} // namespace sparkplug
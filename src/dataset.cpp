@@ -0,0 +1,447 @@
+// src/dataset.cpp
+#include "sparkplug/dataset.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace sparkplug {
+
+namespace {
+
+using DataSetMessage = org::eclipse::tahu::protobuf::Payload::DataSet;
+
+// A decoded DataSetValue before it is stored in its typed column (bools as 0/1)
+using CellValue = std::variant<std::monostate, uint64_t, float, double, std::string_view>;
+
+stdx::expected<CellValue, std::string> decode_cell(std::span<const uint8_t> bytes) {
+  wire::Reader reader(bytes);
+  CellValue value;
+  while (auto tag = reader.read_tag()) {
+    std::optional<CellValue> field_value;
+    switch (tag->field) {
+    case wire::dataset_value_field::INT_VALUE:
+    case wire::dataset_value_field::LONG_VALUE:
+    case wire::dataset_value_field::BOOLEAN_VALUE:
+      if (tag->type == wire::WireType::Varint) {
+        if (auto varint = reader.read_varint()) {
+          field_value = *varint;
+        }
+      }
+      break;
+    case wire::dataset_value_field::FLOAT_VALUE:
+      if (tag->type == wire::WireType::Fixed32) {
+        if (auto bits = reader.read_fixed32()) {
+          field_value = std::bit_cast<float>(*bits);
+        }
+      }
+      break;
+    case wire::dataset_value_field::DOUBLE_VALUE:
+      if (tag->type == wire::WireType::Fixed64) {
+        if (auto bits = reader.read_fixed64()) {
+          field_value = std::bit_cast<double>(*bits);
+        }
+      }
+      break;
+    case wire::dataset_value_field::STRING_VALUE:
+      if (tag->type == wire::WireType::LengthDelimited) {
+        if (auto str = reader.read_string()) {
+          field_value = *str;
+        }
+      }
+      break;
+    default:
+      if (!reader.skip(tag->type)) {
+        return stdx::unexpected("Malformed DataSet cell");
+      }
+      continue;
+    }
+    if (!field_value) {
+      return stdx::unexpected("Malformed DataSet cell");
+    }
+    value = *field_value; // Last oneof member wins, as in protobuf
+  }
+  if (!reader.done()) {
+    return stdx::unexpected("Malformed DataSet cell");
+  }
+  return value;
+}
+
+CellValue cell_value(const DataSetMessage::DataSetValue& cell) {
+  switch (cell.value_case()) {
+  case DataSetMessage::DataSetValue::kIntValue:
+    return static_cast<uint64_t>(cell.int_value());
+  case DataSetMessage::DataSetValue::kLongValue:
+    return cell.long_value();
+  case DataSetMessage::DataSetValue::kFloatValue:
+    return cell.float_value();
+  case DataSetMessage::DataSetValue::kDoubleValue:
+    return cell.double_value();
+  case DataSetMessage::DataSetValue::kBooleanValue:
+    return static_cast<uint64_t>(cell.boolean_value());
+  case DataSetMessage::DataSetValue::kStringValue:
+    return std::string_view(cell.string_value());
+  default:
+    return std::monostate{};
+  }
+}
+
+} // namespace
+
+// DataSetBuilder
+
+stdx::expected<void, std::string> DataSetBuilder::add_column(Column column) {
+  if (!columns_.empty() && column.rows != num_rows()) {
+    return stdx::unexpected(std::format("Column '{}' has {} rows, expected {}",
+                                        column.name, column.rows, num_rows()));
+  }
+  columns_.push_back(std::move(column));
+  return {};
+}
+
+void DataSetBuilder::clear() noexcept {
+  columns_.clear();
+}
+
+size_t DataSetBuilder::row_size(size_t row) const noexcept {
+  size_t size = 0;
+  for (const auto& column : columns_) {
+    size += column.cell_size(column.data, row);
+  }
+  return size;
+}
+
+void DataSetBuilder::write(uint8_t* out) const noexcept {
+  using wire::WireType;
+
+  out = wire::write_varint(out, wire::make_tag(wire::dataset_field::NUM_OF_COLUMNS,
+                                               WireType::Varint));
+  out = wire::write_varint(out, columns_.size());
+  for (const auto& column : columns_) {
+    out = wire::write_varint(
+        out, wire::make_tag(wire::dataset_field::COLUMNS, WireType::LengthDelimited));
+    out = wire::write_varint(out, column.name.size());
+    std::memcpy(out, column.name.data(), column.name.size());
+    out += column.name.size();
+  }
+  for (const auto& column : columns_) {
+    out = wire::write_varint(
+        out, wire::make_tag(wire::dataset_field::TYPES, WireType::Varint));
+    out = wire::write_varint(out, std::to_underlying(column.type));
+  }
+  // Row sizes are recomputed rather than kept from encoded_size(), which stays const
+  for (size_t r = 0; r < num_rows(); r++) {
+    out = wire::write_varint(
+        out, wire::make_tag(wire::dataset_field::ROWS, WireType::LengthDelimited));
+    out = wire::write_varint(out, row_size(r));
+    for (const auto& column : columns_) {
+      out = column.write_cell(out, column.data, r);
+    }
+  }
+}
+
+size_t DataSetBuilder::encoded_size() const {
+  size_t size = 1 + wire::varint_size(columns_.size());
+  for (const auto& column : columns_) {
+    size += 1 + wire::varint_size(column.name.size()) + column.name.size();
+    size += 1 + wire::varint_size(std::to_underlying(column.type));
+  }
+  for (size_t r = 0; r < num_rows(); r++) {
+    const size_t row = row_size(r);
+    size += 1 + wire::varint_size(row) + row;
+  }
+  return size;
+}
+
+void DataSetBuilder::encode_into(std::vector<uint8_t>& buffer) const {
+  buffer.resize(encoded_size());
+  write(buffer.data());
+}
+
+void DataSetBuilder::encode_into(std::string& buffer) const {
+  buffer.resize(encoded_size());
+  write(reinterpret_cast<uint8_t*>(buffer.data()));
+}
+
+stdx::expected<size_t, std::string>
+DataSetBuilder::encode_into(std::span<uint8_t> buffer) const {
+  size_t size = encoded_size();
+  if (size > buffer.size()) {
+    return stdx::unexpected(std::format(
+        "Buffer too small for DataSet: need {} bytes, have {}", size, buffer.size()));
+  }
+  write(buffer.data());
+  return size;
+}
+
+void DataSetBuilder::fill(DataSetMessage& dataset) const {
+  const size_t rows = num_rows();
+  const int cols = static_cast<int>(columns_.size());
+
+  dataset.set_num_of_columns(columns_.size());
+  dataset.mutable_columns()->Reserve(cols);
+  dataset.mutable_types()->Reserve(cols);
+  for (const auto& column : columns_) {
+    dataset.add_columns(column.name);
+    dataset.add_types(std::to_underlying(column.type));
+  }
+
+  dataset.mutable_rows()->Reserve(static_cast<int>(rows));
+  for (size_t r = 0; r < rows; r++) {
+    auto* row = dataset.add_rows();
+    row->mutable_elements()->Reserve(cols);
+    for (const auto& column : columns_) {
+      column.set_cell(row->add_elements(), column.data, r);
+    }
+  }
+}
+
+// DataSetView
+
+stdx::expected<DataSetView::Cells, std::string> DataSetView::make_cells(DataType type,
+                                                                        size_t rows) {
+  switch (type) {
+  case DataType::Int8:
+    return std::vector<int8_t>(rows);
+  case DataType::Int16:
+    return std::vector<int16_t>(rows);
+  case DataType::Int32:
+    return std::vector<int32_t>(rows);
+  case DataType::Int64:
+    return std::vector<int64_t>(rows);
+  case DataType::UInt8:
+    return std::vector<uint8_t>(rows);
+  case DataType::UInt16:
+    return std::vector<uint16_t>(rows);
+  case DataType::UInt32:
+    return std::vector<uint32_t>(rows);
+  case DataType::UInt64:
+    return std::vector<uint64_t>(rows);
+  case DataType::Float:
+    return std::vector<float>(rows);
+  case DataType::Double:
+    return std::vector<double>(rows);
+  case DataType::Boolean:
+    return BoolColumn{.data = std::make_unique<bool[]>(rows), .size = rows};
+  case DataType::String:
+  case DataType::Text:
+  case DataType::UUID:
+    return std::vector<std::string_view>(rows);
+  case DataType::DateTime:
+    return std::vector<DateTime>(rows);
+  default:
+    return stdx::unexpected(
+        std::format("Unsupported DataSet column type {}", std::to_underlying(type)));
+  }
+}
+
+namespace {
+
+// Stores a decoded cell into its typed column; false if the value kind does not fit
+template <typename Cells, typename BoolColumn>
+bool store_cell(Cells& cells, size_t row, const CellValue& value) {
+  if (std::holds_alternative<std::monostate>(value)) {
+    return true; // Empty cell keeps the zero value
+  }
+  return std::visit(
+      [row, &value](auto& column) -> bool {
+        using C = std::decay_t<decltype(column)>;
+        if constexpr (std::is_same_v<C, BoolColumn>) {
+          if (const auto* v = std::get_if<uint64_t>(&value)) {
+            column.data[row] = *v != 0;
+            return true;
+          }
+          return false;
+        } else {
+          using T = typename C::value_type;
+          if constexpr (std::is_same_v<T, std::string_view> || std::is_same_v<T, float> ||
+                        std::is_same_v<T, double>) {
+            if (const auto* v = std::get_if<T>(&value)) {
+              column[row] = *v;
+              return true;
+            }
+          } else if constexpr (std::is_same_v<T, DateTime>) {
+            if (const auto* v = std::get_if<uint64_t>(&value)) {
+              column[row] = DateTime(std::chrono::milliseconds(static_cast<int64_t>(*v)));
+              return true;
+            }
+          } else {
+            if (const auto* v = std::get_if<uint64_t>(&value)) {
+              column[row] = static_cast<T>(*v);
+              return true;
+            }
+          }
+          return false;
+        }
+      },
+      cells);
+}
+
+} // namespace
+
+stdx::expected<DataSetView, std::string>
+DataSetView::parse(std::span<const uint8_t> bytes) {
+  std::optional<uint64_t> num_of_columns;
+  std::vector<std::string_view> names;
+  std::vector<uint32_t> types;
+  std::vector<std::span<const uint8_t>> rows;
+
+  // First pass: header fields and row boundaries
+  wire::Reader reader(bytes);
+  while (auto tag = reader.read_tag()) {
+    bool ok = false;
+    if (tag->field == wire::dataset_field::NUM_OF_COLUMNS &&
+        tag->type == wire::WireType::Varint) {
+      num_of_columns = reader.read_varint();
+      ok = num_of_columns.has_value();
+    } else if (tag->field == wire::dataset_field::COLUMNS &&
+               tag->type == wire::WireType::LengthDelimited) {
+      auto name = reader.read_string();
+      ok = name.has_value();
+      if (ok) {
+        names.push_back(*name);
+      }
+    } else if (tag->field == wire::dataset_field::TYPES &&
+               tag->type == wire::WireType::Varint) {
+      auto type = reader.read_varint();
+      ok = type.has_value();
+      if (ok) {
+        types.push_back(static_cast<uint32_t>(*type));
+      }
+    } else if (tag->field == wire::dataset_field::TYPES &&
+               tag->type == wire::WireType::LengthDelimited) {
+      // Packed encoding, accepted by protobuf parsers for repeated scalars
+      auto packed = reader.read_bytes();
+      ok = packed.has_value();
+      if (ok) {
+        wire::Reader packed_reader(*packed);
+        while (ok && !packed_reader.done()) {
+          auto type = packed_reader.read_varint();
+          ok = type.has_value();
+          if (ok) {
+            types.push_back(static_cast<uint32_t>(*type));
+          }
+        }
+      }
+    } else if (tag->field == wire::dataset_field::ROWS &&
+               tag->type == wire::WireType::LengthDelimited) {
+      auto row = reader.read_bytes();
+      ok = row.has_value();
+      if (ok) {
+        rows.push_back(*row);
+      }
+    } else {
+      ok = reader.skip(tag->type);
+    }
+    if (!ok) {
+      return stdx::unexpected("Malformed DataSet");
+    }
+  }
+  if (!reader.done()) {
+    return stdx::unexpected("Malformed DataSet");
+  }
+  if (names.size() != types.size() ||
+      (num_of_columns && *num_of_columns != names.size())) {
+    return stdx::unexpected(std::format("DataSet declares {} columns, {} names, {} types",
+                                        num_of_columns.value_or(names.size()),
+                                        names.size(), types.size()));
+  }
+
+  DataSetView view;
+  view.num_rows_ = rows.size();
+  view.columns_.reserve(names.size());
+  for (size_t c = 0; c < names.size(); c++) {
+    auto type = static_cast<DataType>(types[c]);
+    auto cells = make_cells(type, rows.size());
+    if (!cells) {
+      return stdx::unexpected(cells.error());
+    }
+    view.columns_.push_back(
+        Column{.name = names[c], .type = type, .cells = std::move(*cells)});
+  }
+
+  // Second pass: decode every cell straight into its column
+  for (size_t r = 0; r < rows.size(); r++) {
+    wire::Reader row_reader(rows[r]);
+    size_t c = 0;
+    while (auto tag = row_reader.read_tag()) {
+      if (tag->field != wire::dataset_field::ROW_ELEMENTS ||
+          tag->type != wire::WireType::LengthDelimited) {
+        if (!row_reader.skip(tag->type)) {
+          return stdx::unexpected(std::format("Malformed DataSet row {}", r));
+        }
+        continue;
+      }
+      auto cell_bytes = row_reader.read_bytes();
+      if (!cell_bytes || c >= view.columns_.size()) {
+        return stdx::unexpected(std::format("Malformed DataSet row {}", r));
+      }
+      auto value = decode_cell(*cell_bytes);
+      if (!value) {
+        return stdx::unexpected(value.error());
+      }
+      if (!store_cell<Cells, BoolColumn>(view.columns_[c].cells, r, *value)) {
+        return stdx::unexpected(std::format("DataSet cell ({}, {}) does not match column "
+                                            "type {}",
+                                            r, c,
+                                            std::to_underlying(view.columns_[c].type)));
+      }
+      c++;
+    }
+    if (!row_reader.done() || c != view.columns_.size()) {
+      return stdx::unexpected(std::format("DataSet row {} has {} cells, expected {}",
+                                          r, c, view.columns_.size()));
+    }
+  }
+  return view;
+}
+
+stdx::expected<DataSetView, std::string>
+DataSetView::from(const DataSetMessage& dataset) {
+  if (dataset.columns_size() != dataset.types_size()) {
+    return stdx::unexpected(std::format("DataSet has {} column names but {} types",
+                                        dataset.columns_size(), dataset.types_size()));
+  }
+
+  DataSetView view;
+  view.num_rows_ = static_cast<size_t>(dataset.rows_size());
+  view.columns_.reserve(dataset.columns_size());
+  for (int c = 0; c < dataset.columns_size(); c++) {
+    auto type = static_cast<DataType>(dataset.types(c));
+    auto cells = make_cells(type, view.num_rows_);
+    if (!cells) {
+      return stdx::unexpected(cells.error());
+    }
+    view.columns_.push_back(
+        Column{.name = dataset.columns(c), .type = type, .cells = std::move(*cells)});
+  }
+
+  // Column-major transpose keeps each column's writes contiguous
+  for (size_t c = 0; c < view.columns_.size(); c++) {
+    auto& cells = view.columns_[c].cells;
+    for (int r = 0; r < dataset.rows_size(); r++) {
+      const auto& row = dataset.rows(r);
+      if (row.elements_size() != static_cast<int>(view.columns_.size())) {
+        return stdx::unexpected(std::format("DataSet row {} has {} cells, expected {}", r,
+                                            row.elements_size(), view.columns_.size()));
+      }
+      if (!store_cell<Cells, BoolColumn>(cells, static_cast<size_t>(r),
+                                         cell_value(row.elements(static_cast<int>(c))))) {
+        return stdx::unexpected(std::format("DataSet cell ({}, {}) does not match column "
+                                            "type {}",
+                                            r, c,
+                                            std::to_underlying(view.columns_[c].type)));
+      }
+    }
+  }
+  return view;
+}
+
+std::optional<size_t> DataSetView::column_index(std::string_view name) const noexcept {
+  auto it = std::ranges::find(columns_, name, &Column::name);
+  if (it == columns_.end()) {
+    return std::nullopt;
+  }
+  return static_cast<size_t>(it - columns_.begin());
+}
+
+} // namespace sparkplug
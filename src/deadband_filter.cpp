@@ -0,0 +1,250 @@
+// src/deadband_filter.cpp
+#include "sparkplug/deadband_filter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+
+namespace sparkplug {
+
+namespace {
+
+// |value - last_sent| beyond max(absolute, percent of |last_sent|)
+inline bool exceeds_deadband(double delta, double last, double absolute,
+                             double percent) noexcept {
+  const double band = std::max(absolute, percent * 0.01 * std::abs(last));
+  return delta > band;
+}
+
+} // namespace
+
+template <typename V>
+uint32_t DeadbandFilter::Table<V>::push(uint64_t alias_value,
+                                         DataType datatype,
+                                         const Deadband& deadband) {
+  current.emplace_back();
+  last_sent.emplace_back();
+  absolute.push_back(deadband.absolute);
+  percent.push_back(deadband.percent);
+  max_silence_ms.push_back(static_cast<uint64_t>(deadband.max_silence.count()));
+  last_sent_ms.push_back(0);
+  state.push_back(0);
+  report.push_back(0);
+  alias.push_back(alias_value);
+  type.push_back(datatype);
+  return static_cast<uint32_t>(current.size() - 1);
+}
+
+stdx::expected<void, std::string>
+DeadbandFilter::add_slot(uint64_t alias, DataType type, const Deadband& deadband) {
+  if (deadband.absolute < 0.0 || deadband.percent < 0.0 ||
+      deadband.max_silence.count() < 0) {
+    return stdx::unexpected(std::format("Negative deadband for alias {}", alias));
+  }
+  if (slots_.contains(alias)) {
+    return stdx::unexpected(std::format("Alias {} is already registered", alias));
+  }
+
+  Slot slot{.lane = Lane::String, .index = 0, .type = type};
+  switch (type) {
+  case DataType::Float:
+  case DataType::Double:
+    slot.lane = Lane::Float;
+    slot.index = floats_.push(alias, type, deadband);
+    break;
+  case DataType::Boolean:
+    slot.lane = Lane::Boolean;
+    slot.index = bools_.push(alias, type, deadband);
+    break;
+  case DataType::String:
+    slot.index = strings_.push(alias, type, deadband);
+    break;
+  default:
+    slot.lane = Lane::Integer;
+    slot.index = ints_.push(alias, type, deadband);
+    break;
+  }
+  slots_.emplace(alias, slot);
+  return {};
+}
+
+stdx::expected<DeadbandFilter::Slot, std::string>
+DeadbandFilter::find_slot(uint64_t alias, DataType type) const {
+  auto it = slots_.find(alias);
+  if (it == slots_.end()) {
+    return stdx::unexpected(std::format("Alias {} is not registered", alias));
+  }
+  if (it->second.type != type) {
+    return stdx::unexpected(std::format("Alias {} has datatype {}, got {}", alias,
+                                        std::to_underlying(it->second.type),
+                                        std::to_underlying(type)));
+  }
+  return it->second;
+}
+
+size_t DeadbandFilter::collect(PayloadBuilder& payload) {
+  const uint64_t now = options_.clock.now_ms();
+  collect_ms_ = now;
+  pending_.clear();
+
+  // A sample with no valid last-sent value, or whose max_silence has elapsed. Written
+  // without branches so the comparison loops vectorize.
+  auto base_report = [now](uint8_t state, uint64_t max_silence_ms,
+                           uint64_t last_sent_ms) {
+    const bool has_value = (state & HAS_VALUE) != 0;
+    const bool sent = (state & SENT) != 0;
+    const bool silent = max_silence_ms != 0 && now - last_sent_ms >= max_silence_ms;
+    return static_cast<uint8_t>(has_value & (!sent | silent));
+  };
+
+  // Comparison passes: contiguous arrays in, one report byte per metric out
+  {
+    auto& t = floats_;
+    for (size_t i = 0; i < t.current.size(); i++) {
+      const double cur = t.current[i];
+      const double last = t.last_sent[i];
+      const bool nan_changed = std::isnan(cur) != std::isnan(last);
+      const bool changed = exceeds_deadband(std::abs(cur - last), last, t.absolute[i],
+                                            t.percent[i]) |
+                           nan_changed;
+      t.report[i] = base_report(t.state[i], t.max_silence_ms[i], t.last_sent_ms[i]) |
+                    static_cast<uint8_t>((t.state[i] == (HAS_VALUE | SENT)) & changed);
+    }
+  }
+  {
+    auto& t = ints_;
+    for (size_t i = 0; i < t.current.size(); i++) {
+      const uint64_t cur = t.current[i];
+      const uint64_t last = t.last_sent[i];
+      // Ordered in the metric's signedness; larger minus smaller is then exact in
+      // uint64_t, up to INT64_MIN..INT64_MAX and 0..UINT64_MAX
+      const bool is_signed = t.type[i] <= DataType::Int64;
+      const bool below =
+          is_signed ? static_cast<int64_t>(cur) < static_cast<int64_t>(last) : cur < last;
+      const uint64_t distance = below ? last - cur : cur - last;
+      const double last_value = is_signed
+                                    ? static_cast<double>(static_cast<int64_t>(last))
+                                    : static_cast<double>(last);
+      const bool changed = exceeds_deadband(static_cast<double>(distance), last_value,
+                                            t.absolute[i], t.percent[i]);
+      t.report[i] = base_report(t.state[i], t.max_silence_ms[i], t.last_sent_ms[i]) |
+                    static_cast<uint8_t>((t.state[i] == (HAS_VALUE | SENT)) & changed);
+    }
+  }
+  {
+    auto& t = bools_;
+    for (size_t i = 0; i < t.current.size(); i++) {
+      t.report[i] = base_report(t.state[i], t.max_silence_ms[i], t.last_sent_ms[i]) |
+                    static_cast<uint8_t>((t.state[i] == (HAS_VALUE | SENT)) &
+                                         (t.current[i] != t.last_sent[i]));
+    }
+  }
+  {
+    auto& t = strings_;
+    for (size_t i = 0; i < t.current.size(); i++) {
+      t.report[i] = base_report(t.state[i], t.max_silence_ms[i], t.last_sent_ms[i]) |
+                    static_cast<uint8_t>((t.state[i] == (HAS_VALUE | SENT)) &&
+                                         t.current[i] != t.last_sent[i]);
+    }
+  }
+
+  // Emission: only reported metrics touch the payload
+  for (uint32_t i = 0; i < floats_.report.size(); i++) {
+    if (floats_.report[i]) {
+      if (floats_.type[i] == DataType::Float) {
+        payload.add_metric_by_alias(floats_.alias[i],
+                                    static_cast<float>(floats_.current[i]));
+      } else {
+        payload.add_metric_by_alias(floats_.alias[i], floats_.current[i]);
+      }
+      pending_.push_back({.lane = Lane::Float, .index = i, .type = floats_.type[i]});
+    }
+  }
+  for (uint32_t i = 0; i < ints_.report.size(); i++) {
+    if (ints_.report[i]) {
+      const uint64_t alias = ints_.alias[i];
+      const uint64_t bits = ints_.current[i];
+      switch (ints_.type[i]) {
+      case DataType::Int8:
+        payload.add_metric_by_alias(alias, static_cast<int8_t>(bits));
+        break;
+      case DataType::Int16:
+        payload.add_metric_by_alias(alias, static_cast<int16_t>(bits));
+        break;
+      case DataType::Int32:
+        payload.add_metric_by_alias(alias, static_cast<int32_t>(bits));
+        break;
+      case DataType::Int64:
+        payload.add_metric_by_alias(alias, static_cast<int64_t>(bits));
+        break;
+      case DataType::UInt8:
+        payload.add_metric_by_alias(alias, static_cast<uint8_t>(bits));
+        break;
+      case DataType::UInt16:
+        payload.add_metric_by_alias(alias, static_cast<uint16_t>(bits));
+        break;
+      case DataType::UInt32:
+        payload.add_metric_by_alias(alias, static_cast<uint32_t>(bits));
+        break;
+      default:
+        payload.add_metric_by_alias(alias, bits);
+        break;
+      }
+      pending_.push_back({.lane = Lane::Integer, .index = i, .type = ints_.type[i]});
+    }
+  }
+  for (uint32_t i = 0; i < bools_.report.size(); i++) {
+    if (bools_.report[i]) {
+      payload.add_metric_by_alias(bools_.alias[i], bools_.current[i] != 0);
+      pending_.push_back({.lane = Lane::Boolean, .index = i, .type = DataType::Boolean});
+    }
+  }
+  for (uint32_t i = 0; i < strings_.report.size(); i++) {
+    if (strings_.report[i]) {
+      payload.add_metric_by_alias(strings_.alias[i],
+                                  std::string_view(strings_.current[i]));
+      pending_.push_back({.lane = Lane::String, .index = i, .type = DataType::String});
+    }
+  }
+  return pending_.size();
+}
+
+void DeadbandFilter::commit() {
+  auto mark_sent = [this](auto& table, uint32_t i) {
+    table.last_sent[i] = table.current[i];
+    table.last_sent_ms[i] = collect_ms_;
+    table.state[i] |= SENT;
+  };
+  for (const auto& slot : pending_) {
+    switch (slot.lane) {
+    case Lane::Float:
+      mark_sent(floats_, slot.index);
+      break;
+    case Lane::Integer:
+      mark_sent(ints_, slot.index);
+      break;
+    case Lane::Boolean:
+      mark_sent(bools_, slot.index);
+      break;
+    case Lane::String:
+      mark_sent(strings_, slot.index);
+      break;
+    }
+  }
+  pending_.clear();
+}
+
+void DeadbandFilter::invalidate() noexcept {
+  auto clear_sent = [](auto& table) {
+    for (auto& state : table.state) {
+      state &= static_cast<uint8_t>(~SENT);
+    }
+  };
+  clear_sent(floats_);
+  clear_sent(ints_);
+  clear_sent(bools_);
+  clear_sent(strings_);
+  pending_.clear();
+}
+
+} // namespace sparkplug
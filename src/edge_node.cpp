@@ -1,9 +1,12 @@
 // src/edge_node.cpp
 #include "sparkplug/edge_node.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <format>
 #include <future>
+#include <iterator>
+#include <random>
 #include <thread>
 #include <utility>
 
@@ -13,9 +16,119 @@ namespace sparkplug {
 
 namespace {
 constexpr int CONNECTION_TIMEOUT_MS = 5000;
+// Paho's own CONNECT timeout (seconds); below CONNECTION_TIMEOUT_MS, so Paho reports a
+// connect that goes nowhere while open_session() is still waiting for it
+constexpr int PAHO_CONNECT_TIMEOUT_S = CONNECTION_TIMEOUT_MS / 1000 - 1;
 constexpr int DISCONNECT_TIMEOUT_MS = 11000;
 constexpr int SUBSCRIBE_TIMEOUT_MS = 5000;
-constexpr uint64_t SEQ_NUMBER_MAX = 256;
+// How long publish_*_async() waits for a free completion slot
+constexpr std::chrono::milliseconds PUBLISH_SLOT_TIMEOUT{5000};
+// Messages queued for the send path before producers wait; each producer has at most
+// one queued, so this only needs to cover the number of publishing threads
+constexpr size_t SEQUENCER_CAPACITY = 256;
+// Seq field added by the send path: tag plus a varint of up to 2 bytes (seq <= 255)
+constexpr size_t SEQ_FIELD_MAX_SIZE = 3;
+// MQTT PUBLISH packet bytes besides the topic name: fixed header (1 + remaining length
+// of up to 4) and the topic length prefix (2)
+constexpr size_t PUBLISH_HEADER_MAX_SIZE = 1 + 4 + 2;
+// Packet identifier, present at QoS 1 and 2
+constexpr size_t PACKET_ID_SIZE = 2;
+// How often the replay thread rechecks for stored messages it was not woken for
+constexpr std::chrono::milliseconds REPLAY_POLL{1000};
+// How long a device's stored DDATA waits for its DBIRTH before it is dropped
+constexpr std::chrono::seconds DEVICE_BIRTH_WAIT{30};
+constexpr std::chrono::milliseconds DEVICE_BIRTH_POLL{100};
+// A stored message whose send fails while online is retried this often, then dropped
+constexpr uint32_t REPLAY_MAX_ATTEMPTS = 5;
+constexpr std::chrono::milliseconds REPLAY_RETRY_DELAY{500};
+
+// Per-thread scratch buffer for encoded payloads. Paho copies the payload in
+// MQTTAsync_sendMessage, so the buffer can be reused as soon as the send call returns.
+std::vector<uint8_t>& publish_buffer() {
+  thread_local std::vector<uint8_t> buffer;
+  return buffer;
+}
+
+// Per-thread chunk list for splitting oversized DATA payloads
+std::vector<PayloadBuilder::Chunk>& split_chunks() {
+  thread_local std::vector<PayloadBuilder::Chunk> chunks;
+  return chunks;
+}
+
+// Per-thread encodings of the chunks of a split payload, sent as one sequenced message
+std::vector<std::vector<uint8_t>>& chunk_buffers() {
+  thread_local std::vector<std::vector<uint8_t>> buffers;
+  return buffers;
+}
+
+std::vector<PublishSequencer::Part>& chunk_parts() {
+  thread_local std::vector<PublishSequencer::Part> parts;
+  return parts;
+}
+
+// Per-thread buffer for topics that differ per call (command targets); keeps its
+// capacity, so formatting into it stops allocating after the first few calls
+std::string& command_topic_buffer() {
+  thread_local std::string buffer;
+  return buffer;
+}
+
+// Raw handle of a client that may not exist yet
+MQTTAsync raw_client(const std::shared_ptr<MQTTAsyncHandle>& client) {
+  return client ? client->get() : nullptr;
+}
+
+stdx::expected<void, std::string> send_message(MQTTAsync client,
+                                               const std::string& topic_str,
+                                               std::span<const uint8_t> payload_data,
+                                               int qos,
+                                               bool retain,
+                                               PublishTracker* tracker,
+                                               const PublishToken* token) {
+  if (!client) {
+    return stdx::unexpected("Not connected");
+  }
+
+  MQTTAsync_message msg = MQTTAsync_message_initializer;
+  msg.payload = const_cast<void*>(reinterpret_cast<const void*>(payload_data.data()));
+  msg.payloadlen = static_cast<int>(payload_data.size());
+  msg.qos = qos;
+  msg.retained = retain ? 1 : 0;
+
+  MQTTAsync_responseOptions opts = MQTTAsync_responseOptions_initializer;
+  if (token) {
+    tracker->prepare(*token, opts);
+  }
+
+  int rc = MQTTAsync_sendMessage(client, topic_str.c_str(), &msg, &opts);
+  if (rc != MQTTASYNC_SUCCESS) {
+    auto error = std::format("Failed to publish: {}", rc);
+    if (token) {
+      tracker->fail(*token, error);
+    }
+    return stdx::unexpected(std::move(error));
+  }
+
+  return {};
+}
+
+// The writer of a node's seq-carrying messages, reporting completions to tracker
+std::unique_ptr<PublishSequencer> make_sequencer(PublishTracker* tracker) {
+  return std::make_unique<PublishSequencer>(
+      SEQUENCER_CAPACITY,
+      [tracker](const PublishSequencer::Route& route,
+                std::span<const uint8_t> payload_data) {
+        return send_message(raw_client(route.client), *route.topic, payload_data,
+                            route.qos, route.retain, tracker, route.token);
+      });
+}
+
+std::string render_topic(const TopicView& topic) {
+  std::string result;
+  result.reserve(topic.formatted_size());
+  topic.format_to(std::back_inserter(result));
+  return result;
+}
 
 void on_connect_success(void* context, MQTTAsync_successData* response) {
   (void)response;
@@ -64,7 +177,18 @@ void EdgeNode::on_connection_lost(void* context, char* cause) {
   {
     std::scoped_lock lock(edge_node->mutex_);
     edge_node->is_connected_ = false;
+    edge_node->birth_sent_ = false;
+    // Unknown until the next session's retained STATE arrives, so births wait for it
+    if (edge_node->config_.primary_host_id.has_value()) {
+      edge_node->primary_host_online_ = false;
+    }
+    if (edge_node->config_.auto_reconnect) {
+      edge_node->connection_lost_ = true;
+      edge_node->reconnecting_ = true;
+      edge_node->lost_at_ = std::chrono::steady_clock::now();
+    }
   }
+  edge_node->reconnect_wake_.notify_all();
 
   (void)cause;
 }
@@ -80,10 +204,39 @@ void MQTTAsyncHandle::reset() noexcept {
   }
 }
 
-EdgeNode::EdgeNode(Config config) : config_(std::move(config)) {
+EdgeNode::EdgeNode(Config config)
+    : config_(std::move(config)),
+      publishes_(std::make_shared<PublishTracker>(config_.max_pending_publishes)),
+      sequencer_(make_sequencer(publishes_.get())) {
   will_opts_ = MQTTAsync_willOptions_initializer;
 }
 
+EdgeNode::NodeTopics EdgeNode::render_node_topics() const {
+  auto render = [this](MessageType type) {
+    return render_topic({.group_id = config_.group_id,
+                         .message_type = type,
+                         .edge_node_id = config_.edge_node_id,
+                         .device_id = {}});
+  };
+  return {.birth = render(MessageType::NBIRTH),
+          .data = render(MessageType::NDATA),
+          .death = render(MessageType::NDEATH),
+          .command = render(MessageType::NCMD)};
+}
+
+EdgeNode::DeviceTopics EdgeNode::render_device_topics(std::string_view device_id) const {
+  auto render = [this, device_id](MessageType type) {
+    return render_topic({.group_id = config_.group_id,
+                         .message_type = type,
+                         .edge_node_id = config_.edge_node_id,
+                         .device_id = device_id});
+  };
+  return {.birth = render(MessageType::DBIRTH),
+          .data = render(MessageType::DDATA),
+          .death = render(MessageType::DDEATH),
+          .command = render(MessageType::DCMD)};
+}
+
 int EdgeNode::on_message_arrived(void* context,
                                  char* topicName,
                                  int topicLen,
@@ -104,6 +257,8 @@ int EdgeNode::on_message_arrived(void* context,
     std::scoped_lock lock(edge_node->mutex_);
     if (payload_str.find("\"online\":true") != std::string::npos) {
       edge_node->primary_host_online_ = true;
+      edge_node->replay_wake_.notify_all();
+      edge_node->reconnect_wake_.notify_all();
     } else if (payload_str.find("\"online\":false") != std::string::npos) {
       edge_node->primary_host_online_ = false;
     }
@@ -137,39 +292,60 @@ int EdgeNode::on_message_arrived(void* context,
 }
 
 EdgeNode::~EdgeNode() {
+  stop_threads();
   if (client_ && is_connected_) {
     (void)disconnect();
   } else if (client_) {
-    MQTTAsync_setCallbacks(client_.get(), nullptr, nullptr, nullptr, nullptr);
+    MQTTAsync_setCallbacks(client_->get(), nullptr, nullptr, nullptr, nullptr);
+  }
+  client_.reset();
+  if (publishes_) {
+    auto abandoned =
+        publishes_->abandon("EdgeNode destroyed before the publish completed");
+    PublishTracker::run(abandoned);
   }
 }
 
-EdgeNode::EdgeNode(EdgeNode&& other) noexcept
-    : config_(std::move(other.config_)), client_(std::move(other.client_)),
-      seq_num_(other.seq_num_), bd_seq_num_(other.bd_seq_num_),
-      death_payload_data_(std::move(other.death_payload_data_)),
-      last_birth_payload_(std::move(other.last_birth_payload_)),
-      device_states_(std::move(other.device_states_)), is_connected_(other.is_connected_)
-// mutex_ is default-constructed (mutexes are not moveable)
-{
-  std::scoped_lock lock(other.mutex_);
-  other.is_connected_ = false;
+EdgeNode::EdgeNode(EdgeNode&& other) noexcept {
+  // Nothing is moved in an init list: other's replay and reconnect threads may still
+  // be reading its members until move assignment has stopped them and locked its mutex
+  will_opts_ = MQTTAsync_willOptions_initializer;
+  *this = std::move(other);
 }
 
 EdgeNode& EdgeNode::operator=(EdgeNode&& other) noexcept {
   if (this != &other) {
+    // The replay and reconnect threads take the mutexes, so they are stopped first
+    stop_threads();
+    other.stop_threads();
     // Lock both mutexes with automatic deadlock avoidance
     std::scoped_lock lock(mutex_, other.mutex_);
 
     config_ = std::move(other.config_);
+    publishes_ = std::move(other.publishes_);
+    sequencer_ = std::move(other.sequencer_);
     client_ = std::move(other.client_);
-    seq_num_ = other.seq_num_;
     bd_seq_num_ = other.bd_seq_num_;
     death_payload_data_ = std::move(other.death_payload_data_);
+    node_topics_ = std::move(other.node_topics_);
     last_birth_payload_ = std::move(other.last_birth_payload_);
+    templates_ = std::move(other.templates_);
     device_states_ = std::move(other.device_states_);
     is_connected_ = other.is_connected_;
+    birth_sent_ = other.birth_sent_;
+    store_forward_ = std::move(other.store_forward_);
+    connection_lost_ = other.connection_lost_;
+    reconnecting_ = other.reconnecting_;
+    lost_at_ = other.lost_at_;
+    connected_at_ = other.connected_at_;
+    last_reconnect_ = other.last_reconnect_;
+    awaiting_first_data_ = other.awaiting_first_data_.load();
+    start_threads();
     other.is_connected_ = false;
+    // A send path of its own, so calls on the moved-from node fail rather than crash
+    other.publishes_ =
+        std::make_shared<PublishTracker>(other.config_.max_pending_publishes);
+    other.sequencer_ = make_sequencer(other.publishes_.get());
   }
   return *this;
 }
@@ -192,47 +368,95 @@ void EdgeNode::set_log_callback(std::optional<LogCallback> callback) {
 }
 
 stdx::expected<void, std::string> EdgeNode::connect() {
-  std::scoped_lock lock(mutex_);
+  {
+    std::scoped_lock lock(mutex_);
+
+    // Opened before connecting, so messages are stored even if the broker is down
+    if (config_.store_forward && !store_forward_) {
+      auto buffer = StoreForwardBuffer::open(*config_.store_forward);
+      if (!buffer) {
+        return stdx::unexpected(buffer.error());
+      }
+      store_forward_ = std::move(*buffer);
+    }
+    start_threads();
+    // The application takes over from an automatic reconnect in progress
+    connection_lost_ = false;
+    reconnecting_ = false;
+  }
+  reconnect_wake_.notify_all();
+
+  return open_session(false);
+}
 
-  MQTTAsync raw_client = nullptr;
+stdx::expected<void, std::string> EdgeNode::open_session(bool reconnect) {
+  // The broker round trips below run without mutex_, so publishes (and the
+  // store-and-forward path) are not held up while the broker is slow or down
+  std::scoped_lock session_lock(session_mutex_);
+
+  Config config;
+  // DCMD topics stay put (device_states_ never erases, and they are never modified)
+  std::vector<const char*> topics;
+  {
+    std::scoped_lock lock(mutex_);
+    birth_sent_ = false;
+    config = config_;
+
+    // Increment bdSeq for this session (Sparkplug spec requires bdSeq to start at 1)
+    bd_seq_num_++;
+
+    // Prepare NDEATH payload BEFORE connecting
+    PayloadBuilder death_payload({.clock = config_.clock});
+    death_payload.add_metric("bdSeq", bd_seq_num_);
+    death_payload_data_ = death_payload.build();
+
+    if (node_topics_.birth.empty()) {
+      node_topics_ = render_node_topics();
+    }
+    // NCMD, STATE and the DCMD of every device born so far in one SUBSCRIBE, so a
+    // reconnect costs one round trip however many devices there are
+    topics.push_back(node_topics_.command.c_str());
+    for (const auto& [device_id, device_state] : device_states_) {
+      if (device_state.is_online) {
+        topics.push_back(device_state.topics.command.c_str());
+      }
+    }
+  }
+
+  MQTTAsync raw_handle = nullptr;
   int rc =
-      MQTTAsync_create(&raw_client, config_.broker_url.c_str(), config_.client_id.c_str(),
+      MQTTAsync_create(&raw_handle, config.broker_url.c_str(), config.client_id.c_str(),
                        MQTTCLIENT_PERSISTENCE_NONE, nullptr);
   if (rc != MQTTASYNC_SUCCESS) {
     return stdx::unexpected(std::format("Failed to create client: {}", rc));
   }
-  client_ = MQTTAsyncHandle(raw_client);
+  // Reset before returning on a timeout: destroying the client ends the callbacks Paho
+  // still owes it while the promises they point at are alive
+  auto client = std::make_shared<MQTTAsyncHandle>(raw_handle);
 
   // Set callbacks (MUST be called after creating client but before connecting)
   // Note: Paho requires message_arrived callback to be non-null, so always pass it
-  rc = MQTTAsync_setCallbacks(client_.get(), this, on_connection_lost, on_message_arrived,
+  rc = MQTTAsync_setCallbacks(client->get(), this, on_connection_lost, on_message_arrived,
                               nullptr);
   if (rc != MQTTASYNC_SUCCESS) {
     return stdx::unexpected(std::format("Failed to set callbacks: {}", rc));
   }
 
-  // Increment bdSeq for this session (Sparkplug spec requires bdSeq to start at 1)
-  bd_seq_num_++;
-
-  // Prepare NDEATH payload BEFORE connecting
-  PayloadBuilder death_payload;
-  death_payload.add_metric("bdSeq", bd_seq_num_);
-  death_payload_data_ = death_payload.build();
-
   MQTTAsync_connectOptions conn_opts = MQTTAsync_connectOptions_initializer;
-  conn_opts.keepAliveInterval = config_.keep_alive_interval;
-  conn_opts.cleansession = config_.clean_session;
+  conn_opts.keepAliveInterval = config.keep_alive_interval;
+  conn_opts.cleansession = config.clean_session;
+  conn_opts.connectTimeout = PAHO_CONNECT_TIMEOUT_S;
 
-  if (config_.username.has_value()) {
-    conn_opts.username = config_.username.value().c_str();
+  if (config.username.has_value()) {
+    conn_opts.username = config.username.value().c_str();
   }
-  if (config_.password.has_value()) {
-    conn_opts.password = config_.password.value().c_str();
+  if (config.password.has_value()) {
+    conn_opts.password = config.password.value().c_str();
   }
 
   ssl_opts_ = MQTTAsync_SSLOptions_initializer;
-  if (config_.tls.has_value()) {
-    const auto& tls = config_.tls.value();
+  if (config.tls.has_value()) {
+    const auto& tls = config.tls.value();
     ssl_opts_.trustStore = tls.trust_store.c_str();
     ssl_opts_.keyStore = tls.key_store.empty() ? nullptr : tls.key_store.c_str();
     ssl_opts_.privateKey = tls.private_key.empty() ? nullptr : tls.private_key.c_str();
@@ -247,21 +471,13 @@ stdx::expected<void, std::string> EdgeNode::connect() {
   // Setup Last Will and Testament (NDEATH)
   // Initialize will options as member variable (must outlive async connect)
   will_opts_ = MQTTAsync_willOptions_initializer;
-
-  Topic death_topic{.group_id = config_.group_id,
-                    .message_type = MessageType::NDEATH,
-                    .edge_node_id = config_.edge_node_id,
-                    .device_id = ""};
-
-  // Store as member variable to keep string alive for async MQTT operations
-  death_topic_str_ = death_topic.to_string();
-  will_opts_.topicName = death_topic_str_.c_str();
+  will_opts_.topicName = node_topics_.death.c_str();
 
   // Use payload.data/len for binary protobuf data
   will_opts_.payload.data = death_payload_data_.data();
   will_opts_.payload.len = static_cast<int>(death_payload_data_.size());
   will_opts_.retained = 0;
-  will_opts_.qos = config_.death_qos;
+  will_opts_.qos = config.death_qos;
 
   conn_opts.will = &will_opts_;
 
@@ -272,13 +488,14 @@ stdx::expected<void, std::string> EdgeNode::connect() {
   conn_opts.onSuccess = on_connect_success;
   conn_opts.onFailure = on_connect_failure;
 
-  rc = MQTTAsync_connect(client_.get(), &conn_opts);
+  rc = MQTTAsync_connect(client->get(), &conn_opts);
   if (rc != MQTTASYNC_SUCCESS) {
     return stdx::unexpected(std::format("Failed to connect: {}", rc));
   }
 
   auto status = connect_future.wait_for(std::chrono::milliseconds(CONNECTION_TIMEOUT_MS));
   if (status == std::future_status::timeout) {
+    client.reset();
     return stdx::unexpected("Connection timeout");
   }
 
@@ -287,19 +504,14 @@ stdx::expected<void, std::string> EdgeNode::connect() {
   } catch (const std::exception& e) {
     return stdx::unexpected(e.what());
   }
+  const auto connected_at = std::chrono::steady_clock::now();
 
-  is_connected_ = true;
-
-  if (!config_.primary_host_id.has_value()) {
-    primary_host_online_ = true;
+  std::string state_topic;
+  if (config.primary_host_id.has_value()) {
+    state_topic = "spBv1.0/STATE/" + config.primary_host_id.value();
+    topics.push_back(state_topic.c_str());
   }
-
-  Topic ncmd_topic{.group_id = config_.group_id,
-                   .message_type = MessageType::NCMD,
-                   .edge_node_id = config_.edge_node_id,
-                   .device_id = ""};
-
-  auto ncmd_topic_str = ncmd_topic.to_string();
+  std::vector<int> qos(topics.size(), 1);
 
   std::promise<void> subscribe_promise;
   auto subscribe_future = subscribe_promise.get_future();
@@ -309,7 +521,9 @@ stdx::expected<void, std::string> EdgeNode::connect() {
   sub_opts.onSuccess = on_subscribe_success;
   sub_opts.onFailure = on_subscribe_failure;
 
-  rc = MQTTAsync_subscribe(client_.get(), ncmd_topic_str.c_str(), 1, &sub_opts);
+  rc = MQTTAsync_subscribeMany(client->get(), static_cast<int>(topics.size()),
+                               const_cast<char* const*>(topics.data()), qos.data(),
+                               &sub_opts);
   if (rc != MQTTASYNC_SUCCESS) {
     return stdx::unexpected(std::format("Failed to subscribe to NCMD: {}", rc));
   }
@@ -317,6 +531,7 @@ stdx::expected<void, std::string> EdgeNode::connect() {
   auto sub_status =
       subscribe_future.wait_for(std::chrono::milliseconds(SUBSCRIBE_TIMEOUT_MS));
   if (sub_status == std::future_status::timeout) {
+    client.reset();
     return stdx::unexpected("NCMD subscription timeout");
   }
 
@@ -326,34 +541,31 @@ stdx::expected<void, std::string> EdgeNode::connect() {
     return stdx::unexpected(std::format("NCMD subscription failed: {}", e.what()));
   }
 
-  if (config_.primary_host_id.has_value()) {
-    std::string state_topic = "spBv1.0/STATE/" + config_.primary_host_id.value();
-
-    std::promise<void> state_subscribe_promise;
-    auto state_subscribe_future = state_subscribe_promise.get_future();
-
-    MQTTAsync_responseOptions state_sub_opts = MQTTAsync_responseOptions_initializer;
-    state_sub_opts.context = &state_subscribe_promise;
-    state_sub_opts.onSuccess = on_subscribe_success;
-    state_sub_opts.onFailure = on_subscribe_failure;
-
-    rc = MQTTAsync_subscribe(client_.get(), state_topic.c_str(), 1, &state_sub_opts);
-    if (rc != MQTTASYNC_SUCCESS) {
-      return stdx::unexpected(std::format("Failed to subscribe to STATE: {}", rc));
+  // The client being replaced lives on until the publishes still using it are done
+  std::shared_ptr<MQTTAsyncHandle> previous;
+  std::vector<PublishTracker::Completion> abandoned;
+  {
+    std::scoped_lock lock(mutex_);
+    if (reconnect && !connection_lost_) {
+      return stdx::unexpected("Reconnect cancelled by connect() or disconnect()");
     }
-
-    auto state_sub_status =
-        state_subscribe_future.wait_for(std::chrono::milliseconds(SUBSCRIBE_TIMEOUT_MS));
-    if (state_sub_status == std::future_status::timeout) {
-      return stdx::unexpected("STATE subscription timeout");
+    // Paho marks the client disconnected before it reports the loss, so a loss
+    // reported while the session was opening shows here
+    if (!MQTTAsync_isConnected(client->get())) {
+      return stdx::unexpected("Connection lost while subscribing");
     }
-
-    try {
-      state_subscribe_future.get();
-    } catch (const std::exception& e) {
-      return stdx::unexpected(std::format("STATE subscription failed: {}", e.what()));
+    // The previous client will not report its pending sends. Given up before the new
+    // client can be published on, so no send prepared for it is caught up in this.
+    abandoned = publishes_->abandon("MQTT client recreated before the publish completed");
+    previous = std::exchange(client_, client);
+    is_connected_ = true;
+    connected_at_ = connected_at;
+    connection_lost_ = false;
+    if (!config.primary_host_id.has_value()) {
+      primary_host_online_ = true;
     }
   }
+  PublishTracker::run(abandoned);
 
   return {};
 }
@@ -361,6 +573,11 @@ stdx::expected<void, std::string> EdgeNode::connect() {
 stdx::expected<void, std::string> EdgeNode::disconnect() {
   std::scoped_lock lock(mutex_);
 
+  // Also ends an automatic reconnect in progress
+  connection_lost_ = false;
+  reconnecting_ = false;
+  reconnect_wake_.notify_all();
+
   if (!client_) {
     return stdx::unexpected("Not connected");
   }
@@ -374,7 +591,7 @@ stdx::expected<void, std::string> EdgeNode::disconnect() {
   opts.onSuccess = on_disconnect_success;
   opts.onFailure = on_disconnect_failure;
 
-  int rc = MQTTAsync_disconnect(client_.get(), &opts);
+  int rc = MQTTAsync_disconnect(client_->get(), &opts);
   if (rc != MQTTASYNC_SUCCESS) {
     return stdx::unexpected(std::format("Failed to disconnect: {}", rc));
   }
@@ -395,37 +612,433 @@ stdx::expected<void, std::string> EdgeNode::disconnect() {
   return {};
 }
 
+std::optional<size_t> EdgeNode::payload_budget(std::string_view topic, int qos) const {
+  if (config_.max_payload_bytes == 0) {
+    return std::nullopt;
+  }
+  const size_t overhead =
+      PUBLISH_HEADER_MAX_SIZE + topic.size() + (qos > 0 ? PACKET_ID_SIZE : 0);
+  return config_.max_payload_bytes > overhead ? config_.max_payload_bytes - overhead : 0;
+}
+
+stdx::expected<void, std::string> EdgeNode::check_payload_size(
+    std::string_view message_type, std::string_view topic, int qos, size_t size) const {
+  if (auto budget = payload_budget(topic, qos); budget && size > *budget) {
+    return stdx::unexpected(std::format(
+        "{} payload is {} bytes; max_payload_bytes {} leaves {} after topic and header",
+        message_type, size, config_.max_payload_bytes, *budget));
+  }
+  return {};
+}
+
 stdx::expected<void, std::string>
-EdgeNode::publish_message(MQTTAsync client,
-                          const std::string& topic_str,
-                          std::span<const uint8_t> payload_data,
-                          int qos,
-                          bool retain) {
-  if (!client) {
-    return stdx::unexpected("Not connected");
+EdgeNode::publish_chunks(PayloadBuilder& payload,
+                         std::span<const PayloadBuilder::Chunk> chunks,
+                         const PublishSequencer::Route& route) {
+  // One sequenced message, so the chunks get consecutive seqs with nothing in between
+  auto& buffers = chunk_buffers();
+  auto& parts = chunk_parts();
+  if (buffers.size() < chunks.size()) {
+    buffers.resize(chunks.size());
+  }
+  parts.clear();
+  for (size_t i = 0; i < chunks.size(); i++) {
+    // Without a seq field; the send path appends each chunk's own
+    payload.build_chunk_into(chunks[i], std::nullopt, buffers[i]);
+    parts.push_back({.bytes = &buffers[i]});
   }
 
-  MQTTAsync_message msg = MQTTAsync_message_initializer;
-  msg.payload = const_cast<void*>(reinterpret_cast<const void*>(payload_data.data()));
-  msg.payloadlen = static_cast<int>(payload_data.size());
-  msg.qos = qos;
-  msg.retained = retain ? 1 : 0;
+  PublishSequencer::Message msg{.route = route, .parts = parts};
+  if (auto result = sequencer_->submit(msg); !result) {
+    return stdx::unexpected(std::format("Chunk {} of {}: {}", msg.parts_sent + 1,
+                                        chunks.size(), result.error()));
+  }
+  note_data_sent();
+  return {};
+}
 
-  MQTTAsync_responseOptions opts = MQTTAsync_responseOptions_initializer;
+stdx::expected<void, std::string>
+EdgeNode::send_in_sequence(const PublishSequencer::Route& route,
+                           PublishSequencer::Part part,
+                           bool restart_seq) {
+  PublishSequencer::Message msg{
+      .route = route, .parts = {&part, 1}, .restart_seq = restart_seq};
+  return sequencer_->submit(msg);
+}
 
-  int rc = MQTTAsync_sendMessage(client, topic_str.c_str(), &msg, &opts);
-  if (rc != MQTTASYNC_SUCCESS) {
-    return stdx::unexpected(std::format("Failed to publish: {}", rc));
+bool EdgeNode::is_online() const noexcept {
+  return is_connected_ && primary_host_online_ && birth_sent_;
+}
+
+bool EdgeNode::should_store(std::string_view device_id) const {
+  // Births still being re-sent count as offline: live sends fail until they are done
+  if (!config_.store_forward || !store_forward_ || (is_online() && !reconnecting_)) {
+    return false;
+  }
+  if (device_id.empty()) {
+    return true;
   }
+  // Only devices born before the outage; others fail as they would online
+  auto it = device_states_.find(device_id);
+  return it != device_states_.end() && it->second.is_online;
+}
 
+stdx::expected<void, std::string>
+EdgeNode::store_data(std::string_view device_id, std::span<const uint8_t> payload_data) {
+  if (!store_forward_->push(device_id, payload_data)) {
+    return stdx::unexpected(std::format(
+        "Store-and-forward buffer rejected a {}-byte payload", payload_data.size()));
+  }
   return {};
 }
 
-stdx::expected<void, std::string> EdgeNode::publish_birth(PayloadBuilder& payload) {
-  MQTTAsync client = nullptr;
-  std::string topic_str;
+StoreForwardBuffer::Stats EdgeNode::store_forward_stats() const {
+  std::scoped_lock lock(mutex_);
+  return store_forward_ ? store_forward_->stats() : StoreForwardBuffer::Stats{};
+}
+
+std::optional<EdgeNode::ReconnectReport> EdgeNode::last_reconnect() const {
+  std::scoped_lock lock(mutex_);
+  return last_reconnect_;
+}
+
+void EdgeNode::start_threads() {
+  if (store_forward_ && !replay_thread_.joinable()) {
+    replay_thread_ = std::jthread([this](std::stop_token stop) { replay_stored(stop); });
+  }
+  if (config_.auto_reconnect && !reconnect_thread_.joinable()) {
+    reconnect_thread_ =
+        std::jthread([this](std::stop_token stop) { reconnect_loop(stop); });
+  }
+}
+
+void EdgeNode::stop_threads() {
+  replay_thread_.request_stop();
+  reconnect_thread_.request_stop();
+  if (replay_thread_.joinable()) {
+    replay_thread_.join();
+  }
+  if (reconnect_thread_.joinable()) {
+    reconnect_thread_.join();
+  }
+}
+
+void EdgeNode::replay_stored(std::stop_token stop) {
+  using Clock = std::chrono::steady_clock;
+  const auto rate = static_cast<Clock::rep>(config_.store_forward_drain_rate);
+  const Clock::duration interval = rate == 0
+                                      ? Clock::duration::zero()
+                                      : Clock::duration(std::chrono::seconds(1)) / rate;
+  auto next_send = Clock::now();
+  std::string device_id;
   std::vector<uint8_t> payload_data;
+  // When each device with stored DDATA was first found not born again; forgotten
+  // whenever there is nothing to replay
+  std::unordered_map<std::string, Clock::time_point, StringHash, StringEqual>
+      unborn_since;
+  // DDATA moved to the back in a row; once that is all of them, they all wait
+  size_t requeued = 0;
+  // Failed sends of the message at the front
+  uint32_t failures = 0;
+
+  // Sleeps until the deadline unless stopped
+  auto pause_until = [&](Clock::time_point deadline) {
+    std::unique_lock lock(mutex_);
+    (void)replay_wake_.wait_until(lock, stop, deadline, [] { return false; });
+  };
+
+  while (!stop.stop_requested()) {
+    {
+      std::unique_lock lock(mutex_);
+      if (!replay_wake_.wait_for(lock, stop, REPLAY_POLL, [this] {
+            return is_online() && !store_forward_->empty();
+          })) {
+        unborn_since.clear();
+        requeued = 0;
+        continue;
+      }
+    }
+
+    // Paced, so the backlog does not crowd out live data
+    if (interval != Clock::duration::zero()) {
+      pause_until(next_send);
+      next_send = std::max(next_send, Clock::now()) + interval;
+    }
+
+    auto position = store_forward_->front(device_id, payload_data);
+    if (!position) {
+      continue;
+    }
+    switch (replay(device_id, payload_data)) {
+    case ReplayResult::Sent:
+      unborn_since.erase(device_id);
+      [[fallthrough]];
+    case ReplayResult::Dropped:
+      store_forward_->pop(*position);
+      requeued = 0;
+      failures = 0;
+      break;
+    case ReplayResult::Offline:
+      break;
+    case ReplayResult::Failed:
+      // Left at the front for the next pass, unless it never goes through
+      if (++failures < REPLAY_MAX_ATTEMPTS) {
+        pause_until(Clock::now() + REPLAY_RETRY_DELAY);
+        break;
+      }
+      log(LogLevel::WARN, std::format("Dropping stored {} after {} failed sends",
+                                      device_id.empty() ? "NDATA" : "DDATA", failures));
+      store_forward_->pop(*position);
+      failures = 0;
+      break;
+    case ReplayResult::DeviceNotBorn: {
+      auto since = unborn_since.try_emplace(device_id, Clock::now()).first->second;
+      if (Clock::now() - since >= DEVICE_BIRTH_WAIT) {
+        log(LogLevel::WARN, std::format("Dropping stored DDATA: device '{}' was not born "
+                                        "again within {} s",
+                                        device_id, DEVICE_BIRTH_WAIT.count()));
+        store_forward_->pop(*position);
+        break;
+      }
+      // Behind the newest record, so one device does not hold up everything after it
+      if (store_forward_->requeue(*position) &&
+          ++requeued >= store_forward_->stats().records) {
+        requeued = 0;
+        pause_until(Clock::now() + DEVICE_BIRTH_POLL);
+      }
+      break;
+    }
+    }
+  }
+}
+
+EdgeNode::ReplayResult EdgeNode::replay(std::string_view device_id,
+                                        std::span<const uint8_t> payload_data) {
+  if (!device_id.empty()) {
+    // DDATA needs a DBIRTH in this MQTT session, which a reconnect does not keep
+    std::scoped_lock lock(mutex_);
+    auto it = device_states_.find(device_id);
+    if (it == device_states_.end() || !it->second.is_online ||
+        it->second.birth_bd_seq != bd_seq_num_) {
+      return is_online() ? ReplayResult::DeviceNotBorn : ReplayResult::Offline;
+    }
+  }
+
+  PayloadBuilder historical;
+  auto& proto_payload = historical.mutable_payload();
+  if (!proto_payload.ParseFromArray(payload_data.data(),
+                                    static_cast<int>(payload_data.size()))) {
+    log(LogLevel::WARN, "Dropping stored payload that cannot be parsed");
+    return ReplayResult::Dropped;
+  }
+  for (auto& metric : *proto_payload.mutable_metrics()) {
+    metric.set_is_historical(true);
+  }
+  historical.clear_seq(); // A new one from the send path
+
+  auto result = device_id.empty()
+                    ? send_data(historical, nullptr, false)
+                    : send_device_data(device_id, historical, nullptr, false);
+  if (result) {
+    return ReplayResult::Sent;
+  }
+  {
+    std::scoped_lock lock(mutex_);
+    if (!is_online()) {
+      return ReplayResult::Offline; // Kept for the next session
+    }
+  }
+  log(LogLevel::DEBUG,
+      std::format("Replaying stored {} failed: {}", device_id.empty() ? "NDATA" : "DDATA",
+                  result.error()));
+  return ReplayResult::Failed;
+}
+
+void EdgeNode::reconnect_loop(std::stop_token stop) {
+  using std::chrono::microseconds;
+  using std::chrono::milliseconds;
+  const auto options = *config_.auto_reconnect;
+  std::minstd_rand random(std::random_device{}());
+  std::uniform_real_distribution<double> spread(1.0 - options.jitter,
+                                                1.0 + options.jitter);
+
+  while (!stop.stop_requested()) {
+    {
+      std::unique_lock lock(mutex_);
+      if (!reconnect_wake_.wait(lock, stop, [this] { return connection_lost_; })) {
+        return;
+      }
+    }
+    log(LogLevel::WARN, "Connection lost, reconnecting");
+
+    // Waits before every attempt, the first included: a broker that just dropped every
+    // client is rarely back at once, and the jitter spreads the nodes' attempts out
+    auto delay = options.initial_delay;
+    uint32_t attempts = 0;
+    bool connected = false;
+    while (!connected && !stop.stop_requested()) {
+      auto wait = std::chrono::duration_cast<milliseconds>(delay * spread(random));
+      {
+        std::unique_lock lock(mutex_);
+        if (reconnect_wake_.wait_for(lock, stop, wait,
+                                     [this] { return !connection_lost_; }) ||
+            stop.stop_requested()) {
+          break; // connect() or disconnect() was called, or the node is going away
+        }
+      }
+      attempts++;
+      // Without mutex_: publishes keep failing fast (or being stored) meanwhile
+      auto result = open_session(true);
+      connected = result.has_value();
+      if (!connected) {
+        log(LogLevel::WARN,
+            std::format("Reconnect attempt {} failed: {}", attempts, result.error()));
+        delay = std::min(
+            std::chrono::duration_cast<milliseconds>(delay * options.multiplier),
+            options.max_delay);
+      }
+    }
+    if (!connected) {
+      continue;
+    }
+
+    auto births = replay_births(stop);
+    std::string message;
+    {
+      std::scoped_lock lock(mutex_);
+      if (births) {
+        using std::chrono::duration_cast;
+        auto ready = std::chrono::steady_clock::now() - connected_at_;
+        last_reconnect_ = ReconnectReport{
+            .attempts = attempts,
+            .outage = duration_cast<milliseconds>(connected_at_ - lost_at_),
+            .session_ready = duration_cast<microseconds>(ready),
+        };
+        awaiting_first_data_ = true;
+        message = std::format(
+            "Reconnected after {} attempt(s) and {} ms offline; births re-sent in {} us",
+            attempts, last_reconnect_->outage.count(),
+            last_reconnect_->session_ready.count());
+      } else {
+        // Lost again (the loop goes round), or births the application must re-send
+        reconnecting_ = connection_lost_;
+      }
+    }
+    if (births) {
+      log(LogLevel::INFO, message);
+    } else if (!stop.stop_requested()) {
+      log(LogLevel::WARN, std::format("Failed to re-send births: {}", births.error()));
+    }
+  }
+}
+
+stdx::expected<void, std::string> EdgeNode::replay_births(std::stop_token stop) {
+  std::shared_ptr<MQTTAsyncHandle> client;
+  std::vector<uint8_t> node_birth;
+  // Topics stay put (device_states_ never erases, and they are never modified)
+  std::vector<std::pair<const DeviceTopics*, std::vector<uint8_t>>> device_births;
+  uint64_t bd_seq = 0;
+  int qos = 0;
+
+  {
+    std::unique_lock lock(mutex_);
+    // STATE arrives shortly after the subscription; births wait for it as they would
+    // from the application
+    if (!reconnect_wake_.wait(
+            lock, stop, [this] { return primary_host_online_ || !is_connected_; })) {
+      return stdx::unexpected("Stopped");
+    }
+    if (!is_connected_) {
+      return stdx::unexpected("Connection lost again");
+    }
+    if (last_birth_payload_.empty()) {
+      reconnecting_ = false; // Never born: NBIRTH is up to the application
+      return {};
+    }
+
+    node_birth = last_birth_payload_;
+    for (const auto& [device_id, device_state] : device_states_) {
+      if (device_state.is_online) {
+        device_births.emplace_back(&device_state.topics, device_state.last_birth_payload);
+      }
+    }
+    bd_seq = bd_seq_num_;
+    client = client_;
+    qos = config_.data_qos;
+  }
+
+  // NBIRTH needs the new bdSeq; DBIRTHs carry none and go out as they were encoded
+  org::eclipse::tahu::protobuf::Payload proto_payload;
+  if (!proto_payload.ParseFromArray(node_birth.data(),
+                                    static_cast<int>(node_birth.size()))) {
+    return stdx::unexpected("Failed to parse stored birth payload");
+  }
+  for (auto& metric : *proto_payload.mutable_metrics()) {
+    if (metric.name() == "bdSeq") {
+      metric.set_long_value(bd_seq);
+      break;
+    }
+  }
+  proto_payload.clear_seq(); // The send path gives NBIRTH seq 0
+  node_birth.resize(proto_payload.ByteSizeLong());
+  proto_payload.SerializeToArray(node_birth.data(), static_cast<int>(node_birth.size()));
+
+  auto result =
+      send_in_sequence({.client = client, .topic = &node_topics_.birth, .qos = qos},
+                       {.bytes = &node_birth}, true);
+  for (auto& [topics, payload_data] : device_births) {
+    if (!result) {
+      break;
+    }
+    result = send_in_sequence({.client = client, .topic = &topics->birth, .qos = qos},
+                              {.bytes = &payload_data});
+  }
+  if (!result) {
+    return result;
+  }
+
+  {
+    std::scoped_lock lock(mutex_);
+    last_birth_payload_ = std::move(node_birth);
+    for (auto& [device_id, device_state] : device_states_) {
+      if (device_state.is_online) {
+        device_state.birth_bd_seq = bd_seq;
+      }
+    }
+    birth_sent_ = is_connected_; // Unless lost again meanwhile
+    reconnecting_ = connection_lost_;
+  }
+  replay_wake_.notify_all();
+
+  return {};
+}
+
+void EdgeNode::note_data_sent() {
+  if (!awaiting_first_data_.load(std::memory_order_relaxed) ||
+      !awaiting_first_data_.exchange(false)) {
+    return;
+  }
+  std::chrono::microseconds elapsed{0};
+  {
+    std::scoped_lock lock(mutex_);
+    elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - connected_at_);
+    if (last_reconnect_) {
+      last_reconnect_->first_data = elapsed;
+    }
+  }
+  log(LogLevel::INFO,
+      std::format("First DATA {} us after the broker accepted the reconnect",
+                  elapsed.count()));
+}
+
+stdx::expected<void, std::string> EdgeNode::publish_birth(const PayloadBuilder& birth) {
+  std::shared_ptr<MQTTAsyncHandle> client;
+  const std::string* topic = nullptr;
+  auto& payload_data = publish_buffer();
   int qos = 0;
+  uint64_t bd_seq = 0;
+  std::vector<TemplateDefinition> templates; // Usually empty
 
   {
     std::scoped_lock lock(mutex_);
@@ -438,91 +1051,195 @@ stdx::expected<void, std::string> EdgeNode::publish_birth(PayloadBuilder& payloa
       return stdx::unexpected("Primary host is not online");
     }
 
-    payload.set_seq(0);
+    if (reconnecting_) {
+      return stdx::unexpected("Reconnecting; the last NBIRTH is re-sent automatically");
+    }
 
-    bool has_bdseq = false;
-    auto& proto_payload = payload.mutable_payload();
+    bd_seq = bd_seq_num_;
+    templates = templates_;
+    topic = &node_topics_.birth;
+    client = client_;
+    qos = config_.data_qos;
+  }
 
-    for (const auto& metric : proto_payload.metrics()) {
-      if (metric.name() == "bdSeq") {
-        has_bdseq = true;
-        break;
-      }
+  // bdSeq and template definitions go into a copy, so the caller's builder can be
+  // published again (after a reconnect) and then carries that session's bdSeq
+  PayloadBuilder payload(birth);
+  payload.clear_seq(); // The send path gives NBIRTH seq 0
+
+  auto& proto_payload = payload.mutable_payload();
+  bool has_bdseq = std::ranges::any_of(proto_payload.metrics(), [](const auto& metric) {
+    return metric.name() == "bdSeq";
+  });
+  if (!has_bdseq) {
+    auto* metric = proto_payload.add_metrics();
+    metric->set_name("bdSeq");
+    metric->set_datatype(std::to_underlying(DataType::UInt64));
+    metric->set_long_value(bd_seq);
+    if (proto_payload.has_timestamp()) {
+      metric->set_timestamp(proto_payload.timestamp());
     }
+  }
 
-    if (!has_bdseq) {
-      auto* metric = proto_payload.add_metrics();
-      metric->set_name("bdSeq");
-      metric->set_datatype(std::to_underlying(DataType::UInt64));
-      metric->set_long_value(bd_seq_num_);
-      if (proto_payload.has_timestamp()) {
-        metric->set_timestamp(proto_payload.timestamp());
-      }
+  for (const auto& definition : templates) {
+    auto metric_name = definition.definition_metric_name();
+    bool present = std::ranges::any_of(proto_payload.metrics(), [&](const auto& metric) {
+      return metric.name() == metric_name;
+    });
+    if (!present) {
+      payload.add_template_definition(definition);
     }
+  }
 
-    Topic topic{.group_id = config_.group_id,
-                .message_type = MessageType::NBIRTH,
-                .edge_node_id = config_.edge_node_id,
-                .device_id = ""};
-
-    topic_str = topic.to_string();
-    payload_data = payload.build();
-    client = client_.get();
-    qos = config_.data_qos;
+  payload.build_into(payload_data);
+  const size_t size = payload_data.size() + SEQ_FIELD_MAX_SIZE;
+  if (auto size_ok = check_payload_size("NBIRTH", *topic, qos, size); !size_ok) {
+    return size_ok;
   }
 
-  auto result = publish_message(client, topic_str, payload_data, qos, false);
+  auto result = send_in_sequence({.client = client, .topic = topic, .qos = qos},
+                                 {.bytes = &payload_data}, true);
   if (!result) {
     return result;
   }
 
   {
     std::scoped_lock lock(mutex_);
-    last_birth_payload_ = std::move(payload_data);
-    seq_num_ = 0;
+    last_birth_payload_.assign(payload_data.begin(), payload_data.end());
+    birth_sent_ = true;
   }
+  replay_wake_.notify_all();
 
   return {};
 }
 
-stdx::expected<void, std::string> EdgeNode::publish_data(PayloadBuilder& payload) {
-  MQTTAsync client = nullptr;
-  std::string topic_str;
-  std::vector<uint8_t> payload_data;
+stdx::expected<void, std::string>
+EdgeNode::register_template(const TemplateDefinition& definition) {
+  std::scoped_lock lock(mutex_);
+  auto it = std::ranges::find(templates_, definition.name(), &TemplateDefinition::name);
+  if (it != templates_.end()) {
+    if (*it == definition) {
+      return {};
+    }
+    return stdx::unexpected(
+        std::format("Template '{}' is already registered with a different definition",
+                    definition.name()));
+  }
+  templates_.push_back(definition);
+  return {};
+}
+
+stdx::expected<void, std::string>
+EdgeNode::send_data(PayloadBuilder& payload, const PublishToken* token, bool may_store) {
+  std::shared_ptr<MQTTAsyncHandle> client;
+  const std::string* topic = nullptr;
+  auto& payload_data = publish_buffer();
   int qos = 0;
 
+  bool store = false;
+
   {
     std::scoped_lock lock(mutex_);
 
-    if (!is_connected_) {
+    // Decided with the connection check, so a drop in between cannot lose the message
+    store = may_store && should_store({});
+    if (!store && (!is_connected_ || reconnecting_)) {
       return stdx::unexpected("Not connected");
     }
 
-    seq_num_ = (seq_num_ + 1) % SEQ_NUMBER_MAX;
+    topic = &node_topics_.data;
+    client = client_;
+    qos = config_.data_qos;
+  }
 
-    if (!payload.has_seq()) {
-      payload.set_seq(seq_num_);
+  if (store) {
+    payload.build_into(payload_data);
+    return store_data({}, payload_data);
+  }
+
+  const PublishSequencer::Route route{
+      .client = client, .topic = topic, .qos = qos, .token = token};
+  if (auto budget = payload_budget(*topic, qos)) {
+    auto& chunks = split_chunks();
+    auto split = payload.split(*budget, chunks);
+    if (!split) {
+      return split;
+    }
+    if (chunks.size() > 1) {
+      return publish_chunks(payload, chunks, route);
     }
+  }
 
-    Topic topic{.group_id = config_.group_id,
-                .message_type = MessageType::NDATA,
-                .edge_node_id = config_.edge_node_id,
-                .device_id = ""};
+  // Encoded without a seq (unless the caller set one); the send path assigns it
+  payload.build_into(payload_data);
+  auto result = send_in_sequence(
+      route, {.bytes = &payload_data, .assign_seq = !payload.has_seq()});
+  if (result) {
+    note_data_sent();
+  }
+  return result;
+}
 
-    topic_str = topic.to_string();
-    payload_data = payload.build();
-    client = client_.get();
+stdx::expected<size_t, std::string> EdgeNode::publish_changed(DeadbandFilter& filter,
+                                                              PayloadBuilder& payload) {
+  payload.reset();
+  size_t count = filter.collect(payload);
+  if (count == 0) {
+    return 0;
+  }
+
+  auto result = publish_data(payload);
+  if (!result) {
+    return stdx::unexpected(result.error());
+  }
+  filter.commit();
+  return count;
+}
+
+stdx::expected<void, std::string> EdgeNode::send_data(FrozenPayload& payload,
+                                                      const PublishToken* token) {
+  std::shared_ptr<MQTTAsyncHandle> client;
+  const std::string* topic = nullptr;
+  int qos = 0;
+
+  bool store = false;
+
+  {
+    std::scoped_lock lock(mutex_);
+
+    store = should_store({});
+    if (!store && (!is_connected_ || reconnecting_)) {
+      return stdx::unexpected("Not connected");
+    }
+
+    topic = &node_topics_.data;
+    client = client_;
     qos = config_.data_qos;
   }
 
-  return publish_message(client, topic_str, payload_data, qos, false);
+  if (store) {
+    return store_data({}, payload.bytes());
+  }
+
+  if (auto size_ok = check_payload_size("NDATA", *topic, qos, payload.bytes().size());
+      !size_ok) {
+    return size_ok;
+  }
+  auto result =
+      send_in_sequence({.client = client, .topic = topic, .qos = qos, .token = token},
+                       {.frozen = &payload});
+  if (result) {
+    note_data_sent();
+  }
+  return result;
 }
 
 stdx::expected<void, std::string> EdgeNode::publish_death() {
-  MQTTAsync client = nullptr;
-  std::string topic_str;
-  std::vector<uint8_t> payload_data;
+  std::shared_ptr<MQTTAsyncHandle> client;
+  const std::string* topic = nullptr;
+  auto& payload_data = publish_buffer();
   int qos = 0;
+  uint64_t bd_seq = 0;
 
   {
     std::scoped_lock lock(mutex_);
@@ -531,27 +1248,19 @@ stdx::expected<void, std::string> EdgeNode::publish_death() {
       return stdx::unexpected("Not connected");
     }
 
-    seq_num_ = (seq_num_ + 1) % 256;
-
-    PayloadBuilder death_payload;
-    death_payload.add_metric("bdSeq", bd_seq_num_);
-    death_payload.set_seq(seq_num_);
-    death_payload.set_timestamp(std::chrono::duration_cast<std::chrono::milliseconds>(
-                                    std::chrono::system_clock::now().time_since_epoch())
-                                    .count());
-
-    Topic topic{.group_id = config_.group_id,
-                .message_type = MessageType::NDEATH,
-                .edge_node_id = config_.edge_node_id,
-                .device_id = ""};
-
-    topic_str = topic.to_string();
-    payload_data = death_payload.build();
-    client = client_.get();
+    bd_seq = bd_seq_num_;
+    topic = &node_topics_.death;
+    client = client_;
     qos = config_.death_qos;
   }
 
-  auto result = publish_message(client, topic_str, payload_data, qos, false);
+  PayloadBuilder death_payload({.clock = config_.clock});
+  death_payload.add_metric("bdSeq", bd_seq);
+  death_payload.set_timestamp(config_.clock.now_ms());
+  death_payload.build_into(payload_data);
+
+  auto result = send_in_sequence({.client = client, .topic = topic, .qos = qos},
+                                 {.bytes = &payload_data});
   if (!result) {
     return result;
   }
@@ -561,8 +1270,9 @@ stdx::expected<void, std::string> EdgeNode::publish_death() {
 
 stdx::expected<void, std::string> EdgeNode::rebirth() {
   std::vector<uint8_t> payload_data;
-  std::string topic_str;
+  const std::string* topic = nullptr;
   int qos = 0;
+  uint64_t new_bdseq = 0;
 
   {
     std::scoped_lock lock(mutex_);
@@ -575,52 +1285,52 @@ stdx::expected<void, std::string> EdgeNode::rebirth() {
       return stdx::unexpected("No previous birth payload stored");
     }
 
-    org::eclipse::tahu::protobuf::Payload proto_payload;
-    if (!proto_payload.ParseFromArray(last_birth_payload_.data(),
-                                      static_cast<int>(last_birth_payload_.size()))) {
-      return stdx::unexpected("Failed to parse stored birth payload");
-    }
+    payload_data = last_birth_payload_;
+    new_bdseq = bd_seq_num_ + 1;
+    topic = &node_topics_.birth;
+    qos = config_.data_qos;
+  }
 
-    uint64_t new_bdseq = bd_seq_num_ + 1;
+  org::eclipse::tahu::protobuf::Payload proto_payload;
+  if (!proto_payload.ParseFromArray(payload_data.data(),
+                                    static_cast<int>(payload_data.size()))) {
+    return stdx::unexpected("Failed to parse stored birth payload");
+  }
 
-    for (auto& metric : *proto_payload.mutable_metrics()) {
-      if (metric.name() == "bdSeq") {
-        metric.set_long_value(new_bdseq);
-        break;
-      }
+  for (auto& metric : *proto_payload.mutable_metrics()) {
+    if (metric.name() == "bdSeq") {
+      metric.set_long_value(new_bdseq);
+      break;
     }
+  }
 
-    proto_payload.set_seq(0);
-
-    payload_data.resize(proto_payload.ByteSizeLong());
-    proto_payload.SerializeToArray(payload_data.data(),
-                                   static_cast<int>(payload_data.size()));
-    last_birth_payload_ = payload_data;
-
-    Topic topic{.group_id = config_.group_id,
-                .message_type = MessageType::NBIRTH,
-                .edge_node_id = config_.edge_node_id,
-                .device_id = ""};
+  proto_payload.clear_seq(); // The send path gives NBIRTH seq 0
 
-    topic_str = topic.to_string();
-    qos = config_.data_qos;
+  payload_data.resize(proto_payload.ByteSizeLong());
+  proto_payload.SerializeToArray(payload_data.data(),
+                                 static_cast<int>(payload_data.size()));
 
-    // Update NDEATH Will Testament payload with new bdSeq BEFORE disconnecting
-    // This ensures the Will Testament sent during disconnect has the correct bdSeq
-    PayloadBuilder death_payload;
-    death_payload.add_metric("bdSeq", new_bdseq);
-    death_payload_data_ = death_payload.build();
+  // Update NDEATH Will Testament payload with new bdSeq BEFORE disconnecting
+  // This ensures the Will Testament sent during disconnect has the correct bdSeq
+  PayloadBuilder death_payload({.clock = config_.clock});
+  death_payload.add_metric("bdSeq", new_bdseq);
+  auto death_payload_data = death_payload.build();
+  {
+    std::scoped_lock lock(session_mutex_, mutex_);
+    death_payload_data_ = std::move(death_payload_data);
   }
 
   auto result = disconnect()
                     .and_then([this]() { return connect(); })
-                    .and_then([this, &topic_str, &payload_data, qos]() {
-                      MQTTAsync client = nullptr;
+                    .and_then([this, topic, &payload_data, qos]() {
+                      std::shared_ptr<MQTTAsyncHandle> client;
                       {
                         std::scoped_lock lock(mutex_);
-                        client = client_.get();
+                        client = client_;
                       }
-                      return publish_message(client, topic_str, payload_data, qos, false);
+                      return send_in_sequence(
+                          {.client = client, .topic = topic, .qos = qos},
+                          {.bytes = &payload_data}, true);
                     });
 
   if (!result) {
@@ -629,17 +1339,20 @@ stdx::expected<void, std::string> EdgeNode::rebirth() {
 
   {
     std::scoped_lock lock(mutex_);
-    seq_num_ = 0;
+    last_birth_payload_ = std::move(payload_data);
+    birth_sent_ = true;
   }
+  replay_wake_.notify_all();
 
   return {};
 }
 
 stdx::expected<void, std::string>
 EdgeNode::publish_device_birth(std::string_view device_id, PayloadBuilder& payload) {
-  MQTTAsync client = nullptr;
-  std::string topic_str;
-  std::vector<uint8_t> payload_data;
+  std::shared_ptr<MQTTAsyncHandle> client;
+  DeviceTopics new_topics; // Only rendered for a device's first DBIRTH
+  const DeviceTopics* topics = nullptr;
+  auto& payload_data = publish_buffer();
   int qos = 0;
 
   {
@@ -657,29 +1370,29 @@ EdgeNode::publish_device_birth(std::string_view device_id, PayloadBuilder& paylo
       return stdx::unexpected("Must publish NBIRTH before DBIRTH");
     }
 
-    seq_num_ = (seq_num_ + 1) % SEQ_NUMBER_MAX;
-    payload.set_seq(seq_num_);
-
-    Topic topic{.group_id = config_.group_id,
-                .message_type = MessageType::DBIRTH,
-                .edge_node_id = config_.edge_node_id,
-                .device_id = std::string(device_id)};
+    if (reconnecting_) {
+      return stdx::unexpected("Reconnecting; DBIRTHs are re-sent automatically");
+    }
 
-    topic_str = topic.to_string();
-    payload_data = payload.build();
-    client = client_.get();
+    if (auto it = device_states_.find(device_id); it != device_states_.end()) {
+      topics = &it->second.topics;
+    } else {
+      new_topics = render_device_topics(device_id);
+      topics = &new_topics;
+    }
+    client = client_;
     qos = config_.data_qos;
   }
 
+  payload.clear_seq(); // Assigned by the send path
+  payload.build_into(payload_data);
+  const size_t size = payload_data.size() + SEQ_FIELD_MAX_SIZE;
+  if (auto size_ok = check_payload_size("DBIRTH", topics->birth, qos, size); !size_ok) {
+    return size_ok;
+  }
+
   // Subscribe to DCMD for this device BEFORE publishing DBIRTH (required by Sparkplug
   // spec)
-  Topic dcmd_topic{.group_id = config_.group_id,
-                   .message_type = MessageType::DCMD,
-                   .edge_node_id = config_.edge_node_id,
-                   .device_id = std::string(device_id)};
-
-  auto dcmd_topic_str = dcmd_topic.to_string();
-
   std::promise<void> subscribe_promise;
   auto subscribe_future = subscribe_promise.get_future();
 
@@ -688,7 +1401,8 @@ EdgeNode::publish_device_birth(std::string_view device_id, PayloadBuilder& paylo
   sub_opts.onSuccess = on_subscribe_success;
   sub_opts.onFailure = on_subscribe_failure;
 
-  int rc = MQTTAsync_subscribe(client, dcmd_topic_str.c_str(), 1, &sub_opts);
+  int rc =
+      MQTTAsync_subscribe(raw_client(client), topics->command.c_str(), 1, &sub_opts);
   if (rc != MQTTASYNC_SUCCESS) {
     return stdx::unexpected(std::format("Failed to subscribe to DCMD: {}", rc));
   }
@@ -705,32 +1419,49 @@ EdgeNode::publish_device_birth(std::string_view device_id, PayloadBuilder& paylo
     return stdx::unexpected(std::format("DCMD subscription failed: {}", e.what()));
   }
 
-  auto result = publish_message(client, topic_str, payload_data, qos, false);
+  // The send path appends the seq to payload_data; the cached DBIRTH is kept without
+  // it, so an automatic reconnect can re-send it as it is
+  const size_t unsequenced_size = payload_data.size();
+  auto result = send_in_sequence({.client = client, .topic = &topics->birth, .qos = qos},
+                                 {.bytes = &payload_data});
   if (!result) {
     return result;
   }
 
   {
     std::scoped_lock lock(mutex_);
-    auto& device_state = device_states_[std::string(device_id)];
-    device_state.last_birth_payload = std::move(payload_data);
+    auto [it, inserted] = device_states_.try_emplace(std::string(device_id));
+    auto& device_state = it->second;
+    if (inserted) {
+      device_state.topics = std::move(new_topics);
+    }
+    device_state.last_birth_payload.assign(payload_data.begin(),
+                                           payload_data.begin() + unsequenced_size);
     device_state.is_online = true;
+    device_state.birth_bd_seq = bd_seq_num_;
   }
+  replay_wake_.notify_all();
 
   return {};
 }
 
-stdx::expected<void, std::string>
-EdgeNode::publish_device_data(std::string_view device_id, PayloadBuilder& payload) {
-  MQTTAsync client = nullptr;
-  std::string topic_str;
-  std::vector<uint8_t> payload_data;
+stdx::expected<void, std::string> EdgeNode::send_device_data(std::string_view device_id,
+                                                             PayloadBuilder& payload,
+                                                             const PublishToken* token,
+                                                             bool may_store) {
+  std::shared_ptr<MQTTAsyncHandle> client;
+  const std::string* topic = nullptr;
+  auto& payload_data = publish_buffer();
   int qos = 0;
 
+  bool store = false;
+
   {
     std::scoped_lock lock(mutex_);
 
-    if (!is_connected_) {
+    // Decided with the connection check, so a drop in between cannot lose the message
+    store = may_store && should_store(device_id);
+    if (!store && (!is_connected_ || reconnecting_)) {
       return stdx::unexpected("Not connected");
     }
 
@@ -740,31 +1471,143 @@ EdgeNode::publish_device_data(std::string_view device_id, PayloadBuilder& payloa
           std::format("Must publish DBIRTH for device '{}' before DDATA", device_id));
     }
 
-    seq_num_ = (seq_num_ + 1) % SEQ_NUMBER_MAX;
+    topic = &it->second.topics.data;
+    client = client_;
+    qos = config_.data_qos;
+  }
+
+  if (store) {
+    payload.build_into(payload_data);
+    return store_data(device_id, payload_data);
+  }
 
-    if (!payload.has_seq()) {
-      payload.set_seq(seq_num_);
+  const PublishSequencer::Route route{
+      .client = client, .topic = topic, .qos = qos, .token = token};
+  if (auto budget = payload_budget(*topic, qos)) {
+    auto& chunks = split_chunks();
+    auto split = payload.split(*budget, chunks);
+    if (!split) {
+      return split;
     }
+    if (chunks.size() > 1) {
+      return publish_chunks(payload, chunks, route);
+    }
+  }
 
-    Topic topic{.group_id = config_.group_id,
-                .message_type = MessageType::DDATA,
-                .edge_node_id = config_.edge_node_id,
-                .device_id = std::string(device_id)};
+  // Encoded without a seq (unless the caller set one); the send path assigns it
+  payload.build_into(payload_data);
+  auto result = send_in_sequence(
+      route, {.bytes = &payload_data, .assign_seq = !payload.has_seq()});
+  if (result) {
+    note_data_sent();
+  }
+  return result;
+}
+
+stdx::expected<void, std::string> EdgeNode::send_device_data(std::string_view device_id,
+                                                             FrozenPayload& payload,
+                                                             const PublishToken* token) {
+  std::shared_ptr<MQTTAsyncHandle> client;
+  const std::string* topic = nullptr;
+  int qos = 0;
+
+  bool store = false;
+
+  {
+    std::scoped_lock lock(mutex_);
+
+    store = should_store(device_id);
+    if (!store && (!is_connected_ || reconnecting_)) {
+      return stdx::unexpected("Not connected");
+    }
 
-    topic_str = topic.to_string();
-    payload_data = payload.build();
-    client = client_.get();
+    auto it = device_states_.find(device_id);
+    if (it == device_states_.end() || !it->second.is_online) {
+      return stdx::unexpected(
+          std::format("Must publish DBIRTH for device '{}' before DDATA", device_id));
+    }
+
+    topic = &it->second.topics.data;
+    client = client_;
     qos = config_.data_qos;
   }
 
-  return publish_message(client, topic_str, payload_data, qos, false);
+  if (store) {
+    return store_data(device_id, payload.bytes());
+  }
+
+  if (auto size_ok = check_payload_size("DDATA", *topic, qos, payload.bytes().size());
+      !size_ok) {
+    return size_ok;
+  }
+  auto result =
+      send_in_sequence({.client = client, .topic = topic, .qos = qos, .token = token},
+                       {.frozen = &payload});
+  if (result) {
+    note_data_sent();
+  }
+  return result;
+}
+
+stdx::expected<void, std::string> EdgeNode::publish_data(PayloadBuilder& payload) {
+  return send_data(payload, nullptr);
+}
+
+stdx::expected<void, std::string> EdgeNode::publish_data(FrozenPayload& payload) {
+  return send_data(payload, nullptr);
+}
+
+stdx::expected<void, std::string>
+EdgeNode::publish_device_data(std::string_view device_id, PayloadBuilder& payload) {
+  return send_device_data(device_id, payload, nullptr);
+}
+
+stdx::expected<void, std::string>
+EdgeNode::publish_device_data(std::string_view device_id, FrozenPayload& payload) {
+  return send_device_data(device_id, payload, nullptr);
+}
+
+stdx::expected<PublishToken, std::string>
+EdgeNode::publish_data_async(PayloadBuilder& payload, PublishCallback on_complete) {
+  return publishes_->publish(std::move(on_complete), PUBLISH_SLOT_TIMEOUT,
+                             [&](const PublishToken& token) {
+                               return send_data(payload, &token);
+                             });
+}
+
+stdx::expected<PublishToken, std::string>
+EdgeNode::publish_data_async(FrozenPayload& payload, PublishCallback on_complete) {
+  return publishes_->publish(std::move(on_complete), PUBLISH_SLOT_TIMEOUT,
+                             [&](const PublishToken& token) {
+                               return send_data(payload, &token);
+                             });
+}
+
+stdx::expected<PublishToken, std::string>
+EdgeNode::publish_device_data_async(std::string_view device_id,
+                                    PayloadBuilder& payload,
+                                    PublishCallback on_complete) {
+  return publishes_->publish(std::move(on_complete), PUBLISH_SLOT_TIMEOUT,
+                             [&](const PublishToken& token) {
+                               return send_device_data(device_id, payload, &token);
+                             });
+}
+
+stdx::expected<PublishToken, std::string>
+EdgeNode::publish_device_data_async(std::string_view device_id,
+                                    FrozenPayload& payload,
+                                    PublishCallback on_complete) {
+  return publishes_->publish(std::move(on_complete), PUBLISH_SLOT_TIMEOUT,
+                             [&](const PublishToken& token) {
+                               return send_device_data(device_id, payload, &token);
+                             });
 }
 
 stdx::expected<void, std::string>
 EdgeNode::publish_device_death(std::string_view device_id) {
-  MQTTAsync client = nullptr;
-  std::string topic_str;
-  std::vector<uint8_t> payload_data;
+  std::shared_ptr<MQTTAsyncHandle> client;
+  const std::string* topic = nullptr;
+  auto& payload_data = publish_buffer();
   int qos = 0;
 
   {
@@ -779,26 +1622,17 @@ EdgeNode::publish_device_death(std::string_view device_id) {
       return stdx::unexpected(std::format("Unknown device: '{}'", device_id));
     }
 
-    seq_num_ = (seq_num_ + 1) % 256;
-
-    PayloadBuilder death_payload;
-    death_payload.set_seq(seq_num_);
-    death_payload.set_timestamp(std::chrono::duration_cast<std::chrono::milliseconds>(
-                                    std::chrono::system_clock::now().time_since_epoch())
-                                    .count());
-
-    Topic topic{.group_id = config_.group_id,
-                .message_type = MessageType::DDEATH,
-                .edge_node_id = config_.edge_node_id,
-                .device_id = std::string(device_id)};
-
-    topic_str = topic.to_string();
-    payload_data = death_payload.build();
-    client = client_.get();
+    topic = &it->second.topics.death;
+    client = client_;
     qos = config_.data_qos;
   }
 
-  auto result = publish_message(client, topic_str, payload_data, qos, false);
+  PayloadBuilder death_payload({.clock = config_.clock});
+  death_payload.set_timestamp(config_.clock.now_ms());
+  death_payload.build_into(payload_data);
+
+  auto result = send_in_sequence({.client = client, .topic = topic, .qos = qos},
+                                 {.bytes = &payload_data});
   if (!result) {
     return result;
   }
@@ -817,9 +1651,9 @@ EdgeNode::publish_device_death(std::string_view device_id) {
 stdx::expected<void, std::string>
 EdgeNode::publish_node_command(std::string_view target_edge_node_id,
                                PayloadBuilder& payload) {
-  MQTTAsync client = nullptr;
-  std::string topic_str;
-  std::vector<uint8_t> payload_data;
+  std::shared_ptr<MQTTAsyncHandle> client;
+  auto& topic_str = command_topic_buffer();
+  auto& payload_data = publish_buffer();
   int qos = 0;
 
   {
@@ -829,27 +1663,29 @@ EdgeNode::publish_node_command(std::string_view target_edge_node_id,
       return stdx::unexpected("Not connected");
     }
 
-    Topic topic{.group_id = config_.group_id,
-                .message_type = MessageType::NCMD,
-                .edge_node_id = std::string(target_edge_node_id),
-                .device_id = ""};
-
-    topic_str = topic.to_string();
-    payload_data = payload.build();
-    client = client_.get();
+    client = client_;
     qos = config_.data_qos;
   }
 
-  return publish_message(client, topic_str, payload_data, qos, false);
+  topic_str.clear();
+  TopicView{.group_id = config_.group_id,
+            .message_type = MessageType::NCMD,
+            .edge_node_id = target_edge_node_id,
+            .device_id = {}}
+      .format_to(std::back_inserter(topic_str));
+  payload.build_into(payload_data);
+
+  return send_message(raw_client(client), topic_str, payload_data, qos, false, nullptr,
+                      nullptr);
 }
 
 stdx::expected<void, std::string>
 EdgeNode::publish_device_command(std::string_view target_edge_node_id,
                                  std::string_view target_device_id,
                                  PayloadBuilder& payload) {
-  MQTTAsync client = nullptr;
-  std::string topic_str;
-  std::vector<uint8_t> payload_data;
+  std::shared_ptr<MQTTAsyncHandle> client;
+  auto& topic_str = command_topic_buffer();
+  auto& payload_data = publish_buffer();
   int qos = 0;
 
   {
@@ -859,18 +1695,20 @@ EdgeNode::publish_device_command(std::string_view target_edge_node_id,
       return stdx::unexpected("Not connected");
     }
 
-    Topic topic{.group_id = config_.group_id,
-                .message_type = MessageType::DCMD,
-                .edge_node_id = std::string(target_edge_node_id),
-                .device_id = std::string(target_device_id)};
-
-    topic_str = topic.to_string();
-    payload_data = payload.build();
-    client = client_.get();
+    client = client_;
     qos = config_.data_qos;
   }
 
-  return publish_message(client, topic_str, payload_data, qos, false);
+  topic_str.clear();
+  TopicView{.group_id = config_.group_id,
+            .message_type = MessageType::DCMD,
+            .edge_node_id = target_edge_node_id,
+            .device_id = target_device_id}
+      .format_to(std::back_inserter(topic_str));
+  payload.build_into(payload_data);
+
+  return send_message(raw_client(client), topic_str, payload_data, qos, false, nullptr,
+                      nullptr);
 }
 
 void EdgeNode::log(LogLevel level, std::string_view message) const noexcept {
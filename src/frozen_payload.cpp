@@ -0,0 +1,246 @@
+// src/frozen_payload.cpp
+#include "sparkplug/frozen_payload.hpp"
+
+#include <cstring>
+#include <format>
+#include <variant>
+
+namespace sparkplug {
+
+namespace {
+
+bool is_string_type(DataType type) noexcept {
+  return type == DataType::String || type == DataType::Text || type == DataType::UUID;
+}
+
+// Whether a value mapped to value_type may be stored in a metric frozen as slot_type
+bool is_compatible(DataType slot_type, DataType value_type) noexcept {
+  if (slot_type == value_type) {
+    return true;
+  }
+  if (is_string_type(slot_type) && is_string_type(value_type)) {
+    return true;
+  }
+  return slot_type == DataType::DateTime &&
+         (value_type == DataType::Int64 || value_type == DataType::UInt64);
+}
+
+size_t value_width(const wire::MetricValue& value) noexcept {
+  return std::visit(
+      [](const auto& v) -> size_t {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, std::monostate>) {
+          return 0;
+        } else if constexpr (std::is_same_v<T, uint32_t> || std::is_same_v<T, uint64_t>) {
+          return wire::varint_size(v);
+        } else if constexpr (std::is_same_v<T, float>) {
+          return 4;
+        } else if constexpr (std::is_same_v<T, double>) {
+          return 8;
+        } else if constexpr (std::is_same_v<T, bool>) {
+          return 1;
+        } else if constexpr (std::is_same_v<T, std::string_view>) {
+          return v.size();
+        } else {
+          return v.data.size();
+        }
+      },
+      value);
+}
+
+} // namespace
+
+stdx::expected<FrozenPayload, std::string>
+FrozenPayload::freeze(const PayloadBuilder& builder) {
+  const auto& payload = builder.payload();
+  if (payload.has_uuid() || payload.has_body() || !payload.unknown_fields().empty()) {
+    return stdx::unexpected("Payload uuid, body and unknown fields cannot be frozen");
+  }
+
+  FrozenPayload frozen;
+  frozen.slots_.resize(payload.metrics_size());
+  for (int i = 0; i < payload.metrics_size(); i++) {
+    auto& slot = frozen.slots_[i];
+    if (!detail::to_wire_metric(payload.metrics(i), slot.metric)) {
+      return stdx::unexpected(std::format(
+          "Metric {} cannot be frozen (metadata, properties or complex value)", i));
+    }
+
+    // Own everything the wire description points at
+    slot.name = slot.metric.name;
+    if (auto* str = std::get_if<std::string_view>(&slot.metric.value)) {
+      slot.text = *str;
+    } else if (auto* bytes = std::get_if<wire::Bytes>(&slot.metric.value)) {
+      slot.text.assign(reinterpret_cast<const char*>(bytes->data.data()),
+                       bytes->data.size());
+    }
+  }
+
+  frozen.timestamp_ =
+      payload.has_timestamp() ? payload.timestamp() : builder.options().clock.now_ms();
+  frozen.seq_ = payload.has_seq() ? payload.seq() : 0;
+
+  frozen.encode();
+  return frozen;
+}
+
+FrozenPayload& FrozenPayload::set_timestamp(uint64_t timestamp_ms) noexcept {
+  timestamp_ = timestamp_ms;
+  patch_varint(timestamp_field_, timestamp_ms);
+  return *this;
+}
+
+FrozenPayload& FrozenPayload::set_seq(uint64_t seq) noexcept {
+  seq_ = seq;
+  if (dirty_) {
+    return *this;
+  }
+
+  // seq is the last field, so a width change only moves the end of the buffer
+  size_t width = wire::varint_size(seq);
+  if (width != seq_field_.width) {
+    bytes_.resize(seq_field_.offset + width);
+    seq_field_.width = width;
+  }
+  wire::write_varint(bytes_.data() + seq_field_.offset, seq);
+  return *this;
+}
+
+std::span<const uint8_t> FrozenPayload::bytes() {
+  if (dirty_) {
+    encode();
+    reencode_count_++;
+  }
+  return bytes_;
+}
+
+stdx::expected<void, std::string>
+FrozenPayload::set_value(size_t index,
+                         DataType datatype,
+                         const wire::MetricValue& value,
+                         std::optional<uint64_t> timestamp_ms) {
+  if (index >= slots_.size()) {
+    return stdx::unexpected(
+        std::format("Metric index {} out of range ({} metrics)", index, slots_.size()));
+  }
+
+  auto& slot = slots_[index];
+  if (std::holds_alternative<std::monostate>(slot.metric.value)) {
+    return stdx::unexpected(std::format("Metric {} was frozen without a value", index));
+  }
+  if (!slot.metric.datatype || !is_compatible(*slot.metric.datatype, datatype) ||
+      slot.metric.value.index() != value.index()) {
+    return stdx::unexpected(std::format(
+        "Metric {} datatype mismatch: frozen as {}, got {}", index,
+        slot.metric.datatype ? std::to_underlying(*slot.metric.datatype) : 0,
+        std::to_underlying(datatype)));
+  }
+  if (timestamp_ms && !slot.metric.timestamp) {
+    return stdx::unexpected(
+        std::format("Metric {} was frozen without a timestamp", index));
+  }
+
+  std::visit(
+      [this, &slot](const auto& v) {
+        using T = std::decay_t<decltype(v)>;
+        slot.metric.value = v;
+        if constexpr (std::is_same_v<T, uint32_t> || std::is_same_v<T, uint64_t>) {
+          patch_varint(slot.value, v);
+        } else if constexpr (std::is_same_v<T, float>) {
+          if (!dirty_) {
+            wire::write_fixed32(bytes_.data() + slot.value.offset,
+                                std::bit_cast<uint32_t>(v));
+          }
+        } else if constexpr (std::is_same_v<T, double>) {
+          if (!dirty_) {
+            wire::write_fixed64(bytes_.data() + slot.value.offset,
+                                std::bit_cast<uint64_t>(v));
+          }
+        } else if constexpr (std::is_same_v<T, bool>) {
+          if (!dirty_) {
+            bytes_[slot.value.offset] = v ? 1 : 0;
+          }
+        } else if constexpr (std::is_same_v<T, std::string_view>) {
+          slot.text.assign(v.data(), v.size());
+          if (!dirty_ && v.size() == slot.value.width) {
+            if (!v.empty()) {
+              std::memcpy(bytes_.data() + slot.value.offset, v.data(), v.size());
+            }
+          } else {
+            dirty_ = true;
+          }
+        }
+      },
+      value);
+
+  if (timestamp_ms) {
+    slot.metric.timestamp = *timestamp_ms;
+    patch_varint(slot.timestamp, *timestamp_ms);
+  }
+  return {};
+}
+
+bool FrozenPayload::patch_varint(const Field& field, uint64_t value) noexcept {
+  if (dirty_ || wire::varint_size(value) != field.width) {
+    dirty_ = true;
+    return false;
+  }
+  wire::write_varint(bytes_.data() + field.offset, value);
+  return true;
+}
+
+void FrozenPayload::encode() {
+  encoder_.clear();
+  if (timestamp_) {
+    encoder_.set_timestamp(*timestamp_);
+  }
+  for (auto& slot : slots_) {
+    // Refresh views into the owned storage (slots may have been moved since last time)
+    slot.metric.name = slot.name;
+    if (std::holds_alternative<std::string_view>(slot.metric.value)) {
+      slot.metric.value = std::string_view(slot.text);
+    } else if (std::holds_alternative<wire::Bytes>(slot.metric.value)) {
+      slot.metric.value = wire::Bytes{std::span(
+          reinterpret_cast<const uint8_t*>(slot.text.data()), slot.text.size())};
+    }
+    encoder_.add_metric(slot.metric);
+  }
+  encoder_.set_seq(seq_);
+  encoder_.encode_into(bytes_);
+
+  // Record where every patchable field landed (mirrors the encoder's field order)
+  size_t pos = 0;
+  if (timestamp_) {
+    timestamp_field_ = {.offset = 1, .width = wire::varint_size(*timestamp_)};
+    pos = timestamp_field_.offset + timestamp_field_.width;
+  }
+  for (auto& slot : slots_) {
+    const auto& metric = slot.metric;
+    size_t body_size = wire::metric_body_size(metric);
+    size_t body_start = pos + 1 + wire::varint_size(body_size);
+
+    if (metric.timestamp) {
+      size_t offset = body_start;
+      if (!metric.name.empty()) {
+        offset += 1 + wire::varint_size(metric.name.size()) + metric.name.size();
+      }
+      if (metric.alias) {
+        offset += 1 + wire::varint_size(*metric.alias);
+      }
+      slot.timestamp = {.offset = offset + 1,
+                        .width = wire::varint_size(*metric.timestamp)};
+    } else {
+      slot.timestamp = {};
+    }
+
+    // The value is always the last field of the metric body
+    size_t width = value_width(metric.value);
+    slot.value = {.offset = body_start + body_size - width, .width = width};
+    pos = body_start + body_size;
+  }
+  seq_field_ = {.offset = pos + 1, .width = wire::varint_size(seq_)};
+
+  dirty_ = false;
+}
+
+} // namespace sparkplug
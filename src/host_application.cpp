@@ -3,6 +3,7 @@
 
 #include "sparkplug/topic.hpp"
 
+#include <array>
 #include <cstring>
 #include <format>
 #include <future>
@@ -16,6 +17,9 @@ namespace sparkplug {
 namespace {
 constexpr int CONNECTION_TIMEOUT_MS = 10000; // Increased from 5s to 10s
 constexpr int DISCONNECT_TIMEOUT_MS = 11000;
+// How long a publish waits for a free completion slot, and STATE for its completion
+constexpr std::chrono::milliseconds PUBLISH_SLOT_TIMEOUT{5000};
+constexpr std::chrono::milliseconds PUBLISH_TIMEOUT{5000};
 constexpr uint64_t SEQ_NUMBER_MAX = 256;
 
 void on_connect_success(void* context, MQTTAsync_successData* response) {
@@ -48,9 +52,31 @@ void on_disconnect_failure(void* context, MQTTAsync_failureData* response) {
   promise->set_exception(std::make_exception_ptr(std::runtime_error(error)));
 }
 
+constexpr std::string_view STATE_TOPIC_PREFIX = "spBv1.0/STATE/";
+
+// Hash of (group_id, edge_node_id) taken straight from the topic string, so every
+// message of a node and its devices is queued on the same ingest worker
+uint64_t node_shard_key(std::string_view topic) {
+  std::array<std::string_view, 4> segments{}; // namespace/group/type/node
+  for (auto& segment : segments) {
+    auto slash = topic.find('/');
+    segment = topic.substr(0, slash);
+    if (slash == std::string_view::npos) {
+      break;
+    }
+    topic.remove_prefix(slash + 1);
+  }
+  size_t h1 = std::hash<std::string_view>{}(segments[1]);
+  size_t h2 = std::hash<std::string_view>{}(segments[3]);
+  return h1 ^ (h2 + 0x9e3779b97f4a7c15ULL + (h1 << 6) + (h1 >> 2));
+}
+
 } // namespace
 
-HostApplication::HostApplication(Config config) : config_(std::move(config)) {
+HostApplication::HostApplication(Config config)
+    : config_(std::move(config)),
+      publishes_(std::make_shared<PublishTracker>(config_.max_pending_publishes)),
+      last_values_(std::make_unique<LastValueCache>()) {
 }
 
 HostApplication::~HostApplication() {
@@ -59,13 +85,24 @@ HostApplication::~HostApplication() {
   } else if (client_) {
     MQTTAsync_setCallbacks(client_.get(), nullptr, nullptr, nullptr, nullptr);
   }
+  stop_ingest();
+  client_.reset();
+  if (publishes_) {
+    auto abandoned =
+        publishes_->abandon("HostApplication destroyed before the publish completed");
+    PublishTracker::run(abandoned);
+  }
 }
 
 HostApplication::HostApplication(HostApplication&& other) noexcept
-    : config_(std::move(other.config_)), client_(std::move(other.client_)),
-      is_connected_(other.is_connected_) {
+    : config_(std::move(other.config_)), publishes_(std::move(other.publishes_)),
+      client_(std::move(other.client_)),
+      is_connected_(other.is_connected_), last_values_(std::move(other.last_values_)) {
   std::scoped_lock lock(other.mutex_);
   other.is_connected_ = false;
+  // A tracker of its own, so publishes on the moved-from host fail rather than crash
+  other.publishes_ =
+      std::make_shared<PublishTracker>(other.config_.max_pending_publishes);
 }
 
 HostApplication& HostApplication::operator=(HostApplication&& other) noexcept {
@@ -74,13 +111,22 @@ HostApplication& HostApplication::operator=(HostApplication&& other) noexcept {
     std::scoped_lock lock(mutex_, other.mutex_);
 
     config_ = std::move(other.config_);
+    publishes_ = std::move(other.publishes_);
     client_ = std::move(other.client_);
     is_connected_ = other.is_connected_;
+    last_values_ = std::move(other.last_values_);
     other.is_connected_ = false;
+    other.publishes_ =
+        std::make_shared<PublishTracker>(other.config_.max_pending_publishes);
   }
   return *this;
 }
 
+const LastValueCache& HostApplication::last_values() const noexcept {
+  static const LastValueCache empty;
+  return last_values_ ? *last_values_ : empty;
+}
+
 void HostApplication::set_credentials(std::optional<std::string> username,
                                       std::optional<std::string> password) {
   std::scoped_lock lock(mutex_);
@@ -98,6 +144,16 @@ void HostApplication::set_message_callback(MessageCallback callback) {
   config_.message_callback = std::move(callback);
 }
 
+void HostApplication::set_payload_view_callback(PayloadViewCallback callback) {
+  std::scoped_lock lock(mutex_);
+  config_.payload_view_callback = std::move(callback);
+}
+
+void HostApplication::set_interest_filter(InterestFilter filter) {
+  std::scoped_lock lock(mutex_);
+  config_.interest_filter = std::move(filter);
+}
+
 void HostApplication::set_log_callback(LogCallback callback) {
   std::scoped_lock lock(mutex_);
   config_.log_callback = std::move(callback);
@@ -114,6 +170,21 @@ stdx::expected<void, std::string> HostApplication::connect() {
     return stdx::unexpected(std::format("Failed to create client: {}", rc));
   }
   client_ = MQTTAsyncHandle(raw_client);
+  // The previous client, if any, is gone and will not report its pending sends
+  auto abandoned =
+      publishes_->abandon("MQTT client recreated before the publish completed");
+  PublishTracker::run(abandoned);
+
+  if (config_.ingest_workers > 0) {
+    std::scoped_lock ingest_lock(ingest_mutex_);
+    if (!ingest_) {
+      ingest_ = std::make_unique<IngestQueue<IngestMessage>>(
+          config_.ingest_workers, config_.ingest_queue_capacity,
+          [this](IngestMessage& msg) {
+            process_message(msg.topic_name, msg.topic_len, msg.message);
+          });
+    }
+  }
 
   rc = MQTTAsync_setCallbacks(client_.get(), this, on_connection_lost, on_message_arrived,
                               nullptr);
@@ -181,6 +252,13 @@ stdx::expected<void, std::string> HostApplication::connect() {
 }
 
 stdx::expected<void, std::string> HostApplication::disconnect() {
+  auto result = disconnect_client();
+  // No more messages arrive once the client is disconnected
+  stop_ingest();
+  return result;
+}
+
+stdx::expected<void, std::string> HostApplication::disconnect_client() {
   std::scoped_lock lock(mutex_);
 
   if (!client_) {
@@ -254,9 +332,11 @@ HostApplication::publish_state_death(uint64_t timestamp) {
 }
 
 stdx::expected<void, std::string>
-HostApplication::publish_node_command(std::string_view group_id,
-                                      std::string_view target_edge_node_id,
-                                      PayloadBuilder& payload) {
+HostApplication::send_command(std::string_view group_id,
+                              std::string_view target_edge_node_id,
+                              std::string_view target_device_id,
+                              PayloadBuilder& payload,
+                              const PublishToken* token) {
   std::string topic_str;
   std::vector<uint8_t> payload_data;
   {
@@ -267,15 +347,23 @@ HostApplication::publish_node_command(std::string_view group_id,
     }
 
     Topic topic{.group_id = std::string(group_id),
-                .message_type = MessageType::NCMD,
+                .message_type =
+                    target_device_id.empty() ? MessageType::NCMD : MessageType::DCMD,
                 .edge_node_id = std::string(target_edge_node_id),
-                .device_id = ""};
+                .device_id = std::string(target_device_id)};
 
     topic_str = topic.to_string();
     payload_data = payload.build();
   }
 
-  return publish_command_message(topic_str, payload_data);
+  return send_message(topic_str, payload_data, 0, false, token);
+}
+
+stdx::expected<void, std::string>
+HostApplication::publish_node_command(std::string_view group_id,
+                                      std::string_view target_edge_node_id,
+                                      PayloadBuilder& payload) {
+  return send_command(group_id, target_edge_node_id, "", payload, nullptr);
 }
 
 stdx::expected<void, std::string>
@@ -283,25 +371,31 @@ HostApplication::publish_device_command(std::string_view group_id,
                                         std::string_view target_edge_node_id,
                                         std::string_view target_device_id,
                                         PayloadBuilder& payload) {
-  std::string topic_str;
-  std::vector<uint8_t> payload_data;
-  {
-    std::scoped_lock lock(mutex_);
-
-    if (!is_connected_) {
-      return stdx::unexpected("Not connected");
-    }
-
-    Topic topic{.group_id = std::string(group_id),
-                .message_type = MessageType::DCMD,
-                .edge_node_id = std::string(target_edge_node_id),
-                .device_id = std::string(target_device_id)};
+  return send_command(group_id, target_edge_node_id, target_device_id, payload, nullptr);
+}
 
-    topic_str = topic.to_string();
-    payload_data = payload.build();
-  }
+stdx::expected<PublishToken, std::string>
+HostApplication::publish_node_command_async(std::string_view group_id,
+                                            std::string_view target_edge_node_id,
+                                            PayloadBuilder& payload,
+                                            PublishCallback on_complete) {
+  return publishes_->publish(
+      std::move(on_complete), PUBLISH_SLOT_TIMEOUT, [&](const PublishToken& token) {
+        return send_command(group_id, target_edge_node_id, "", payload, &token);
+      });
+}
 
-  return publish_command_message(topic_str, payload_data);
+stdx::expected<PublishToken, std::string>
+HostApplication::publish_device_command_async(std::string_view group_id,
+                                              std::string_view target_edge_node_id,
+                                              std::string_view target_device_id,
+                                              PayloadBuilder& payload,
+                                              PublishCallback on_complete) {
+  return publishes_->publish(std::move(on_complete), PUBLISH_SLOT_TIMEOUT,
+                             [&](const PublishToken& token) {
+                               return send_command(group_id, target_edge_node_id,
+                                                   target_device_id, payload, &token);
+                             });
 }
 
 stdx::expected<void, std::string>
@@ -309,54 +403,26 @@ HostApplication::publish_raw_message(std::string_view topic,
                                      std::span<const uint8_t> payload_data,
                                      int qos,
                                      bool retain) {
-  if (!client_ || !is_connected_) {
-    return stdx::unexpected("Not connected");
-  }
-
-  MQTTAsync_message msg = MQTTAsync_message_initializer;
-  msg.payload = const_cast<void*>(reinterpret_cast<const void*>(payload_data.data()));
-  msg.payloadlen = static_cast<int>(payload_data.size());
-  msg.qos = qos;
-  msg.retained = retain ? 1 : 0;
-
-  std::promise<void> send_promise;
-  auto send_future = send_promise.get_future();
-
-  MQTTAsync_responseOptions opts = MQTTAsync_responseOptions_initializer;
-  opts.context = &send_promise;
-  opts.onSuccess = [](void* context, MQTTAsync_successData* /*response*/) {
-    auto* promise = static_cast<std::promise<void>*>(context);
-    promise->set_value();
-  };
-  opts.onFailure = [](void* context, MQTTAsync_failureData* response) {
-    auto* promise = static_cast<std::promise<void>*>(context);
-    std::string error =
-        std::format("Publish failed: code={}", response ? response->code : -1);
-    promise->set_exception(std::make_exception_ptr(std::runtime_error(error)));
-  };
-
-  int rc = MQTTAsync_sendMessage(client_.get(), std::string(topic).c_str(), &msg, &opts);
-  if (rc != MQTTASYNC_SUCCESS) {
-    return stdx::unexpected(std::format("Failed to publish: {}", rc));
+  auto token = publishes_->publish({}, PUBLISH_SLOT_TIMEOUT, [&](const PublishToken& t) {
+    return send_message(topic, payload_data, qos, retain, &t);
+  });
+  if (!token) {
+    return stdx::unexpected(token.error());
   }
 
-  auto status = send_future.wait_for(std::chrono::milliseconds(5000));
-  if (status == std::future_status::timeout) {
+  auto result = token->wait_for(PUBLISH_TIMEOUT);
+  if (!result) {
     return stdx::unexpected("Publish timeout");
   }
-
-  try {
-    send_future.get();
-  } catch (const std::exception& e) {
-    return stdx::unexpected(e.what());
-  }
-
-  return {};
+  return *result;
 }
 
 stdx::expected<void, std::string>
-HostApplication::publish_command_message(std::string_view topic,
-                                         std::span<const uint8_t> payload_data) {
+HostApplication::send_message(std::string_view topic,
+                              std::span<const uint8_t> payload_data,
+                              int qos,
+                              bool retain,
+                              const PublishToken* token) {
   if (!client_ || !is_connected_) {
     return stdx::unexpected("Not connected");
   }
@@ -364,14 +430,21 @@ HostApplication::publish_command_message(std::string_view topic,
   MQTTAsync_message msg = MQTTAsync_message_initializer;
   msg.payload = const_cast<void*>(reinterpret_cast<const void*>(payload_data.data()));
   msg.payloadlen = static_cast<int>(payload_data.size());
-  msg.qos = 0;
-  msg.retained = 0;
+  msg.qos = qos;
+  msg.retained = retain ? 1 : 0;
 
   MQTTAsync_responseOptions opts = MQTTAsync_responseOptions_initializer;
+  if (token) {
+    publishes_->prepare(*token, opts);
+  }
 
   int rc = MQTTAsync_sendMessage(client_.get(), std::string(topic).c_str(), &msg, &opts);
   if (rc != MQTTASYNC_SUCCESS) {
-    return stdx::unexpected(std::format("Failed to publish: {}", rc));
+    auto error = std::format("Failed to publish: {}", rc);
+    if (token) {
+      publishes_->fail(*token, error);
+    }
+    return stdx::unexpected(std::move(error));
   }
 
   return {};
@@ -457,51 +530,84 @@ HostApplication::subscribe_state(std::string_view host_id) {
   return {};
 }
 
+std::optional<HostApplication::NodeKey>
+HostApplication::find_node_key(std::string_view group_id,
+                               std::string_view edge_node_id) const {
+  auto group = node_names_.find(group_id);
+  auto node = node_names_.find(edge_node_id);
+  if (!group || !node) {
+    return std::nullopt;
+  }
+  return NodeKey{.group_id = *group, .edge_node_id = *node};
+}
+
 std::optional<std::reference_wrapper<const HostApplication::NodeState>>
 HostApplication::get_node_state(std::string_view group_id,
                                 std::string_view edge_node_id) const {
-  std::scoped_lock lock(mutex_);
+  auto key = find_node_key(group_id, edge_node_id);
+  if (!key) {
+    return std::nullopt;
+  }
 
-  auto it = node_states_.find(std::make_pair(group_id, edge_node_id));
-  if (it != node_states_.end()) {
-    return std::cref(it->second);
+  const NodeState* found = nullptr;
+  node_states_.visit(*key, [&](const NodeEntry& entry) { found = &entry.state; });
+  if (found) {
+    return std::cref(*found);
   }
   return std::nullopt;
 }
 
+std::shared_ptr<const HostApplication::NodeSnapshot>
+HostApplication::get_node_snapshot(std::string_view group_id,
+                                   std::string_view edge_node_id) const {
+  auto key = find_node_key(group_id, edge_node_id);
+  if (!key) {
+    return nullptr;
+  }
+
+  std::shared_ptr<const NodeSnapshot> snapshot;
+  node_snapshots_.visit(*key, [&](const std::shared_ptr<const SnapshotCell>& cell) {
+    snapshot = cell->load();
+  });
+  return snapshot;
+}
+
+std::vector<HostApplication::NodeSnapshotEntry>
+HostApplication::get_node_snapshots() const {
+  std::vector<NodeSnapshotEntry> entries;
+  node_snapshots_.for_each(
+      [&](const NodeKey& key, const std::shared_ptr<const SnapshotCell>& cell) {
+        entries.push_back(
+            {.group_id = std::string(node_names_.name(key.group_id)),
+             .edge_node_id = std::string(node_names_.name(key.edge_node_id)),
+             .snapshot = cell->load()});
+      });
+  return entries;
+}
+
 std::optional<std::string_view>
 HostApplication::get_metric_name(std::string_view group_id,
                                  std::string_view edge_node_id,
                                  std::string_view device_id,
                                  uint64_t alias) const {
-  std::scoped_lock lock(mutex_);
-
-  auto it = node_states_.find(std::make_pair(group_id, edge_node_id));
-  if (it == node_states_.end()) {
+  auto key = find_node_key(group_id, edge_node_id);
+  if (!key) {
     return std::nullopt;
   }
 
-  const auto& node_state = it->second;
-
-  if (!device_id.empty()) {
-    auto device_it = node_state.devices.find(device_id);
-    if (device_it == node_state.devices.end()) {
-      return std::nullopt;
+  std::optional<std::string_view> name;
+  node_states_.visit(*key, [&](const NodeEntry& entry) {
+    const auto& node_state = entry.state;
+    if (device_id.empty()) {
+      name = node_state.alias_map.find(alias);
+      return;
     }
-
-    const auto& device_state = device_it->second;
-    auto alias_it = device_state.alias_map.find(alias);
-    if (alias_it != device_state.alias_map.end()) {
-      return std::string_view(alias_it->second);
+    auto device_it = node_state.devices.find(device_id);
+    if (device_it != node_state.devices.end()) {
+      name = device_it->second.alias_map.find(alias);
     }
-    return std::nullopt;
-  }
-
-  auto alias_it = node_state.alias_map.find(alias);
-  if (alias_it != node_state.alias_map.end()) {
-    return std::string_view(alias_it->second);
-  }
-  return std::nullopt;
+  });
+  return name;
 }
 
 void HostApplication::log(LogLevel level, std::string_view message) const noexcept {
@@ -510,51 +616,95 @@ void HostApplication::log(LogLevel level, std::string_view message) const noexce
   }
 }
 
-bool HostApplication::validate_message(
-    const Topic& topic,
-    const org::eclipse::tahu::protobuf::Payload& payload) {
+bool HostApplication::validate_message(const TopicView& topic,
+                                       const PayloadHeader& header,
+                                       const PayloadView* payload) {
   if (!config_.validate_sequence) {
     return true;
   }
 
-  NodeKey key{topic.group_id, topic.edge_node_id};
-  auto& state = node_states_[key];
-  const std::string node_id = topic.group_id + "/" + topic.edge_node_id;
+  const NodeKey key{.group_id = node_names_.intern(topic.group_id),
+                    .edge_node_id = node_names_.intern(topic.edge_node_id)};
+  return node_states_.update(key, [&](NodeEntry& entry) {
+    const bool valid = validate_node_message(entry.state, topic, header, payload);
+    publish_snapshot(key, entry, topic.message_type);
+    return valid;
+  });
+}
+
+void HostApplication::publish_snapshot(const NodeKey& key,
+                                       NodeEntry& entry,
+                                       MessageType type) {
+  if (!entry.snapshot) {
+    entry.snapshot = std::make_shared<SnapshotCell>();
+    node_snapshots_.update(
+        key, [&](std::shared_ptr<const SnapshotCell>& cell) { cell = entry.snapshot; });
+  }
+
+  const auto previous = entry.snapshot->load();
+  const auto& state = entry.state;
+  auto snapshot = std::make_shared<NodeSnapshot>(
+      NodeSnapshot{.is_online = state.is_online,
+                   .last_seq = state.last_seq,
+                   .bd_seq = state.bd_seq,
+                   .birth_timestamp = state.birth_timestamp,
+                   .birth_received = state.birth_received,
+                   .version = previous ? previous->version + 1 : 1,
+                   .devices = previous ? previous->devices : nullptr});
+
+  // Only device births and deaths change device state, so the (possibly long) device
+  // list is copied for those alone and shared by every other snapshot
+  if (!snapshot->devices || type == MessageType::DBIRTH ||
+      type == MessageType::DDEATH) {
+    auto devices = std::make_shared<std::vector<DeviceSnapshot>>();
+    devices->reserve(state.devices.size());
+    for (const auto& [device_id, device] : state.devices) {
+      devices->push_back({.device_id = device_id,
+                          .is_online = device.is_online,
+                          .birth_received = device.birth_received,
+                          .metrics_stale = device.metrics_stale,
+                          .offline_timestamp = device.offline_timestamp});
+    }
+    snapshot->devices = std::move(devices);
+  }
+
+  entry.snapshot->store(std::move(snapshot));
+}
+
+bool HostApplication::validate_node_message(NodeState& state,
+                                            const TopicView& topic,
+                                            const PayloadHeader& header,
+                                            const PayloadView* payload) {
+  // Only formatted when something is logged
+  const auto node_id = [&topic] {
+    return std::format("{}/{}", topic.group_id, topic.edge_node_id);
+  };
 
   switch (topic.message_type) {
   case MessageType::NBIRTH: {
-    if (payload.has_seq() && payload.seq() != 0) {
+    if (header.seq.value_or(0) != 0) {
       log(LogLevel::WARN, std::format("NBIRTH for {} has invalid seq: {} (expected 0)",
-                                      node_id, payload.seq()));
+                                      node_id(), *header.seq));
       return false;
     }
 
-    uint64_t bd_seq = 0;
-    bool has_bdseq = false;
-    for (const auto& metric : payload.metrics()) {
-      if (metric.name() == "bdSeq") {
-        bd_seq = metric.long_value();
-        has_bdseq = true;
-        break;
-      }
-    }
-
-    if (!has_bdseq) {
+    if (!header.bd_seq) {
       log(LogLevel::WARN,
-          std::format("NBIRTH for {} missing required bdSeq metric", node_id));
+          std::format("NBIRTH for {} missing required bdSeq metric", node_id()));
       return false;
     }
 
-    state.bd_seq = bd_seq;
+    state.bd_seq = *header.bd_seq;
     state.last_seq = 0;
     state.is_online = true;
     state.birth_received = true;
-    state.birth_timestamp = payload.timestamp();
+    state.birth_timestamp = header.timestamp.value_or(0);
 
-    state.alias_map.clear();
-    for (const auto& metric : payload.metrics()) {
-      if (metric.has_alias() && metric.has_name()) {
-        state.alias_map[metric.alias()] = metric.name();
+    state.alias_map.reset(payload->metric_count());
+    std::scoped_lock names_lock(metric_names_mutex_);
+    for (const auto& metric : payload->metrics()) {
+      if (metric.alias && !metric.name.empty()) {
+        state.alias_map.insert(*metric.alias, metric_names_.intern(metric.name));
       }
     }
 
@@ -562,17 +712,11 @@ bool HostApplication::validate_message(
   }
 
   case MessageType::NDEATH: {
-    uint64_t bd_seq = 0;
-    for (const auto& metric : payload.metrics()) {
-      if (metric.name() == "bdSeq") {
-        bd_seq = metric.long_value();
-        break;
-      }
-    }
+    uint64_t bd_seq = header.bd_seq.value_or(0);
 
     if (state.birth_received && bd_seq != state.bd_seq) {
       log(LogLevel::WARN,
-          std::format("NDEATH bdSeq mismatch for {} (NDEATH: {}, NBIRTH: {})", node_id,
+          std::format("NDEATH bdSeq mismatch for {} (NDEATH: {}, NBIRTH: {})", node_id(),
                       bd_seq, state.bd_seq));
     }
 
@@ -582,18 +726,18 @@ bool HostApplication::validate_message(
 
   case MessageType::NDATA: {
     if (!state.birth_received) {
-      log(LogLevel::WARN, std::format("Received NDATA for {} before NBIRTH", node_id));
+      log(LogLevel::WARN, std::format("Received NDATA for {} before NBIRTH", node_id()));
       return false;
     }
 
-    if (payload.has_seq()) {
-      uint64_t seq = payload.seq();
+    if (header.seq) {
+      uint64_t seq = *header.seq;
       uint64_t expected_seq = (state.last_seq + 1) % SEQ_NUMBER_MAX;
 
       if (seq != expected_seq) {
         log(LogLevel::WARN,
-            std::format("Sequence number gap for {} (got {}, expected {})", node_id, seq,
-                        expected_seq));
+            std::format("Sequence number gap for {} (got {}, expected {})", node_id(),
+                        seq, expected_seq));
       }
 
       state.last_seq = seq;
@@ -605,34 +749,39 @@ bool HostApplication::validate_message(
   case MessageType::DBIRTH: {
     if (!state.birth_received) {
       log(LogLevel::WARN,
-          std::format("Received DBIRTH for device on {} before node NBIRTH", node_id));
+          std::format("Received DBIRTH for device on {} before node NBIRTH", node_id()));
       return false;
     }
 
-    if (payload.has_seq()) {
-      uint64_t seq = payload.seq();
+    if (header.seq) {
+      uint64_t seq = *header.seq;
       uint64_t expected_seq = (state.last_seq + 1) % SEQ_NUMBER_MAX;
 
       if (seq != expected_seq) {
         log(LogLevel::WARN,
             std::format(
                 "Sequence number gap for DBIRTH device '{}' on {} (got {}, expected {})",
-                topic.device_id, node_id, seq, expected_seq));
+                topic.device_id, node_id(), seq, expected_seq));
       }
 
       state.last_seq = seq;
     }
 
-    auto& device_state = state.devices[topic.device_id];
+    auto device_it = state.devices.find(topic.device_id);
+    if (device_it == state.devices.end()) {
+      device_it = state.devices.try_emplace(std::string(topic.device_id)).first;
+    }
+    auto& device_state = device_it->second;
     device_state.is_online = true;
     device_state.birth_received = true;
     device_state.metrics_stale = false;
     device_state.offline_timestamp = 0;
 
-    device_state.alias_map.clear();
-    for (const auto& metric : payload.metrics()) {
-      if (metric.has_alias() && metric.has_name()) {
-        device_state.alias_map[metric.alias()] = metric.name();
+    device_state.alias_map.reset(payload->metric_count());
+    std::scoped_lock names_lock(metric_names_mutex_);
+    for (const auto& metric : payload->metrics()) {
+      if (metric.alias && !metric.name.empty()) {
+        device_state.alias_map.insert(*metric.alias, metric_names_.intern(metric.name));
       }
     }
 
@@ -643,7 +792,7 @@ bool HostApplication::validate_message(
     if (!state.birth_received) {
       log(LogLevel::WARN,
           std::format("Received DDATA for device '{}' on {} before node NBIRTH",
-                      topic.device_id, node_id));
+                      topic.device_id, node_id()));
       return false;
     }
 
@@ -651,18 +800,18 @@ bool HostApplication::validate_message(
     if (device_it == state.devices.end() || !device_it->second.birth_received) {
       log(LogLevel::WARN,
           std::format("Received DDATA for device '{}' on {} before DBIRTH",
-                      topic.device_id, node_id));
+                      topic.device_id, node_id()));
       return false;
     }
 
-    if (payload.has_seq()) {
-      uint64_t seq = payload.seq();
+    if (header.seq) {
+      uint64_t seq = *header.seq;
       uint64_t expected_seq = (state.last_seq + 1) % SEQ_NUMBER_MAX;
 
       if (seq != expected_seq) {
         log(LogLevel::WARN,
             std::format("Sequence number gap for device '{}' on {} (got {}, expected {})",
-                        topic.device_id, node_id, seq, expected_seq));
+                        topic.device_id, node_id(), seq, expected_seq));
       }
 
       state.last_seq = seq;
@@ -675,15 +824,15 @@ bool HostApplication::validate_message(
     auto device_it = state.devices.find(topic.device_id);
     if (device_it != state.devices.end()) {
       device_it->second.is_online = false;
-      if (payload.has_timestamp()) {
-        device_it->second.offline_timestamp = payload.timestamp();
+      if (header.timestamp) {
+        device_it->second.offline_timestamp = *header.timestamp;
       }
       device_it->second.metrics_stale = true;
       log(LogLevel::DEBUG, std::format("Device {} offline, metrics stale on {}",
-                                       topic.device_id, node_id));
+                                       topic.device_id, node_id()));
     } else {
       log(LogLevel::WARN, std::format("Received DDEATH for unknown device {} on {}",
-                                      topic.device_id, node_id));
+                                      topic.device_id, node_id()));
     }
     return true;
   }
@@ -696,6 +845,20 @@ bool HostApplication::validate_message(
   std::unreachable();
 }
 
+IngestStats HostApplication::ingest_stats() const {
+  std::scoped_lock lock(ingest_mutex_);
+  return ingest_ ? ingest_->stats() : IngestStats{};
+}
+
+void HostApplication::stop_ingest() {
+  std::unique_ptr<IngestQueue<IngestMessage>> ingest;
+  {
+    std::scoped_lock lock(ingest_mutex_);
+    ingest = std::move(ingest_);
+  }
+  ingest.reset(); // Joins the workers, whose callbacks may publish (locking mutex_)
+}
+
 int HostApplication::on_message_arrived(void* context,
                                         char* topicName,
                                         int topicLen,
@@ -710,64 +873,153 @@ int HostApplication::on_message_arrived(void* context,
     return 1;
   }
 
-  std::string topic_str(topicName, topicLen > 0 ? topicLen : strlen(topicName));
-
-  std::string state_prefix = std::format("{}/STATE/", NAMESPACE);
-  if (topic_str.starts_with(state_prefix)) {
-    std::string state_value(static_cast<char*>(message->payload), message->payloadlen);
-
-    org::eclipse::tahu::protobuf::Payload dummy_payload;
+  // With ingest workers, the MQTT thread only hands the message over
+  {
+    std::scoped_lock lock(host_app->ingest_mutex_);
+    if (host_app->ingest_) {
+      std::string_view topic(topicName, topicLen > 0 ? topicLen : strlen(topicName));
+      IngestMessage queued{
+          .topic_name = topicName, .topic_len = topicLen, .message = message};
+      if (!host_app->ingest_->submit(node_shard_key(topic), std::move(queued))) {
+        MQTTAsync_freeMessage(&message);
+        MQTTAsync_free(topicName);
+      }
+      return 1;
+    }
+  }
 
-    Topic state_topic{.group_id = "",
-                      .message_type = MessageType::STATE,
-                      .edge_node_id = topic_str.substr(state_prefix.length()),
-                      .device_id = ""};
+  host_app->process_message(topicName, topicLen, message);
+  return 1;
+}
 
-    if (host_app->config_.message_callback) {
-      try {
-        host_app->config_.message_callback(state_topic, dummy_payload);
-      } catch (...) {
+void HostApplication::process_message(char* topic_name,
+                                      int topic_len,
+                                      MQTTAsync_message* message) {
+  const std::string_view topic_str(topic_name,
+                                   topic_len > 0 ? topic_len : strlen(topic_name));
+
+  if (topic_str.starts_with(STATE_TOPIC_PREFIX)) {
+    // The callbacks take an owning Topic, built only for them; STATE carries JSON, so
+    // they get an empty payload
+    if (config_.message_callback || config_.payload_view_callback) {
+      const std::string_view host_id = topic_str.substr(STATE_TOPIC_PREFIX.size());
+      const Topic state_topic{.group_id = "",
+                              .message_type = MessageType::STATE,
+                              .edge_node_id = std::string(host_id),
+                              .device_id = ""};
+      const auto& filter = config_.interest_filter;
+      if (!filter || filter(state_topic)) {
+        if (config_.payload_view_callback) {
+          try {
+            config_.payload_view_callback(state_topic, PayloadView{});
+          } catch (...) {
+          }
+        }
+        if (config_.message_callback) {
+          try {
+            config_.message_callback(
+                state_topic, org::eclipse::tahu::protobuf::Payload::default_instance());
+          } catch (...) {
+          }
+        }
       }
     }
 
     MQTTAsync_freeMessage(&message);
-    MQTTAsync_free(topicName);
-    return 1;
+    MQTTAsync_free(topic_name);
+    return;
   }
 
-  auto topic_result = Topic::parse(topic_str);
+  // The topic is only viewed in the MQTT buffer; node state is keyed by interned IDs
+  auto topic_result = TopicView::parse(topic_str);
 
   if (!topic_result) {
-    host_app->log(LogLevel::DEBUG,
-                  std::format("Ignoring non-Sparkplug topic: {}", topic_str));
+    log(LogLevel::DEBUG, std::format("Ignoring non-Sparkplug topic: {}", topic_str));
     MQTTAsync_freeMessage(&message);
-    MQTTAsync_free(topicName);
-    return 1;
+    MQTTAsync_free(topic_name);
+    return;
+  }
+
+  // Validation only needs the header fields, scanned from the MQTT buffer. The view
+  // is parsed for births (alias maps) and the view callback; a protobuf Payload is
+  // only decoded for the classic message callback.
+  const TopicView& topic = *topic_result;
+  const MessageType type = topic.message_type;
+  const bool is_birth = type == MessageType::NBIRTH || type == MessageType::DBIRTH;
+  // The callbacks and the interest filter take an owning Topic, built only for them
+  std::optional<Topic> owned_topic;
+  if (config_.message_callback || config_.payload_view_callback) {
+    owned_topic = topic.to_topic();
   }
+  const bool deliver = owned_topic && (!config_.interest_filter ||
+                                       config_.interest_filter(*owned_topic));
+  const std::span<const uint8_t> bytes(
+      static_cast<const uint8_t*>(message->payload),
+      message->payloadlen > 0 ? static_cast<size_t>(message->payloadlen) : 0);
 
-  org::eclipse::tahu::protobuf::Payload payload;
-  if (!payload.ParseFromArray(message->payload, message->payloadlen)) {
-    host_app->log(LogLevel::ERROR, "Failed to parse Sparkplug B payload");
+  if (!deliver && !config_.validate_sequence && !config_.last_value_cache) {
     MQTTAsync_freeMessage(&message);
-    MQTTAsync_free(topicName);
-    return 1;
+    MQTTAsync_free(topic_name);
+    return;
   }
 
-  {
-    std::scoped_lock lock(host_app->mutex_);
-    host_app->validate_message(*topic_result, payload);
+  auto header = scan_payload_header(
+      bytes, type == MessageType::NBIRTH || type == MessageType::NDEATH);
+  std::optional<PayloadView> view;
+  if (header && ((config_.validate_sequence && is_birth) || config_.last_value_cache ||
+                 (deliver && config_.payload_view_callback))) {
+    auto parsed = PayloadView::parse(bytes);
+    if (parsed) {
+      view = *parsed;
+    } else {
+      header = stdx::unexpected(std::move(parsed.error()));
+    }
+  }
+  if (!header) {
+    log(LogLevel::ERROR,
+        std::format("Failed to parse Sparkplug B payload: {}", header.error()));
+    MQTTAsync_freeMessage(&message);
+    MQTTAsync_free(topic_name);
+    return;
+  }
+
+  const bool valid = validate_message(topic, *header, view ? &*view : nullptr);
+
+  // Messages that fail validation (e.g. DDATA before its DBIRTH) must not overwrite
+  // values from the current session
+  if (config_.last_value_cache && valid) {
+    if (auto applied = last_values_->apply(topic, *view); !applied) {
+      log(LogLevel::DEBUG, applied.error());
+    }
+  }
+
+  if (!deliver) {
+    MQTTAsync_freeMessage(&message);
+    MQTTAsync_free(topic_name);
+    return;
   }
 
-  if (host_app->config_.message_callback) {
+  if (config_.payload_view_callback) {
     try {
-      host_app->config_.message_callback(*topic_result, payload);
+      config_.payload_view_callback(*owned_topic, *view);
     } catch (...) {
     }
   }
 
+  if (config_.message_callback) {
+    org::eclipse::tahu::protobuf::Payload payload;
+    if (!payload.ParseFromArray(message->payload, message->payloadlen)) {
+      log(LogLevel::ERROR, "Failed to parse Sparkplug B payload");
+    } else {
+      try {
+        config_.message_callback(*owned_topic, payload);
+      } catch (...) {
+      }
+    }
+  }
+
   MQTTAsync_freeMessage(&message);
-  MQTTAsync_free(topicName);
-  return 1;
+  MQTTAsync_free(topic_name);
 }
 
 void HostApplication::on_connection_lost(void* context, char* cause) {
@@ -0,0 +1,493 @@
+// src/last_value_cache.cpp
+#include "sparkplug/last_value_cache.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <format>
+#include <mutex>
+#include <thread>
+
+namespace sparkplug {
+
+namespace {
+
+// Row state byte: quality in the low bits plus flags
+constexpr uint8_t QUALITY_MASK = 0x03;
+constexpr uint8_t STALE = 0x04;
+constexpr uint8_t HAS_ALIAS = 0x08; // Immutable after the birth
+
+constexpr uint32_t NO_ROW = 0xFFFFFFFF;
+
+enum class Family : uint8_t { Signed, Unsigned, Floating, Boolean, String, Other };
+
+constexpr Family family_of(DataType type) noexcept {
+  switch (type) {
+  case DataType::Int8:
+  case DataType::Int16:
+  case DataType::Int32:
+  case DataType::Int64:
+    return Family::Signed;
+  case DataType::UInt8:
+  case DataType::UInt16:
+  case DataType::UInt32:
+  case DataType::UInt64:
+  case DataType::DateTime:
+    return Family::Unsigned;
+  case DataType::Float:
+  case DataType::Double:
+    return Family::Floating;
+  case DataType::Boolean:
+    return Family::Boolean;
+  case DataType::String:
+  case DataType::Text:
+  case DataType::UUID:
+    return Family::String;
+  default:
+    return Family::Other;
+  }
+}
+
+// Sign-extends the low bits of a 32-bit wire value holding a signed T
+template <typename T>
+uint64_t sign_extend(uint32_t value) noexcept {
+  return static_cast<uint64_t>(static_cast<int64_t>(static_cast<T>(value)));
+}
+
+// 64-bit cell representation of a scalar wire value, widened per datatype
+std::optional<uint64_t> to_cell(DataType type, const wire::MetricValue& value) noexcept {
+  if (const auto* int_value = std::get_if<uint32_t>(&value)) {
+    switch (type) {
+    case DataType::Int8:
+      return sign_extend<int8_t>(*int_value);
+    case DataType::Int16:
+      return sign_extend<int16_t>(*int_value);
+    case DataType::Int32:
+      return sign_extend<int32_t>(*int_value);
+    default:
+      return *int_value;
+    }
+  }
+  if (const auto* long_value = std::get_if<uint64_t>(&value)) {
+    return *long_value;
+  }
+  if (const auto* float_value = std::get_if<float>(&value)) {
+    return std::bit_cast<uint64_t>(static_cast<double>(*float_value));
+  }
+  if (const auto* double_value = std::get_if<double>(&value)) {
+    return std::bit_cast<uint64_t>(*double_value);
+  }
+  if (const auto* bool_value = std::get_if<bool>(&value)) {
+    return *bool_value ? 1 : 0;
+  }
+  return std::nullopt;
+}
+
+LastValueCache::Value from_cell(Family family, uint64_t cell) {
+  switch (family) {
+  case Family::Signed:
+    return static_cast<int64_t>(cell);
+  case Family::Unsigned:
+    return cell;
+  case Family::Floating:
+    return std::bit_cast<double>(cell);
+  case Family::Boolean:
+    return cell != 0;
+  default:
+    return std::monostate{};
+  }
+}
+
+} // namespace
+
+struct LastValueCache::Source {
+  // Schema, immutable after the birth
+  std::vector<std::string_view> names;
+  std::vector<uint64_t> aliases;
+  std::vector<DataType> types;
+  std::vector<uint32_t> by_name;          // Rows sorted by name
+  std::vector<uint32_t> dense_alias_rows; // Indexed by alias, NO_ROW if unused
+  std::unordered_map<uint64_t, uint32_t> sparse_alias_rows;
+
+  // Cells, written by apply() inside the sequence lock and read through atomic_ref.
+  // For String rows the value cell holds the row's index into strings.
+  std::vector<uint64_t> values;
+  std::vector<uint64_t> timestamps;
+  std::vector<uint8_t> states;
+  std::atomic<uint64_t> version{0}; // Odd while an update is in progress
+
+  // String values are immutable snapshots, one atomically replaced pointer per String
+  // row, so readers and the writer never share a lock
+  std::unique_ptr<stdx::atomic_shared_ptr<const std::string>[]> strings;
+  size_t string_count{0};
+
+  [[nodiscard]] uint32_t row_of_alias(uint64_t alias) const noexcept {
+    if (alias < dense_alias_rows.size()) {
+      return dense_alias_rows[alias];
+    }
+    auto it = sparse_alias_rows.find(alias);
+    return it == sparse_alias_rows.end() ? NO_ROW : it->second;
+  }
+
+  [[nodiscard]] uint32_t row_of_name(std::string_view name) const noexcept {
+    auto it = std::lower_bound(by_name.begin(), by_name.end(), name,
+                               [this](uint32_t row, std::string_view key) {
+                                 return names[row] < key;
+                               });
+    return it != by_name.end() && names[*it] == name ? *it : NO_ROW;
+  }
+
+  void begin_write() noexcept {
+    version.store(version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  void end_write() noexcept {
+    version.store(version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  void mark_stale() noexcept {
+    begin_write();
+    for (uint32_t i = 0; i < states.size(); i++) {
+      set_state(i, static_cast<uint8_t>(state(i) | STALE));
+    }
+    end_write();
+  }
+
+  void set_state(uint32_t row, uint8_t state) noexcept {
+    std::atomic_ref<uint8_t>(states[row]).store(state, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] uint8_t state(uint32_t row) const noexcept {
+    return std::atomic_ref<uint8_t>(const_cast<uint8_t&>(states[row]))
+        .load(std::memory_order_relaxed);
+  }
+
+  // Writes one reported metric into its row (inside begin_write/end_write)
+  void write(uint32_t row, const MetricView& metric, uint64_t payload_timestamp) {
+    const bool is_null = metric.is_null.value_or(false);
+    if (!is_null && std::holds_alternative<std::monostate>(metric.value)) {
+      return; // Nothing reported: keep the previous value (Uncertain after a birth)
+    }
+    std::atomic_ref<uint64_t>(timestamps[row])
+        .store(metric.timestamp.value_or(payload_timestamp), std::memory_order_relaxed);
+
+    auto quality = LastValueCache::Quality::Bad;
+    if (!is_null) {
+      quality = LastValueCache::Quality::Good;
+      if (family_of(types[row]) == Family::String) {
+        if (const auto* str = std::get_if<std::string_view>(&metric.value)) {
+          strings[values[row]].store(std::make_shared<const std::string>(*str));
+        }
+      } else if (auto cell = to_cell(types[row], metric.value)) {
+        std::atomic_ref<uint64_t>(values[row]).store(*cell, std::memory_order_relaxed);
+      }
+    }
+    set_state(row, static_cast<uint8_t>((state(row) & HAS_ALIAS) |
+                                        std::to_underlying(quality)));
+  }
+
+  // Copies one row; must run inside a read_consistent() attempt
+  void read(uint32_t row, MetricSnapshot& out) const {
+    const uint8_t row_state = state(row);
+    out.name = names[row];
+    out.alias = (row_state & HAS_ALIAS) ? std::optional<uint64_t>(aliases[row])
+                                        : std::nullopt;
+    out.datatype = types[row];
+    out.timestamp = std::atomic_ref<uint64_t>(const_cast<uint64_t&>(timestamps[row]))
+                        .load(std::memory_order_relaxed);
+    out.quality = static_cast<Quality>(row_state & QUALITY_MASK);
+    out.stale = (row_state & STALE) != 0;
+
+    const Family family = family_of(types[row]);
+    if (out.quality != Quality::Good) {
+      out.value = std::monostate{};
+    } else if (family == Family::String) {
+      auto str = strings[values[row]].load();
+      out.value = str ? *str : std::string();
+    } else {
+      out.value = from_cell(family, std::atomic_ref<uint64_t>(const_cast<uint64_t&>(
+                                        values[row]))
+                                        .load(std::memory_order_relaxed));
+    }
+  }
+
+  // Runs fn until it observes a state no writer changed concurrently
+  template <typename F>
+  void read_consistent(F&& fn) const {
+    for (;;) {
+      const uint64_t before = version.load(std::memory_order_acquire);
+      if (before & 1) {
+        std::this_thread::yield();
+        continue;
+      }
+      fn();
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (version.load(std::memory_order_relaxed) == before) {
+        return;
+      }
+    }
+  }
+
+  [[nodiscard]] size_t memory_bytes() const noexcept {
+    size_t bytes = names.capacity() * sizeof(std::string_view) +
+                   aliases.capacity() * sizeof(uint64_t) +
+                   types.capacity() * sizeof(DataType) +
+                   by_name.capacity() * sizeof(uint32_t) +
+                   dense_alias_rows.capacity() * sizeof(uint32_t) +
+                   sparse_alias_rows.size() * (sizeof(void*) + 2 * sizeof(uint64_t)) +
+                   sparse_alias_rows.bucket_count() * sizeof(void*) +
+                   values.capacity() * sizeof(uint64_t) +
+                   timestamps.capacity() * sizeof(uint64_t) +
+                   states.capacity() * sizeof(uint8_t) +
+                   string_count * sizeof(stdx::atomic_shared_ptr<const std::string>);
+    for (size_t i = 0; i < string_count; i++) {
+      if (auto str = strings[i].load()) {
+        bytes += sizeof(std::string) + 2 * sizeof(long) + str->capacity();
+      }
+    }
+    return bytes;
+  }
+};
+
+LastValueCache::LastValueCache() = default;
+LastValueCache::~LastValueCache() = default;
+
+std::shared_ptr<LastValueCache::Source>
+LastValueCache::find_source(const SourceRef& key) const {
+  std::shared_lock lock(sources_mutex_);
+  auto it = sources_.find(key);
+  return it == sources_.end() ? nullptr : it->second;
+}
+
+const LastValueCache::NodeSources*
+LastValueCache::find_node(std::string_view group_id,
+                          std::string_view edge_node_id) const {
+  auto it = nodes_.find(SourceRef{group_id, edge_node_id, ""});
+  return it == nodes_.end() ? nullptr : &it->second;
+}
+
+stdx::expected<void, std::string> LastValueCache::apply(const TopicView& topic,
+                                                        const PayloadView& payload) {
+  switch (topic.message_type) {
+  case MessageType::NBIRTH:
+  case MessageType::DBIRTH:
+    apply_birth(topic, payload);
+    return {};
+  case MessageType::NDEATH:
+  case MessageType::DDEATH:
+    mark_stale(topic);
+    return {};
+  case MessageType::NDATA:
+  case MessageType::DDATA:
+    break;
+  default:
+    return {};
+  }
+
+  auto source = find_source({topic.group_id, topic.edge_node_id, topic.device_id});
+  if (!source) {
+    const char* type = topic.message_type == MessageType::NDATA ? "NDATA" : "DDATA";
+    return stdx::unexpected(std::format("{} for {}/{}{}{} before its birth", type,
+                                        topic.group_id, topic.edge_node_id,
+                                        topic.device_id.empty() ? "" : "/",
+                                        topic.device_id));
+  }
+
+  const uint64_t payload_timestamp = payload.timestamp().value_or(0);
+  size_t unknown = 0;
+  source->begin_write();
+  for (const auto& metric : payload.metrics()) {
+    uint32_t row = metric.alias ? source->row_of_alias(*metric.alias)
+                                : source->row_of_name(metric.name);
+    if (row == NO_ROW) {
+      unknown++;
+      continue;
+    }
+    source->write(row, metric, payload_timestamp);
+  }
+  source->end_write();
+
+  if (unknown > 0) {
+    return stdx::unexpected(
+        std::format("{} metric(s) not defined by the birth of {}/{}{}{}", unknown,
+                    topic.group_id, topic.edge_node_id,
+                    topic.device_id.empty() ? "" : "/", topic.device_id));
+  }
+  return {};
+}
+
+void LastValueCache::apply_birth(const TopicView& topic, const PayloadView& payload) {
+  auto source = std::make_shared<Source>();
+  const size_t count = payload.metric_count();
+  source->names.reserve(count);
+  source->aliases.reserve(count);
+  source->types.reserve(count);
+  source->values.reserve(count);
+  source->timestamps.reserve(count);
+  source->states.reserve(count);
+
+  uint64_t max_alias = 0;
+  size_t aliased = 0;
+  for (const auto& metric : payload.metrics()) {
+    source->aliases.push_back(metric.alias.value_or(0));
+    source->types.push_back(metric.datatype.value_or(DataType::Unknown));
+    source->values.push_back(0);
+    source->timestamps.push_back(0);
+    source->states.push_back(metric.alias ? HAS_ALIAS : 0);
+    if (metric.alias) {
+      max_alias = std::max(max_alias, *metric.alias);
+      aliased++;
+    }
+    if (family_of(source->types.back()) == Family::String) {
+      source->values.back() = source->string_count++;
+    }
+  }
+  using StringCell = stdx::atomic_shared_ptr<const std::string>;
+  source->strings = std::make_unique<StringCell[]>(source->string_count);
+
+  // Aliases index a vector when dense enough, as in AliasTable
+  const size_t rows = source->types.size();
+  if (aliased > 0 && max_alias < std::max<size_t>(64, 2 * rows)) {
+    source->dense_alias_rows.assign(max_alias + 1, NO_ROW);
+  }
+
+  std::unique_lock lock(sources_mutex_);
+
+  uint32_t row = 0;
+  const uint64_t payload_timestamp = payload.timestamp().value_or(0);
+  for (const auto& metric : payload.metrics()) {
+    source->names.push_back(names_.intern(metric.name));
+    if (metric.alias) {
+      if (*metric.alias < source->dense_alias_rows.size()) {
+        source->dense_alias_rows[*metric.alias] = row;
+      } else {
+        source->sparse_alias_rows[*metric.alias] = row;
+      }
+    }
+    source->write(row, metric, payload_timestamp);
+    row++;
+  }
+  source->by_name.resize(rows);
+  for (uint32_t i = 0; i < rows; i++) {
+    source->by_name[i] = i;
+  }
+  std::stable_sort(source->by_name.begin(), source->by_name.end(),
+                   [&](uint32_t lhs, uint32_t rhs) {
+                     return source->names[lhs] < source->names[rhs];
+                   });
+
+  SourceKey source_key{std::string(topic.group_id), std::string(topic.edge_node_id),
+                       std::string(topic.device_id)};
+  auto [it, inserted] = sources_.try_emplace(std::move(source_key), source);
+  if (inserted) {
+    nodes_[SourceKey{it->first.group_id, it->first.edge_node_id, ""}].push_back(&*it);
+  } else {
+    it->second = std::move(source); // Readers holding the old schema keep it alive
+  }
+
+  // A new node session invalidates its devices until they rebirth
+  if (topic.message_type == MessageType::NBIRTH) {
+    for (auto* entry : *find_node(topic.group_id, topic.edge_node_id)) {
+      if (!entry->first.device_id.empty()) {
+        entry->second->mark_stale();
+      }
+    }
+  }
+}
+
+void LastValueCache::mark_stale(const TopicView& topic) {
+  std::shared_lock lock(sources_mutex_);
+  // NDEATH covers the node and all its devices, DDEATH only the device
+  if (topic.message_type == MessageType::DDEATH) {
+    auto it =
+        sources_.find(SourceRef{topic.group_id, topic.edge_node_id, topic.device_id});
+    if (it != sources_.end()) {
+      it->second->mark_stale();
+    }
+    return;
+  }
+  if (const auto* node = find_node(topic.group_id, topic.edge_node_id)) {
+    for (auto* entry : *node) {
+      entry->second->mark_stale();
+    }
+  }
+}
+
+bool LastValueCache::snapshot(std::string_view group_id,
+                              std::string_view edge_node_id,
+                              std::string_view device_id,
+                              std::vector<MetricSnapshot>& out) const {
+  auto source = find_source({group_id, edge_node_id, device_id});
+  if (!source) {
+    out.clear();
+    return false;
+  }
+  out.resize(source->names.size());
+  source->read_consistent([&] {
+    for (uint32_t row = 0; row < out.size(); row++) {
+      source->read(row, out[row]);
+    }
+  });
+  return true;
+}
+
+std::optional<LastValueCache::MetricSnapshot>
+LastValueCache::find(std::string_view group_id,
+                     std::string_view edge_node_id,
+                     std::string_view device_id,
+                     std::string_view metric_name) const {
+  auto source = find_source({group_id, edge_node_id, device_id});
+  if (!source) {
+    return std::nullopt;
+  }
+  uint32_t row = source->row_of_name(metric_name);
+  if (row == NO_ROW) {
+    return std::nullopt;
+  }
+  MetricSnapshot snapshot;
+  source->read_consistent([&] { source->read(row, snapshot); });
+  return snapshot;
+}
+
+std::vector<std::string> LastValueCache::devices(std::string_view group_id,
+                                                 std::string_view edge_node_id) const {
+  std::vector<std::string> result;
+  std::shared_lock lock(sources_mutex_);
+  if (const auto* node = find_node(group_id, edge_node_id)) {
+    for (const auto* entry : *node) {
+      if (!entry->first.device_id.empty()) {
+        result.push_back(entry->first.device_id);
+      }
+    }
+  }
+  return result;
+}
+
+size_t LastValueCache::metric_count() const {
+  std::shared_lock lock(sources_mutex_);
+  size_t count = 0;
+  for (const auto& [key, source] : sources_) {
+    count += source->names.size();
+  }
+  return count;
+}
+
+size_t LastValueCache::memory_bytes() const {
+  std::shared_lock lock(sources_mutex_);
+  size_t bytes = names_.memory_bytes() +
+                 sources_.bucket_count() * sizeof(void*);
+  for (const auto& [key, source] : sources_) {
+    bytes += sizeof(Source) + sizeof(SourceKey) + key.group_id.capacity() +
+             key.edge_node_id.capacity() + key.device_id.capacity() +
+             source->memory_bytes();
+  }
+  bytes += nodes_.bucket_count() * sizeof(void*);
+  for (const auto& [key, node] : nodes_) {
+    bytes += sizeof(SourceKey) + sizeof(NodeSources) + key.group_id.capacity() +
+             key.edge_node_id.capacity() + node.capacity() * sizeof(void*);
+  }
+  return bytes;
+}
+
+} // namespace sparkplug
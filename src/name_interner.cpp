@@ -0,0 +1,64 @@
+// src/name_interner.cpp
+#include "sparkplug/name_interner.hpp"
+
+#include <functional>
+#include <mutex>
+
+namespace sparkplug {
+
+size_t NameInterner::stripe_index(std::string_view name) noexcept {
+  // The maps bucket on the low hash bits, so the stripe takes the high bits of a mix
+  const uint64_t mixed =
+      static_cast<uint64_t>(std::hash<std::string_view>{}(name)) * 0x9e3779b97f4a7c15ULL;
+  return static_cast<size_t>(mixed >> (64 - STRIPE_BITS));
+}
+
+NameInterner::Id NameInterner::intern(std::string_view name) {
+  const size_t index = stripe_index(name);
+  Stripe& stripe = stripes_[index];
+  {
+    std::shared_lock lock(stripe.mutex);
+    if (auto it = stripe.ids.find(name); it != stripe.ids.end()) {
+      return it->second;
+    }
+  }
+
+  std::unique_lock lock(stripe.mutex);
+  // Another thread may have added it between the two locks
+  if (auto it = stripe.ids.find(name); it != stripe.ids.end()) {
+    return it->second;
+  }
+  const auto id = static_cast<Id>((stripe.names.size() << STRIPE_BITS) | index);
+  const std::string_view pooled = stripe.pool.intern(name);
+  stripe.names.push_back(pooled);
+  stripe.ids.emplace(pooled, id);
+  return id;
+}
+
+std::optional<NameInterner::Id> NameInterner::find(std::string_view name) const {
+  const Stripe& stripe = stripes_[stripe_index(name)];
+  std::shared_lock lock(stripe.mutex);
+  auto it = stripe.ids.find(name);
+  if (it == stripe.ids.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+std::string_view NameInterner::name(Id id) const {
+  const Stripe& stripe = stripes_[id & (STRIPES - 1)];
+  const size_t slot = id >> STRIPE_BITS;
+  std::shared_lock lock(stripe.mutex);
+  return slot < stripe.names.size() ? stripe.names[slot] : std::string_view{};
+}
+
+size_t NameInterner::size() const {
+  size_t total = 0;
+  for (const auto& stripe : stripes_) {
+    std::shared_lock lock(stripe.mutex);
+    total += stripe.names.size();
+  }
+  return total;
+}
+
+} // namespace sparkplug
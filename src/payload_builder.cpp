@@ -1,35 +1,606 @@
 // src/payload_builder.cpp
 #include "sparkplug/payload_builder.hpp"
+#include "sparkplug/dataset.hpp"
+#include "sparkplug/template.hpp"
 
-#include <chrono>
+#include <algorithm>
+#include <format>
+#include <variant>
+
+#include <google/protobuf/arena.h>
+#include <google/protobuf/unknown_field_set.h>
 
 namespace sparkplug {
 
-PayloadBuilder::PayloadBuilder() {
-  auto now = std::chrono::system_clock::now();
-  auto timestamp =
-      std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch())
-          .count();
-  payload_.set_timestamp(timestamp);
+namespace {
+
+using Payload = org::eclipse::tahu::protobuf::Payload;
+
+constexpr uint64_t SEQ_MAX = 255; // Largest Sparkplug sequence number
+// First allocation of a builder's Encoding::Wire text buffer, which then doubles
+constexpr size_t WIRE_TEXT_MIN_CAPACITY = 256;
+
+// Appends a metric recorded for Encoding::Wire (scalar values only) to the message
+void add_wire_metric(Payload& payload, const wire::Metric& wire_metric) {
+  auto* metric = payload.add_metrics();
+  if (!wire_metric.name.empty()) {
+    metric->mutable_name()->assign(wire_metric.name.data(), wire_metric.name.size());
+  }
+  if (wire_metric.alias) {
+    metric->set_alias(*wire_metric.alias);
+  }
+  if (wire_metric.timestamp) {
+    metric->set_timestamp(*wire_metric.timestamp);
+  }
+  if (wire_metric.datatype) {
+    metric->set_datatype(std::to_underlying(*wire_metric.datatype));
+  }
+  if (wire_metric.is_historical) {
+    metric->set_is_historical(*wire_metric.is_historical);
+  }
+  if (wire_metric.is_transient) {
+    metric->set_is_transient(*wire_metric.is_transient);
+  }
+  if (wire_metric.is_null) {
+    metric->set_is_null(*wire_metric.is_null);
+  }
+  std::visit(
+      [metric]<typename V>(const V& value) {
+        if constexpr (std::is_same_v<V, uint32_t>) {
+          metric->set_int_value(value);
+        } else if constexpr (std::is_same_v<V, uint64_t>) {
+          metric->set_long_value(value);
+        } else if constexpr (std::is_same_v<V, float>) {
+          metric->set_float_value(value);
+        } else if constexpr (std::is_same_v<V, double>) {
+          metric->set_double_value(value);
+        } else if constexpr (std::is_same_v<V, bool>) {
+          metric->set_boolean_value(value);
+        } else if constexpr (std::is_same_v<V, std::string_view>) {
+          metric->mutable_string_value()->assign(value.data(), value.size());
+        }
+      },
+      wire_metric.value);
+}
+
+void add_dataset_metric(Payload& payload,
+                        std::string_view name,
+                        const DataSetBuilder& table,
+                        std::optional<uint64_t> alias,
+                        uint64_t timestamp_ms) {
+  auto* metric = payload.add_metrics();
+  if (!name.empty()) {
+    metric->mutable_name()->assign(name.data(), name.size());
+  }
+  if (alias.has_value()) {
+    metric->set_alias(*alias);
+  }
+  metric->set_timestamp(timestamp_ms);
+  metric->set_datatype(std::to_underlying(DataType::DataSet));
+  // Stored already encoded: libprotobuf writes unknown fields verbatim after the known
+  // ones, which is where field 17 goes, so the bytes match a filled dataset_value
+  table.encode_into(*metric->mutable_unknown_fields()->AddLengthDelimited(
+      wire::metric_field::DATASET_VALUE));
+}
+
+} // namespace
+
+bool detail::to_wire_metric(const Payload::Metric& metric, wire::Metric& out) {
+  if (metric.has_metadata() || metric.has_properties() ||
+      !metric.unknown_fields().empty()) {
+    return false;
+  }
+  // An explicitly set empty name is still serialized by protobuf
+  if (metric.has_name() && metric.name().empty()) {
+    return false;
+  }
+
+  out = wire::Metric{};
+  out.name = metric.name();
+  if (metric.has_alias()) {
+    out.alias = metric.alias();
+  }
+  if (metric.has_timestamp()) {
+    out.timestamp = metric.timestamp();
+  }
+  if (metric.has_datatype()) {
+    out.datatype = static_cast<DataType>(metric.datatype());
+  }
+  if (metric.has_is_historical()) {
+    out.is_historical = metric.is_historical();
+  }
+  if (metric.has_is_transient()) {
+    out.is_transient = metric.is_transient();
+  }
+  if (metric.has_is_null()) {
+    out.is_null = metric.is_null();
+  }
+
+  switch (metric.value_case()) {
+  case Payload::Metric::kIntValue:
+    out.value = metric.int_value();
+    break;
+  case Payload::Metric::kLongValue:
+    out.value = metric.long_value();
+    break;
+  case Payload::Metric::kFloatValue:
+    out.value = metric.float_value();
+    break;
+  case Payload::Metric::kDoubleValue:
+    out.value = metric.double_value();
+    break;
+  case Payload::Metric::kBooleanValue:
+    out.value = metric.boolean_value();
+    break;
+  case Payload::Metric::kStringValue:
+    out.value = std::string_view(metric.string_value());
+    break;
+  case Payload::Metric::kBytesValue: {
+    const auto& bytes = metric.bytes_value();
+    out.value = wire::Bytes{std::span(reinterpret_cast<const uint8_t*>(bytes.data()),
+                                      bytes.size())};
+    break;
+  }
+  case Payload::Metric::VALUE_NOT_SET:
+    break;
+  default:
+    return false;
+  }
+  return true;
+}
+
+// Arena plus the caller-sized initial block it allocates from. Arena::Reset() keeps a
+// user-provided initial block, so a builder that fits in it never returns to malloc.
+struct PayloadBuilder::ArenaStorage {
+  explicit ArenaStorage(size_t block_size)
+      : block(std::make_unique<char[]>(block_size)), arena(make_options(block_size)) {
+  }
+
+  google::protobuf::ArenaOptions make_options(size_t block_size) {
+    google::protobuf::ArenaOptions arena_options;
+    arena_options.initial_block = block.get();
+    arena_options.initial_block_size = block_size;
+    return arena_options;
+  }
+
+  std::unique_ptr<char[]> block;
+  google::protobuf::Arena arena;
+};
+
+PayloadBuilder::PayloadBuilder() : PayloadBuilder(Options{}) {
+}
+
+PayloadBuilder::PayloadBuilder(const Options& options) : options_(options) {
+  if (options_.use_arena) {
+    arena_ = std::make_unique<ArenaStorage>(options_.arena_block_size);
+  }
+  create_payload();
+  wire_active_ = options_.encoding == Encoding::Wire;
+  snapshot_ms_ = options_.clock.now_ms();
+  payload_->set_timestamp(snapshot_ms_);
+}
+
+PayloadBuilder::~PayloadBuilder() = default;
+
+PayloadBuilder::PayloadBuilder(const PayloadBuilder& other)
+    : PayloadBuilder(other.options_) {
+  payload_->CopyFrom(other.message());
+  wire_active_ = other.wire_active_;
+  wire_metrics_ = other.wire_metrics_;
+  wire_text_ = other.wire_text_;
+  rebase_wire_text(other.wire_text_.data());
+  seq_explicitly_set_ = other.seq_explicitly_set_;
+  timestamp_explicitly_set_ = other.timestamp_explicitly_set_;
+  snapshot_ms_ = other.snapshot_ms_;
+}
+
+PayloadBuilder& PayloadBuilder::operator=(const PayloadBuilder& other) {
+  if (this != &other) {
+    if (arena_) {
+      // Rewind rather than copy over the old message, whose parts stay in the arena
+      arena_->arena.Reset();
+      create_payload();
+    }
+    fields().CopyFrom(other.message());
+    wire_active_ = other.wire_active_;
+    wire_metrics_ = other.wire_metrics_;
+    wire_text_ = other.wire_text_;
+    rebase_wire_text(other.wire_text_.data());
+    seq_explicitly_set_ = other.seq_explicitly_set_;
+    timestamp_explicitly_set_ = other.timestamp_explicitly_set_;
+    snapshot_ms_ = other.snapshot_ms_;
+    sized_metrics_ = 0;
+    sized_bytes_ = 0;
+  }
+  return *this;
+}
+
+PayloadBuilder::PayloadBuilder(PayloadBuilder&& other) noexcept
+    : options_(std::move(other.options_)), arena_(std::move(other.arena_)),
+      owned_(std::move(other.owned_)), payload_(other.payload_),
+      wire_metrics_(std::move(other.wire_metrics_)),
+      wire_text_(std::move(other.wire_text_)), wire_active_(other.wire_active_),
+      encoder_(std::move(other.encoder_)), seq_explicitly_set_(other.seq_explicitly_set_),
+      timestamp_explicitly_set_(other.timestamp_explicitly_set_),
+      snapshot_ms_(other.snapshot_ms_), sized_metrics_(other.sized_metrics_),
+      sized_bytes_(other.sized_bytes_) {
+  other.leave_empty();
+}
+
+PayloadBuilder& PayloadBuilder::operator=(PayloadBuilder&& other) noexcept {
+  if (this != &other) {
+    // Release the message before the arena that may own it
+    owned_.reset();
+    arena_.reset();
+
+    options_ = std::move(other.options_);
+    arena_ = std::move(other.arena_);
+    owned_ = std::move(other.owned_);
+    payload_ = other.payload_;
+    wire_metrics_ = std::move(other.wire_metrics_);
+    wire_text_ = std::move(other.wire_text_);
+    wire_active_ = other.wire_active_;
+    encoder_ = std::move(other.encoder_);
+    seq_explicitly_set_ = other.seq_explicitly_set_;
+    timestamp_explicitly_set_ = other.timestamp_explicitly_set_;
+    snapshot_ms_ = other.snapshot_ms_;
+    sized_metrics_ = other.sized_metrics_;
+    sized_bytes_ = other.sized_bytes_;
+    other.leave_empty();
+  }
+  return *this;
+}
+
+void PayloadBuilder::leave_empty() noexcept {
+  // The arena and clock went with the message; message() makes a heap one when needed
+  options_ = Options{};
+  payload_ = nullptr;
+  wire_metrics_.clear();
+  wire_text_.clear();
+  wire_active_ = false;
+  seq_explicitly_set_ = false;
+  timestamp_explicitly_set_ = false;
+  sized_metrics_ = 0;
+  sized_bytes_ = 0;
+}
+
+void PayloadBuilder::create_payload() {
+  if (arena_) {
+    payload_ =
+        google::protobuf::Arena::CreateMessage<org::eclipse::tahu::protobuf::Payload>(
+            &arena_->arena);
+  } else {
+    owned_ = std::make_unique<org::eclipse::tahu::protobuf::Payload>();
+    payload_ = owned_.get();
+  }
+}
+
+PayloadBuilder& PayloadBuilder::reset() {
+  if (arena_) {
+    arena_->arena.Reset();
+    create_payload();
+  } else if (payload_) {
+    payload_->Clear();
+  }
+  wire_metrics_.clear();
+  wire_text_.clear();
+  wire_active_ = options_.encoding == Encoding::Wire;
+
+  seq_explicitly_set_ = false;
+  timestamp_explicitly_set_ = false;
+  sized_metrics_ = 0;
+  sized_bytes_ = 0;
+  snapshot_ms_ = options_.clock.now_ms();
+  fields().set_timestamp(snapshot_ms_);
+  return *this;
+}
+
+PayloadBuilder& PayloadBuilder::set_encoding(Encoding encoding) {
+  options_.encoding = encoding;
+  if (encoding == Encoding::Protobuf) {
+    leave_wire();
+  } else if (!payload_ || (payload_->metrics_size() == 0 && !payload_->has_uuid() &&
+                           !payload_->has_body() && payload_->unknown_fields().empty())) {
+    wire_active_ = true;
+  }
+  return *this;
+}
+
+void PayloadBuilder::record_wire(wire::Metric metric) {
+  fields(); // leave_wire() moves the metrics into it, possibly from a const method
+  auto* text = std::get_if<std::string_view>(&metric.value);
+  reserve_wire_text(metric.name.size() + (text ? text->size() : 0));
+  metric.name = append_wire_text(metric.name);
+  if (text) {
+    *text = append_wire_text(*text);
+  }
+  wire_metrics_.push_back(metric);
+}
+
+void PayloadBuilder::reserve_wire_text(size_t size) {
+  if (wire_text_.capacity() - wire_text_.size() >= size) {
+    return;
+  }
+  const char* old_base = wire_text_.data();
+  wire_text_.reserve(std::max({wire_text_.capacity() * 2, wire_text_.size() + size,
+                               WIRE_TEXT_MIN_CAPACITY}));
+  rebase_wire_text(old_base);
+}
+
+std::string_view PayloadBuilder::append_wire_text(std::string_view text) {
+  if (text.empty()) {
+    return {};
+  }
+  const size_t offset = wire_text_.size();
+  wire_text_.insert(wire_text_.end(), text.begin(), text.end());
+  return {wire_text_.data() + offset, text.size()};
+}
+
+void PayloadBuilder::rebase_wire_text(const char* old_base) noexcept {
+  auto rebase = [&](std::string_view& text) {
+    if (!text.empty()) {
+      text = {wire_text_.data() + (text.data() - old_base), text.size()};
+    }
+  };
+  for (auto& metric : wire_metrics_) {
+    rebase(metric.name);
+    if (auto* text = std::get_if<std::string_view>(&metric.value)) {
+      rebase(*text);
+    }
+  }
+}
+
+void PayloadBuilder::leave_wire() const {
+  if (!wire_active_) {
+    return;
+  }
+  wire_active_ = false;
+  for (const auto& metric : wire_metrics_) {
+    add_wire_metric(*payload_, metric);
+  }
+  wire_metrics_.clear();
+  wire_text_.clear();
+}
+
+void PayloadBuilder::load_wire(wire::Encoder& encoder) const {
+  const auto& proto_payload = message();
+  encoder.clear();
+  if (proto_payload.has_timestamp()) {
+    encoder.set_timestamp(proto_payload.timestamp());
+  }
+  for (const auto& metric : wire_metrics_) {
+    encoder.add_metric(metric);
+  }
+  if (proto_payload.has_seq()) {
+    encoder.set_seq(proto_payload.seq());
+  }
 }
 
 std::vector<uint8_t> PayloadBuilder::build() const {
-  auto payload_copy = payload_;
-  if (!timestamp_explicitly_set_ && !payload_copy.has_timestamp()) {
-    auto now = std::chrono::system_clock::now();
-    auto timestamp =
-        std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch())
-            .count();
-    payload_copy.set_timestamp(timestamp);
+  if (wire_active_) {
+    wire::Encoder encoder;
+    load_wire(encoder);
+    if (!timestamp_explicitly_set_ && !message().has_timestamp()) {
+      encoder.set_timestamp(metric_timestamp());
+    }
+    std::vector<uint8_t> buffer;
+    encoder.encode_into(buffer);
+    return buffer;
+  }
+
+  const auto& proto_payload = message();
+  if (!timestamp_explicitly_set_ && !proto_payload.has_timestamp()) {
+    auto payload_copy = proto_payload;
+    payload_copy.set_timestamp(metric_timestamp());
+
+    std::vector<uint8_t> buffer(payload_copy.ByteSizeLong());
+    payload_copy.SerializeWithCachedSizesToArray(buffer.data());
+    return buffer;
   }
 
-  std::vector<uint8_t> buffer(payload_copy.ByteSizeLong());
-  payload_copy.SerializeToArray(buffer.data(), static_cast<int>(buffer.size()));
+  std::vector<uint8_t> buffer(proto_payload.ByteSizeLong());
+  proto_payload.SerializeWithCachedSizesToArray(buffer.data());
   return buffer;
 }
 
-const org::eclipse::tahu::protobuf::Payload& PayloadBuilder::payload() const noexcept {
-  return payload_;
+stdx::expected<size_t, std::string>
+PayloadBuilder::build_into(std::span<uint8_t> buffer) {
+  auto& proto_payload = fields();
+  if (!timestamp_explicitly_set_ && !proto_payload.has_timestamp()) {
+    proto_payload.set_timestamp(metric_timestamp());
+  }
+
+  if (wire_active_) {
+    load_wire(encoder_);
+    return encoder_.encode_into(buffer);
+  }
+
+  size_t size = proto_payload.ByteSizeLong();
+  if (size > buffer.size()) {
+    return stdx::unexpected(std::format(
+        "Buffer too small for payload: need {} bytes, have {}", size, buffer.size()));
+  }
+
+  proto_payload.SerializeWithCachedSizesToArray(buffer.data());
+  return size;
+}
+
+void PayloadBuilder::build_into(std::vector<uint8_t>& buffer) {
+  auto& proto_payload = fields();
+  if (!timestamp_explicitly_set_ && !proto_payload.has_timestamp()) {
+    proto_payload.set_timestamp(metric_timestamp());
+  }
+
+  if (wire_active_) {
+    load_wire(encoder_);
+    encoder_.encode_into(buffer);
+    return;
+  }
+
+  buffer.resize(proto_payload.ByteSizeLong());
+  proto_payload.SerializeWithCachedSizesToArray(buffer.data());
+}
+
+PayloadBuilder& PayloadBuilder::add_dataset(std::string_view name,
+                                            const DataSetBuilder& table) {
+  add_dataset_metric(message(), name, table, std::nullopt, metric_timestamp());
+  return *this;
+}
+
+PayloadBuilder& PayloadBuilder::add_dataset_with_alias(std::string_view name,
+                                                       uint64_t alias,
+                                                       const DataSetBuilder& table) {
+  add_dataset_metric(message(), name, table, alias, metric_timestamp());
+  return *this;
+}
+
+PayloadBuilder& PayloadBuilder::add_dataset_by_alias(uint64_t alias,
+                                                     const DataSetBuilder& table) {
+  add_dataset_metric(message(), "", table, alias, metric_timestamp());
+  return *this;
+}
+
+PayloadBuilder&
+PayloadBuilder::add_template_definition(const TemplateDefinition& definition) {
+  auto* metric = message().add_metrics();
+  metric->set_name(definition.definition_metric_name());
+  metric->set_timestamp(metric_timestamp());
+  metric->set_datatype(std::to_underlying(DataType::Template));
+  definition.fill_definition(*metric->mutable_template_value());
+  return *this;
+}
+
+Payload::Template& PayloadBuilder::add_template_metric(std::string_view name,
+                                                       std::optional<uint64_t> alias) {
+  auto* metric = message().add_metrics();
+  if (!name.empty()) {
+    metric->mutable_name()->assign(name.data(), name.size());
+  }
+  if (alias.has_value()) {
+    metric->set_alias(*alias);
+  }
+  metric->set_timestamp(metric_timestamp());
+  metric->set_datatype(std::to_underlying(DataType::Template));
+  return *metric->mutable_template_value();
+}
+
+size_t PayloadBuilder::encoded_size() const {
+  const auto& proto_payload = message();
+  if (proto_payload.has_uuid() || proto_payload.has_body() ||
+      !proto_payload.unknown_fields().empty()) {
+    return proto_payload.ByteSizeLong();
+  }
+
+  // Recorded wire metrics encode to the same size, so the count carries over when
+  // they move into the message
+  const auto& metrics = proto_payload.metrics();
+  const auto count =
+      wire_active_ ? wire_metrics_.size() : static_cast<size_t>(metrics.size());
+  if (sized_metrics_ > count) {
+    sized_metrics_ = 0;
+    sized_bytes_ = 0;
+  }
+  for (; sized_metrics_ < count; sized_metrics_++) {
+    size_t size = wire_active_ ? wire::metric_body_size(wire_metrics_[sized_metrics_])
+                               : metrics[static_cast<int>(sized_metrics_)].ByteSizeLong();
+    sized_bytes_ += 1 + wire::varint_size(size) + size;
+  }
+
+  size_t size = sized_bytes_;
+  if (proto_payload.has_timestamp()) {
+    size += 1 + wire::varint_size(proto_payload.timestamp());
+  }
+  if (proto_payload.has_seq()) {
+    size += 1 + wire::varint_size(proto_payload.seq());
+  }
+  return size;
+}
+
+stdx::expected<void, std::string> PayloadBuilder::split(size_t max_bytes,
+                                                        std::vector<Chunk>& chunks) {
+  auto& proto_payload = message();
+  if (!timestamp_explicitly_set_ && !proto_payload.has_timestamp()) {
+    proto_payload.set_timestamp(metric_timestamp());
+  }
+  chunks.clear();
+
+  // Every chunk repeats the timestamp and carries a seq of up to 255 (2-byte varint)
+  const size_t header = (proto_payload.has_timestamp()
+                             ? 1 + wire::varint_size(proto_payload.timestamp())
+                             : 0) +
+                        1 + wire::varint_size(SEQ_MAX);
+  const auto& metrics = proto_payload.metrics();
+
+  Chunk chunk;
+  size_t chunk_size = header;
+  for (int i = 0; i < metrics.size(); i++) {
+    size_t body = metrics[i].ByteSizeLong(); // Also caches sizes for build_chunk_into()
+    size_t field = 1 + wire::varint_size(body) + body;
+    if (header + field > max_bytes) {
+      return stdx::unexpected(
+          std::format("Metric {} encodes to {} bytes, which does not fit in {} bytes", i,
+                      field, max_bytes));
+    }
+    if (chunk.metric_count > 0 && chunk_size + field > max_bytes) {
+      chunks.push_back(chunk);
+      chunk = Chunk{.first_metric = static_cast<size_t>(i), .metric_count = 0};
+      chunk_size = header;
+    }
+    chunk_size += field;
+    chunk.metric_count++;
+  }
+  chunks.push_back(chunk);
+
+  if (chunks.size() > 1 && (proto_payload.has_uuid() || proto_payload.has_body() ||
+                            !proto_payload.unknown_fields().empty())) {
+    chunks.clear();
+    return stdx::unexpected("Payload uuid, body and unknown fields cannot be split");
+  }
+  return {};
+}
+
+void PayloadBuilder::build_chunk_into(const Chunk& chunk,
+                                      std::optional<uint64_t> seq,
+                                      std::vector<uint8_t>& buffer) const {
+  const auto& proto_payload = message();
+  using wire::WireType;
+  const auto& metrics = proto_payload.metrics();
+  const auto first = static_cast<int>(chunk.first_metric);
+  const auto last = static_cast<int>(chunk.first_metric + chunk.metric_count);
+
+  size_t size = seq ? 1 + wire::varint_size(*seq) : 0;
+  if (proto_payload.has_timestamp()) {
+    size += 1 + wire::varint_size(proto_payload.timestamp());
+  }
+  for (int i = first; i < last; i++) {
+    size_t body = metrics[i].GetCachedSize();
+    size += 1 + wire::varint_size(body) + body;
+  }
+  buffer.resize(size);
+
+  // Field order matches libprotobuf: timestamp (1), metrics (2), seq (3)
+  uint8_t* out = buffer.data();
+  if (proto_payload.has_timestamp()) {
+    out = wire::write_varint(
+        out, wire::make_tag(wire::payload_field::TIMESTAMP, WireType::Varint));
+    out = wire::write_varint(out, proto_payload.timestamp());
+  }
+  for (int i = first; i < last; i++) {
+    out = wire::write_varint(
+        out, wire::make_tag(wire::payload_field::METRICS, WireType::LengthDelimited));
+    out = wire::write_varint(out, static_cast<uint64_t>(metrics[i].GetCachedSize()));
+    out = metrics[i].SerializeWithCachedSizesToArray(out);
+  }
+  if (seq) {
+    out = wire::write_varint(out,
+                             wire::make_tag(wire::payload_field::SEQ, WireType::Varint));
+    wire::write_varint(out, *seq);
+  }
+}
+
+const org::eclipse::tahu::protobuf::Payload& PayloadBuilder::payload() const {
+  leave_wire();
+  return message();
 }
 
-} // namespace sparkplug
\ No newline at end of file
+} // namespace sparkplug
@@ -0,0 +1,311 @@
+// src/payload_view.cpp
+#include "sparkplug/payload_view.hpp"
+
+#include <bit>
+#include <format>
+
+namespace sparkplug {
+
+namespace {
+
+using wire::WireType;
+
+// Decodes one Metric message body; false on malformed input
+bool decode_metric(std::span<const uint8_t> body, MetricView& metric) noexcept {
+  metric = MetricView{};
+  wire::Reader reader(body);
+  while (!reader.done()) {
+    auto tag = reader.read_tag();
+    if (!tag) {
+      return false;
+    }
+
+    bool decoded = true;
+    switch (tag->type) {
+    case WireType::Varint: {
+      if (tag->field != wire::metric_field::ALIAS &&
+          tag->field != wire::metric_field::TIMESTAMP &&
+          tag->field != wire::metric_field::DATATYPE &&
+          tag->field != wire::metric_field::IS_HISTORICAL &&
+          tag->field != wire::metric_field::IS_TRANSIENT &&
+          tag->field != wire::metric_field::IS_NULL &&
+          tag->field != wire::metric_field::INT_VALUE &&
+          tag->field != wire::metric_field::LONG_VALUE &&
+          tag->field != wire::metric_field::BOOLEAN_VALUE) {
+        decoded = false;
+        break;
+      }
+      auto value = reader.read_varint();
+      if (!value) {
+        return false;
+      }
+      switch (tag->field) {
+      case wire::metric_field::ALIAS:
+        metric.alias = *value;
+        break;
+      case wire::metric_field::TIMESTAMP:
+        metric.timestamp = *value;
+        break;
+      case wire::metric_field::DATATYPE:
+        metric.datatype = static_cast<DataType>(static_cast<uint32_t>(*value));
+        break;
+      case wire::metric_field::IS_HISTORICAL:
+        metric.is_historical = *value != 0;
+        break;
+      case wire::metric_field::IS_TRANSIENT:
+        metric.is_transient = *value != 0;
+        break;
+      case wire::metric_field::IS_NULL:
+        metric.is_null = *value != 0;
+        break;
+      case wire::metric_field::INT_VALUE:
+        metric.value = static_cast<uint32_t>(*value);
+        break;
+      case wire::metric_field::LONG_VALUE:
+        metric.value = *value;
+        break;
+      default: // BOOLEAN_VALUE
+        metric.value = *value != 0;
+        break;
+      }
+      break;
+    }
+    case WireType::Fixed32:
+      if (tag->field != wire::metric_field::FLOAT_VALUE) {
+        decoded = false;
+      } else if (auto bits = reader.read_fixed32()) {
+        metric.value = std::bit_cast<float>(*bits);
+      } else {
+        return false;
+      }
+      break;
+    case WireType::Fixed64:
+      if (tag->field != wire::metric_field::DOUBLE_VALUE) {
+        decoded = false;
+      } else if (auto bits = reader.read_fixed64()) {
+        metric.value = std::bit_cast<double>(*bits);
+      } else {
+        return false;
+      }
+      break;
+    case WireType::LengthDelimited: {
+      if (tag->field != wire::metric_field::NAME &&
+          tag->field != wire::metric_field::STRING_VALUE &&
+          tag->field != wire::metric_field::BYTES_VALUE &&
+          tag->field != wire::metric_field::DATASET_VALUE &&
+          tag->field != wire::metric_field::TEMPLATE_VALUE) {
+        decoded = false; // Metadata, properties and unknown fields
+        break;
+      }
+      auto bytes = reader.read_bytes();
+      if (!bytes) {
+        return false;
+      }
+      switch (tag->field) {
+      case wire::metric_field::NAME:
+        metric.name = std::string_view(reinterpret_cast<const char*>(bytes->data()),
+                                       bytes->size());
+        break;
+      case wire::metric_field::STRING_VALUE:
+        metric.value = std::string_view(reinterpret_cast<const char*>(bytes->data()),
+                                        bytes->size());
+        break;
+      case wire::metric_field::BYTES_VALUE:
+        metric.value = wire::Bytes{*bytes};
+        break;
+      case wire::metric_field::DATASET_VALUE:
+        metric.value = wire::DataSetBytes{*bytes};
+        break;
+      default: // TEMPLATE_VALUE
+        metric.value = wire::TemplateBytes{*bytes};
+        break;
+      }
+      break;
+    }
+    default:
+      decoded = false;
+      break;
+    }
+
+    if (!decoded && !reader.skip(tag->type)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+constexpr std::string_view BD_SEQ_METRIC = "bdSeq";
+
+// Sets bd_seq if this metric body is the bdSeq metric; false on malformed input
+bool match_bd_seq(std::span<const uint8_t> body,
+                  std::optional<uint64_t>& bd_seq) noexcept {
+  wire::Reader reader(body);
+  bool named = false;
+  uint64_t value = 0;
+  while (!reader.done()) {
+    auto tag = reader.read_tag();
+    if (!tag) {
+      return false;
+    }
+    if (tag->field == wire::metric_field::NAME &&
+        tag->type == WireType::LengthDelimited) {
+      auto name = reader.read_string();
+      if (!name) {
+        return false;
+      }
+      if (*name != BD_SEQ_METRIC) {
+        return true; // Another metric: the rest of the body is not needed
+      }
+      named = true;
+    } else if (tag->field == wire::metric_field::LONG_VALUE &&
+               tag->type == WireType::Varint) {
+      auto long_value = reader.read_varint();
+      if (!long_value) {
+        return false;
+      }
+      value = *long_value;
+    } else if (!reader.skip(tag->type)) {
+      return false;
+    }
+  }
+  if (named) {
+    bd_seq = value;
+  }
+  return true;
+}
+
+} // namespace
+
+void PayloadView::MetricIterator::advance() noexcept {
+  while (!reader_.done()) {
+    const uint8_t* start = reader_.position();
+    auto tag = reader_.read_tag();
+    if (!tag) {
+      break;
+    }
+    if (tag->field == wire::payload_field::METRICS &&
+        tag->type == WireType::LengthDelimited) {
+      auto body = reader_.read_bytes();
+      if (!body || !decode_metric(*body, current_)) {
+        break;
+      }
+      position_ = start;
+      at_end_ = false;
+      return;
+    }
+    if (!reader_.skip(tag->type)) {
+      break;
+    }
+  }
+  // parse() has checked the structure, so only the end of input gets here
+  at_end_ = true;
+  position_ = nullptr;
+}
+
+stdx::expected<PayloadView, std::string>
+PayloadView::parse(std::span<const uint8_t> bytes) {
+  PayloadView view;
+  view.data_ = bytes;
+
+  wire::Reader reader(bytes);
+  MetricView scratch;
+  while (!reader.done()) {
+    auto tag = reader.read_tag();
+    if (!tag) {
+      return stdx::unexpected(std::format("Malformed field key at offset {}",
+                                          bytes.size() - reader.remaining()));
+    }
+
+    bool ok = true;
+    if (tag->type == WireType::Varint && tag->field == wire::payload_field::TIMESTAMP) {
+      view.timestamp_ = reader.read_varint();
+      ok = view.timestamp_.has_value();
+    } else if (tag->type == WireType::Varint && tag->field == wire::payload_field::SEQ) {
+      view.seq_ = reader.read_varint();
+      ok = view.seq_.has_value();
+    } else if (tag->type == WireType::LengthDelimited &&
+               tag->field == wire::payload_field::METRICS) {
+      auto body = reader.read_bytes();
+      if (!body) {
+        ok = false;
+      } else if (!decode_metric(*body, scratch)) {
+        return stdx::unexpected(
+            std::format("Malformed metric at index {}", view.metric_count_));
+      } else {
+        view.metric_count_++;
+      }
+    } else if (tag->type == WireType::LengthDelimited &&
+               tag->field == wire::payload_field::UUID) {
+      view.uuid_ = reader.read_string();
+      ok = view.uuid_.has_value();
+    } else if (tag->type == WireType::LengthDelimited &&
+               tag->field == wire::payload_field::BODY) {
+      view.body_ = reader.read_bytes();
+      ok = view.body_.has_value();
+    } else {
+      ok = reader.skip(tag->type);
+    }
+
+    if (!ok) {
+      return stdx::unexpected(std::format("Truncated payload field {}", tag->field));
+    }
+  }
+  return view;
+}
+
+stdx::expected<PayloadHeader, std::string>
+scan_payload_header(std::span<const uint8_t> bytes, bool locate_bd_seq) {
+  PayloadHeader header;
+  wire::Reader reader(bytes);
+  while (!reader.done()) {
+    auto tag = reader.read_tag();
+    if (!tag) {
+      return stdx::unexpected(std::format("Malformed field key at offset {}",
+                                          bytes.size() - reader.remaining()));
+    }
+
+    bool ok = true;
+    if (tag->type == WireType::Varint && tag->field == wire::payload_field::TIMESTAMP) {
+      header.timestamp = reader.read_varint();
+      ok = header.timestamp.has_value();
+    } else if (tag->type == WireType::Varint && tag->field == wire::payload_field::SEQ) {
+      header.seq = reader.read_varint();
+      ok = header.seq.has_value();
+    } else if (locate_bd_seq && !header.bd_seq &&
+               tag->type == WireType::LengthDelimited &&
+               tag->field == wire::payload_field::METRICS) {
+      auto body = reader.read_bytes();
+      if (body && !match_bd_seq(*body, header.bd_seq)) {
+        return stdx::unexpected("Malformed metric while locating bdSeq");
+      }
+      ok = body.has_value();
+    } else {
+      ok = reader.skip(tag->type);
+    }
+
+    if (!ok) {
+      return stdx::unexpected(std::format("Truncated payload field {}", tag->field));
+    }
+  }
+  return header;
+}
+
+std::optional<MetricView> PayloadView::find(std::string_view name) const noexcept {
+  for (const auto& metric : metrics()) {
+    if (metric.name == name) {
+      return metric;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<MetricView> PayloadView::find(uint64_t alias) const noexcept {
+  for (const auto& metric : metrics()) {
+    if (metric.alias == alias) {
+      return metric;
+    }
+  }
+  return std::nullopt;
+}
+
+} // namespace sparkplug
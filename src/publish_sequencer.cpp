@@ -0,0 +1,123 @@
+// src/publish_sequencer.cpp
+#include "sparkplug/publish_sequencer.hpp"
+
+#include "sparkplug/wire.hpp"
+
+#include <thread>
+#include <utility>
+
+namespace sparkplug {
+
+namespace {
+
+// Appends the seq field (tag 3, varint) to an encoded payload
+void append_seq(std::vector<uint8_t>& bytes, uint64_t seq) {
+  const uint64_t tag = wire::make_tag(wire::payload_field::SEQ, wire::WireType::Varint);
+  const size_t size = bytes.size();
+  bytes.resize(size + wire::varint_size(tag) + wire::varint_size(seq));
+  wire::write_varint(wire::write_varint(bytes.data() + size, tag), seq);
+}
+
+} // namespace
+
+PublishSequencer::PublishSequencer(size_t capacity, Send send)
+    : send_(std::move(send)), ring_(capacity) {
+}
+
+stdx::expected<void, std::string> PublishSequencer::submit(Message& msg) {
+  // Counted before the push, so a writer about to give up the role sees it and stays
+  queued_.fetch_add(1);
+  while (!ring_.try_push(&msg)) {
+    // Full: drain it ourselves, or let the current writer catch up
+    if (!try_write(msg, false)) {
+      std::this_thread::yield();
+    }
+  }
+
+  for (;;) {
+    const uint32_t completed = completed_.load(std::memory_order_acquire);
+    if (msg.done.load(std::memory_order_acquire)) {
+      break;
+    }
+    if (!try_write(msg, true)) {
+      completed_.wait(completed, std::memory_order_acquire);
+    }
+  }
+  return msg.result;
+}
+
+bool PublishSequencer::try_write(const Message& own, bool own_queued) {
+  if (writing_.exchange(true)) {
+    return false;
+  }
+  // Not queued yet (the ring was full): nothing of ours to wait for
+  auto own_finished = [&] {
+    return !own_queued || own.done.load(std::memory_order_acquire);
+  };
+  size_t written = 0;
+  for (;;) {
+    while (auto msg = ring_.try_pop()) {
+      write(**msg);
+      queued_.fetch_sub(1);
+      completed_.fetch_add(1, std::memory_order_release);
+      completed_.notify_all();
+      // Under sustained load, hand the role on rather than write for others forever
+      if (++written >= ring_.capacity() && own_finished()) {
+        break;
+      }
+    }
+    writing_.store(false);
+    if (queued_.load() == 0) {
+      return true;
+    }
+    if (own_finished()) {
+      // Every queued message has a producer waiting for it; wake one to take over
+      completed_.fetch_add(1, std::memory_order_release);
+      completed_.notify_all();
+      return true;
+    }
+    // A producer that found the role taken after our last pop is waiting on us
+    if (writing_.exchange(true)) {
+      return true;
+    }
+  }
+}
+
+void PublishSequencer::write(Message& msg) {
+  uint64_t seq = seq_.load(std::memory_order_relaxed);
+  msg.first_seq = msg.restart_seq ? 0 : (seq + 1) % SEQ_MODULUS;
+  msg.parts_sent = 0;
+  msg.result = {};
+
+  for (auto& part : msg.parts) {
+    const uint64_t next = (msg.restart_seq && msg.parts_sent == 0)
+                              ? 0
+                              : (seq + 1) % SEQ_MODULUS;
+    std::span<const uint8_t> bytes;
+    if (part.frozen) {
+      if (part.assign_seq) {
+        part.frozen->set_seq(next);
+      }
+      bytes = part.frozen->bytes();
+    } else {
+      if (part.assign_seq) {
+        append_seq(*part.bytes, next);
+      }
+      bytes = *part.bytes;
+    }
+
+    msg.result = send_(msg.route, bytes);
+    if (!msg.result) {
+      break;
+    }
+    if (part.assign_seq) {
+      seq = next;
+    }
+    msg.parts_sent++;
+  }
+
+  seq_.store(seq, std::memory_order_relaxed);
+  msg.done.store(true, std::memory_order_release);
+}
+
+} // namespace sparkplug
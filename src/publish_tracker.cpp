@@ -0,0 +1,253 @@
+// src/publish_tracker.cpp
+#include "sparkplug/publish_tracker.hpp"
+
+#include <algorithm>
+#include <format>
+#include <utility>
+
+namespace sparkplug {
+
+PublishToken::~PublishToken() {
+  if (tracker_) {
+    tracker_->release_token(slot_);
+  }
+}
+
+PublishToken::PublishToken(PublishToken&& other) noexcept
+    : tracker_(std::move(other.tracker_)), slot_(other.slot_) {
+}
+
+PublishToken& PublishToken::operator=(PublishToken&& other) noexcept {
+  if (this != &other) {
+    if (tracker_) {
+      tracker_->release_token(slot_);
+    }
+    tracker_ = std::move(other.tracker_);
+    slot_ = other.slot_;
+  }
+  return *this;
+}
+
+bool PublishToken::ready() const {
+  if (!tracker_) {
+    return false;
+  }
+  std::scoped_lock lock(tracker_->mutex_);
+  return tracker_->slots_[slot_].done;
+}
+
+PublishResult PublishToken::wait() const {
+  if (!tracker_) {
+    return stdx::unexpected("Empty PublishToken");
+  }
+  std::unique_lock lock(tracker_->mutex_);
+  const auto& slot = tracker_->slots_[slot_];
+  tracker_->changed_.wait(lock, [&slot] { return slot.done; });
+  return slot.result;
+}
+
+std::optional<PublishResult>
+PublishToken::wait_for(std::chrono::milliseconds timeout) const {
+  if (!tracker_) {
+    return PublishResult(stdx::unexpected("Empty PublishToken"));
+  }
+  std::unique_lock lock(tracker_->mutex_);
+  const auto& slot = tracker_->slots_[slot_];
+  if (!tracker_->changed_.wait_for(lock, timeout, [&slot] { return slot.done; })) {
+    return std::nullopt;
+  }
+  return slot.result;
+}
+
+PublishTracker::PublishTracker(size_t capacity) : slots_(std::max<size_t>(capacity, 1)) {
+  free_.reserve(slots_.size());
+  for (size_t i = slots_.size(); i-- > 0;) {
+    slots_[i].index = static_cast<uint32_t>(i);
+    free_.push_back(static_cast<uint32_t>(i));
+  }
+}
+
+stdx::expected<PublishToken, std::string>
+PublishTracker::start(PublishCallback on_complete, std::chrono::milliseconds timeout) {
+  std::unique_lock lock(mutex_);
+  if (!changed_.wait_for(lock, timeout, [this] { return !free_.empty(); })) {
+    return stdx::unexpected(
+        std::format("{} publishes already in flight", slots_.size()));
+  }
+  const uint32_t index = free_.back();
+  free_.pop_back();
+
+  Slot& slot = slots_[index];
+  renew(slot);
+  slot.sends = 0;
+  slot.open = true;
+  slot.done = false;
+  slot.held = true;
+  slot.result = {};
+  slot.callback = std::move(on_complete);
+  in_flight_++;
+  return PublishToken(shared_from_this(), index);
+}
+
+void PublishTracker::prepare(const PublishToken& token, MQTTAsync_responseOptions& opts) {
+  std::scoped_lock lock(mutex_);
+  Slot& slot = slots_[token.slot_];
+  slot.sends++;
+  slot.context->reports++;
+  opts.context = slot.context;
+  opts.onSuccess = on_success;
+  opts.onFailure = on_failure;
+}
+
+void PublishTracker::fail(const PublishToken& token, std::string error) {
+  Context* context = nullptr;
+  {
+    std::scoped_lock lock(mutex_);
+    context = slots_[token.slot_].context;
+  }
+  complete_send(*context, std::move(error));
+}
+
+void PublishTracker::finish(const PublishToken& token) {
+  Completion completion;
+  {
+    std::scoped_lock lock(mutex_);
+    Slot& slot = slots_[token.slot_];
+    slot.open = false;
+    completion = settle(slot);
+  }
+  run(completion);
+}
+
+void PublishTracker::discard(const PublishToken& token) {
+  std::scoped_lock lock(mutex_);
+  Slot& slot = slots_[token.slot_];
+  slot.callback = nullptr;
+  slot.open = false;
+  (void)settle(slot);
+}
+
+std::vector<PublishTracker::Completion>
+PublishTracker::abandon(std::string_view reason) {
+  std::vector<Completion> completions;
+  std::scoped_lock lock(mutex_);
+  for (auto& slot : slots_) {
+    if (slot.done || slot.sends == 0) {
+      continue;
+    }
+    slot.sends = 0;
+    if (slot.result) {
+      slot.result = stdx::unexpected(std::string(reason));
+    }
+    // Should the client report the abandoned sends after all, they are ignored
+    renew(slot);
+    if (auto completion = settle(slot); completion.callback) {
+      completions.push_back(std::move(completion));
+    }
+  }
+  return completions;
+}
+
+size_t PublishTracker::in_flight() const {
+  std::scoped_lock lock(mutex_);
+  return in_flight_;
+}
+
+void PublishTracker::on_success(void* context, MQTTAsync_successData* /*response*/) {
+  auto* send_context = static_cast<Context*>(context);
+  send_context->owner->complete_send(*send_context, std::nullopt);
+}
+
+void PublishTracker::on_failure(void* context, MQTTAsync_failureData* response) {
+  auto* send_context = static_cast<Context*>(context);
+  send_context->owner->complete_send(
+      *send_context,
+      std::format("Publish failed: code={}", response ? response->code : -1));
+}
+
+void PublishTracker::renew(Slot& slot) {
+  slot.generation++;
+  if (slot.context && slot.context->reports == 0) {
+    slot.context->generation = slot.generation;
+    return;
+  }
+  // The old context, if any, is left to its outstanding reports
+  Context* context = nullptr;
+  if (spare_contexts_.empty()) {
+    context = contexts_.emplace_back(std::make_unique<Context>()).get();
+  } else {
+    context = spare_contexts_.back();
+    spare_contexts_.pop_back();
+  }
+  *context = {.owner = this, .slot = slot.index, .generation = slot.generation};
+  slot.context = context;
+}
+
+PublishTracker::Completion PublishTracker::settle(Slot& slot) {
+  if (slot.done || slot.open || slot.sends > 0) {
+    return {};
+  }
+  slot.done = true;
+  in_flight_--;
+
+  Completion completion;
+  if (slot.callback) {
+    completion.callback = std::move(slot.callback);
+    completion.result = slot.result;
+    slot.callback = nullptr;
+  }
+  if (!slot.held) {
+    free_.push_back(slot.index);
+  }
+  changed_.notify_all();
+  return completion;
+}
+
+void PublishTracker::complete_send(Context& context, std::optional<std::string> error) {
+  Completion completion;
+  {
+    std::scoped_lock lock(mutex_);
+    context.reports--;
+    Slot& slot = slots_[context.slot];
+    if (context.generation != slot.generation) {
+      // Abandoned, and the slot may have been reused since
+      if (context.reports == 0) {
+        spare_contexts_.push_back(&context);
+      }
+      return;
+    }
+    if (slot.sends == 0) {
+      return;
+    }
+    slot.sends--;
+    if (error && slot.result) {
+      slot.result = stdx::unexpected(std::move(*error));
+    }
+    completion = settle(slot);
+  }
+  run(completion);
+}
+
+void PublishTracker::release_token(uint32_t index) {
+  std::scoped_lock lock(mutex_);
+  Slot& slot = slots_[index];
+  slot.held = false;
+  if (slot.done) {
+    free_.push_back(index);
+    changed_.notify_all();
+  }
+}
+
+void PublishTracker::run(Completion& completion) {
+  if (completion.callback) {
+    completion.callback(completion.result);
+  }
+}
+
+void PublishTracker::run(std::vector<Completion>& completions) {
+  for (auto& completion : completions) {
+    run(completion);
+  }
+}
+
+} // namespace sparkplug
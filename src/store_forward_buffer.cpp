@@ -0,0 +1,299 @@
+// src/store_forward_buffer.cpp
+#include "sparkplug/store_forward_buffer.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <new>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace sparkplug {
+
+namespace {
+
+constexpr char MAGIC[8] = {'S', 'P', 'B', 'S', 'A', 'F', '0', '1'};
+// The ring starts this far into the file, after the header
+constexpr size_t HEADER_SIZE = 64;
+
+// Precedes each record's device ID and payload
+struct RecordHeader {
+  uint32_t payload_size;
+  uint32_t device_id_size;
+};
+constexpr size_t RECORD_HEADER_SIZE = sizeof(RecordHeader);
+
+std::string errno_message() {
+  return std::strerror(errno);
+}
+
+} // namespace
+
+stdx::expected<std::unique_ptr<StoreForwardBuffer>, std::string>
+StoreForwardBuffer::open(Options options) {
+  static_assert(sizeof(Header) <= HEADER_SIZE);
+  const size_t capacity = options.capacity_bytes;
+  if (capacity <= RECORD_HEADER_SIZE) {
+    return stdx::unexpected(
+        std::format("capacity_bytes must be more than {}", RECORD_HEADER_SIZE));
+  }
+  const size_t total = HEADER_SIZE + capacity;
+
+  auto init = [capacity](Header* header) {
+    std::memcpy(header->magic, MAGIC, sizeof(MAGIC));
+    header->capacity = capacity;
+    header->read_pos = 0;
+    header->write_pos = 0;
+    header->records = 0;
+  };
+
+  if (options.file_path.empty()) {
+    auto memory = std::make_unique<uint8_t[]>(total);
+    auto* header = new (memory.get()) Header{};
+    init(header);
+    uint8_t* ring = memory.get() + HEADER_SIZE;
+    return std::unique_ptr<StoreForwardBuffer>(
+        new StoreForwardBuffer(std::move(options), header, ring, 0, std::move(memory)));
+  }
+
+  const auto& path = options.file_path;
+  int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return stdx::unexpected(std::format("Failed to open store-and-forward file '{}': {}",
+                                        path, errno_message()));
+  }
+
+  struct stat st{};
+  if (::fstat(fd, &st) != 0) {
+    auto error = errno_message();
+    ::close(fd);
+    return stdx::unexpected(
+        std::format("Failed to stat store-and-forward file '{}': {}", path, error));
+  }
+  if (st.st_size == 0) {
+    if (::ftruncate(fd, static_cast<off_t>(total)) != 0) {
+      auto error = errno_message();
+      ::close(fd);
+      return stdx::unexpected(
+          std::format("Failed to size store-and-forward file '{}': {}", path, error));
+    }
+  } else if (static_cast<size_t>(st.st_size) != total) {
+    ::close(fd);
+    return stdx::unexpected(std::format(
+        "Store-and-forward file '{}' is {} bytes; capacity_bytes {} needs {}", path,
+        st.st_size, capacity, total));
+  }
+
+  void* mapped = ::mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  auto map_error = errno_message();
+  ::close(fd); // The mapping keeps the file open
+  if (mapped == MAP_FAILED) {
+    return stdx::unexpected(
+        std::format("Failed to map store-and-forward file '{}': {}", path, map_error));
+  }
+
+  auto* header = static_cast<Header*>(mapped);
+  static constexpr char NO_MAGIC[8] = {};
+  if (std::memcmp(header->magic, NO_MAGIC, sizeof(NO_MAGIC)) == 0) {
+    init(header); // New file
+  } else if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+             header->capacity != capacity) {
+    ::munmap(mapped, total);
+    return stdx::unexpected(std::format(
+        "'{}' is not a store-and-forward file with capacity_bytes {}", path, capacity));
+  }
+
+  uint8_t* ring = static_cast<uint8_t*>(mapped) + HEADER_SIZE;
+  std::unique_ptr<StoreForwardBuffer> buffer(
+      new StoreForwardBuffer(std::move(options), header, ring, total, nullptr));
+  buffer->recover();
+  return buffer;
+}
+
+StoreForwardBuffer::StoreForwardBuffer(Options options, Header* header, uint8_t* ring,
+                                       size_t mapped_bytes,
+                                       std::unique_ptr<uint8_t[]> memory)
+    : options_(std::move(options)), header_(header), ring_(ring),
+      mapped_bytes_(mapped_bytes), memory_(std::move(memory)) {
+}
+
+StoreForwardBuffer::~StoreForwardBuffer() {
+  if (mapped_bytes_ != 0) {
+    ::munmap(header_, mapped_bytes_);
+  }
+}
+
+void StoreForwardBuffer::write_at(uint64_t pos, const void* data, size_t size) {
+  if (size == 0) {
+    return; // data may be null
+  }
+  const size_t offset = pos % header_->capacity;
+  const size_t first = std::min(size, header_->capacity - offset);
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  std::memcpy(ring_ + offset, bytes, first);
+  std::memcpy(ring_, bytes + first, size - first);
+}
+
+void StoreForwardBuffer::read_at(uint64_t pos, void* data, size_t size) const {
+  if (size == 0) {
+    return; // data may be null
+  }
+  const size_t offset = pos % header_->capacity;
+  const size_t first = std::min(size, header_->capacity - offset);
+  auto* bytes = static_cast<uint8_t*>(data);
+  std::memcpy(bytes, ring_ + offset, first);
+  std::memcpy(bytes + first, ring_, size - first);
+}
+
+size_t StoreForwardBuffer::record_size(uint64_t pos) const {
+  RecordHeader record;
+  read_at(pos, &record, sizeof(record));
+  return RECORD_HEADER_SIZE + record.device_id_size + record.payload_size;
+}
+
+void StoreForwardBuffer::drop_front() {
+  header_->read_pos += record_size(header_->read_pos);
+  header_->records--;
+}
+
+void StoreForwardBuffer::sync(uint64_t pos, size_t size) {
+  if (!options_.durable || mapped_bytes_ == 0) {
+    return;
+  }
+  static const auto page = static_cast<uintptr_t>(::sysconf(_SC_PAGESIZE));
+  auto sync_bytes = [](const uint8_t* begin, size_t length) {
+    const auto start = reinterpret_cast<uintptr_t>(begin) & ~(page - 1);
+    const auto end = reinterpret_cast<uintptr_t>(begin) + length;
+    ::msync(reinterpret_cast<void*>(start), end - start, MS_SYNC);
+  };
+  const size_t offset = pos % header_->capacity;
+  const size_t first = std::min(size, header_->capacity - offset);
+  if (first != 0) {
+    sync_bytes(ring_ + offset, first);
+  }
+  if (size > first) {
+    sync_bytes(ring_, size - first);
+  }
+  // Last, so the positions never point at records that are not on disk yet
+  sync_bytes(reinterpret_cast<const uint8_t*>(header_), sizeof(Header));
+}
+
+void StoreForwardBuffer::recover() {
+  std::scoped_lock lock(mutex_);
+  // Count the records from the read position; a process stopped in the middle of an
+  // update leaves positions that do not line up, and the ring is then started afresh
+  const uint64_t used = header_->write_pos - header_->read_pos;
+  bool valid = header_->write_pos >= header_->read_pos && used <= header_->capacity;
+  uint64_t records = 0;
+  for (uint64_t pos = header_->read_pos; valid && pos != header_->write_pos; records++) {
+    const size_t size = record_size(pos);
+    valid = size <= header_->write_pos - pos;
+    pos += size;
+  }
+  if (valid) {
+    header_->records = records;
+    return;
+  }
+  header_->read_pos = 0;
+  header_->write_pos = 0;
+  header_->records = 0;
+}
+
+bool StoreForwardBuffer::push(std::string_view device_id,
+                              std::span<const uint8_t> payload) {
+  const size_t size = RECORD_HEADER_SIZE + device_id.size() + payload.size();
+  std::scoped_lock lock(mutex_);
+
+  if (size > header_->capacity) {
+    rejected_++;
+    return false;
+  }
+  while (header_->capacity - (header_->write_pos - header_->read_pos) < size) {
+    if (options_.eviction == Eviction::DropNewest) {
+      rejected_++;
+      return false;
+    }
+    drop_front();
+    evicted_++;
+  }
+
+  const uint64_t pos = header_->write_pos;
+  const RecordHeader record{.payload_size = static_cast<uint32_t>(payload.size()),
+                            .device_id_size = static_cast<uint32_t>(device_id.size())};
+  write_at(pos, &record, sizeof(record));
+  write_at(pos + RECORD_HEADER_SIZE, device_id.data(), device_id.size());
+  write_at(pos + RECORD_HEADER_SIZE + device_id.size(), payload.data(), payload.size());
+  // Published after the record itself, so a reopened file never sees half a record
+  header_->write_pos = pos + size;
+  header_->records++;
+  sync(pos, size);
+  return true;
+}
+
+std::optional<uint64_t> StoreForwardBuffer::front(std::string& device_id,
+                                                  std::vector<uint8_t>& payload) const {
+  std::scoped_lock lock(mutex_);
+  if (header_->records == 0) {
+    return std::nullopt;
+  }
+
+  const uint64_t pos = header_->read_pos;
+  RecordHeader record;
+  read_at(pos, &record, sizeof(record));
+  device_id.resize(record.device_id_size);
+  payload.resize(record.payload_size);
+  read_at(pos + RECORD_HEADER_SIZE, device_id.data(), device_id.size());
+  read_at(pos + RECORD_HEADER_SIZE + device_id.size(), payload.data(), payload.size());
+  return pos;
+}
+
+void StoreForwardBuffer::pop(uint64_t position) {
+  std::scoped_lock lock(mutex_);
+  if (header_->records > 0 && header_->read_pos == position) {
+    drop_front();
+    sync(header_->read_pos, 0);
+  }
+}
+
+bool StoreForwardBuffer::requeue(uint64_t position) {
+  std::scoped_lock lock(mutex_);
+  if (header_->records == 0 || header_->read_pos != position) {
+    return false;
+  }
+  const size_t size = record_size(position);
+  std::vector<uint8_t> record(size);
+  read_at(position, record.data(), size);
+
+  const uint64_t pos = header_->write_pos;
+  const bool fits = header_->capacity - (pos - position) >= size;
+  if (!fits) {
+    // The copy overwrites the record itself, which is given up first
+    header_->read_pos = position + size;
+  }
+  write_at(pos, record.data(), size);
+  header_->write_pos = pos + size;
+  header_->read_pos = position + size;
+  sync(pos, size);
+  return true;
+}
+
+bool StoreForwardBuffer::empty() const {
+  std::scoped_lock lock(mutex_);
+  return header_->records == 0;
+}
+
+StoreForwardBuffer::Stats StoreForwardBuffer::stats() const {
+  std::scoped_lock lock(mutex_);
+  return {.records = header_->records,
+          .bytes = header_->write_pos - header_->read_pos,
+          .capacity_bytes = header_->capacity,
+          .evicted = evicted_,
+          .rejected = rejected_};
+}
+
+} // namespace sparkplug
@@ -0,0 +1,29 @@
+// src/template.cpp
+#include "sparkplug/template.hpp"
+
+#include <algorithm>
+
+namespace sparkplug {
+
+void TemplateDefinition::fill_definition(
+    org::eclipse::tahu::protobuf::Payload::Template& out) const {
+  if (!version_.empty()) {
+    out.set_version(version_);
+  }
+  out.mutable_metrics()->Reserve(static_cast<int>(members_.size()));
+  for (const auto& member : members_) {
+    auto* metric = out.add_metrics();
+    metric->set_name(member.name);
+    metric->set_datatype(std::to_underlying(member.type));
+  }
+  out.set_is_definition(true);
+}
+
+bool operator==(const TemplateDefinition& a, const TemplateDefinition& b) {
+  return a.name_ == b.name_ && a.version_ == b.version_ &&
+         std::ranges::equal(a.members_, b.members_, [](const auto& x, const auto& y) {
+           return x.name == y.name && x.type == y.type;
+         });
+}
+
+} // namespace sparkplug
@@ -1,11 +1,12 @@
 // src/topic.cpp
 #include "sparkplug/topic.hpp"
 
-#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <format>
-#include <ranges>
+#include <iterator>
 #include <utility>
-#include <vector>
 
 namespace sparkplug {
 
@@ -13,86 +14,114 @@ namespace {
 
 using namespace std::string_view_literals;
 
-constexpr std::string_view message_type_to_string(MessageType type) noexcept {
-  switch (type) {
-  case MessageType::NBIRTH:
-    return "NBIRTH";
-  case MessageType::NDEATH:
-    return "NDEATH";
-  case MessageType::DBIRTH:
-    return "DBIRTH";
-  case MessageType::DDEATH:
-    return "DDEATH";
-  case MessageType::NDATA:
-    return "NDATA";
-  case MessageType::DDATA:
-    return "DDATA";
-  case MessageType::NCMD:
-    return "NCMD";
-  case MessageType::DCMD:
-    return "DCMD";
-  case MessageType::STATE:
-    return "STATE";
-  }
-  std::unreachable();
+// Message type names are 4-6 bytes, so the first and last 4 bytes (overlapping for
+// short names) identify one uniquely; together with the length, two loads suffice
+constexpr uint64_t pack_type_name(std::string_view str) noexcept {
+  auto load32 = [](const char* ptr) {
+    uint32_t word = 0;
+    for (int i = 0; i < 4; i++) {
+      word |= static_cast<uint32_t>(static_cast<unsigned char>(ptr[i])) << (8 * i);
+    }
+    return word;
+  };
+  return load32(str.data()) |
+         (static_cast<uint64_t>(load32(str.data() + str.size() - 4)) << 32);
+}
+
+constexpr size_t TYPE_SLOT_BITS = 4;
+
+// The golden-ratio multiply happens to be a perfect hash for the nine names
+constexpr size_t type_slot(uint64_t packed) noexcept {
+  return static_cast<size_t>((packed * 0x9e3779b97f4a7c15ULL) >> (64 - TYPE_SLOT_BITS));
 }
 
+struct TypeSlot {
+  uint64_t packed{0};
+  size_t length{0}; // 0 for unused slots
+  MessageType type{MessageType::NBIRTH};
+};
+
+constexpr std::array<TypeSlot, size_t{1} << TYPE_SLOT_BITS> TYPE_SLOTS = [] {
+  std::array<TypeSlot, size_t{1} << TYPE_SLOT_BITS> slots{};
+  for (auto type : {MessageType::NBIRTH, MessageType::NDEATH, MessageType::DBIRTH,
+                    MessageType::DDEATH, MessageType::NDATA, MessageType::DDATA,
+                    MessageType::NCMD, MessageType::DCMD, MessageType::STATE}) {
+    const auto name = message_type_name(type);
+    auto& slot = slots[type_slot(pack_type_name(name))];
+    if (slot.length != 0) {
+      throw "message type hash collision"; // Fails constant evaluation
+    }
+    slot = TypeSlot{.packed = pack_type_name(name), .length = name.size(), .type = type};
+  }
+  return slots;
+}();
+
 stdx::expected<MessageType, std::string> parse_message_type(std::string_view str) {
-  if (str == "NBIRTH")
-    return MessageType::NBIRTH;
-  if (str == "NDEATH")
-    return MessageType::NDEATH;
-  if (str == "DBIRTH")
-    return MessageType::DBIRTH;
-  if (str == "DDEATH")
-    return MessageType::DDEATH;
-  if (str == "NDATA")
-    return MessageType::NDATA;
-  if (str == "DDATA")
-    return MessageType::DDATA;
-  if (str == "NCMD")
-    return MessageType::NCMD;
-  if (str == "DCMD")
-    return MessageType::DCMD;
-  if (str == "STATE")
-    return MessageType::STATE;
+  if (str.size() >= 4 && str.size() <= 6) {
+    const uint64_t packed = pack_type_name(str);
+    const TypeSlot& slot = TYPE_SLOTS[type_slot(packed)];
+    if (slot.packed == packed && slot.length == str.size()) {
+      return slot.type;
+    }
+  }
   return stdx::unexpected(std::format("Unknown message type: {}", str));
 }
-} // namespace
 
-std::string Topic::to_string() const {
-  if (message_type == MessageType::STATE) {
-    return std::format("{}/STATE/{}", NAMESPACE, edge_node_id);
+// Splits a topic on '/' like std::views::split: an empty string has no segments and a
+// trailing '/' ends with one empty segment
+class TopicSegments {
+public:
+  explicit TopicSegments(std::string_view str) noexcept
+      : pos_(str.data()), end_(str.data() + str.size()), more_(!str.empty()) {
   }
 
-  auto base = std::format("{}/{}/{}/{}", NAMESPACE, group_id,
-                          message_type_to_string(message_type), edge_node_id);
-
-  if (!device_id.empty()) {
-    return std::format("{}/{}", base, device_id);
+  bool next(std::string_view& segment) noexcept {
+    if (!more_) {
+      return false;
+    }
+    const size_t remaining = static_cast<size_t>(end_ - pos_);
+    const auto* slash = static_cast<const char*>(std::memchr(pos_, '/', remaining));
+    if (slash == nullptr) {
+      segment = std::string_view(pos_, end_);
+      more_ = false;
+    } else {
+      segment = std::string_view(pos_, slash);
+      pos_ = slash + 1;
+    }
+    return true;
   }
-  return base;
-}
 
-stdx::expected<Topic, std::string> Topic::parse(std::string_view topic_str) {
-  // Parse without allocating vector - use iterators directly
-  auto parts = topic_str | std::views::split('/') | std::views::transform([](auto&& rng) {
-                 return std::string_view(rng.begin(),
-                                         std::ranges::distance(rng.begin(), rng.end()));
-               });
+private:
+  const char* pos_;
+  const char* end_;
+  bool more_;
+};
+} // namespace
 
-  auto it = parts.begin();
-  auto end = parts.end();
+std::string Topic::to_string() const {
+  const TopicView view = *this;
+  std::string result;
+  result.reserve(view.formatted_size());
+  view.format_to(std::back_inserter(result));
+  return result;
+}
 
-  if (it == end) {
-    return stdx::unexpected("Invalid topic format");
+size_t TopicView::formatted_size() const noexcept {
+  // Separators: "spBv1.0/STATE/{host}" or "spBv1.0/{group}/{type}/{node}[/{device}]"
+  if (message_type == MessageType::STATE) {
+    return NAMESPACE.size() + 7 + edge_node_id.size();
   }
+  return NAMESPACE.size() + 3 + group_id.size() + message_type_name(message_type).size() +
+         edge_node_id.size() + (device_id.empty() ? 0 : 1 + device_id.size());
+}
 
-  std::string_view part0 = *it++;
-  if (it == end) {
+stdx::expected<TopicView, std::string> TopicView::parse(std::string_view topic_str) {
+  TopicSegments segments(topic_str);
+  std::string_view part0;
+  std::string_view part1;
+  if (!segments.next(part0) || !segments.next(part1)) {
     return stdx::unexpected("Invalid topic format");
   }
-  std::string_view part1 = *it++;
 
   // Sparkplug B topic: spBv1.0/{group_id}/{message_type}/{edge_node_id}[/{device_id}]
   // or STATE message: spBv1.0/STATE/{host_id}
@@ -102,40 +131,49 @@ stdx::expected<Topic, std::string> Topic::parse(std::string_view topic_str) {
 
   // Check for STATE message: spBv1.0/STATE/{host_id}
   if (part1 == "STATE") {
-    if (it == end) {
+    std::string_view host_id;
+    if (!segments.next(host_id)) {
       return stdx::unexpected("STATE topic requires host_id");
     }
-    std::string_view host_id = *it++;
-    return Topic{.group_id = "",
-                 .message_type = MessageType::STATE,
-                 .edge_node_id = std::string(host_id),
-                 .device_id = ""};
+    return TopicView{.group_id = {},
+                     .message_type = MessageType::STATE,
+                     .edge_node_id = host_id,
+                     .device_id = {}};
   }
 
-  if (it == end) {
+  std::string_view part2;
+  std::string_view part3;
+  if (!segments.next(part2) || !segments.next(part3)) {
     return stdx::unexpected("Invalid Sparkplug B topic");
   }
-  std::string_view part2 = *it++;
-
-  if (it == end) {
-    return stdx::unexpected("Invalid Sparkplug B topic");
-  }
-  std::string_view part3 = *it++;
 
   auto msg_type = parse_message_type(part2);
   if (!msg_type) {
     return stdx::unexpected(msg_type.error());
   }
 
-  std::string device_id;
-  if (it != end) {
-    device_id = std::string(*it);
-  }
+  std::string_view device_id;
+  segments.next(device_id);
+
+  return TopicView{.group_id = part1,
+                   .message_type = *msg_type,
+                   .edge_node_id = part3,
+                   .device_id = device_id};
+}
 
-  return Topic{.group_id = std::string(part1),
-               .message_type = *msg_type,
-               .edge_node_id = std::string(part3),
-               .device_id = std::move(device_id)};
+Topic TopicView::to_topic() const {
+  return Topic{.group_id = std::string(group_id),
+               .message_type = message_type,
+               .edge_node_id = std::string(edge_node_id),
+               .device_id = std::string(device_id)};
+}
+
+stdx::expected<Topic, std::string> Topic::parse(std::string_view topic_str) {
+  auto view = TopicView::parse(topic_str);
+  if (!view) {
+    return stdx::unexpected(view.error());
+  }
+  return view->to_topic();
 }
 
-} // namespace sparkplug
\ No newline at end of file
+} // namespace sparkplug
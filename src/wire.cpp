@@ -0,0 +1,238 @@
+// src/wire.cpp
+#include "sparkplug/wire.hpp"
+
+#include <format>
+#include <type_traits>
+#include <utility>
+
+namespace sparkplug::wire {
+
+namespace {
+
+constexpr size_t field_size(uint32_t field, WireType type) noexcept {
+  return varint_size(make_tag(field, type));
+}
+
+inline uint8_t* write_tag(uint8_t* out, uint32_t field, WireType type) noexcept {
+  return write_varint(out, make_tag(field, type));
+}
+
+inline uint8_t*
+write_length_delimited(uint8_t* out, uint32_t field, const void* data, size_t size) {
+  out = write_tag(out, field, WireType::LengthDelimited);
+  out = write_varint(out, size);
+  if (size > 0) {
+    std::memcpy(out, data, size);
+  }
+  return out + size;
+}
+
+size_t value_size(const MetricValue& value) noexcept {
+  return std::visit(
+      [](const auto& v) -> size_t {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, std::monostate>) {
+          return 0;
+        } else if constexpr (std::is_same_v<T, uint32_t>) {
+          return field_size(metric_field::INT_VALUE, WireType::Varint) + varint_size(v);
+        } else if constexpr (std::is_same_v<T, uint64_t>) {
+          return field_size(metric_field::LONG_VALUE, WireType::Varint) + varint_size(v);
+        } else if constexpr (std::is_same_v<T, float>) {
+          return field_size(metric_field::FLOAT_VALUE, WireType::Fixed32) + 4;
+        } else if constexpr (std::is_same_v<T, double>) {
+          return field_size(metric_field::DOUBLE_VALUE, WireType::Fixed64) + 8;
+        } else if constexpr (std::is_same_v<T, bool>) {
+          return field_size(metric_field::BOOLEAN_VALUE, WireType::Varint) + 1;
+        } else if constexpr (std::is_same_v<T, std::string_view>) {
+          return field_size(metric_field::STRING_VALUE, WireType::LengthDelimited) +
+                 varint_size(v.size()) + v.size();
+        } else if constexpr (std::is_same_v<T, Bytes>) {
+          return field_size(metric_field::BYTES_VALUE, WireType::LengthDelimited) +
+                 varint_size(v.data.size()) + v.data.size();
+        } else if constexpr (std::is_same_v<T, DataSetBytes>) {
+          return field_size(metric_field::DATASET_VALUE, WireType::LengthDelimited) +
+                 varint_size(v.data.size()) + v.data.size();
+        } else {
+          return field_size(metric_field::TEMPLATE_VALUE, WireType::LengthDelimited) +
+                 varint_size(v.data.size()) + v.data.size();
+        }
+      },
+      value);
+}
+
+uint8_t* write_value(uint8_t* out, const MetricValue& value) noexcept {
+  return std::visit(
+      [out](const auto& v) -> uint8_t* {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, std::monostate>) {
+          return out;
+        } else if constexpr (std::is_same_v<T, uint32_t>) {
+          return write_varint(write_tag(out, metric_field::INT_VALUE, WireType::Varint),
+                              v);
+        } else if constexpr (std::is_same_v<T, uint64_t>) {
+          return write_varint(write_tag(out, metric_field::LONG_VALUE, WireType::Varint),
+                              v);
+        } else if constexpr (std::is_same_v<T, float>) {
+          return write_fixed32(
+              write_tag(out, metric_field::FLOAT_VALUE, WireType::Fixed32),
+              std::bit_cast<uint32_t>(v));
+        } else if constexpr (std::is_same_v<T, double>) {
+          return write_fixed64(
+              write_tag(out, metric_field::DOUBLE_VALUE, WireType::Fixed64),
+              std::bit_cast<uint64_t>(v));
+        } else if constexpr (std::is_same_v<T, bool>) {
+          uint8_t* p = write_tag(out, metric_field::BOOLEAN_VALUE, WireType::Varint);
+          *p = v ? 1 : 0;
+          return p + 1;
+        } else if constexpr (std::is_same_v<T, std::string_view>) {
+          return write_length_delimited(out, metric_field::STRING_VALUE, v.data(),
+                                        v.size());
+        } else if constexpr (std::is_same_v<T, Bytes>) {
+          return write_length_delimited(out, metric_field::BYTES_VALUE, v.data.data(),
+                                        v.data.size());
+        } else if constexpr (std::is_same_v<T, DataSetBytes>) {
+          return write_length_delimited(out, metric_field::DATASET_VALUE, v.data.data(),
+                                        v.data.size());
+        } else {
+          return write_length_delimited(out, metric_field::TEMPLATE_VALUE, v.data.data(),
+                                        v.data.size());
+        }
+      },
+      value);
+}
+
+} // namespace
+
+size_t metric_body_size(const Metric& metric) noexcept {
+  size_t size = 0;
+  if (!metric.name.empty()) {
+    size += field_size(metric_field::NAME, WireType::LengthDelimited) +
+            varint_size(metric.name.size()) + metric.name.size();
+  }
+  if (metric.alias) {
+    size +=
+        field_size(metric_field::ALIAS, WireType::Varint) + varint_size(*metric.alias);
+  }
+  if (metric.timestamp) {
+    size += field_size(metric_field::TIMESTAMP, WireType::Varint) +
+            varint_size(*metric.timestamp);
+  }
+  if (metric.datatype) {
+    size += field_size(metric_field::DATATYPE, WireType::Varint) +
+            varint_size(std::to_underlying(*metric.datatype));
+  }
+  if (metric.is_historical) {
+    size += field_size(metric_field::IS_HISTORICAL, WireType::Varint) + 1;
+  }
+  if (metric.is_transient) {
+    size += field_size(metric_field::IS_TRANSIENT, WireType::Varint) + 1;
+  }
+  if (metric.is_null) {
+    size += field_size(metric_field::IS_NULL, WireType::Varint) + 1;
+  }
+  return size + value_size(metric.value);
+}
+
+uint8_t* write_metric_body(uint8_t* out, const Metric& metric) noexcept {
+  if (!metric.name.empty()) {
+    out = write_length_delimited(out, metric_field::NAME, metric.name.data(),
+                                 metric.name.size());
+  }
+  if (metric.alias) {
+    out = write_varint(write_tag(out, metric_field::ALIAS, WireType::Varint),
+                       *metric.alias);
+  }
+  if (metric.timestamp) {
+    out = write_varint(write_tag(out, metric_field::TIMESTAMP, WireType::Varint),
+                       *metric.timestamp);
+  }
+  if (metric.datatype) {
+    out = write_varint(write_tag(out, metric_field::DATATYPE, WireType::Varint),
+                       std::to_underlying(*metric.datatype));
+  }
+  if (metric.is_historical) {
+    out = write_tag(out, metric_field::IS_HISTORICAL, WireType::Varint);
+    *out++ = *metric.is_historical ? 1 : 0;
+  }
+  if (metric.is_transient) {
+    out = write_tag(out, metric_field::IS_TRANSIENT, WireType::Varint);
+    *out++ = *metric.is_transient ? 1 : 0;
+  }
+  if (metric.is_null) {
+    out = write_tag(out, metric_field::IS_NULL, WireType::Varint);
+    *out++ = *metric.is_null ? 1 : 0;
+  }
+  return write_value(out, metric.value);
+}
+
+Encoder& Encoder::set_timestamp(uint64_t timestamp) noexcept {
+  timestamp_ = timestamp;
+  return *this;
+}
+
+Encoder& Encoder::set_seq(uint64_t seq) noexcept {
+  seq_ = seq;
+  return *this;
+}
+
+Encoder& Encoder::add_metric(const Metric& metric) {
+  size_t body_size = metric_body_size(metric);
+  metrics_.push_back(metric);
+  body_sizes_.push_back(body_size);
+  metrics_size_ += metric_field_size(body_size);
+  return *this;
+}
+
+void Encoder::clear() noexcept {
+  timestamp_.reset();
+  seq_.reset();
+  metrics_.clear();
+  body_sizes_.clear();
+  metrics_size_ = 0;
+}
+
+size_t Encoder::encoded_size() const noexcept {
+  size_t size = metrics_size_;
+  if (timestamp_) {
+    size += field_size(payload_field::TIMESTAMP, WireType::Varint) +
+            varint_size(*timestamp_);
+  }
+  if (seq_) {
+    size += field_size(payload_field::SEQ, WireType::Varint) + varint_size(*seq_);
+  }
+  return size;
+}
+
+uint8_t* Encoder::write(uint8_t* out) const noexcept {
+  if (timestamp_) {
+    out = write_varint(write_tag(out, payload_field::TIMESTAMP, WireType::Varint),
+                       *timestamp_);
+  }
+  for (size_t i = 0; i < metrics_.size(); i++) {
+    out = write_tag(out, payload_field::METRICS, WireType::LengthDelimited);
+    out = write_varint(out, body_sizes_[i]);
+    out = write_metric_body(out, metrics_[i]);
+  }
+  if (seq_) {
+    out = write_varint(write_tag(out, payload_field::SEQ, WireType::Varint), *seq_);
+  }
+  return out;
+}
+
+void Encoder::encode_into(std::vector<uint8_t>& buffer) const {
+  buffer.resize(encoded_size());
+  write(buffer.data());
+}
+
+stdx::expected<size_t, std::string>
+Encoder::encode_into(std::span<uint8_t> buffer) const {
+  size_t size = encoded_size();
+  if (size > buffer.size()) {
+    return stdx::unexpected(std::format(
+        "Buffer too small for payload: need {} bytes, have {}", size, buffer.size()));
+  }
+  write(buffer.data());
+  return size;
+}
+
+} // namespace sparkplug::wire
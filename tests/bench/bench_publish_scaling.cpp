@@ -0,0 +1,107 @@
+// tests/bench/bench_publish_scaling.cpp
+// DDATA throughput from 1 to 8 device threads on one EdgeNode, with payloads encoded
+// outside the node's lock (current) versus under one shared lock (the previous
+// publish path); needs a broker on localhost:1883
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sparkplug/edge_node.hpp>
+
+namespace {
+
+constexpr int MAX_DEVICES = 8;
+constexpr int MESSAGES_PER_DEVICE = 2000;
+constexpr uint64_t METRICS_PER_PAYLOAD = 200;
+
+void fill_payload(sparkplug::PayloadBuilder& payload, int round) {
+  payload.reset();
+  payload.set_timestamp(1700000000000 + round);
+  for (uint64_t alias = 1; alias <= METRICS_PER_PAYLOAD; alias++) {
+    payload.add_metric_by_alias(alias, static_cast<double>(alias) * round);
+  }
+}
+
+// Returns DDATA per second across all threads
+double run(sparkplug::EdgeNode& node, int devices, std::mutex* encode_lock) {
+  std::atomic<int> failures{0};
+  std::vector<std::thread> publishers;
+  auto start = std::chrono::steady_clock::now();
+
+  for (int d = 0; d < devices; d++) {
+    publishers.emplace_back([&, d] {
+      const auto device_id = std::format("Device{}", d);
+      sparkplug::PayloadBuilder payload;
+      for (int i = 0; i < MESSAGES_PER_DEVICE; i++) {
+        fill_payload(payload, i);
+        std::unique_lock<std::mutex> lock;
+        if (encode_lock) {
+          lock = std::unique_lock(*encode_lock);
+        }
+        if (!node.publish_device_data(device_id, payload)) {
+          failures++;
+        }
+      }
+    });
+  }
+  for (auto& publisher : publishers) {
+    publisher.join();
+  }
+
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+  assert(failures == 0);
+  return devices * MESSAGES_PER_DEVICE / elapsed.count();
+}
+
+} // namespace
+
+int main() {
+  std::cout << "=== Publish Scaling Benchmark ===\n\n";
+
+  sparkplug::EdgeNode node({.broker_url = "tcp://localhost:1883",
+                            .client_id = "bench_scaling_node",
+                            .group_id = "ScalingGroup",
+                            .edge_node_id = "ScalingNode"});
+  if (!node.connect()) {
+    std::cerr << "[FAIL] No broker on localhost:1883\n";
+    return 1;
+  }
+
+  sparkplug::PayloadBuilder birth;
+  birth.add_metric_with_alias("Value", 1, 0.0);
+  assert(node.publish_birth(birth));
+  for (int d = 0; d < MAX_DEVICES; d++) {
+    sparkplug::PayloadBuilder device_birth;
+    for (uint64_t alias = 1; alias <= METRICS_PER_PAYLOAD; alias++) {
+      device_birth.add_metric_with_alias(std::format("Metric{}", alias), alias, 0.0);
+    }
+    assert(node.publish_device_birth(std::format("Device{}", d), device_birth));
+  }
+
+  std::cout << std::format("{} metrics per DDATA, {} DDATA per thread\n",
+                           METRICS_PER_PAYLOAD, MESSAGES_PER_DEVICE);
+  std::cout << "threads  encode under lock   encode outside lock\n";
+  double single = 0;
+  for (int devices = 1; devices <= MAX_DEVICES; devices *= 2) {
+    std::mutex encode_lock;
+    double locked = run(node, devices, &encode_lock);
+    double unlocked = run(node, devices, nullptr);
+    if (devices == 1) {
+      single = unlocked;
+    }
+    std::cout << std::format("{:7}  {:10.0f} msg/s    {:10.0f} msg/s ({:.1f}x)\n",
+                             devices, locked, unlocked, unlocked / single);
+  }
+
+  (void)node.disconnect();
+
+  std::cout << "\n=== Publish scaling benchmark complete ===\n";
+  return 0;
+}
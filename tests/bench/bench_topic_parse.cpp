@@ -0,0 +1,80 @@
+// tests/bench/bench_topic_parse.cpp
+// ns/topic for TopicView::parse, Topic::parse and the previous std::views::split parser
+// across representative topic shapes
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <format>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sparkplug/topic.hpp>
+
+#include "../topic_parse_reference.hpp"
+
+namespace {
+
+using topic_parse_reference::reference_parse;
+
+template <typename Parse>
+double measure_ns_per_topic(const std::vector<std::string>& topics, Parse&& parse) {
+  constexpr size_t iterations = 200000;
+  size_t checksum = 0;
+
+  const auto begin = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) {
+    auto result = parse(topics[i % topics.size()]);
+    checksum += result ? result->edge_node_id.size() : 1;
+  }
+  const std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - begin;
+
+  assert(checksum > 0);
+  return elapsed.count() / iterations;
+}
+
+} // namespace
+
+void benchmark_parse() {
+  struct Shape {
+    const char* name;
+    std::vector<std::string> topics;
+  };
+  const std::vector<Shape> shapes = {
+      {"NDATA", {"spBv1.0/Energy/NDATA/Gateway01", "spBv1.0/Plant2/NDATA/Line07-PLC"}},
+      {"DDATA",
+       {"spBv1.0/Energy/DDATA/Gateway01/Sensor01",
+        "spBv1.0/Plant2/DDATA/Line07-PLC/Conveyor-Drive-03"}},
+      {"mixed types",
+       {"spBv1.0/Energy/NBIRTH/Gateway01", "spBv1.0/Energy/DBIRTH/Gateway01/Sensor01",
+        "spBv1.0/Energy/NDATA/Gateway01", "spBv1.0/Energy/DDATA/Gateway01/Sensor01",
+        "spBv1.0/Energy/DDEATH/Gateway01/Sensor01", "spBv1.0/Energy/NDEATH/Gateway01",
+        "spBv1.0/Energy/NCMD/Gateway01", "spBv1.0/Energy/DCMD/Gateway01/Sensor01"}},
+      {"long IDs",
+       {std::format("spBv1.0/{}/DDATA/{}/{}", std::string(48, 'g'), std::string(64, 'n'),
+                    std::string(64, 'd'))}},
+      {"STATE", {"spBv1.0/STATE/scada_primary_host"}},
+      {"malformed", {"spBv1.0/Energy/NFOO/Gateway01", "spBv2.0/Energy/NDATA/Gateway01"}},
+  };
+
+  std::cout << "\nTopic parse cost (ns/topic):\n";
+  std::cout << std::format("{:>12} {:>12} {:>12} {:>8} {:>14}\n", "shape", "reference",
+                           "TopicView", "speedup", "Topic::parse");
+  for (const auto& shape : shapes) {
+    const double before = measure_ns_per_topic(shape.topics, reference_parse);
+    const double after = measure_ns_per_topic(shape.topics, sparkplug::TopicView::parse);
+    const double owned = measure_ns_per_topic(shape.topics, sparkplug::Topic::parse);
+    std::cout << std::format("{:>12} {:>12.1f} {:>12.1f} {:>7.1f}x {:>14.1f}\n",
+                             shape.name, before, after, before / after, owned);
+  }
+}
+
+int main() {
+  std::cout << "=== Topic Parse Benchmark ===\n";
+
+  benchmark_parse();
+
+  std::cout << "\n=== Topic parse benchmark complete ===\n";
+  return 0;
+}
@@ -0,0 +1,156 @@
+// tests/test_alias_table.cpp
+// Unit tests for AliasTable and StringPool, with a memory comparison against the
+// previous std::unordered_map<uint64_t, std::string> alias maps
+#include <cassert>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <sparkplug/alias_table.hpp>
+
+namespace {
+
+// Heap bytes of an unordered_map<uint64_t, std::string> with libstdc++'s node layout:
+// next pointer + cached-hash-free pair per node, bucket array, out-of-SSO strings
+size_t map_memory_bytes(const std::unordered_map<uint64_t, std::string>& map) {
+  size_t bytes = map.bucket_count() * sizeof(void*);
+  for (const auto& [alias, name] : map) {
+    bytes += sizeof(void*) + sizeof(std::pair<const uint64_t, std::string>);
+    if (name.capacity() > 15) {
+      bytes += name.capacity() + 1;
+    }
+  }
+  return bytes;
+}
+
+std::string metric_name(size_t index) {
+  return std::format("Plant/Line{}/Motor{}/Temperature", index % 8, index);
+}
+
+} // namespace
+
+void test_dense_and_sparse() {
+  sparkplug::StringPool pool;
+  sparkplug::AliasTable table;
+  table.reset(4);
+
+  table.insert(0, pool.intern("bdSeq"));
+  table.insert(3, pool.intern("Temperature"));
+  table.insert(1'000'000, pool.intern("Far Away"));
+  assert(table.size() == 3);
+  assert(table.find(0) == "bdSeq");
+  assert(table.find(3) == "Temperature");
+  assert(table.find(1'000'000) == "Far Away");
+  assert(!table.find(1).has_value());
+  assert(!table.find(2'000'000).has_value());
+
+  // Replacing keeps the count
+  table.insert(3, pool.intern("Pressure"));
+  assert(table.size() == 3 && table.find(3) == "Pressure");
+
+  size_t visited = 0;
+  table.for_each([&](uint64_t alias, std::string_view name) {
+    assert(table.find(alias) == name);
+    visited++;
+  });
+  assert(visited == 3);
+
+  table.reset();
+  assert(table.empty() && !table.find(0).has_value());
+
+  std::cout << "[OK] Dense aliases index a vector, far aliases use the fallback map\n";
+}
+
+void test_string_pool() {
+  sparkplug::StringPool pool;
+  auto first = pool.intern("Temperature");
+  std::string copy = "Temperature";
+  auto second = pool.intern(copy);
+  assert(first.data() == second.data());
+  assert(pool.size() == 1);
+
+  // Views stay valid while the pool grows across blocks
+  std::vector<std::string_view> names;
+  for (size_t i = 0; i < 20'000; i++) {
+    names.push_back(pool.intern(metric_name(i)));
+  }
+  std::string large(100'000, 'x');
+  auto large_view = pool.intern(large);
+  for (size_t i = 0; i < names.size(); i++) {
+    assert(names[i] == metric_name(i));
+  }
+  assert(large_view == large);
+  assert(pool.intern(metric_name(7)).data() == names[7].data());
+  assert(pool.size() == 20'002);
+
+  std::cout << "[OK] StringPool deduplicates and keeps addresses stable\n";
+}
+
+void test_rebirth_reuses_capacity() {
+  sparkplug::StringPool pool;
+  sparkplug::AliasTable table;
+  constexpr size_t metrics = 1000;
+
+  for (int rebirth = 0; rebirth < 3; rebirth++) {
+    table.reset(metrics);
+    for (size_t alias = 0; alias < metrics; alias++) {
+      table.insert(alias, pool.intern(metric_name(alias)));
+    }
+    assert(table.size() == metrics);
+  }
+  auto memory = table.memory_bytes();
+  table.reset(metrics);
+  for (size_t alias = 0; alias < metrics; alias++) {
+    table.insert(alias, pool.intern(metric_name(alias)));
+  }
+  assert(table.memory_bytes() == memory);
+  assert(pool.size() == metrics);
+
+  std::cout << "[OK] Rebirths rebuild the table in its existing capacity\n";
+}
+
+void test_memory_comparison() {
+  // 100 nodes sharing the same 500-metric schema, aliases 0..499
+  constexpr size_t nodes = 100;
+  constexpr size_t metrics = 500;
+
+  sparkplug::StringPool pool;
+  std::vector<sparkplug::AliasTable> tables(nodes);
+  std::vector<std::unordered_map<uint64_t, std::string>> maps(nodes);
+  for (size_t node = 0; node < nodes; node++) {
+    tables[node].reset(metrics);
+    for (size_t alias = 0; alias < metrics; alias++) {
+      auto name = metric_name(alias);
+      tables[node].insert(alias, pool.intern(name));
+      maps[node][alias] = name;
+    }
+  }
+
+  size_t table_bytes = pool.memory_bytes();
+  size_t map_bytes = 0;
+  for (size_t node = 0; node < nodes; node++) {
+    table_bytes += tables[node].memory_bytes();
+    map_bytes += map_memory_bytes(maps[node]);
+  }
+  assert(table_bytes * 3 < map_bytes);
+
+  std::cout << std::format("[OK] Memory per node ({} metrics): AliasTable {} B "
+                           "(incl. shared pool), unordered_map {} B\n",
+                           metrics, table_bytes / nodes, map_bytes / nodes);
+}
+
+int main() {
+  std::cout << "=== AliasTable Tests ===\n\n";
+
+  test_dense_and_sparse();
+  test_string_pool();
+  test_rebirth_reuses_capacity();
+  test_memory_comparison();
+
+  std::cout << "\n=== All AliasTable tests passed! ===\n";
+  return 0;
+}
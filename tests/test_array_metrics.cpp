@@ -0,0 +1,219 @@
+// tests/test_array_metrics.cpp
+// Unit tests for Sparkplug 3.0 packed array datatypes (encode and zero-copy decode)
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <sparkplug/array_view.hpp>
+#include <sparkplug/payload_builder.hpp>
+
+namespace {
+
+std::vector<uint8_t>
+bytes_of(const org::eclipse::tahu::protobuf::Payload::Metric& metric) {
+  const auto& bytes = metric.bytes_value();
+  return {bytes.begin(), bytes.end()};
+}
+
+template <typename T>
+void check_round_trip(const std::vector<T>& values, sparkplug::DataType datatype) {
+  sparkplug::PayloadBuilder payload;
+  payload.add_metric("array", values);
+
+  const auto& metric = payload.payload().metrics(0);
+  assert(metric.datatype() == std::to_underlying(datatype));
+  assert(metric.bytes_value().size() == values.size() * sizeof(T));
+
+  auto view = sparkplug::get_array<T>(metric);
+  assert(view.has_value());
+  assert(view->size() == values.size());
+  for (size_t i = 0; i < values.size(); i++) {
+    assert((*view)[i] == values[i]);
+  }
+  assert(view->to_vector() == values);
+}
+
+} // namespace
+
+void test_datatype_values() {
+  assert(std::to_underlying(sparkplug::DataType::Int8Array) == 22);
+  assert(std::to_underlying(sparkplug::DataType::DoubleArray) == 31);
+  assert(std::to_underlying(sparkplug::DataType::DateTimeArray) == 34);
+
+  std::cout << "[OK] Array datatype values match sparkplug_b.proto\n";
+}
+
+void test_numeric_round_trips() {
+  check_round_trip<int8_t>({-128, 0, 127}, sparkplug::DataType::Int8Array);
+  check_round_trip<int16_t>({-32768, 1, 32767}, sparkplug::DataType::Int16Array);
+  check_round_trip<int32_t>({std::numeric_limits<int32_t>::min(), 0, 42},
+                            sparkplug::DataType::Int32Array);
+  check_round_trip<int64_t>({std::numeric_limits<int64_t>::min(), -1, 1},
+                            sparkplug::DataType::Int64Array);
+  check_round_trip<uint8_t>({0, 255}, sparkplug::DataType::UInt8Array);
+  check_round_trip<uint16_t>({0, 65535}, sparkplug::DataType::UInt16Array);
+  check_round_trip<uint32_t>({0, 4294967295U}, sparkplug::DataType::UInt32Array);
+  check_round_trip<uint64_t>({0, std::numeric_limits<uint64_t>::max()},
+                             sparkplug::DataType::UInt64Array);
+  check_round_trip<float>({1.5f, -0.0f, 3.25f}, sparkplug::DataType::FloatArray);
+  check_round_trip<double>({2.718281828459045, -1e300}, sparkplug::DataType::DoubleArray);
+  check_round_trip<int32_t>({}, sparkplug::DataType::Int32Array);
+
+  std::cout << "[OK] Numeric arrays round-trip\n";
+}
+
+void test_little_endian_layout() {
+  // Layouts as in the Sparkplug 3.0 specification examples
+  sparkplug::PayloadBuilder payload;
+  payload.add_metric("int16", std::array<int16_t, 2>{-23, 123});
+  payload.add_metric("uint32", std::array<uint32_t, 2>{52, 3293});
+  payload.add_metric("float", std::array<float, 2>{1.23f, 89.341f});
+
+  const auto& pb = payload.payload();
+  assert(bytes_of(pb.metrics(0)) == (std::vector<uint8_t>{0xE9, 0xFF, 0x7B, 0x00}));
+  assert(bytes_of(pb.metrics(1)) ==
+         (std::vector<uint8_t>{0x34, 0x00, 0x00, 0x00, 0xDD, 0x0C, 0x00, 0x00}));
+  assert(bytes_of(pb.metrics(2)) ==
+         (std::vector<uint8_t>{0xA4, 0x70, 0x9D, 0x3F, 0x98, 0xAE, 0xB2, 0x42}));
+
+  std::cout << "[OK] Packed little-endian layout matches the specification\n";
+}
+
+void test_boolean_array() {
+  // Specification example: 12 values -> count 0x0C, bits 0x34 0xD0 (MSB first)
+  std::array<bool, 12> values{false, false, true, true, false, true,
+                              false, false, true, true, false, true};
+  sparkplug::PayloadBuilder payload;
+  payload.add_metric_with_alias("flags", 7, values);
+
+  const auto& metric = payload.payload().metrics(0);
+  assert(metric.datatype() == std::to_underlying(sparkplug::DataType::BooleanArray));
+  assert(bytes_of(metric) ==
+         (std::vector<uint8_t>{0x0C, 0x00, 0x00, 0x00, 0x34, 0xD0}));
+
+  auto view = sparkplug::get_array<bool>(metric);
+  assert(view.has_value());
+  assert(view->size() == values.size());
+  size_t i = 0;
+  for (bool value : *view) {
+    assert(value == values[i++]);
+  }
+
+  std::array<bool, 16> many{};
+  for (size_t j = 0; j < many.size(); j++) {
+    many[j] = j % 3 == 0;
+  }
+  sparkplug::PayloadBuilder whole_bytes;
+  whole_bytes.add_metric("many", many);
+  auto many_view = sparkplug::get_array<bool>(whole_bytes.payload().metrics(0));
+  assert(many_view.has_value());
+  std::array<bool, 16> decoded{};
+  assert(many_view->copy_to(decoded) == 16);
+  assert(decoded == many);
+
+  std::cout << "[OK] BooleanArray packs bits MSB first with a 4-byte count\n";
+}
+
+void test_string_array() {
+  std::vector<std::string> values{"ABC", "hello", ""};
+  sparkplug::PayloadBuilder payload;
+  payload.add_metric_by_alias(3, values);
+
+  const auto& metric = payload.payload().metrics(0);
+  assert(metric.datatype() == std::to_underlying(sparkplug::DataType::StringArray));
+  assert(metric.bytes_value() == std::string("ABC\0hello\0\0", 11));
+
+  auto view = sparkplug::get_array<std::string_view>(metric);
+  assert(view.has_value());
+  assert(view->size() == 3);
+  size_t i = 0;
+  for (std::string_view value : *view) {
+    assert(value == values[i++]);
+  }
+  assert(i == 3);
+
+  std::cout << "[OK] StringArray uses null-terminated strings\n";
+}
+
+void test_datetime_array() {
+  std::vector<sparkplug::DateTime> values{
+      sparkplug::DateTime(std::chrono::milliseconds(1700000000000LL)),
+      sparkplug::DateTime(std::chrono::milliseconds(0))};
+  check_round_trip(values, sparkplug::DataType::DateTimeArray);
+
+  std::cout << "[OK] DateTimeArray round-trips as int64 milliseconds\n";
+}
+
+void test_span_and_timestamps() {
+  std::array<double, 4> waveform{0.0, 0.5, 1.0, 0.5};
+  sparkplug::PayloadBuilder payload;
+  payload.add_metric("span", std::span<const double>(waveform), 1234);
+  payload.add_metric_by_alias(9, waveform, 5678);
+
+  const auto& pb = payload.payload();
+  assert(pb.metrics(0).timestamp() == 1234);
+  assert(pb.metrics(1).alias() == 9);
+  assert(pb.metrics(1).timestamp() == 5678);
+  assert(pb.metrics(0).bytes_value() == pb.metrics(1).bytes_value());
+
+  // Array payloads go through the wire encoder unchanged
+  sparkplug::wire::Encoder encoder;
+  encoder.set_timestamp(pb.timestamp());
+  for (const auto& pb_metric : pb.metrics()) {
+    sparkplug::wire::Metric metric;
+    [[maybe_unused]] bool ok = sparkplug::detail::to_wire_metric(pb_metric, metric);
+    assert(ok);
+    encoder.add_metric(metric);
+  }
+  std::vector<uint8_t> wire_bytes;
+  encoder.encode_into(wire_bytes);
+  std::vector<uint8_t> pb_bytes(pb.ByteSizeLong());
+  pb.SerializeToArray(pb_bytes.data(), static_cast<int>(pb_bytes.size()));
+  assert(wire_bytes == pb_bytes);
+
+  std::cout << "[OK] Spans, custom timestamps and wire encoding\n";
+}
+
+void test_decode_errors() {
+  sparkplug::PayloadBuilder payload;
+  payload.add_metric("doubles", std::array<double, 2>{1.0, 2.0});
+  payload.add_metric("scalar", 1.0);
+
+  const auto& pb = payload.payload();
+  assert(!sparkplug::get_array<float>(pb.metrics(0)).has_value());  // Wrong type
+  assert(!sparkplug::get_array<double>(pb.metrics(1)).has_value()); // Not an array
+
+  std::vector<uint8_t> truncated{0x01, 0x02, 0x03};
+  assert(!sparkplug::get_array<uint16_t>(sparkplug::DataType::UInt16Array, truncated)
+              .has_value());
+  std::vector<uint8_t> short_bools{0x09, 0x00, 0x00, 0x00, 0xFF};
+  assert(!sparkplug::get_array<bool>(sparkplug::DataType::BooleanArray, short_bools)
+              .has_value());
+  std::vector<uint8_t> unterminated{'a', 'b'};
+  assert(!sparkplug::get_array<std::string_view>(sparkplug::DataType::StringArray,
+                                                 unterminated)
+              .has_value());
+
+  std::cout << "[OK] Malformed arrays are rejected\n";
+}
+
+int main() {
+  std::cout << "=== Array Metric Tests ===\n\n";
+
+  test_datatype_values();
+  test_numeric_round_trips();
+  test_little_endian_layout();
+  test_boolean_array();
+  test_string_array();
+  test_datetime_array();
+  test_span_and_timestamps();
+  test_decode_errors();
+
+  std::cout << "\n=== All array metric tests passed! ===\n";
+  return 0;
+}
@@ -205,10 +205,13 @@ void test_nbirth_has_bdseq() {
   // Wait for message
   std::this_thread::sleep_for(std::chrono::milliseconds(500));
 
-  bool passed = got_nbirth && found_bdseq;
+  // bdSeq is added to the published copy, not to the caller's builder
+  bool unchanged = birth.payload().metrics_size() == 1;
+  bool passed = got_nbirth && found_bdseq && unchanged;
   report_test("NBIRTH contains bdSeq", passed,
               !got_nbirth    ? "No NBIRTH received"
               : !found_bdseq ? "bdSeq metric not found"
+              : !unchanged   ? "Caller's payload was modified"
                              : "");
 
   (void)pub.disconnect();
@@ -793,6 +796,78 @@ void test_command_callback() {
   (void)sub.disconnect();
 }
 
+// Test 15: Host node snapshots are immutable and share unchanged device lists
+void test_node_snapshots() {
+  sparkplug::HostApplication::Config sub_config{.broker_url = "tcp://localhost:1883",
+                                                .client_id = "test_snapshot_sub",
+                                                .host_id = "TestGroup"};
+
+  sparkplug::HostApplication sub(std::move(sub_config));
+  if (!sub.connect() || !sub.subscribe_all_groups()) {
+    report_test("Node snapshots", false, "Subscriber setup failed");
+    return;
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+  sparkplug::EdgeNode::Config config{.broker_url = "tcp://localhost:1883",
+                                     .client_id = "test_snapshot_pub",
+                                     .group_id = "TestGroup",
+                                     .edge_node_id = "TestNode10"};
+
+  sparkplug::EdgeNode pub(std::move(config));
+  if (!pub.connect()) {
+    report_test("Node snapshots", false, "Failed to connect");
+    (void)sub.disconnect();
+    return;
+  }
+
+  sparkplug::PayloadBuilder nbirth;
+  nbirth.add_metric("NodeMetric", 100);
+  sparkplug::PayloadBuilder dbirth;
+  dbirth.add_metric("DeviceMetric", 42);
+  if (!pub.publish_birth(nbirth) || !pub.publish_device_birth("Device01", dbirth)) {
+    report_test("Node snapshots", false, "Birth failed");
+    (void)pub.disconnect();
+    (void)sub.disconnect();
+    return;
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  auto after_births = sub.get_node_snapshot("TestGroup", "TestNode10");
+
+  sparkplug::PayloadBuilder ndata;
+  ndata.add_metric("NodeMetric", 101);
+  (void)pub.publish_data(ndata);
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  auto after_data = sub.get_node_snapshot("TestGroup", "TestNode10");
+
+  (void)pub.publish_device_death("Device01");
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  auto after_death = sub.get_node_snapshot("TestGroup", "TestNode10");
+
+  bool found = after_births && after_data && after_death &&
+               after_births->find_device("Device01") &&
+               after_death->find_device("Device01");
+  // Held snapshots never change; NDATA reuses the device list, DDEATH replaces it
+  bool passed = found && after_births->is_online && after_births->last_seq == 1 &&
+                after_data->last_seq == 2 &&
+                after_data->version > after_births->version &&
+                after_data->devices == after_births->devices &&
+                !after_births->find_device("Device01")->metrics_stale &&
+                after_death->find_device("Device01")->metrics_stale &&
+                !sub.get_node_snapshot("TestGroup", "UnknownNode");
+
+  report_test("Node snapshots", passed,
+              !found ? "Snapshot missing"
+                     : std::format("seq {} -> {}, versions {} -> {}",
+                                   after_births->last_seq, after_data->last_seq,
+                                   after_births->version, after_data->version));
+
+  (void)pub.disconnect();
+  (void)sub.disconnect();
+}
+
 int main() {
   std::cout << "=== Sparkplug 2.2 Compliance Tests ===\n\n";
 
@@ -816,6 +891,9 @@ int main() {
   test_dcmd_publishing();
   test_command_callback();
 
+  // Host state tests
+  test_node_snapshots();
+
   // Summary
   int passed = 0;
   int failed = 0;
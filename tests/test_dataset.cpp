@@ -0,0 +1,230 @@
+// tests/test_dataset.cpp
+// Unit tests for the columnar DataSetBuilder and DataSetView
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sparkplug/dataset.hpp>
+#include <sparkplug/payload_builder.hpp>
+#include <sparkplug/wire.hpp>
+
+namespace {
+
+std::vector<uint8_t> serialize(const google::protobuf::MessageLite& message) {
+  std::vector<uint8_t> buffer(message.ByteSizeLong());
+  [[maybe_unused]] bool ok =
+      message.SerializeToArray(buffer.data(), static_cast<int>(buffer.size()));
+  assert(ok);
+  return buffer;
+}
+
+// Builds the payload and parses it back, as a receiver would see it
+org::eclipse::tahu::protobuf::Payload
+parse_built(const sparkplug::PayloadBuilder& builder) {
+  auto bytes = builder.build();
+  org::eclipse::tahu::protobuf::Payload payload;
+  [[maybe_unused]] bool ok =
+      payload.ParseFromArray(bytes.data(), static_cast<int>(bytes.size()));
+  assert(ok);
+  return payload;
+}
+
+// Sample batch table shared by the tests
+struct Batch {
+  std::vector<int64_t> ids{1001, 1002, -3};
+  std::vector<double> weights{12.5, 13.25, 0.0};
+  std::vector<float> temps{20.5f, -1.0f, 99.0f};
+  std::vector<std::string> operators{"alice", "", "bob"};
+  std::array<bool, 3> passed{true, false, true};
+  std::vector<uint16_t> lines{1, 65535, 7};
+  std::vector<sparkplug::DateTime> started{
+      sparkplug::DateTime(std::chrono::milliseconds(1700000000000LL)),
+      sparkplug::DateTime(std::chrono::milliseconds(0)),
+      sparkplug::DateTime(std::chrono::milliseconds(1700000001000LL))};
+
+  void add_to(sparkplug::DataSetBuilder& table) const {
+    assert(table.add_column("BatchId", ids).has_value());
+    assert(table.add_column("Weight", weights).has_value());
+    assert(table.add_column("Temp", std::span<const float>(temps)).has_value());
+    assert(table.add_column("Operator", operators).has_value());
+    assert(table.add_column("Passed", passed).has_value());
+    assert(table.add_column("Line", lines).has_value());
+    assert(table.add_column("Started", started).has_value());
+  }
+
+  void check(const sparkplug::DataSetView& view) const {
+    assert(view.num_columns() == 7);
+    assert(view.num_rows() == 3);
+    assert(view.column_name(1) == "Weight");
+    assert(view.column_type(3) == sparkplug::DataType::String);
+    assert(view.column_index("Line") == 5);
+
+    auto view_ids = view.column<int64_t>("BatchId");
+    assert(view_ids.has_value());
+    assert(std::vector<int64_t>(view_ids->begin(), view_ids->end()) == ids);
+    auto view_weights = view.column<double>(1);
+    assert(view_weights.has_value() && (*view_weights)[1] == 13.25);
+    auto view_temps = view.column<float>("Temp");
+    assert(view_temps.has_value() && (*view_temps)[1] == -1.0f);
+    auto view_operators = view.column<std::string_view>("Operator");
+    assert(view_operators.has_value());
+    for (size_t i = 0; i < operators.size(); i++) {
+      assert((*view_operators)[i] == operators[i]);
+    }
+    auto view_passed = view.column<bool>("Passed");
+    assert(view_passed.has_value());
+    for (size_t i = 0; i < passed.size(); i++) {
+      assert((*view_passed)[i] == passed[i]);
+    }
+    auto view_lines = view.column<uint16_t>("Line");
+    assert(view_lines.has_value() && (*view_lines)[1] == 65535);
+    auto view_started = view.column<sparkplug::DateTime>("Started");
+    assert(view_started.has_value() && (*view_started)[0] == started[0]);
+  }
+};
+
+} // namespace
+
+void test_encode_matches_protobuf() {
+  Batch batch;
+  sparkplug::DataSetBuilder table;
+  batch.add_to(table);
+  assert(table.num_columns() == 7);
+  assert(table.num_rows() == 3);
+
+  sparkplug::PayloadBuilder payload;
+  payload.add_dataset_with_alias("Batches", 20, table);
+  assert(!payload.payload().metrics(0).has_dataset_value()); // Stored pre-encoded
+  auto received = parse_built(payload);
+  const auto& metric = received.metrics(0);
+  assert(metric.name() == "Batches");
+  assert(metric.alias() == 20);
+  assert(metric.datatype() == std::to_underlying(sparkplug::DataType::DataSet));
+  assert(metric.dataset_value().rows_size() == 3);
+
+  std::vector<uint8_t> encoded;
+  table.encode_into(encoded);
+  assert(encoded.size() == table.encoded_size());
+  assert(encoded == serialize(metric.dataset_value()));
+
+  org::eclipse::tahu::protobuf::Payload::DataSet filled;
+  table.fill(filled);
+  assert(encoded == serialize(filled));
+
+  std::vector<uint8_t> fixed(encoded.size());
+  auto written = table.encode_into(std::span<uint8_t>(fixed));
+  assert(written.has_value() && *written == encoded.size());
+  assert(fixed == encoded);
+
+  std::vector<uint8_t> small(encoded.size() - 1);
+  assert(!table.encode_into(std::span<uint8_t>(small)).has_value());
+
+  std::cout << "[OK] encode_into() matches the protobuf DataSet byte for byte\n";
+}
+
+void test_view_round_trip() {
+  Batch batch;
+  sparkplug::DataSetBuilder table;
+  batch.add_to(table);
+
+  std::vector<uint8_t> encoded;
+  table.encode_into(encoded);
+  auto parsed = sparkplug::DataSetView::parse(encoded);
+  assert(parsed.has_value());
+  batch.check(*parsed);
+
+  sparkplug::PayloadBuilder payload;
+  payload.add_dataset("Batches", table);
+  auto received = parse_built(payload);
+  auto transposed = sparkplug::DataSetView::from(received.metrics(0).dataset_value());
+  assert(transposed.has_value());
+  batch.check(*transposed);
+
+  std::cout << "[OK] DataSetView decodes bytes and protobuf into typed columns\n";
+}
+
+void test_wire_encoder_embedding() {
+  Batch batch;
+  sparkplug::DataSetBuilder table;
+  batch.add_to(table);
+
+  sparkplug::PayloadBuilder payload;
+  payload.set_timestamp(1700000000000);
+  payload.add_dataset_by_alias(20, table);
+  payload.set_seq(4);
+  const auto& pb_metric = payload.payload().metrics(0);
+
+  std::vector<uint8_t> dataset_bytes;
+  table.encode_into(dataset_bytes);
+
+  sparkplug::wire::Encoder encoder;
+  encoder.set_timestamp(1700000000000);
+  encoder.add_metric({.alias = 20,
+                      .timestamp = pb_metric.timestamp(),
+                      .datatype = sparkplug::DataType::DataSet,
+                      .value = sparkplug::wire::DataSetBytes{dataset_bytes}});
+  encoder.set_seq(4);
+
+  std::vector<uint8_t> wire_bytes;
+  encoder.encode_into(wire_bytes);
+  assert(wire_bytes == serialize(payload.payload()));
+
+  std::cout << "[OK] DataSet bytes embed in wire::Encoder payloads\n";
+}
+
+void test_errors() {
+  std::vector<int32_t> three{1, 2, 3};
+  std::vector<double> two{1.0, 2.0};
+  sparkplug::DataSetBuilder table;
+  assert(table.add_column("a", three).has_value());
+  assert(!table.add_column("b", two).has_value());
+  assert(table.num_columns() == 1);
+
+  table.clear();
+  assert(table.num_columns() == 0 && table.num_rows() == 0);
+  assert(table.add_column("b", two).has_value());
+
+  std::vector<uint8_t> encoded;
+  table.encode_into(encoded);
+  auto view = sparkplug::DataSetView::parse(encoded);
+  assert(view.has_value());
+  assert(!view->column<float>("b").has_value()); // Wrong type
+  assert(!view->column<double>("missing").has_value());
+  assert(!view->column<double>(5).has_value());
+
+  // Cell kind does not match the declared column type
+  org::eclipse::tahu::protobuf::Payload::DataSet dataset;
+  dataset.set_num_of_columns(1);
+  dataset.add_columns("x");
+  dataset.add_types(std::to_underlying(sparkplug::DataType::Double));
+  dataset.add_rows()->add_elements()->set_string_value("oops");
+  assert(!sparkplug::DataSetView::from(dataset).has_value());
+  assert(!sparkplug::DataSetView::parse(serialize(dataset)).has_value());
+
+  // Row with a missing cell
+  dataset.mutable_rows(0)->clear_elements();
+  assert(!sparkplug::DataSetView::from(dataset).has_value());
+  assert(!sparkplug::DataSetView::parse(serialize(dataset)).has_value());
+
+  encoded.pop_back();
+  assert(!sparkplug::DataSetView::parse(encoded).has_value());
+
+  std::cout << "[OK] Mismatched and malformed tables are rejected\n";
+}
+
+int main() {
+  std::cout << "=== DataSet Tests ===\n\n";
+
+  test_encode_matches_protobuf();
+  test_view_round_trip();
+  test_wire_encoder_embedding();
+  test_errors();
+
+  std::cout << "\n=== All DataSet tests passed! ===\n";
+  return 0;
+}
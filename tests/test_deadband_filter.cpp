@@ -0,0 +1,198 @@
+// tests/test_deadband_filter.cpp
+// Unit tests for the Report by Exception DeadbandFilter
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include <sparkplug/deadband_filter.hpp>
+#include <sparkplug/payload_builder.hpp>
+
+namespace {
+
+// Collects into a fresh builder and commits, returning the reported aliases' payload
+org::eclipse::tahu::protobuf::Payload collect(sparkplug::DeadbandFilter& filter,
+                                              bool commit = true) {
+  sparkplug::PayloadBuilder payload;
+  filter.collect(payload);
+  if (commit) {
+    filter.commit();
+  }
+  return payload.payload();
+}
+
+} // namespace
+
+void test_absolute_and_percent() {
+  sparkplug::DeadbandFilter filter;
+  assert(filter.add_metric<double>(1, {.absolute = 0.5}).has_value());
+  assert(filter.add_metric<int32_t>(2, {.percent = 10.0}).has_value());
+  assert(filter.size() == 2);
+
+  // Nothing staged yet
+  assert(collect(filter).metrics_size() == 0);
+
+  // First samples are always reported
+  assert(filter.update(1, 20.0).has_value());
+  assert(filter.update(2, int32_t{100}).has_value());
+  auto first = collect(filter);
+  assert(first.metrics_size() == 2);
+  assert(first.metrics(0).alias() == 1 && first.metrics(0).double_value() == 20.0);
+  assert(first.metrics(1).alias() == 2 && first.metrics(1).int_value() == 100);
+  assert(first.metrics(1).datatype() == std::to_underlying(sparkplug::DataType::Int32));
+
+  // Within the deadbands
+  assert(filter.update(1, 20.4).has_value());
+  assert(filter.update(2, int32_t{109}).has_value());
+  assert(collect(filter).metrics_size() == 0);
+
+  // Beyond them (relative to the last sent value, not the last sample)
+  assert(filter.update(1, 20.6).has_value());
+  assert(filter.update(2, int32_t{89}).has_value());
+  auto second = collect(filter);
+  assert(second.metrics_size() == 2);
+  assert(second.metrics(0).double_value() == 20.6);
+  assert(static_cast<int32_t>(second.metrics(1).int_value()) == 89);
+
+  std::cout << "[OK] Absolute and percent deadbands\n";
+}
+
+void test_exact_types() {
+  sparkplug::DeadbandFilter filter;
+  assert(filter.add_metric<bool>(1).has_value());
+  assert(filter.add_metric<std::string>(2).has_value());
+  assert(filter.add_metric<uint64_t>(3).has_value());
+  assert(filter.add_metric<int64_t>(4).has_value());
+
+  constexpr uint64_t big = std::numeric_limits<uint64_t>::max() - 1;
+  assert(filter.update(1, true).has_value());
+  assert(filter.update(2, "idle").has_value());
+  assert(filter.update(3, big).has_value());
+  assert(filter.update(4, int64_t{-5}).has_value());
+  assert(collect(filter).metrics_size() == 4);
+
+  // Unchanged values are suppressed
+  assert(filter.update(1, true).has_value());
+  assert(filter.update(2, std::string("idle")).has_value());
+  assert(filter.update(3, big).has_value());
+  assert(collect(filter).metrics_size() == 0);
+
+  // Changes too small for a double are still seen
+  assert(filter.update(3, big + 1).has_value());
+  assert(filter.update(2, "running").has_value());
+  assert(filter.update(4, int64_t{-6}).has_value());
+  auto changed = collect(filter);
+  assert(changed.metrics_size() == 3);
+  assert(changed.metrics(0).alias() == 3 && changed.metrics(0).long_value() == big + 1);
+  assert(static_cast<int64_t>(changed.metrics(1).long_value()) == -6);
+  assert(changed.metrics(2).string_value() == "running");
+
+  std::cout << "[OK] Booleans, strings and 64-bit integers report any change\n";
+}
+
+void test_integer_extremes() {
+  constexpr uint64_t u64_max = std::numeric_limits<uint64_t>::max();
+  constexpr int64_t i64_min = std::numeric_limits<int64_t>::min();
+  constexpr int64_t i64_max = std::numeric_limits<int64_t>::max();
+  sparkplug::DeadbandFilter filter;
+  assert(filter.add_metric<uint64_t>(1, {.absolute = 10.0}).has_value());
+  assert(filter.add_metric<int64_t>(2, {.absolute = 10.0}).has_value());
+  assert(filter.add_metric<int8_t>(3, {.absolute = 10.0}).has_value());
+
+  assert(filter.update(1, uint64_t{0}).has_value());
+  assert(filter.update(2, i64_min).has_value());
+  assert(filter.update(3, int8_t{-128}).has_value());
+  assert(collect(filter).metrics_size() == 3);
+
+  // The largest possible changes are not mistaken for tiny ones
+  assert(filter.update(1, u64_max).has_value());
+  assert(filter.update(2, i64_max).has_value());
+  assert(filter.update(3, int8_t{127}).has_value());
+  auto up = collect(filter);
+  assert(up.metrics_size() == 3);
+  assert(up.metrics(0).long_value() == u64_max);
+  assert(static_cast<int64_t>(up.metrics(1).long_value()) == i64_max);
+
+  // Small steps at the extremes stay within the deadband
+  assert(filter.update(1, u64_max - 5).has_value());
+  assert(filter.update(2, i64_max - 5).has_value());
+  assert(filter.update(3, int8_t{122}).has_value());
+  assert(collect(filter).metrics_size() == 0);
+
+  // And back down across the whole range
+  assert(filter.update(1, uint64_t{0}).has_value());
+  assert(filter.update(2, i64_min).has_value());
+  assert(filter.update(3, int8_t{-128}).has_value());
+  assert(collect(filter).metrics_size() == 3);
+
+  std::cout << "[OK] Integer changes across the whole range exceed the deadband\n";
+}
+
+void test_max_silence() {
+  uint64_t fake_now = 1000;
+  sparkplug::DeadbandFilter filter(
+      {.clock = sparkplug::Clock::custom([&] { return fake_now; })});
+  assert(filter
+             .add_metric<float>(7, {.absolute = 100.0,
+                                    .max_silence = std::chrono::milliseconds(5000)})
+             .has_value());
+
+  assert(filter.update(7, 1.0f).has_value());
+  assert(collect(filter).metrics_size() == 1);
+
+  fake_now += 4999;
+  assert(collect(filter).metrics_size() == 0);
+
+  fake_now += 1;
+  auto refresh = collect(filter);
+  assert(refresh.metrics_size() == 1);
+  assert(refresh.metrics(0).float_value() == 1.0f);
+
+  fake_now += 10;
+  assert(collect(filter).metrics_size() == 0);
+
+  std::cout << "[OK] max_silence forces a refresh\n";
+}
+
+void test_commit_and_invalidate() {
+  sparkplug::DeadbandFilter filter;
+  assert(filter.add_metric<double>(1).has_value());
+  assert(filter.update(1, 1.0).has_value());
+
+  // Without commit() the metric is reported again (e.g., after a failed publish)
+  assert(collect(filter, false).metrics_size() == 1);
+  assert(collect(filter).metrics_size() == 1);
+  assert(collect(filter).metrics_size() == 0);
+
+  filter.invalidate();
+  assert(collect(filter).metrics_size() == 1);
+
+  std::cout << "[OK] commit() and invalidate()\n";
+}
+
+void test_errors() {
+  sparkplug::DeadbandFilter filter;
+  assert(filter.add_metric<double>(1).has_value());
+  assert(!filter.add_metric<double>(1).has_value());          // Duplicate alias
+  assert(!filter.add_metric<double>(2, {.absolute = -1.0}).has_value());
+  assert(!filter.update(1, 1.0f).has_value());                 // Wrong type
+  assert(!filter.update(99, 1.0).has_value());                 // Unknown alias
+
+  std::cout << "[OK] Invalid registrations and updates are rejected\n";
+}
+
+int main() {
+  std::cout << "=== DeadbandFilter Tests ===\n\n";
+
+  test_absolute_and_percent();
+  test_exact_types();
+  test_integer_extremes();
+  test_max_silence();
+  test_commit_and_invalidate();
+  test_errors();
+
+  std::cout << "\n=== All DeadbandFilter tests passed! ===\n";
+  return 0;
+}
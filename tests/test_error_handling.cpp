@@ -131,12 +131,49 @@ void test_move_semantics() {
   // Move constructor
   sparkplug::EdgeNode pub2(std::move(pub1));
 
-  // pub1 is now in moved-from state
-  // Attempting to use it should fail safely (though behavior is undefined)
+  // The moved-from node keeps a send path of its own and fails its calls
+  assert(pub1.get_seq() == 0);
+  sparkplug::PayloadBuilder payload;
+  payload.add_metric("Temperature", 20.5);
+  assert(!pub1.publish_data(payload).has_value());
+  assert(!pub1.publish_data_async(payload, [](const auto&) {}).has_value());
+  assert(!pub1.connect().has_value());
+  assert(!pub2.publish_data(payload).has_value());
 
   std::cout << "[OK] Move constructor works\n";
 }
 
+void test_host_move_semantics() {
+  sparkplug::HostApplication::Config config{.broker_url = "tcp://localhost:1883",
+                                            .client_id = "test_host_move",
+                                            .host_id = "Test",
+                                            .last_value_cache = true};
+
+  sparkplug::HostApplication host1(std::move(config));
+  sparkplug::HostApplication host2(std::move(host1));
+
+  // The moved-from host still answers queries, with an empty cache
+  assert(host1.last_values().metric_count() == 0);
+  assert(host2.last_values().metric_count() == 0);
+
+  // ... and fails its publishes instead of crashing
+  sparkplug::PayloadBuilder cmd;
+  cmd.add_metric("Node Control/Rebirth", true);
+  assert(!host1.publish_node_command("Group", "Node", cmd).has_value());
+  assert(!host1.publish_node_command_async("Group", "Node", cmd, {}).has_value());
+  assert(
+      !host1.publish_device_command_async("Group", "Node", "Dev", cmd, {}).has_value());
+  assert(!host1.publish_state_birth(0).has_value());
+
+  sparkplug::HostApplication host3({.broker_url = "tcp://localhost:1883",
+                                    .client_id = "test_host_move3",
+                                    .host_id = "Test"});
+  host3 = std::move(host2);
+  assert(!host2.publish_node_command_async("Group", "Node", cmd, {}).has_value());
+
+  std::cout << "[OK] Moved-from host returns an empty cache and fails its publishes\n";
+}
+
 void test_subscriber_invalid_broker() {
   auto callback = [](const sparkplug::Topic&, const auto&) {};
 
@@ -230,6 +267,7 @@ int main() {
   test_disconnect_not_connected();
   test_invalid_topic_parse();
   test_move_semantics();
+  test_host_move_semantics();
   test_subscriber_invalid_broker();
   test_subscriber_subscribe_before_connect();
   test_empty_config_fields();
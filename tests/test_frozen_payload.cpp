@@ -0,0 +1,182 @@
+// tests/test_frozen_payload.cpp
+// Unit tests for FrozenPayload in-place patching
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sparkplug/frozen_payload.hpp>
+#include <sparkplug/payload_builder.hpp>
+
+namespace {
+
+constexpr uint64_t TS = 1700000000000ULL;
+
+std::vector<uint8_t> to_vector(std::span<const uint8_t> bytes) {
+  return {bytes.begin(), bytes.end()};
+}
+
+// Builder with the same shape as the frozen payload in these tests
+sparkplug::PayloadBuilder make_shape(double temperature,
+                                     int32_t counter,
+                                     bool running,
+                                     std::string_view state,
+                                     uint64_t seq,
+                                     uint64_t metric_ts = TS) {
+  sparkplug::PayloadBuilder builder;
+  builder.set_timestamp(TS);
+  builder.add_metric_by_alias(1, temperature, metric_ts);
+  builder.add_metric_by_alias(2, counter, metric_ts);
+  builder.add_metric_by_alias(3, running, metric_ts);
+  builder.add_metric_by_alias(4, state, metric_ts);
+  builder.add_metric_by_alias(5, 1.5f, metric_ts);
+  builder.set_seq(seq);
+  return builder;
+}
+
+} // namespace
+
+void test_freeze_matches_build() {
+  auto builder = make_shape(20.5, 7, true, "RUN", 0);
+  auto frozen = sparkplug::FrozenPayload::freeze(builder);
+  assert(frozen.has_value());
+  assert(frozen->metric_count() == 5);
+  assert(to_vector(frozen->bytes()) == builder.build());
+  assert(frozen->reencode_count() == 0);
+
+  std::cout << "[OK] Frozen bytes match PayloadBuilder::build()\n";
+}
+
+void test_in_place_patching() {
+  auto frozen = sparkplug::FrozenPayload::freeze(make_shape(20.5, 7, true, "RUN", 0));
+  assert(frozen.has_value());
+
+  assert(frozen->set(0, 99.25, TS + 1).has_value());
+  assert(frozen->set(1, int32_t{9}, TS + 1).has_value());
+  assert(frozen->set(2, false, TS + 1).has_value());
+  assert(frozen->set(3, "OFF", TS + 1).has_value());
+  assert(frozen->set(4, -2.5f, TS + 1).has_value());
+  frozen->set_seq(5);
+
+  auto expected = make_shape(99.25, 9, false, "OFF", 5, TS + 1);
+  // Metric 4 is the only float, patch it on the expected side too
+  expected.mutable_payload().mutable_metrics(4)->set_float_value(-2.5f);
+
+  assert(to_vector(frozen->bytes()) == expected.build());
+  assert(frozen->reencode_count() == 0);
+
+  std::cout << "[OK] Same-width updates are patched in place\n";
+}
+
+void test_width_change_reencodes() {
+  auto frozen = sparkplug::FrozenPayload::freeze(make_shape(20.5, 7, true, "RUN", 0));
+  assert(frozen.has_value());
+
+  // 7 -> 100000 grows the varint, "RUN" -> "STOPPED" grows the string
+  assert(frozen->set(1, int32_t{100000}).has_value());
+  assert(frozen->set(3, "STOPPED").has_value());
+  assert(frozen->set(0, 1.0).has_value());
+
+  auto bytes = to_vector(frozen->bytes());
+  assert(frozen->reencode_count() == 1);
+  assert(bytes == make_shape(1.0, 100000, true, "STOPPED", 0).build());
+
+  // Negative int32 values use the 5-byte uint32 representation, as protobuf does
+  assert(frozen->set(1, int32_t{-1}).has_value());
+  assert(to_vector(frozen->bytes()) == make_shape(1.0, -1, true, "STOPPED", 0).build());
+  assert(frozen->reencode_count() == 2);
+
+  // Back on the fast path once the layout is recomputed
+  assert(frozen->set(1, int32_t{-2}).has_value());
+  assert(to_vector(frozen->bytes()) == make_shape(1.0, -2, true, "STOPPED", 0).build());
+  assert(frozen->reencode_count() == 2);
+
+  std::cout << "[OK] Width changes trigger a single re-encode\n";
+}
+
+void test_seq_wraparound() {
+  auto frozen = sparkplug::FrozenPayload::freeze(make_shape(20.5, 7, true, "RUN", 0));
+  assert(frozen.has_value());
+
+  // seq grows from 1 to 2 varint bytes at 128 and shrinks back on wrap
+  for (uint64_t seq : {127ULL, 128ULL, 255ULL, 0ULL}) {
+    frozen->set_seq(seq);
+    assert(to_vector(frozen->bytes()) == make_shape(20.5, 7, true, "RUN", seq).build());
+  }
+  assert(frozen->reencode_count() == 0);
+
+  std::cout << "[OK] seq width changes are handled without re-encoding\n";
+}
+
+void test_payload_timestamp() {
+  auto frozen = sparkplug::FrozenPayload::freeze(make_shape(20.5, 7, true, "RUN", 0));
+  assert(frozen.has_value());
+
+  frozen->set_timestamp(TS + 500);
+  auto expected = make_shape(20.5, 7, true, "RUN", 0);
+  expected.set_timestamp(TS + 500);
+  assert(to_vector(frozen->bytes()) == expected.build());
+  assert(frozen->reencode_count() == 0);
+
+  std::cout << "[OK] Payload timestamp is patched in place\n";
+}
+
+void test_timestamp_from_builder_clock() {
+  sparkplug::PayloadBuilder builder(
+      {.clock = sparkplug::Clock::custom([] { return TS + 42; })});
+  builder.add_metric_by_alias(1, 20.5, TS);
+  builder.mutable_payload().clear_timestamp();
+
+  auto frozen = sparkplug::FrozenPayload::freeze(builder);
+  assert(frozen.has_value());
+
+  sparkplug::PayloadBuilder expected;
+  expected.set_timestamp(TS + 42);
+  expected.add_metric_by_alias(1, 20.5, TS);
+  expected.set_seq(0);
+  assert(to_vector(frozen->bytes()) == expected.build());
+
+  std::cout << "[OK] Missing payload timestamp comes from the builder's clock\n";
+}
+
+void test_errors() {
+  auto frozen = sparkplug::FrozenPayload::freeze(make_shape(20.5, 7, true, "RUN", 0));
+  assert(frozen.has_value());
+
+  assert(!frozen->set(5, 1.0).has_value());        // Out of range
+  assert(!frozen->set(0, int32_t{1}).has_value()); // Double slot, int32 value
+  assert(!frozen->set(1, uint32_t{1}).has_value()); // Int32 slot, uint32 value
+  assert(!frozen->set(2, "true").has_value());      // Boolean slot, string value
+
+  sparkplug::PayloadBuilder no_timestamp;
+  no_timestamp.mutable_payload().add_metrics()->set_alias(1);
+  no_timestamp.mutable_payload().mutable_metrics(0)->set_datatype(
+      std::to_underlying(sparkplug::DataType::Double));
+  no_timestamp.mutable_payload().mutable_metrics(0)->set_double_value(1.0);
+  auto partial = sparkplug::FrozenPayload::freeze(no_timestamp);
+  assert(partial.has_value());
+  assert(partial->set(0, 2.0).has_value());
+  assert(!partial->set(0, 2.0, TS).has_value()); // Frozen without a metric timestamp
+
+  sparkplug::PayloadBuilder with_dataset;
+  with_dataset.mutable_payload().add_metrics()->mutable_dataset_value();
+  assert(!sparkplug::FrozenPayload::freeze(with_dataset).has_value());
+
+  std::cout << "[OK] Invalid updates and unsupported payloads are rejected\n";
+}
+
+int main() {
+  std::cout << "=== FrozenPayload Unit Tests ===\n\n";
+
+  test_freeze_matches_build();
+  test_in_place_patching();
+  test_width_change_reencodes();
+  test_seq_wraparound();
+  test_payload_timestamp();
+  test_timestamp_from_builder_clock();
+  test_errors();
+
+  std::cout << "\n=== All FrozenPayload tests passed! ===\n";
+  return 0;
+}
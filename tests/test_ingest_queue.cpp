@@ -0,0 +1,175 @@
+// tests/test_ingest_queue.cpp
+// Unit tests for MpscRing and the sharded IngestQueue used by HostApplication
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sparkplug/ingest_queue.hpp>
+
+namespace {
+
+struct Item {
+  uint64_t producer{0};
+  uint64_t seq{0};
+};
+
+} // namespace
+
+void test_ring_basics() {
+  sparkplug::MpscRing<int> ring(5);
+  assert(ring.capacity() == 8);
+  assert(!ring.try_pop().has_value());
+
+  // Several laps around the ring keep FIFO order and the full/empty states
+  int next_push = 0;
+  int next_pop = 0;
+  for (int lap = 0; lap < 10; lap++) {
+    while (ring.try_push(int{next_push})) {
+      next_push++;
+    }
+    assert(ring.size() == 8);
+    for (int i = 0; i < 5; i++) {
+      auto value = ring.try_pop();
+      assert(value && *value == next_pop);
+      next_pop++;
+    }
+  }
+  while (auto value = ring.try_pop()) {
+    assert(*value == next_pop++);
+  }
+  assert(next_pop == next_push && ring.size() == 0);
+
+  std::cout << "[OK] Ring keeps FIFO order and rejects pushes when full\n";
+}
+
+void test_ring_multiple_producers() {
+  constexpr uint64_t producers = 4;
+  constexpr uint64_t per_producer = 200000;
+  sparkplug::MpscRing<Item> ring(1024);
+
+  std::vector<std::thread> threads;
+  for (uint64_t p = 0; p < producers; p++) {
+    threads.emplace_back([&ring, p] {
+      for (uint64_t seq = 0; seq < per_producer; seq++) {
+        while (!ring.try_push(Item{.producer = p, .seq = seq})) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  std::vector<uint64_t> next(producers, 0);
+  uint64_t received = 0;
+  while (received < producers * per_producer) {
+    if (auto item = ring.try_pop()) {
+      assert(item->seq == next[item->producer]); // Per-producer order is kept
+      next[item->producer]++;
+      received++;
+    }
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  assert(!ring.try_pop().has_value());
+
+  std::cout << std::format("[OK] {} items from {} producers, none lost or reordered\n",
+                           received, producers);
+}
+
+void test_sharded_order() {
+  constexpr uint64_t keys = 16;
+  constexpr uint64_t per_key = 20000;
+  std::vector<uint64_t> next(keys, 0);
+  std::vector<std::thread::id> worker_of(keys);
+  std::mutex worker_mutex;
+  std::atomic<uint64_t> handled{0};
+
+  {
+    sparkplug::IngestQueue<Item> queue(4, 1 << 16, [&](Item& item) {
+      // Same key -> same worker, in submission order
+      assert(item.seq == next[item.producer]);
+      next[item.producer]++;
+      {
+        std::scoped_lock lock(worker_mutex);
+        if (item.seq == 0) {
+          worker_of[item.producer] = std::this_thread::get_id();
+        }
+        assert(worker_of[item.producer] == std::this_thread::get_id());
+      }
+      handled.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    for (uint64_t seq = 0; seq < per_key; seq++) {
+      for (uint64_t key = 0; key < keys; key++) {
+        Item item{.producer = key, .seq = seq};
+        while (!queue.submit(key, std::move(item))) {
+          std::this_thread::yield();
+        }
+      }
+    }
+    auto stats = queue.stats();
+    assert(stats.workers == 4 && stats.worker_depths.size() == 4);
+  } // Destructor drains every queue
+
+  assert(handled == keys * per_key);
+  for (uint64_t key = 0; key < keys; key++) {
+    assert(next[key] == per_key);
+  }
+
+  std::cout << "[OK] Items of one key stay on one worker, in order\n";
+}
+
+void test_drops_counted() {
+  std::atomic<bool> release{false};
+  std::atomic<uint64_t> handled{0};
+  sparkplug::IngestQueue<Item> queue(1, 8, [&](Item&) {
+    while (!release) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    handled++;
+  });
+
+  // One item blocks the worker, eight fill its queue, the rest are dropped
+  uint64_t accepted = 0;
+  for (uint64_t seq = 0; seq < 20; seq++) {
+    if (queue.submit(0, Item{.producer = 0, .seq = seq})) {
+      accepted++;
+    }
+    if (seq == 0) {
+      while (queue.stats().queue_depth != 0) {
+        std::this_thread::yield();
+      }
+    }
+  }
+  auto stats = queue.stats();
+  assert(accepted == 9);
+  assert(stats.dropped == 11);
+  assert(stats.queue_depth == 8 && stats.max_worker_depth == 8);
+  assert(stats.capacity_per_worker == 8);
+
+  release = true;
+  while (queue.stats().processed != accepted) {
+    std::this_thread::yield();
+  }
+  assert(handled == accepted && queue.stats().queue_depth == 0);
+
+  std::cout << "[OK] Full queues drop and count instead of blocking\n";
+}
+
+int main() {
+  std::cout << "=== IngestQueue Tests ===\n\n";
+
+  test_ring_basics();
+  test_ring_multiple_producers();
+  test_sharded_order();
+  test_drops_counted();
+
+  std::cout << "\n=== All IngestQueue tests passed! ===\n";
+  return 0;
+}
@@ -0,0 +1,234 @@
+// tests/test_last_value_cache.cpp
+// Unit tests for the host-side LastValueCache
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include <sparkplug/last_value_cache.hpp>
+#include <sparkplug/payload_builder.hpp>
+#include <sparkplug/payload_view.hpp>
+
+namespace {
+
+using Cache = sparkplug::LastValueCache;
+
+sparkplug::Topic topic(sparkplug::MessageType type, std::string device = "") {
+  return {.group_id = "Energy",
+          .message_type = type,
+          .edge_node_id = "Node1",
+          .device_id = std::move(device)};
+}
+
+sparkplug::stdx::expected<void, std::string>
+apply(Cache& cache,
+      const sparkplug::Topic& message_topic,
+      const sparkplug::PayloadBuilder& payload) {
+  std::vector<uint8_t> bytes(payload.payload().ByteSizeLong());
+  [[maybe_unused]] bool ok =
+      payload.payload().SerializeToArray(bytes.data(), static_cast<int>(bytes.size()));
+  assert(ok);
+  auto view = sparkplug::PayloadView::parse(bytes);
+  assert(view.has_value());
+  return cache.apply(message_topic, *view);
+}
+
+sparkplug::PayloadBuilder node_birth() {
+  sparkplug::PayloadBuilder birth;
+  birth.set_timestamp(1000);
+  birth.add_metric("bdSeq", uint64_t{0});
+  birth.add_metric_with_alias("Temperature", 1, 20.5);
+  birth.add_metric_with_alias("Offset", 2, int8_t{-5});
+  birth.add_metric_with_alias("Running", 3, true);
+  birth.add_metric_with_alias("Mode", 4, "auto");
+  birth.add_metric_with_alias("Count", 5, uint32_t{7});
+  birth.set_seq(0);
+  return birth;
+}
+
+} // namespace
+
+using sparkplug::MessageType;
+
+void test_birth_and_data() {
+  Cache cache;
+  assert(apply(cache, topic(MessageType::NBIRTH), node_birth()).has_value());
+  assert(cache.metric_count() == 6);
+
+  std::vector<Cache::MetricSnapshot> metrics;
+  assert(cache.snapshot("Energy", "Node1", "", metrics));
+  assert(metrics.size() == 6);
+  assert(metrics[1].name == "Temperature" && metrics[1].alias == 1);
+  assert(std::get<double>(metrics[1].value) == 20.5);
+  assert(std::get<int64_t>(metrics[2].value) == -5);
+  assert(std::get<bool>(metrics[3].value));
+  assert(std::get<std::string>(metrics[4].value) == "auto");
+  assert(std::get<uint64_t>(metrics[5].value) == 7);
+  assert(metrics[1].quality == Cache::Quality::Good && !metrics[1].stale);
+
+  sparkplug::PayloadBuilder data;
+  data.set_timestamp(2000);
+  data.add_metric_by_alias(1, 21.0, 1999);
+  data.add_metric_by_alias(4, "manual");
+  data.add_metric_by_alias(2, int8_t{-6});
+  data.set_seq(1);
+  assert(apply(cache, topic(MessageType::NDATA), data).has_value());
+
+  auto temperature = cache.find("Energy", "Node1", "", "Temperature");
+  assert(temperature && std::get<double>(temperature->value) == 21.0);
+  assert(temperature->timestamp == 1999);
+  auto mode = cache.find("Energy", "Node1", "", "Mode");
+  assert(mode && std::get<std::string>(mode->value) == "manual");
+  assert(std::get<int64_t>(cache.find("Energy", "Node1", "", "Offset")->value) == -6);
+  assert(!cache.find("Energy", "Node1", "", "Missing").has_value());
+  assert(!cache.find("Energy", "Node2", "", "Temperature").has_value());
+
+  // Null values are Bad, unknown aliases are reported but do not stop the update
+  sparkplug::PayloadBuilder nulls;
+  nulls.add_metric_by_alias(99, 1.0);
+  nulls.add_metric_by_alias(1, 0.0);
+  nulls.mutable_payload().mutable_metrics(1)->set_is_null(true);
+  nulls.mutable_payload().mutable_metrics(1)->clear_double_value();
+  assert(!apply(cache, topic(MessageType::NDATA), nulls).has_value());
+  temperature = cache.find("Energy", "Node1", "", "Temperature");
+  assert(temperature->quality == Cache::Quality::Bad);
+  assert(std::holds_alternative<std::monostate>(temperature->value));
+
+  std::cout << "[OK] Births define columns, DATA updates them by alias\n";
+}
+
+void test_devices_and_staleness() {
+  Cache cache;
+  sparkplug::PayloadBuilder data;
+  data.add_metric_by_alias(1, 1.0);
+  assert(!apply(cache, topic(MessageType::NDATA), data).has_value()); // Before birth
+
+  assert(apply(cache, topic(MessageType::NBIRTH), node_birth()).has_value());
+  sparkplug::PayloadBuilder device_birth;
+  device_birth.add_metric_with_alias("Speed", 10, 1500.0);
+  assert(apply(cache, topic(MessageType::DBIRTH, "Motor1"), device_birth).has_value());
+  assert(cache.devices("Energy", "Node1") == std::vector<std::string>{"Motor1"});
+
+  // Another node whose device shares the name; births and deaths of Node1 leave it be
+  auto other_node = topic(MessageType::NBIRTH);
+  other_node.edge_node_id = "Node2";
+  assert(apply(cache, other_node, node_birth()).has_value());
+  auto other_device = topic(MessageType::DBIRTH, "Motor1");
+  other_device.edge_node_id = "Node2";
+  assert(apply(cache, other_device, device_birth).has_value());
+  assert(cache.devices("Energy", "Node2") == std::vector<std::string>{"Motor1"});
+  assert(cache.devices("Energy", "Node3").empty());
+
+  sparkplug::PayloadBuilder device_data;
+  device_data.add_metric_by_alias(10, 1480.0);
+  assert(apply(cache, topic(MessageType::DDATA, "Motor1"), device_data).has_value());
+  assert(std::get<double>(cache.find("Energy", "Node1", "Motor1", "Speed")->value) ==
+         1480.0);
+
+  assert(apply(cache, topic(MessageType::DDEATH, "Motor1"), {}).has_value());
+  assert(cache.find("Energy", "Node1", "Motor1", "Speed")->stale);
+  assert(!cache.find("Energy", "Node1", "", "Temperature")->stale);
+
+  assert(apply(cache, topic(MessageType::DBIRTH, "Motor1"), device_birth).has_value());
+  assert(!cache.find("Energy", "Node1", "Motor1", "Speed")->stale);
+
+  assert(apply(cache, topic(MessageType::NDEATH), {}).has_value());
+  assert(cache.find("Energy", "Node1", "", "Temperature")->stale);
+  assert(cache.find("Energy", "Node1", "Motor1", "Speed")->stale);
+
+  // A rebirth replaces the node's columns; devices stay stale until their DBIRTH
+  assert(apply(cache, topic(MessageType::NBIRTH), node_birth()).has_value());
+  assert(!cache.find("Energy", "Node1", "", "Temperature")->stale);
+  assert(cache.find("Energy", "Node1", "Motor1", "Speed")->stale);
+
+  assert(!cache.find("Energy", "Node2", "", "Temperature")->stale);
+  assert(!cache.find("Energy", "Node2", "Motor1", "Speed")->stale);
+
+  std::cout << "[OK] Devices and NDEATH/DDEATH staleness\n";
+}
+
+void test_concurrent_snapshots() {
+  Cache cache;
+  sparkplug::PayloadBuilder birth;
+  birth.add_metric_with_alias("A", 1, uint64_t{0});
+  birth.add_metric_with_alias("B", 2, uint64_t{0});
+  assert(apply(cache, topic(MessageType::NBIRTH), birth).has_value());
+
+  // Every NDATA keeps A == B; a snapshot must never see them differ
+  std::atomic<bool> done{false};
+  std::thread writer([&] {
+    sparkplug::PayloadBuilder data;
+    for (uint64_t i = 1; i <= 20000; i++) {
+      data.reset();
+      data.add_metric_by_alias(1, i);
+      data.add_metric_by_alias(2, i);
+      [[maybe_unused]] auto applied = apply(cache, topic(MessageType::NDATA), data);
+      assert(applied.has_value());
+    }
+    done = true;
+  });
+
+  std::vector<Cache::MetricSnapshot> metrics;
+  size_t reads = 0;
+  uint64_t last = 0;
+  while (!done) {
+    assert(cache.snapshot("Energy", "Node1", "", metrics));
+    auto a = std::get<uint64_t>(metrics[0].value);
+    auto b = std::get<uint64_t>(metrics[1].value);
+    assert(a == b);
+    assert(a >= last);
+    last = a;
+    reads++;
+  }
+  writer.join();
+  assert(std::get<uint64_t>(cache.find("Energy", "Node1", "", "B")->value) == 20000);
+
+  std::cout << std::format("[OK] {} snapshots consistent while ingesting\n", reads);
+}
+
+void test_memory_per_metric() {
+  Cache cache;
+  constexpr size_t nodes = 100;
+  constexpr size_t metrics = 1000;
+  sparkplug::PayloadBuilder birth;
+  for (size_t alias = 0; alias < metrics; alias++) {
+    birth.add_metric_with_alias(std::format("Area{}/Sensor{}", alias % 10, alias), alias,
+                                static_cast<double>(alias));
+  }
+  std::vector<uint8_t> bytes(birth.payload().ByteSizeLong());
+  [[maybe_unused]] bool ok =
+      birth.payload().SerializeToArray(bytes.data(), static_cast<int>(bytes.size()));
+  assert(ok);
+  auto view = sparkplug::PayloadView::parse(bytes);
+  for (size_t node = 0; node < nodes; node++) {
+    sparkplug::Topic node_topic{.group_id = "Plant",
+                                .message_type = MessageType::NBIRTH,
+                                .edge_node_id = std::format("Node{}", node),
+                                .device_id = ""};
+    assert(cache.apply(node_topic, *view).has_value());
+  }
+  assert(cache.metric_count() == nodes * metrics);
+
+  size_t per_metric = cache.memory_bytes() / cache.metric_count();
+  assert(per_metric < 80);
+
+  std::cout << std::format("[OK] {} metrics cached in {} B each\n", cache.metric_count(),
+                           per_metric);
+}
+
+int main() {
+  std::cout << "=== LastValueCache Tests ===\n\n";
+
+  test_birth_and_data();
+  test_devices_and_staleness();
+  test_concurrent_snapshots();
+  test_memory_per_metric();
+
+  std::cout << "\n=== All LastValueCache tests passed! ===\n";
+  return 0;
+}
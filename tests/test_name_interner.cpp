@@ -0,0 +1,70 @@
+// tests/test_name_interner.cpp
+// Unit tests for NameInterner, which keys HostApplication node state by integer IDs
+#include <cassert>
+#include <format>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sparkplug/name_interner.hpp>
+
+void test_intern_and_lookup() {
+  sparkplug::NameInterner names;
+  assert(names.size() == 0);
+  assert(!names.find("Energy").has_value());
+
+  auto group = names.intern("Energy");
+  auto node = names.intern(std::string("Gateway01"));
+  assert(group != node);
+  assert(names.intern("Energy") == group);
+  assert(names.find("Gateway01") == node);
+  assert(names.name(node) == "Gateway01");
+  assert(names.name(42 << 4).empty());
+  assert(names.name(0xFFFFFFFF).empty());
+  assert(names.size() == 2);
+
+  std::cout << "[OK] Names get stable IDs on first sight\n";
+}
+
+void test_concurrent_intern() {
+  constexpr int threads = 8;
+  constexpr int names_per_thread = 2000;
+  sparkplug::NameInterner names;
+
+  // Every thread interns the same names in a different order
+  std::vector<std::vector<sparkplug::NameInterner::Id>> ids(threads);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([&, t] {
+      ids[t].resize(names_per_thread);
+      for (int i = 0; i < names_per_thread; i++) {
+        int n = (i + t * 97) % names_per_thread;
+        ids[t][n] = names.intern(std::format("Node{}", n));
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  assert(names.size() == names_per_thread);
+  for (int n = 0; n < names_per_thread; n++) {
+    for (int t = 1; t < threads; t++) {
+      assert(ids[t][n] == ids[0][n]);
+    }
+    assert(names.name(ids[0][n]) == std::format("Node{}", n));
+  }
+
+  std::cout << "[OK] Concurrent interning agrees on every ID\n";
+}
+
+int main() {
+  std::cout << "=== NameInterner Tests ===\n\n";
+
+  test_intern_and_lookup();
+  test_concurrent_intern();
+
+  std::cout << "\n=== All NameInterner tests passed! ===\n";
+  return 0;
+}
@@ -0,0 +1,197 @@
+// tests/test_payload_allocations.cpp
+// Verifies that long-lived PayloadBuilders refilled via reset() stop allocating
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#include <sparkplug/payload_builder.hpp>
+
+namespace {
+std::atomic<size_t> g_allocations{0};
+constexpr int CYCLES = 10000;
+constexpr uint64_t METRICS_PER_CYCLE = 100;
+} // namespace
+
+void* operator new(std::size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept {
+  std::free(ptr);
+}
+
+void run_data_cycle(sparkplug::PayloadBuilder& payload,
+                    std::vector<uint8_t>& buffer,
+                    int cycle) {
+  payload.reset();
+  for (uint64_t alias = 0; alias < METRICS_PER_CYCLE; alias += 4) {
+    payload.add_metric_by_alias(alias, static_cast<double>(cycle) * 0.5);
+    payload.add_metric_by_alias(alias + 1, static_cast<int32_t>(cycle));
+    payload.add_metric_by_alias(alias + 2, (cycle % 2) == 0);
+    payload.add_metric_by_alias(alias + 3, "RUNNING");
+  }
+  payload.set_seq(static_cast<uint64_t>(cycle) % 256);
+  payload.build_into(buffer);
+}
+
+void test_arena_builder_steady_state() {
+  sparkplug::PayloadBuilder payload({.use_arena = true});
+  std::vector<uint8_t> buffer;
+
+  // Warm-up cycle with the widest varints (seq 255) grows the output buffer once
+  run_data_cycle(payload, buffer, 255);
+
+  size_t before = g_allocations.load();
+  for (int cycle = 1; cycle <= CYCLES; cycle++) {
+    run_data_cycle(payload, buffer, cycle);
+  }
+  [[maybe_unused]] size_t allocations = g_allocations.load() - before;
+
+  assert(payload.payload().metrics_size() == static_cast<int>(METRICS_PER_CYCLE));
+  assert(allocations == 0);
+
+  std::cout << "[OK] Arena builder: 0 allocations across " << CYCLES << " cycles\n";
+}
+
+void test_wire_builder_steady_state() {
+  using Encoding = sparkplug::PayloadBuilder::Encoding;
+  sparkplug::PayloadBuilder payload({.encoding = Encoding::Wire});
+  std::vector<uint8_t> buffer;
+
+  run_data_cycle(payload, buffer, 255);
+
+  size_t before = g_allocations.load();
+  for (int cycle = 1; cycle <= CYCLES; cycle++) {
+    run_data_cycle(payload, buffer, cycle);
+  }
+  [[maybe_unused]] size_t allocations = g_allocations.load() - before;
+
+  assert(payload.payload().metrics_size() == static_cast<int>(METRICS_PER_CYCLE));
+  assert(allocations == 0);
+
+  std::cout << "[OK] Wire builder: 0 allocations across " << CYCLES << " cycles\n";
+}
+
+void test_heap_builder_reuses_capacity() {
+  sparkplug::PayloadBuilder payload;
+  std::vector<uint8_t> buffer;
+
+  auto run_cycle = [&payload, &buffer](int cycle) {
+    payload.reset();
+    for (uint64_t alias = 0; alias < METRICS_PER_CYCLE; alias++) {
+      payload.add_metric_with_alias("Line 1/Conveyor/Motor Speed", alias,
+                                    static_cast<double>(cycle));
+    }
+    payload.build_into(buffer);
+  };
+
+  run_cycle(0);
+
+  size_t before = g_allocations.load();
+  for (int cycle = 1; cycle <= CYCLES; cycle++) {
+    run_cycle(cycle);
+  }
+  [[maybe_unused]] size_t allocations = g_allocations.load() - before;
+
+  assert(payload.payload().metrics(0).name() == "Line 1/Conveyor/Motor Speed");
+  assert(allocations == 0);
+
+  std::cout << "[OK] Heap builder: 0 allocations across " << CYCLES
+            << " cycles after reset()\n";
+}
+
+void test_reset_clears_state() {
+  sparkplug::PayloadBuilder payload({.use_arena = true});
+
+  payload.add_metric("test", 42);
+  payload.set_seq(5);
+  payload.set_timestamp(123);
+
+  payload.reset();
+
+  assert(payload.payload().metrics_size() == 0);
+  assert(!payload.has_seq());
+  assert(!payload.has_timestamp());
+  assert(payload.payload().has_timestamp());
+  assert(payload.payload().timestamp() != 123);
+
+  std::cout << "[OK] reset() clears metrics, seq and timestamp\n";
+}
+
+void test_arena_builder_copy_and_move() {
+  sparkplug::PayloadBuilder payload({.use_arena = true});
+  payload.add_metric_with_alias("Temperature", 1, 20.5);
+
+  sparkplug::PayloadBuilder copy(payload);
+  assert(copy.build() == payload.build());
+
+  // Moves take the message, arena and options along and allocate nothing
+  sparkplug::PayloadBuilder heap;
+  size_t before = g_allocations.load();
+  sparkplug::PayloadBuilder moved(std::move(copy));
+  assert(moved.payload().metrics_size() == 1);
+  assert(moved.payload().metrics(0).name() == "Temperature");
+
+  heap = std::move(moved);
+  [[maybe_unused]] size_t allocations = g_allocations.load() - before;
+  assert(heap.payload().metrics(0).double_value() == 20.5);
+  assert(allocations == 0);
+
+  // Moved-from builders are empty and can be refilled
+  assert(copy.payload().metrics_size() == 0 && !copy.has_seq());
+  assert(moved.payload().metrics_size() == 0);
+  copy.add_metric_by_alias(2, 1.5);
+  moved.reset().add_metric_by_alias(3, true);
+  assert(copy.payload().metrics(0).alias() == 2 && !copy.build().empty());
+  assert(moved.payload().metrics(0).alias() == 3 && !moved.build().empty());
+
+  std::cout << "[OK] Arena builder copy and move\n";
+}
+
+void test_arena_builder_copy_assign_steady_state() {
+  sparkplug::PayloadBuilder source;
+  for (uint64_t alias = 0; alias < METRICS_PER_CYCLE; alias += 2) {
+    source.add_metric_by_alias(alias, static_cast<double>(alias));
+    source.add_metric_by_alias(alias + 1, "RUNNING");
+  }
+  sparkplug::PayloadBuilder target({.use_arena = true});
+  target = source; // Warm-up
+
+  // Each copy rewinds the arena, so its initial block is reused
+  size_t before = g_allocations.load();
+  for (int cycle = 0; cycle < CYCLES; cycle++) {
+    target = source;
+  }
+  [[maybe_unused]] size_t allocations = g_allocations.load() - before;
+
+  assert(target.build() == source.build());
+  assert(allocations == 0);
+
+  std::cout << "[OK] Arena builder: 0 allocations across " << CYCLES
+            << " copy-assignments\n";
+}
+
+int main() {
+  std::cout << "=== PayloadBuilder Allocation Tests ===\n\n";
+
+  test_arena_builder_steady_state();
+  test_wire_builder_steady_state();
+  test_heap_builder_reuses_capacity();
+  test_reset_clears_state();
+  test_arena_builder_copy_and_move();
+  test_arena_builder_copy_assign_steady_state();
+
+  std::cout << "\n=== All PayloadBuilder allocation tests passed! ===\n";
+  return 0;
+}
@@ -270,6 +270,106 @@ void test_serialize() {
   std::cout << "[OK] Payload serialization\n";
 }
 
+void test_build_into() {
+  sparkplug::PayloadBuilder payload;
+
+  payload.add_metric_with_alias("Temperature", 1, 20.5);
+  payload.add_metric_with_alias("Status", 2, "OK");
+  payload.set_seq(7);
+
+  auto expected = payload.build();
+
+  std::vector<uint8_t> buffer;
+  payload.build_into(buffer);
+  assert(buffer == expected);
+
+  // Reusing the buffer keeps its capacity
+  auto* data_before = buffer.data();
+  payload.build_into(buffer);
+  assert(buffer.data() == data_before);
+  assert(buffer == expected);
+
+  std::vector<uint8_t> storage(expected.size());
+  auto written = payload.build_into(std::span<uint8_t>(storage));
+  assert(written.has_value());
+  assert(*written == expected.size());
+  assert(storage == expected);
+
+  std::vector<uint8_t> too_small(expected.size() - 1);
+  [[maybe_unused]] auto result = payload.build_into(std::span<uint8_t>(too_small));
+  assert(!result.has_value());
+
+  std::cout << "[OK] Serialization into caller-owned buffer\n";
+}
+
+void test_injected_clock() {
+  uint64_t fake_now = 1700000000000ULL;
+  sparkplug::PayloadBuilder payload(
+      {.clock = sparkplug::Clock::custom([&fake_now] { return fake_now++; })});
+
+  payload.add_metric("a", 1);
+  payload.add_metric("b", 2);
+
+  auto pb = payload.payload();
+  assert(pb.timestamp() == 1700000000000ULL);
+  assert(pb.metrics(0).timestamp() == 1700000000001ULL);
+  assert(pb.metrics(1).timestamp() == 1700000000002ULL);
+
+  // The clock moves with the builder; the moved-from one falls back to the system clock
+  sparkplug::PayloadBuilder moved(std::move(payload));
+  moved.add_metric("c", 3);
+  assert(moved.payload().metrics(2).timestamp() == 1700000000003ULL);
+  payload.add_metric("d", 4);
+  assert(payload.payload().metrics(0).timestamp() > 1700000000003ULL);
+
+  std::cout << "[OK] Injected clock stamps payload and metrics\n";
+}
+
+void test_snapshot_timestamps() {
+  int reads = 0;
+  uint64_t fake_now = 1700000000000ULL;
+  sparkplug::PayloadBuilder payload(
+      {.clock = sparkplug::Clock::custom([&] {
+         reads++;
+         return fake_now++;
+       }),
+       .timestamp_mode = sparkplug::PayloadBuilder::TimestampMode::Snapshot});
+
+  for (int i = 0; i < 1000; i++) {
+    payload.add_metric_by_alias(static_cast<uint64_t>(i), i);
+  }
+  [[maybe_unused]] auto bytes = payload.build();
+  assert(reads == 1);
+
+  auto pb = payload.payload();
+  for (const auto& metric : pb.metrics()) {
+    assert(metric.timestamp() == pb.timestamp());
+  }
+  payload.add_metric("explicit", 1, 5ULL);
+  assert(payload.payload().metrics(1000).timestamp() == 5);
+
+  payload.reset();
+  payload.add_metric("after_reset", true);
+  assert(reads == 2);
+  assert(payload.payload().timestamp() == 1700000000001ULL);
+  assert(payload.payload().metrics(0).timestamp() == 1700000000001ULL);
+
+  std::cout << "[OK] Snapshot mode reads the clock once per payload\n";
+}
+
+void test_coarse_clock() {
+  auto system_now = sparkplug::Clock::system().now_ms();
+  auto coarse_now = sparkplug::Clock::coarse().now_ms();
+  assert(sparkplug::Clock::coarse().source() == sparkplug::Clock::Source::Coarse);
+
+  // Coarse resolution is a scheduler tick; allow generous slack
+  [[maybe_unused]] auto diff =
+      coarse_now > system_now ? coarse_now - system_now : system_now - coarse_now;
+  assert(diff < 1000);
+
+  std::cout << "[OK] Coarse clock tracks the system clock\n";
+}
+
 int main() {
   std::cout << "=== PayloadBuilder Unit Tests ===\n\n";
 
@@ -288,6 +388,10 @@ int main() {
   test_method_chaining();
   test_node_control_metrics();
   test_serialize();
+  test_build_into();
+  test_injected_clock();
+  test_snapshot_timestamps();
+  test_coarse_clock();
 
   std::cout << "\n=== All PayloadBuilder tests passed! ===\n";
   return 0;
@@ -0,0 +1,209 @@
+// tests/test_payload_view.cpp
+// Unit tests for the zero-copy PayloadView decoder
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include <sparkplug/payload_builder.hpp>
+#include <sparkplug/payload_view.hpp>
+#include <sparkplug/wire.hpp>
+
+namespace {
+
+std::vector<uint8_t> serialize(const org::eclipse::tahu::protobuf::Payload& payload) {
+  std::vector<uint8_t> buffer(payload.ByteSizeLong());
+  [[maybe_unused]] bool ok =
+      payload.SerializeToArray(buffer.data(), static_cast<int>(buffer.size()));
+  assert(ok);
+  return buffer;
+}
+
+} // namespace
+
+void test_all_value_types() {
+  sparkplug::PayloadBuilder builder;
+  builder.set_timestamp(1700000000000);
+  builder.add_metric_with_alias("bdSeq", 0, uint64_t{3});
+  builder.add_metric_with_alias("Temperature", 1, 21.5);
+  builder.add_metric_with_alias("Pressure", 2, 1.25f);
+  builder.add_metric_with_alias("Offset", 3, int32_t{-7});
+  builder.add_metric_with_alias("Running", 4, true);
+  builder.add_metric_with_alias("Mode", 5, "auto");
+  builder.add_metric_by_alias(6, int64_t{-9000000000});
+  builder.set_seq(0);
+
+  auto bytes = serialize(builder.payload());
+  auto view = sparkplug::PayloadView::parse(bytes);
+  assert(view.has_value());
+  assert(view->timestamp() == 1700000000000);
+  assert(view->seq() == 0);
+  assert(!view->uuid().has_value());
+  assert(view->metric_count() == 7);
+  assert(view->metrics().size() == 7);
+
+  const auto& pb = builder.payload();
+  int index = 0;
+  for (const auto& metric : view->metrics()) {
+    const auto& expected = pb.metrics(index++);
+    assert(metric.name == expected.name());
+    assert(metric.alias == expected.alias());
+    assert(metric.timestamp == expected.timestamp());
+    assert(metric.datatype.has_value());
+    assert(std::to_underlying(*metric.datatype) == expected.datatype());
+  }
+  assert(index == 7);
+
+  auto metric = view->find("Temperature");
+  assert(metric && std::get<double>(metric->value) == 21.5);
+  assert(std::get<float>(view->find(2)->value) == 1.25f);
+  assert(static_cast<int32_t>(std::get<uint32_t>(view->find(3)->value)) == -7);
+  assert(std::get<bool>(view->find(4)->value));
+  assert(std::get<std::string_view>(view->find("Mode")->value) == "auto");
+  assert(static_cast<int64_t>(std::get<uint64_t>(view->find(6)->value)) == -9000000000);
+  assert(std::get<uint64_t>(view->find("bdSeq")->value) == 3);
+  assert(view->find(6)->name.empty());
+  assert(!view->find("Missing").has_value());
+
+  // Names and strings point into the received buffer
+  const auto* mode = std::get<std::string_view>(view->find(5)->value).data();
+  assert(reinterpret_cast<const uint8_t*>(mode) >= bytes.data() &&
+         reinterpret_cast<const uint8_t*>(mode) < bytes.data() + bytes.size());
+
+  std::cout << "[OK] Scalar metrics decode without materializing the payload\n";
+}
+
+void test_round_trip_with_encoder() {
+  sparkplug::PayloadBuilder builder;
+  builder.set_timestamp(42);
+  builder.add_metric_by_alias(1, 1.5, 42);
+  builder.add_metric_by_alias(2, "text", 42);
+  std::vector<uint8_t> blob{1, 2, 3};
+  builder.add_metric("Blob", blob);
+  builder.set_seq(17);
+  builder.mutable_payload().set_uuid("custom-uuid");
+  auto bytes = serialize(builder.payload());
+
+  auto view = sparkplug::PayloadView::parse(bytes);
+  assert(view.has_value());
+  assert(view->uuid() == "custom-uuid");
+
+  // A view re-encodes to the same bytes (uuid aside, which the encoder does not write)
+  sparkplug::wire::Encoder encoder;
+  encoder.set_timestamp(*view->timestamp());
+  for (const auto& metric : view->metrics()) {
+    encoder.add_metric(metric);
+  }
+  encoder.set_seq(*view->seq());
+  std::vector<uint8_t> encoded;
+  encoder.encode_into(encoded);
+
+  builder.mutable_payload().clear_uuid();
+  assert(encoded == serialize(builder.payload()));
+
+  std::cout << "[OK] Decoded metrics re-encode byte-identically\n";
+}
+
+void test_skips_unknown_and_metadata() {
+  org::eclipse::tahu::protobuf::Payload payload;
+  auto* metric = payload.add_metrics();
+  metric->set_name("WithMetadata");
+  metric->set_datatype(std::to_underlying(sparkplug::DataType::Int32));
+  metric->mutable_metadata()->set_content_type("text/plain");
+  metric->set_int_value(5);
+  payload.set_body("opaque");
+  auto bytes = serialize(payload);
+
+  // Unknown top-level field 99 (varint) at the end
+  bytes.push_back(static_cast<uint8_t>(sparkplug::wire::make_tag(
+                      99, sparkplug::wire::WireType::Varint) |
+                  0x80));
+  bytes.push_back(static_cast<uint8_t>(
+      sparkplug::wire::make_tag(99, sparkplug::wire::WireType::Varint) >> 7));
+  bytes.push_back(1);
+
+  auto view = sparkplug::PayloadView::parse(bytes);
+  assert(view.has_value());
+  assert(view->metric_count() == 1);
+  assert(view->body().has_value() && view->body()->size() == 6);
+  auto decoded = view->find("WithMetadata");
+  assert(decoded && std::get<uint32_t>(decoded->value) == 5);
+
+  std::cout << "[OK] Metadata and unknown fields are skipped\n";
+}
+
+void test_malformed() {
+  sparkplug::PayloadBuilder builder;
+  builder.add_metric("Temperature", 20.0);
+  auto bytes = serialize(builder.payload());
+
+  assert(sparkplug::PayloadView::parse({}).has_value()); // Empty payload is valid
+  // Every truncation is accepted exactly when libprotobuf accepts it
+  size_t rejected = 0;
+  for (size_t length = 1; length < bytes.size(); length++) {
+    auto truncated = std::span<const uint8_t>(bytes).first(length);
+    org::eclipse::tahu::protobuf::Payload reference;
+    bool valid = reference.ParseFromArray(truncated.data(), static_cast<int>(length));
+    assert(sparkplug::PayloadView::parse(truncated).has_value() == valid);
+    rejected += valid ? 0 : 1;
+  }
+  assert(rejected > 0);
+
+  std::vector<uint8_t> bad_key{0x00, 0x01};
+  assert(!sparkplug::PayloadView::parse(bad_key).has_value());
+
+  std::cout << "[OK] Truncated and malformed payloads are rejected\n";
+}
+
+void test_header_scan() {
+  sparkplug::PayloadBuilder birth;
+  birth.set_timestamp(1700000000000);
+  birth.add_metric_with_alias("Temperature", 1, 20.0);
+  birth.add_metric("bdSeq", uint64_t{7});
+  birth.add_metric("Mode", "bdSeq"); // A string value equal to the name is not a match
+  birth.set_seq(0);
+  auto bytes = serialize(birth.payload());
+
+  auto header = sparkplug::scan_payload_header(bytes, true);
+  assert(header.has_value());
+  assert(header->timestamp == 1700000000000);
+  assert(header->seq == 0);
+  assert(header->bd_seq == 7);
+
+  // Without the locator metrics are not inspected
+  auto plain = sparkplug::scan_payload_header(bytes);
+  assert(plain.has_value() && plain->seq == 0 && !plain->bd_seq.has_value());
+
+  sparkplug::PayloadBuilder data;
+  data.add_metric_by_alias(1, 21.0);
+  data.set_seq(42);
+  auto data_bytes = serialize(data.payload());
+  auto data_header = sparkplug::scan_payload_header(data_bytes, true);
+  assert(data_header.has_value());
+  assert(data_header->seq == 42);
+  assert(!data_header->bd_seq.has_value());
+
+  // Truncated framing is detected
+  auto truncated = std::span<const uint8_t>(data_bytes).first(data_bytes.size() - 4);
+  org::eclipse::tahu::protobuf::Payload reference;
+  assert(!reference.ParseFromArray(truncated.data(), static_cast<int>(truncated.size())));
+  assert(!sparkplug::scan_payload_header(truncated).has_value());
+
+  std::cout << "[OK] Header scan extracts seq, timestamp and bdSeq\n";
+}
+
+int main() {
+  std::cout << "=== PayloadView Tests ===\n\n";
+
+  test_all_value_types();
+  test_round_trip_with_encoder();
+  test_skips_unknown_and_metadata();
+  test_malformed();
+  test_header_scan();
+
+  std::cout << "\n=== All PayloadView tests passed! ===\n";
+  return 0;
+}
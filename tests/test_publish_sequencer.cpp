@@ -0,0 +1,287 @@
+// tests/test_publish_sequencer.cpp
+// PublishSequencer unit tests, then a multi-threaded EdgeNode stress test checking at
+// the broker that every message of the node arrives with the next seq (needs a broker
+// on localhost:1883)
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sparkplug/edge_node.hpp>
+#include <sparkplug/host_application.hpp>
+#include <sparkplug/publish_sequencer.hpp>
+
+using namespace std::chrono_literals;
+using sparkplug::PublishSequencer;
+
+namespace {
+
+uint64_t decode_seq(std::span<const uint8_t> bytes) {
+  org::eclipse::tahu::protobuf::Payload payload;
+  bool parsed = payload.ParseFromArray(bytes.data(), static_cast<int>(bytes.size()));
+  assert(parsed && payload.has_seq());
+  (void)parsed;
+  return payload.seq();
+}
+
+std::vector<uint8_t> encode_without_seq(double value) {
+  sparkplug::PayloadBuilder payload;
+  payload.set_timestamp(1);
+  payload.add_metric_by_alias(1, value);
+  return payload.build();
+}
+
+// Records what a sequencer sends, in send order
+struct Recorder {
+  std::vector<uint64_t> seqs;
+  size_t fail_at{SIZE_MAX}; // Index of a send to reject
+
+  PublishSequencer::Send sender() {
+    return [this](const PublishSequencer::Route&, std::span<const uint8_t> bytes)
+               -> sparkplug::stdx::expected<void, std::string> {
+      if (seqs.size() == fail_at) {
+        fail_at = SIZE_MAX;
+        return sparkplug::stdx::unexpected("Failed to publish: -3");
+      }
+      seqs.push_back(decode_seq(bytes));
+      return {};
+    };
+  }
+};
+
+void assert_consecutive(const std::vector<uint64_t>& seqs, uint64_t first) {
+  for (size_t i = 0; i < seqs.size(); i++) {
+    if (seqs[i] != (first + i) % 256) {
+      std::cerr << std::format("seq {} at position {}, expected {}\n", seqs[i], i,
+                               (first + i) % 256);
+      assert(false);
+    }
+  }
+}
+
+} // namespace
+
+void test_parts_and_restart() {
+  Recorder recorder;
+  PublishSequencer sequencer(16, recorder.sender());
+
+  auto bytes = encode_without_seq(1.0);
+  PublishSequencer::Part part{.bytes = &bytes};
+  PublishSequencer::Message data{.route = {}, .parts = {&part, 1}};
+  assert(sequencer.submit(data));
+  assert(data.first_seq == 1 && sequencer.seq() == 1);
+
+  // A split payload: three chunks with consecutive seqs
+  std::vector<std::vector<uint8_t>> chunks(3, encode_without_seq(2.0));
+  std::vector<PublishSequencer::Part> parts;
+  for (auto& chunk : chunks) {
+    parts.push_back({.bytes = &chunk});
+  }
+  PublishSequencer::Message split{.route = {}, .parts = parts};
+  assert(sequencer.submit(split));
+  assert(split.first_seq == 2 && split.parts_sent == 3);
+
+  // NBIRTH restarts the numbering
+  auto birth = encode_without_seq(3.0);
+  PublishSequencer::Part birth_part{.bytes = &birth};
+  PublishSequencer::Message restart{
+      .route = {}, .parts = {&birth_part, 1}, .restart_seq = true};
+  assert(sequencer.submit(restart));
+  assert(restart.first_seq == 0 && sequencer.seq() == 0);
+
+  assert((recorder.seqs == std::vector<uint64_t>{1, 2, 3, 4, 0}));
+
+  std::cout << "[OK] Parts get consecutive seqs; NBIRTH restarts at 0\n";
+}
+
+void test_failed_send_keeps_seq() {
+  Recorder recorder;
+  PublishSequencer sequencer(16, recorder.sender());
+  recorder.fail_at = 1;
+
+  std::vector<std::vector<uint8_t>> chunks(3, encode_without_seq(1.0));
+  std::vector<PublishSequencer::Part> parts;
+  for (auto& chunk : chunks) {
+    parts.push_back({.bytes = &chunk});
+  }
+  PublishSequencer::Message split{.route = {}, .parts = parts};
+  auto result = sequencer.submit(split);
+  assert(!result && result.error() == "Failed to publish: -3");
+  assert(split.parts_sent == 1 && sequencer.seq() == 1);
+
+  auto bytes = encode_without_seq(2.0);
+  PublishSequencer::Part part{.bytes = &bytes};
+  PublishSequencer::Message next{.route = {}, .parts = {&part, 1}};
+  assert(sequencer.submit(next) && next.first_seq == 2);
+  assert((recorder.seqs == std::vector<uint64_t>{1, 2}));
+
+  std::cout << "[OK] Failed sends use up no seq number\n";
+}
+
+void test_caller_seq() {
+  Recorder recorder;
+  PublishSequencer sequencer(16, recorder.sender());
+
+  auto first = encode_without_seq(1.0);
+  PublishSequencer::Part first_part{.bytes = &first};
+  PublishSequencer::Message data{.route = {}, .parts = {&first_part, 1}};
+  assert(sequencer.submit(data) && sequencer.seq() == 1);
+
+  // Sent as it is, without taking a number from the sequence
+  sparkplug::PayloadBuilder builder;
+  builder.add_metric_by_alias(1, 2.0).set_seq(200);
+  auto own = builder.build();
+  PublishSequencer::Part own_part{.bytes = &own, .assign_seq = false};
+  PublishSequencer::Message caller{.route = {}, .parts = {&own_part, 1}};
+  assert(sequencer.submit(caller) && sequencer.seq() == 1);
+
+  auto next = encode_without_seq(3.0);
+  PublishSequencer::Part next_part{.bytes = &next};
+  PublishSequencer::Message after{.route = {}, .parts = {&next_part, 1}};
+  assert(sequencer.submit(after) && after.first_seq == 2);
+  assert((recorder.seqs == std::vector<uint64_t>{1, 200, 2}));
+
+  std::cout << "[OK] Caller-set seqs use up no seq number\n";
+}
+
+void test_concurrent_producers() {
+  constexpr int threads = 8;
+  constexpr int messages_per_thread = 20000;
+  Recorder recorder;
+  // A small ring also exercises producers waiting for room
+  PublishSequencer sequencer(4, recorder.sender());
+
+  std::vector<std::thread> producers;
+  std::atomic<int> mismatches{0};
+  for (int t = 0; t < threads; t++) {
+    producers.emplace_back([&] {
+      for (int i = 0; i < messages_per_thread; i++) {
+        auto bytes = encode_without_seq(static_cast<double>(i));
+        PublishSequencer::Part part{.bytes = &bytes};
+        PublishSequencer::Message msg{.route = {}, .parts = {&part, 1}};
+        if (!sequencer.submit(msg) || decode_seq(bytes) != msg.first_seq) {
+          mismatches++;
+        }
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+
+  assert(mismatches == 0);
+  assert(recorder.seqs.size() == threads * messages_per_thread);
+  assert_consecutive(recorder.seqs, 1);
+
+  std::cout << std::format("[OK] {} messages from {} threads sent in seq order\n",
+                           recorder.seqs.size(), threads);
+}
+
+void test_broker_order() {
+  constexpr int devices = 8;
+  constexpr int messages_per_device = 2000;
+  constexpr size_t expected = devices * (messages_per_device + 1); // DBIRTHs and DDATA
+
+  std::mutex seqs_mutex;
+  std::vector<uint64_t> seqs;
+  sparkplug::HostApplication::Config host_config{
+      .broker_url = "tcp://localhost:1883",
+      .client_id = "test_sequencer_host",
+      .host_id = "SequencerHost",
+      .validate_sequence = false,
+      .message_callback =
+          [&](const sparkplug::Topic& topic,
+              const org::eclipse::tahu::protobuf::Payload& payload) {
+            if (topic.edge_node_id != "SequencerNode" ||
+                topic.message_type == sparkplug::MessageType::NBIRTH ||
+                topic.message_type == sparkplug::MessageType::NDEATH) {
+              return;
+            }
+            std::scoped_lock lock(seqs_mutex);
+            seqs.push_back(payload.seq());
+          },
+  };
+  sparkplug::HostApplication host(std::move(host_config));
+  if (!host.connect() || !host.subscribe_group("SequencerGroup")) {
+    std::cerr << "[FAIL] Broker order: no broker on localhost:1883\n";
+    std::exit(1);
+  }
+  std::this_thread::sleep_for(200ms);
+
+  sparkplug::EdgeNode node({.broker_url = "tcp://localhost:1883",
+                            .client_id = "test_sequencer_node",
+                            .group_id = "SequencerGroup",
+                            .edge_node_id = "SequencerNode"});
+  assert(node.connect());
+  sparkplug::PayloadBuilder birth;
+  birth.add_metric_with_alias("Value", 1, 0.0);
+  assert(node.publish_birth(birth));
+
+  // One thread per device, all publishing at once on the same node seq
+  std::vector<std::thread> publishers;
+  std::atomic<int> failures{0};
+  for (int d = 0; d < devices; d++) {
+    publishers.emplace_back([&, d] {
+      const auto device_id = std::format("Device{}", d);
+      sparkplug::PayloadBuilder device_birth;
+      device_birth.add_metric_with_alias("Value", 1, 0.0);
+      if (!node.publish_device_birth(device_id, device_birth)) {
+        failures++;
+        return;
+      }
+      for (int i = 0; i < messages_per_device; i++) {
+        sparkplug::PayloadBuilder data;
+        data.add_metric_by_alias(1, static_cast<double>(i));
+        if (!node.publish_device_data(device_id, data)) {
+          failures++;
+        }
+      }
+    });
+  }
+  for (auto& publisher : publishers) {
+    publisher.join();
+  }
+  assert(failures == 0);
+
+  for (int i = 0; i < 200; i++) {
+    {
+      std::scoped_lock lock(seqs_mutex);
+      if (seqs.size() >= expected) {
+        break;
+      }
+    }
+    std::this_thread::sleep_for(50ms);
+  }
+
+  {
+    std::scoped_lock lock(seqs_mutex);
+    assert(seqs.size() == expected);
+    assert_consecutive(seqs, 1); // NBIRTH had seq 0
+  }
+
+  (void)node.disconnect();
+  (void)host.disconnect();
+
+  std::cout << std::format(
+      "[OK] {} DBIRTH/DDATA from {} threads reached the broker gap-free\n", expected,
+      devices);
+}
+
+int main() {
+  std::cout << "=== PublishSequencer Tests ===\n\n";
+
+  test_parts_and_restart();
+  test_failed_send_keeps_seq();
+  test_caller_seq();
+  test_concurrent_producers();
+  test_broker_order();
+
+  std::cout << "\n=== All PublishSequencer tests passed! ===\n";
+  return 0;
+}
@@ -0,0 +1,320 @@
+// tests/test_publish_tracker.cpp
+// Unit tests for PublishTracker, the pooled completion slots behind publish_*_async();
+// the MQTT client is simulated by invoking the response options' callbacks directly
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <MQTTAsync.h>
+#include <sparkplug/publish_tracker.hpp>
+
+using namespace std::chrono_literals;
+using sparkplug::PublishResult;
+using sparkplug::PublishToken;
+using sparkplug::PublishTracker;
+
+namespace {
+
+// What the MQTT client would do once a send prepared with opts is written or fails
+void report_success(const MQTTAsync_responseOptions& opts) {
+  MQTTAsync_successData data{};
+  opts.onSuccess(opts.context, &data);
+}
+
+void report_failure(const MQTTAsync_responseOptions& opts, int code) {
+  MQTTAsync_failureData data{};
+  data.code = code;
+  opts.onFailure(opts.context, &data);
+}
+
+} // namespace
+
+void test_single_send() {
+  auto tracker = std::make_shared<PublishTracker>(4);
+  int calls = 0;
+  PublishResult seen = sparkplug::stdx::unexpected("not called");
+
+  MQTTAsync_responseOptions opts = MQTTAsync_responseOptions_initializer;
+  auto token = tracker->publish(
+      [&](const PublishResult& result) {
+        calls++;
+        seen = result;
+      },
+      1s,
+      [&](const PublishToken& t) -> PublishResult {
+        tracker->prepare(t, opts);
+        return {};
+      });
+  assert(token && token->valid());
+  assert(!token->ready());
+  assert(calls == 0);
+  assert(tracker->in_flight() == 1);
+
+  report_success(opts);
+  assert(calls == 1 && seen.has_value());
+  assert(token->ready() && token->wait().has_value());
+  assert(tracker->in_flight() == 0);
+
+  std::cout << "[OK] Callback and token report a completed send once\n";
+}
+
+void test_failed_send() {
+  auto tracker = std::make_shared<PublishTracker>(4);
+  std::string error;
+
+  MQTTAsync_responseOptions opts = MQTTAsync_responseOptions_initializer;
+  auto on_complete = [&](const PublishResult& result) { error = result.error(); };
+  auto token =
+      tracker->publish(on_complete, 1s, [&](const PublishToken& t) -> PublishResult {
+        tracker->prepare(t, opts);
+        return {};
+      });
+  assert(token);
+  report_failure(opts, -3);
+  assert(error == "Publish failed: code=-3");
+  assert(!token->wait().has_value());
+
+  std::cout << "[OK] MQTT failures reach the callback and token\n";
+}
+
+void test_multi_send() {
+  auto tracker = std::make_shared<PublishTracker>(4);
+  int calls = 0;
+  PublishResult seen;
+
+  // A split payload: three chunks, the second one fails
+  std::vector<MQTTAsync_responseOptions> opts(3, MQTTAsync_responseOptions_initializer);
+  auto token = tracker->publish(
+      [&](const PublishResult& result) {
+        calls++;
+        seen = result;
+      },
+      1s,
+      [&](const PublishToken& t) -> PublishResult {
+        for (auto& o : opts) {
+          tracker->prepare(t, o);
+        }
+        return {};
+      });
+  assert(token);
+
+  report_success(opts[0]);
+  report_failure(opts[1], 7);
+  assert(calls == 0 && !token->ready());
+  report_success(opts[2]);
+  assert(calls == 1 && !seen.has_value());
+  assert(seen.error() == "Publish failed: code=7");
+
+  std::cout << "[OK] Multi-message publishes complete with their last message\n";
+}
+
+void test_completion_before_finish() {
+  auto tracker = std::make_shared<PublishTracker>(4);
+  int calls = 0;
+
+  // The MQTT client may report a send before the publishing call has returned
+  auto token = tracker->publish([&](const PublishResult&) { calls++; }, 1s,
+                                [&](const PublishToken& t) -> PublishResult {
+                                  MQTTAsync_responseOptions opts =
+                                      MQTTAsync_responseOptions_initializer;
+                                  tracker->prepare(t, opts);
+                                  report_success(opts);
+                                  assert(calls == 0);
+                                  return {};
+                                });
+  assert(token && token->ready());
+  assert(calls == 1);
+
+  std::cout << "[OK] Publishes stay open until the publishing call returns\n";
+}
+
+void test_send_error_discards() {
+  auto tracker = std::make_shared<PublishTracker>(1);
+  const std::string send_error = "Failed to publish: -3";
+  int calls = 0;
+
+  auto token = tracker->publish([&](const PublishResult&) { calls++; }, 1s,
+                                [&](const PublishToken& t) -> PublishResult {
+                                  MQTTAsync_responseOptions opts =
+                                      MQTTAsync_responseOptions_initializer;
+                                  tracker->prepare(t, opts);
+                                  tracker->fail(t, send_error);
+                                  return sparkplug::stdx::unexpected(send_error);
+                                });
+  assert(!token && token.error() == send_error);
+  assert(calls == 0);
+  assert(tracker->in_flight() == 0);
+
+  // The slot was returned to the pool
+  auto next = tracker->start({}, 0ms);
+  assert(next);
+
+  std::cout << "[OK] Errors returned to the caller never reach the callback\n";
+}
+
+void test_backpressure() {
+  auto tracker = std::make_shared<PublishTracker>(2);
+
+  std::vector<MQTTAsync_responseOptions> opts(2, MQTTAsync_responseOptions_initializer);
+  std::vector<PublishToken> tokens;
+  for (auto& o : opts) {
+    auto token = tracker->publish({}, 1s, [&](const PublishToken& t) -> PublishResult {
+      tracker->prepare(t, o);
+      return {};
+    });
+    assert(token);
+    tokens.push_back(std::move(*token));
+  }
+
+  auto full = tracker->start({}, 20ms);
+  assert(!full && full.error() == "2 publishes already in flight");
+
+  // A completed publish keeps its slot while its token is alive
+  report_success(opts[0]);
+  assert(!tracker->start({}, 0ms));
+  tokens[0] = PublishToken();
+  auto reused = tracker->start({}, 0ms);
+  assert(reused);
+  tracker->discard(*reused);
+  *reused = PublishToken();
+
+  // A waiting publisher proceeds as soon as a slot frees up
+  auto blocker = tracker->start({}, 0ms);
+  assert(blocker);
+  std::atomic<bool> started{false};
+  std::thread waiter([&] {
+    auto token = tracker->start({}, 5s);
+    assert(token);
+    started = true;
+    tracker->discard(*token);
+  });
+  tokens.clear();
+  std::this_thread::sleep_for(20ms);
+  assert(!started);
+  report_success(opts[1]); // Its token is gone, so the slot is freed right away
+  waiter.join();
+  assert(started);
+  tracker->discard(*blocker);
+
+  std::cout << "[OK] Full pools block new publishes until a slot frees up\n";
+}
+
+void test_abandon() {
+  auto tracker = std::make_shared<PublishTracker>(4);
+  std::string error;
+
+  MQTTAsync_responseOptions opts = MQTTAsync_responseOptions_initializer;
+  auto on_complete = [&](const PublishResult& result) { error = result.error(); };
+  auto token =
+      tracker->publish(on_complete, 1s, [&](const PublishToken& t) -> PublishResult {
+        tracker->prepare(t, opts);
+        return {};
+      });
+  assert(token);
+
+  auto abandoned = tracker->abandon("client destroyed");
+  assert(error.empty() && abandoned.size() == 1);
+  PublishTracker::run(abandoned);
+  assert(error == "client destroyed");
+  assert(token->ready() && token->wait().error() == "client destroyed");
+  assert(tracker->in_flight() == 0);
+
+  std::cout << "[OK] Abandoned sends fail their publishes\n";
+}
+
+void test_late_report_after_abandon() {
+  auto tracker = std::make_shared<PublishTracker>(1);
+
+  MQTTAsync_responseOptions old_opts = MQTTAsync_responseOptions_initializer;
+  auto old_token = tracker->publish({}, 1s, [&](const PublishToken& t) -> PublishResult {
+    tracker->prepare(t, old_opts);
+    return {};
+  });
+  assert(old_token);
+  auto abandoned = tracker->abandon("client destroyed");
+  assert(abandoned.empty()); // No callback
+  *old_token = PublishToken();
+
+  // The only slot is reused by a publish on the new client
+  PublishResult seen = sparkplug::stdx::unexpected("not called");
+  MQTTAsync_responseOptions new_opts = MQTTAsync_responseOptions_initializer;
+  auto token = tracker->publish([&](const PublishResult& result) { seen = result; }, 1s,
+                                [&](const PublishToken& t) -> PublishResult {
+                                  tracker->prepare(t, new_opts);
+                                  return {};
+                                });
+  assert(token);
+
+  // The replaced client flushes its pending send on destruction
+  report_failure(old_opts, -9);
+  assert(!token->ready());
+  report_success(new_opts);
+  assert(token->ready() && seen.has_value());
+  assert(tracker->in_flight() == 0);
+
+  std::cout << "[OK] Reports from a replaced client do not reach a reused slot\n";
+}
+
+void test_wait_across_threads() {
+  constexpr int publishes = 1000;
+  auto tracker = std::make_shared<PublishTracker>(64);
+  std::atomic<int> completed{0};
+
+  // A simulated MQTT client thread reports sends in order, like Paho's
+  std::vector<MQTTAsync_responseOptions> pending(publishes);
+  std::atomic<int> sent{0};
+  std::thread client([&] {
+    for (int i = 0; i < publishes; i++) {
+      while (sent.load() <= i) {
+        std::this_thread::yield();
+      }
+      report_success(pending[i]);
+    }
+  });
+
+  std::vector<PublishToken> tokens;
+  for (int i = 0; i < publishes; i++) {
+    auto token = tracker->publish([&](const PublishResult&) { completed++; }, 5s,
+                                  [&](const PublishToken& t) -> PublishResult {
+                                    pending[i] = MQTTAsync_responseOptions_initializer;
+                                    tracker->prepare(t, pending[i]);
+                                    sent++;
+                                    return {};
+                                  });
+    assert(token);
+    if (i % 100 == 0) {
+      tokens.push_back(std::move(*token)); // Others release their slot on completion
+    }
+  }
+  for (auto& token : tokens) {
+    auto result = token.wait_for(5s);
+    assert(result && result->has_value());
+  }
+  client.join();
+  assert(completed == publishes);
+  assert(tracker->in_flight() == 0);
+
+  std::cout << "[OK] 1000 publishes pipelined through 64 slots\n";
+}
+
+int main() {
+  std::cout << "=== PublishTracker Tests ===\n\n";
+
+  test_single_send();
+  test_failed_send();
+  test_multi_send();
+  test_completion_before_finish();
+  test_send_error_discards();
+  test_backpressure();
+  test_abandon();
+  test_late_report_after_abandon();
+  test_wait_across_threads();
+
+  std::cout << "\n=== All PublishTracker tests passed! ===\n";
+  return 0;
+}
@@ -0,0 +1,142 @@
+// tests/test_reconnect.cpp
+// Automatic reconnect: a node whose session is taken over by another client with the
+// same client ID reconnects on its own, re-sends NBIRTH (next bdSeq) and DBIRTH, and
+// reports how long the first NDATA took (needs a broker on localhost:1883)
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sparkplug/edge_node.hpp>
+#include <sparkplug/host_application.hpp>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+struct Received {
+  sparkplug::MessageType type;
+  std::string device_id;
+  std::optional<uint64_t> bd_seq;
+  uint64_t seq;
+};
+
+std::mutex received_mutex;
+std::vector<Received> received;
+
+void record(const sparkplug::Topic& topic,
+            const org::eclipse::tahu::protobuf::Payload& payload) {
+  if (topic.edge_node_id != "ReconnectNode") {
+    return;
+  }
+  Received message{topic.message_type, topic.device_id, std::nullopt, payload.seq()};
+  for (const auto& metric : payload.metrics()) {
+    if (metric.name() == "bdSeq") {
+      message.bd_seq = metric.long_value();
+    }
+  }
+  std::scoped_lock lock(received_mutex);
+  received.push_back(std::move(message));
+}
+
+size_t count(sparkplug::MessageType type) {
+  std::scoped_lock lock(received_mutex);
+  size_t n = 0;
+  for (const auto& message : received) {
+    n += message.type == type;
+  }
+  return n;
+}
+
+} // namespace
+
+int main() {
+  std::cout << "=== Automatic Reconnect Tests ===\n\n";
+
+  sparkplug::HostApplication host({.broker_url = "tcp://localhost:1883",
+                                   .client_id = "test_reconnect_host",
+                                   .host_id = "ReconnectHost",
+                                   .validate_sequence = false,
+                                   .message_callback = record});
+  if (!host.connect() || !host.subscribe_group("ReconnectGroup")) {
+    std::cerr << "[FAIL] No broker on localhost:1883\n";
+    return 1;
+  }
+  std::this_thread::sleep_for(200ms);
+
+  sparkplug::EdgeNode node(
+      {.broker_url = "tcp://localhost:1883",
+       .client_id = "test_reconnect_node",
+       .group_id = "ReconnectGroup",
+       .edge_node_id = "ReconnectNode",
+       .auto_reconnect = sparkplug::EdgeNode::ReconnectOptions{.initial_delay = 50ms}});
+  assert(node.connect());
+  sparkplug::PayloadBuilder birth;
+  birth.add_metric_with_alias("Value", 1, 0.0);
+  assert(node.publish_birth(birth));
+  sparkplug::PayloadBuilder device_birth;
+  device_birth.add_metric_with_alias("Value", 1, 0.0);
+  assert(node.publish_device_birth("Dev", device_birth));
+  assert(!node.last_reconnect());
+
+  // A second client with the same ID makes the broker drop the node's connection
+  sparkplug::EdgeNode intruder({.broker_url = "tcp://localhost:1883",
+                                .client_id = "test_reconnect_node",
+                                .group_id = "ReconnectGroup",
+                                .edge_node_id = "Intruder"});
+  assert(intruder.connect());
+  (void)intruder.disconnect();
+
+  for (int i = 0; i < 200 && !node.last_reconnect(); i++) {
+    std::this_thread::sleep_for(20ms);
+  }
+  auto report = node.last_reconnect();
+  assert(report && report->attempts >= 1 && !report->first_data);
+
+  sparkplug::PayloadBuilder data;
+  data.add_metric_by_alias(1, 42.0);
+  assert(node.publish_data(data));
+  report = node.last_reconnect();
+  assert(report && report->first_data && *report->first_data >= report->session_ready);
+
+  for (int i = 0; i < 100 && count(sparkplug::MessageType::NDATA) == 0; i++) {
+    std::this_thread::sleep_for(20ms);
+  }
+
+  {
+    std::scoped_lock lock(received_mutex);
+    // NBIRTH, DBIRTH, NDEATH (the Will), NBIRTH, DBIRTH, NDATA
+    std::vector<sparkplug::MessageType> types;
+    for (const auto& message : received) {
+      types.push_back(message.type);
+    }
+    using enum sparkplug::MessageType;
+    assert((types == std::vector{NBIRTH, DBIRTH, NDEATH, NBIRTH, DBIRTH, NDATA}));
+
+    assert(received[0].bd_seq == 1 && received[2].bd_seq == 1);
+    assert(received[3].bd_seq == 2 && received[3].seq == 0);
+    assert(received[4].device_id == "Dev" && received[4].seq == 1);
+    assert(received[5].seq == 2);
+  }
+  std::cout << std::format("[OK] Reconnected after {} attempt(s); births re-sent in "
+                           "{} us, first NDATA after {} us\n",
+                           report->attempts, report->session_ready.count(),
+                           report->first_data->count());
+
+  // A disconnect() by the application is not reconnected
+  assert(node.disconnect());
+  std::this_thread::sleep_for(300ms);
+  assert(!node.publish_data(data));
+  std::cout << "[OK] disconnect() is not undone by the reconnect thread\n";
+
+  (void)host.disconnect();
+
+  std::cout << "\n=== All automatic reconnect tests passed! ===\n";
+  return 0;
+}
@@ -0,0 +1,305 @@
+// tests/test_store_forward.cpp
+// StoreForwardBuffer unit tests, then an EdgeNode outage: NDATA/DDATA published while
+// disconnected are replayed as historical after the next NBIRTH/DBIRTH (needs a broker
+// on localhost:1883)
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <sparkplug/edge_node.hpp>
+#include <sparkplug/host_application.hpp>
+#include <sparkplug/store_forward_buffer.hpp>
+
+using namespace std::chrono_literals;
+using sparkplug::StoreForwardBuffer;
+
+namespace {
+
+std::vector<uint8_t> record_bytes(size_t size, uint8_t fill) {
+  return std::vector<uint8_t>(size, fill);
+}
+
+std::unique_ptr<StoreForwardBuffer> open_buffer(StoreForwardBuffer::Options options) {
+  auto buffer = StoreForwardBuffer::open(std::move(options));
+  assert(buffer);
+  return std::move(*buffer);
+}
+
+} // namespace
+
+void test_fifo_and_wrap() {
+  auto buffer = open_buffer({.capacity_bytes = 100});
+  assert(buffer->empty());
+
+  std::string device_id;
+  std::vector<uint8_t> payload;
+  // 30-byte records: the ring wraps around every few pushes, often mid-record
+  for (int i = 0; i < 50; i++) {
+    auto device = std::format("D{}", i % 3);
+    assert(buffer->push(device, record_bytes(20, static_cast<uint8_t>(i))));
+    auto position = buffer->front(device_id, payload);
+    assert(position && device_id == device);
+    assert(payload == record_bytes(20, static_cast<uint8_t>(i)));
+    buffer->pop(*position);
+    assert(buffer->empty());
+  }
+
+  assert(buffer->push("", record_bytes(5, 1)));
+  assert(buffer->push("Dev", record_bytes(7, 2)));
+  auto stats = buffer->stats();
+  assert(stats.records == 2 && stats.bytes == 8 + 5 + 8 + 3 + 7);
+
+  auto first = buffer->front(device_id, payload);
+  assert(first && device_id.empty() && payload == record_bytes(5, 1));
+  buffer->pop(*first);
+  auto second = buffer->front(device_id, payload);
+  assert(second && device_id == "Dev" && payload == record_bytes(7, 2));
+
+  std::cout << "[OK] Records come out in order across the ring's end\n";
+}
+
+void test_eviction() {
+  // Room for three 30-byte records
+  auto oldest = open_buffer({.capacity_bytes = 100});
+  for (uint8_t i = 0; i < 5; i++) {
+    assert(oldest->push("", record_bytes(22, i)));
+  }
+  std::string device_id;
+  std::vector<uint8_t> payload;
+  assert(oldest->front(device_id, payload) && payload == record_bytes(22, 2));
+  assert(oldest->stats().records == 3 && oldest->stats().evicted == 2);
+
+  auto newest = open_buffer(
+      {.capacity_bytes = 100, .eviction = StoreForwardBuffer::Eviction::DropNewest});
+  for (uint8_t i = 0; i < 5; i++) {
+    assert(newest->push("", record_bytes(22, i)) == (i < 3));
+  }
+  assert(newest->front(device_id, payload) && payload == record_bytes(22, 0));
+  assert(newest->stats().records == 3 && newest->stats().rejected == 2);
+
+  // Larger than the whole ring: rejected under either policy
+  assert(!oldest->push("", record_bytes(100, 0)));
+  assert(oldest->stats().records == 3 && oldest->stats().rejected == 1);
+
+  std::cout << "[OK] DropOldest evicts, DropNewest and oversized records are rejected\n";
+}
+
+void test_pop_after_eviction() {
+  auto buffer = open_buffer({.capacity_bytes = 100});
+  for (uint8_t i = 0; i < 3; i++) {
+    assert(buffer->push("", record_bytes(22, i)));
+  }
+  std::string device_id;
+  std::vector<uint8_t> payload;
+  auto position = buffer->front(device_id, payload);
+  assert(position);
+
+  // Evicts the record being replayed; popping it must not drop its successor
+  assert(buffer->push("", record_bytes(22, 3)));
+  buffer->pop(*position);
+  assert(buffer->front(device_id, payload) && payload == record_bytes(22, 1));
+  assert(buffer->stats().records == 3);
+
+  std::cout << "[OK] pop() leaves a record that replaced an evicted one\n";
+}
+
+void test_requeue() {
+  std::string device_id;
+  std::vector<uint8_t> payload;
+  // A full ring (three 30-byte records in 100 bytes) and one with room to spare
+  for (size_t capacity : {100, 200}) {
+    auto buffer = open_buffer({.capacity_bytes = capacity});
+    for (uint8_t i = 0; i < 3; i++) {
+      assert(buffer->push(std::format("D{}", i), record_bytes(20, i)));
+    }
+    auto position = buffer->front(device_id, payload);
+    assert(position && buffer->requeue(*position));
+    // Already moved: a stale position is left alone
+    assert(!buffer->requeue(*position));
+    assert(buffer->stats().records == 3 && buffer->stats().bytes == 90);
+
+    for (uint8_t expected : {1, 2, 0}) {
+      auto next = buffer->front(device_id, payload);
+      assert(next && device_id == std::format("D{}", expected));
+      assert(payload == record_bytes(20, expected));
+      buffer->pop(*next);
+    }
+    assert(buffer->empty());
+  }
+
+  std::cout << "[OK] requeue() moves the oldest record behind the newest\n";
+}
+
+void test_file_backing() {
+  auto path = std::filesystem::temp_directory_path() /
+              std::format("sparkplug_store_forward_{}.buf", ::getpid());
+  std::filesystem::remove(path);
+  StoreForwardBuffer::Options options{
+      .capacity_bytes = 4096, .file_path = path.string(), .durable = true};
+
+  {
+    auto buffer = open_buffer(options);
+    for (uint8_t i = 0; i < 3; i++) {
+      assert(buffer->push(std::format("Dev{}", i), record_bytes(100, i)));
+    }
+    std::string device_id;
+    std::vector<uint8_t> payload;
+    buffer->pop(*buffer->front(device_id, payload));
+  }
+
+  {
+    auto buffer = open_buffer(options);
+    assert(buffer->stats().records == 2);
+    std::string device_id;
+    std::vector<uint8_t> payload;
+    auto position = buffer->front(device_id, payload);
+    assert(position && device_id == "Dev1" && payload == record_bytes(100, 1));
+  }
+
+  auto resized =
+      StoreForwardBuffer::open({.capacity_bytes = 8192, .file_path = path.string()});
+  assert(!resized);
+
+  std::filesystem::remove(path);
+  std::cout << "[OK] A file-backed buffer keeps its records across reopening\n";
+}
+
+void test_edge_node_replay() {
+  struct Received {
+    std::string device_id;
+    double value;
+    bool historical;
+  };
+  std::mutex received_mutex;
+  std::vector<Received> received;
+
+  sparkplug::HostApplication::Config host_config{
+      .broker_url = "tcp://localhost:1883",
+      .client_id = "test_store_forward_host",
+      .host_id = "StoreForwardHost",
+      .validate_sequence = false,
+      .message_callback =
+          [&](const sparkplug::Topic& topic,
+              const org::eclipse::tahu::protobuf::Payload& payload) {
+            if (topic.message_type != sparkplug::MessageType::NDATA &&
+                topic.message_type != sparkplug::MessageType::DDATA) {
+              return;
+            }
+            std::scoped_lock lock(received_mutex);
+            for (const auto& metric : payload.metrics()) {
+              received.push_back({topic.device_id, metric.double_value(),
+                                  metric.is_historical()});
+            }
+          },
+  };
+  sparkplug::HostApplication host(std::move(host_config));
+  if (!host.connect() || !host.subscribe_group("StoreForwardGroup")) {
+    std::cerr << "[FAIL] Edge node replay: no broker on localhost:1883\n";
+    std::exit(1);
+  }
+  std::this_thread::sleep_for(200ms);
+
+  sparkplug::EdgeNode node({.broker_url = "tcp://localhost:1883",
+                            .client_id = "test_store_forward_node",
+                            .group_id = "StoreForwardGroup",
+                            .edge_node_id = "StoreForwardNode",
+                            .store_forward = StoreForwardBuffer::Options{},
+                            .store_forward_drain_rate = 200});
+  auto node_birth = [&] {
+    sparkplug::PayloadBuilder birth;
+    birth.add_metric_with_alias("Value", 1, 0.0);
+    assert(node.publish_birth(birth));
+  };
+  auto device_birth = [&] {
+    sparkplug::PayloadBuilder birth;
+    birth.add_metric_with_alias("Value", 1, 0.0);
+    assert(node.publish_device_birth("Dev", birth));
+  };
+  auto publish = [&](std::string_view device_id, double value) {
+    sparkplug::PayloadBuilder data;
+    data.add_metric_by_alias(1, value);
+    return device_id.empty() ? node.publish_data(data)
+                             : node.publish_device_data(device_id, data);
+  };
+
+  assert(node.connect());
+  node_birth();
+  device_birth();
+
+  // Outage: publishes succeed and are stored
+  assert(node.disconnect());
+  for (int i = 0; i < 20; i++) {
+    assert(publish("", i));
+  }
+  for (int i = 0; i < 5; i++) {
+    assert(publish("Dev", 100 + i));
+  }
+  assert(!publish("NeverBorn", 0)); // Unknown devices are not stored
+  assert(node.store_forward_stats().records == 25);
+
+  // Back online: NDATA replay after NBIRTH, DDATA only after the new DBIRTH
+  assert(node.connect());
+  node_birth();
+  assert(publish("", 1000)); // Live data is not held back by the backlog
+  std::this_thread::sleep_for(300ms);
+  device_birth();
+
+  for (int i = 0; i < 200 && node.store_forward_stats().records > 0; i++) {
+    std::this_thread::sleep_for(20ms);
+  }
+  assert(node.store_forward_stats().records == 0);
+  std::this_thread::sleep_for(200ms);
+
+  {
+    std::scoped_lock lock(received_mutex);
+    std::vector<double> historical_node;
+    std::vector<double> historical_device;
+    size_t live_position = received.size();
+    for (size_t i = 0; i < received.size(); i++) {
+      const auto& message = received[i];
+      if (message.historical) {
+        (message.device_id.empty() ? historical_node : historical_device)
+            .push_back(message.value);
+      } else if (message.value == 1000) {
+        live_position = i;
+      }
+    }
+    assert(historical_node.size() == 20 && historical_device.size() == 5);
+    for (int i = 0; i < 20; i++) {
+      assert(historical_node[i] == i);
+    }
+    for (int i = 0; i < 5; i++) {
+      assert(historical_device[i] == 100 + i);
+    }
+    // Replay is paced (200/s), so the live NDATA went out before most of it
+    assert(live_position < received.size() - 10);
+  }
+
+  (void)node.disconnect();
+  (void)host.disconnect();
+  std::cout << "[OK] Stored NDATA/DDATA replayed as historical after the next births\n";
+}
+
+int main() {
+  std::cout << "=== Store and Forward Tests ===\n\n";
+
+  test_fifo_and_wrap();
+  test_eviction();
+  test_pop_after_eviction();
+  test_requeue();
+  test_file_backing();
+  test_edge_node_replay();
+
+  std::cout << "\n=== All store and forward tests passed! ===\n";
+  return 0;
+}
@@ -0,0 +1,119 @@
+// tests/test_striped_map.cpp
+// Unit tests for StripedMap (see tests/bench/bench_striped_map.cpp for the lock
+// contention benchmark)
+#include <cassert>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <sparkplug/striped_map.hpp>
+
+namespace {
+
+struct StringHash {
+  using is_transparent = void;
+  size_t operator()(std::string_view str) const noexcept {
+    return std::hash<std::string_view>{}(str);
+  }
+};
+
+// Stand-in for HostApplication::NodeState
+struct Node {
+  uint64_t last_seq{255};
+  uint64_t messages{0};
+  uint64_t gaps{0};
+};
+
+using NodeMap = sparkplug::StripedMap<std::string, Node, StringHash, std::equal_to<>>;
+
+std::vector<std::string> node_names(size_t count) {
+  std::vector<std::string> names;
+  names.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    names.push_back(std::format("Plant{}/Gateway{:04}", i % 4, i));
+  }
+  return names;
+}
+
+// Per-message validation work, as done under the node's lock
+void apply_data(Node& node, uint64_t seq) {
+  if (seq != (node.last_seq + 1) % 256) {
+    node.gaps++;
+  }
+  node.last_seq = seq;
+  node.messages++;
+}
+
+} // namespace
+
+void test_update_and_visit() {
+  NodeMap map(5);
+  assert(map.stripe_count() == 8);
+  assert(map.size() == 0);
+
+  assert(!map.visit(std::string_view("missing"), [](const Node&) { assert(false); }));
+
+  uint64_t seen = map.update("Gateway01", [](Node& node) {
+    apply_data(node, 0);
+    return node.messages;
+  });
+  assert(seen == 1);
+
+  uint64_t last_seq = 0;
+  assert(map.visit(std::string_view("Gateway01"),
+                   [&](const Node& node) { last_seq = node.last_seq; }));
+  assert(last_seq == 0);
+
+  for (const auto& name : node_names(100)) {
+    map.update(name, [](Node& node) { node.messages = 7; });
+  }
+  assert(map.size() == 101);
+
+  size_t visited = 0;
+  map.for_each([&](const std::string&, const Node&) { visited++; });
+  assert(visited == 101);
+
+  std::cout << "[OK] update() creates entries, visit() finds them by string_view\n";
+}
+
+void test_concurrent_updates() {
+  constexpr size_t threads = 8;
+  constexpr uint64_t per_thread = 50000;
+  const auto names = node_names(64);
+  NodeMap map;
+
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < threads; t++) {
+    workers.emplace_back([&, t] {
+      for (uint64_t i = 0; i < per_thread; i++) {
+        const auto& name = names[(t * 7 + i) % names.size()];
+        map.update(name, [](Node& node) { node.messages++; });
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  uint64_t total = 0;
+  map.for_each([&](const std::string&, const Node& node) { total += node.messages; });
+  assert(total == threads * per_thread);
+  assert(map.size() == names.size());
+
+  std::cout << std::format("[OK] {} concurrent updates, none lost\n", total);
+}
+
+int main() {
+  std::cout << "=== StripedMap Tests ===\n\n";
+
+  test_update_and_visit();
+  test_concurrent_updates();
+
+  std::cout << "\n=== All StripedMap tests passed! ===\n";
+  return 0;
+}
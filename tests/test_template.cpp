@@ -0,0 +1,144 @@
+// tests/test_template.cpp
+// Unit tests for Template (UDT) definitions, instance encoding and the EdgeNode registry
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include <sparkplug/edge_node.hpp>
+#include <sparkplug/payload_builder.hpp>
+#include <sparkplug/template.hpp>
+#include <sparkplug/wire.hpp>
+
+namespace {
+
+using Motor = sparkplug::TemplateLayout<double, bool, int32_t, std::string_view>;
+
+const Motor& motor_layout() {
+  static const Motor motor("Motor", {"Speed", "Running", "Faults", "Mode"}, "v1");
+  return motor;
+}
+
+std::vector<uint8_t> serialize(const google::protobuf::MessageLite& message) {
+  std::vector<uint8_t> buffer(message.ByteSizeLong());
+  [[maybe_unused]] bool ok =
+      message.SerializeToArray(buffer.data(), static_cast<int>(buffer.size()));
+  assert(ok);
+  return buffer;
+}
+
+} // namespace
+
+void test_definition() {
+  const auto& definition = motor_layout().definition();
+  assert(definition.name() == "Motor");
+  assert(definition.members().size() == 4);
+  assert(definition.members()[2].type == sparkplug::DataType::Int32);
+  assert(definition.members()[3].type == sparkplug::DataType::String);
+
+  sparkplug::PayloadBuilder birth;
+  birth.add_template_definition(definition);
+  const auto& metric = birth.payload().metrics(0);
+  assert(metric.name() == "_types_/Motor");
+  assert(metric.datatype() == std::to_underlying(sparkplug::DataType::Template));
+  const auto& tmpl = metric.template_value();
+  assert(tmpl.is_definition());
+  assert(tmpl.version() == "v1");
+  assert(!tmpl.has_template_ref());
+  assert(tmpl.metrics_size() == 4);
+  assert(tmpl.metrics(0).name() == "Speed");
+  assert(tmpl.metrics(1).datatype() == std::to_underlying(sparkplug::DataType::Boolean));
+
+  std::cout << "[OK] Definitions are published as _types_/<name> with is_definition\n";
+}
+
+void test_instance() {
+  sparkplug::PayloadBuilder birth;
+  birth.add_template_with_alias("Motor1", 30, motor_layout(), {1500.0, true, -2, "auto"});
+  birth.add_template_by_alias(31, motor_layout(), {0.0, false, 0, ""});
+
+  const auto& metric = birth.payload().metrics(0);
+  assert(metric.name() == "Motor1");
+  assert(metric.alias() == 30);
+  assert(metric.datatype() == std::to_underlying(sparkplug::DataType::Template));
+  const auto& tmpl = metric.template_value();
+  assert(!tmpl.is_definition());
+  assert(tmpl.template_ref() == "Motor");
+  assert(tmpl.metrics(0).name() == "Speed" && tmpl.metrics(0).double_value() == 1500.0);
+  assert(tmpl.metrics(1).boolean_value());
+  assert(static_cast<int32_t>(tmpl.metrics(2).int_value()) == -2);
+  assert(tmpl.metrics(3).string_value() == "auto");
+  assert(!birth.payload().metrics(1).has_name());
+
+  std::cout << "[OK] Instances carry values and template_ref\n";
+}
+
+void test_direct_encoding() {
+  sparkplug::PayloadBuilder data;
+  data.set_timestamp(1700000000000);
+  data.add_template_by_alias(30, motor_layout(), {1480.5, true, 7, "manual"});
+  data.set_seq(9);
+  const auto& pb_metric = data.payload().metrics(0);
+
+  std::vector<uint8_t> instance;
+  motor_layout().encode_instance_into(instance, {1480.5, true, 7, "manual"});
+  assert(instance == serialize(pb_metric.template_value()));
+
+  std::vector<uint8_t> fixed(instance.size());
+  auto written = motor_layout().encode_instance_into(std::span<uint8_t>(fixed),
+                                                     {1480.5, true, 7, "manual"});
+  assert(written.has_value() && *written == instance.size());
+  assert(fixed == instance);
+  std::vector<uint8_t> small(instance.size() - 1);
+  [[maybe_unused]] auto too_small = motor_layout().encode_instance_into(
+      std::span<uint8_t>(small), {1480.5, true, 7, "manual"});
+  assert(!too_small.has_value());
+
+  sparkplug::wire::Encoder encoder;
+  encoder.set_timestamp(1700000000000);
+  encoder.add_metric({.alias = 30,
+                      .timestamp = pb_metric.timestamp(),
+                      .datatype = sparkplug::DataType::Template,
+                      .value = sparkplug::wire::TemplateBytes{instance}});
+  encoder.set_seq(9);
+  std::vector<uint8_t> wire_bytes;
+  encoder.encode_into(wire_bytes);
+  assert(wire_bytes == serialize(data.payload()));
+
+  std::cout << "[OK] encode_instance_into() matches the protobuf instance\n";
+}
+
+void test_registry() {
+  sparkplug::EdgeNode::Config config{.broker_url = "tcp://localhost:1883",
+                                     .client_id = "template_test",
+                                     .group_id = "Energy",
+                                     .edge_node_id = "Node1"};
+  sparkplug::EdgeNode node(std::move(config));
+
+  assert(node.register_template(motor_layout().definition()).has_value());
+  // Re-registering the same definition is a no-op
+  assert(node.register_template(motor_layout().definition()).has_value());
+
+  sparkplug::TemplateDefinition other("Motor");
+  other.add_member("Speed", sparkplug::DataType::Float);
+  assert(!node.register_template(other).has_value());
+
+  sparkplug::TemplateDefinition pump("Pump");
+  pump.add_member("Flow", sparkplug::DataType::Double);
+  assert(node.register_template(pump).has_value());
+
+  std::cout << "[OK] EdgeNode registry rejects conflicting definitions\n";
+}
+
+int main() {
+  std::cout << "=== Template Tests ===\n\n";
+
+  test_definition();
+  test_instance();
+  test_direct_encoding();
+  test_registry();
+
+  std::cout << "\n=== All template tests passed! ===\n";
+  return 0;
+}
@@ -1,6 +1,9 @@
 // tests/test_topic.cpp
+#include <array>
 #include <cassert>
 #include <iostream>
+#include <string>
+#include <string_view>
 
 #include <sparkplug/topic.hpp>
 
@@ -71,6 +74,68 @@ void test_parse_state_topic() {
   std::cout << "[OK] Parse STATE topic\n";
 }
 
+void test_topic_view_parse() {
+  std::string buffer = "spBv1.0/Energy/DDATA/Gateway01/Sensor01";
+  auto result = sparkplug::TopicView::parse(buffer);
+  assert(result.has_value());
+
+  // Fields point into the parsed string
+  [[maybe_unused]] auto& view = *result;
+  assert(view.group_id == "Energy" && view.group_id.data() == buffer.data() + 8);
+  assert(view.message_type == sparkplug::MessageType::DDATA);
+  assert(view.edge_node_id == "Gateway01");
+  assert(view.device_id == "Sensor01");
+
+  auto topic = view.to_topic();
+  assert(topic.to_string() == buffer);
+  [[maybe_unused]] sparkplug::TopicView round_trip = topic;
+  assert(round_trip.edge_node_id == "Gateway01" && round_trip.device_id == "Sensor01");
+  std::cout << "[OK] TopicView parse without copying\n";
+}
+
+void test_topic_view_errors_match_topic() {
+  for (const char* bad : {"", "spBv1.0", "spBv2.0/G/NDATA/N", "spBv1.0/STATE",
+                          "spBv1.0/G/NDATA", "spBv1.0/G/NFOO/N"}) {
+    auto view = sparkplug::TopicView::parse(bad);
+    auto topic = sparkplug::Topic::parse(bad);
+    assert(!view.has_value() && !topic.has_value());
+    assert(view.error() == topic.error());
+  }
+
+  auto state = sparkplug::TopicView::parse("spBv1.0/STATE/scada_host");
+  assert(state && state->message_type == sparkplug::MessageType::STATE);
+  assert(state->edge_node_id == "scada_host" && state->group_id.empty());
+  std::cout << "[OK] TopicView accepts and rejects the same topics as Topic\n";
+}
+
+void test_format_to_buffer() {
+  const sparkplug::Topic topics[] = {
+      {.group_id = "Energy",
+       .message_type = sparkplug::MessageType::NDATA,
+       .edge_node_id = "Gateway01",
+       .device_id = ""},
+      {.group_id = "Energy",
+       .message_type = sparkplug::MessageType::DCMD,
+       .edge_node_id = "Gateway01",
+       .device_id = "Motor01"},
+      {.group_id = "",
+       .message_type = sparkplug::MessageType::STATE,
+       .edge_node_id = "scada_host",
+       .device_id = ""},
+  };
+
+  for (const auto& topic : topics) {
+    std::array<char, 64> buffer{};
+    const sparkplug::TopicView view = topic;
+    assert(view.formatted_size() == topic.to_string().size());
+
+    char* end = topic.format_to(buffer.data());
+    assert(std::string_view(buffer.data(), end) == topic.to_string());
+    assert(static_cast<size_t>(end - buffer.data()) == view.formatted_size());
+  }
+  std::cout << "[OK] format_to writes to a caller buffer\n";
+}
+
 int main() {
   test_topic_to_string();
   test_topic_with_device();
@@ -78,6 +143,9 @@ int main() {
   test_parse_topic();
   test_parse_device_topic();
   test_parse_state_topic();
+  test_topic_view_parse();
+  test_topic_view_errors_match_topic();
+  test_format_to_buffer();
 
   std::cout << "\nAll tests passed!\n";
   return 0;
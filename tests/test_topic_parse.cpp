@@ -0,0 +1,87 @@
+// tests/test_topic_parse.cpp
+// Checks TopicView::parse against the previous std::views::split parser on valid and
+// malformed topics (see tests/bench/bench_topic_parse.cpp for the ns/topic benchmark)
+#include <cassert>
+#include <format>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sparkplug/topic.hpp>
+
+#include "topic_parse_reference.hpp"
+
+namespace {
+
+using topic_parse_reference::ParseResult;
+using topic_parse_reference::reference_parse;
+
+bool same_result(const ParseResult& lhs, const ParseResult& rhs) {
+  if (lhs.has_value() != rhs.has_value()) {
+    return false;
+  }
+  if (!lhs) {
+    return lhs.error() == rhs.error();
+  }
+  return lhs->group_id == rhs->group_id && lhs->message_type == rhs->message_type &&
+         lhs->edge_node_id == rhs->edge_node_id && lhs->device_id == rhs->device_id;
+}
+
+} // namespace
+
+void test_matches_reference() {
+  std::vector<std::string> topics = {
+      "",
+      "/",
+      "//",
+      "spBv1.0",
+      "spBv1.0/",
+      "spBv1.0//",
+      "spBv1.0/STATE",
+      "spBv1.0/STATE/",
+      "spBv1.0/STATE/host/extra",
+      "spBv1.0/G",
+      "spBv1.0/G/NDATA",
+      "spBv1.0/G/NDATA/",
+      "spBv1.0/G/NDATA/N/",
+      "spBv1.0/G/NDATA/N/D/extra",
+      "spBv1.0/G/STATE/N",
+      "spBv1.0/G//N",
+      "spBv1.0/G/N/N",
+      "spBv1.0/G/NDAT/N",
+      "spBv1.0/G/NDATAX/N",
+      "spBv1.0/G/ndata/N",
+      "spBv1.0/G/NBIRTHNBIRTH/N",
+      "spBv1.0/G/NDATDATA/N",
+      "spBv1.0/G/DCM/N",
+      "spBv1.0/G/DDEAT/N",
+      "spBv2.0/G/NDATA/N",
+      "spBv1.0x/G/NDATA/N",
+      "STATE/host",
+  };
+  for (const char* type :
+       {"NBIRTH", "NDEATH", "DBIRTH", "DDEATH", "NDATA", "DDATA", "NCMD", "DCMD"}) {
+    topics.push_back(std::format("spBv1.0/Energy/{}/Gateway01", type));
+    topics.push_back(std::format("spBv1.0/Energy/{}/Gateway01/Sensor01", type));
+  }
+
+  for (const auto& topic : topics) {
+    if (!same_result(sparkplug::TopicView::parse(topic), reference_parse(topic))) {
+      std::cerr << std::format("Mismatch for \"{}\"\n", topic);
+      assert(false);
+    }
+  }
+
+  std::cout << std::format("[OK] {} topics parse identically to the reference parser\n",
+                           topics.size());
+}
+
+int main() {
+  std::cout << "=== Topic Parse Tests ===\n\n";
+
+  test_matches_reference();
+
+  std::cout << "\n=== All Topic parse tests passed! ===\n";
+  return 0;
+}
@@ -0,0 +1,289 @@
+// tests/test_wire_encoder.cpp
+// Conformance tests: wire::Encoder output must be byte-identical to libprotobuf's
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include <sparkplug/payload_builder.hpp>
+#include <sparkplug/wire.hpp>
+
+namespace {
+
+std::vector<uint8_t>
+protobuf_bytes(const org::eclipse::tahu::protobuf::Payload& payload) {
+  std::vector<uint8_t> buffer(payload.ByteSizeLong());
+  [[maybe_unused]] bool ok =
+      payload.SerializeToArray(buffer.data(), static_cast<int>(buffer.size()));
+  assert(ok);
+  return buffer;
+}
+
+// Loads a payload's metrics into the encoder; false if one needs libprotobuf
+bool load_encoder(const org::eclipse::tahu::protobuf::Payload& payload,
+                  sparkplug::wire::Encoder& encoder) {
+  if (payload.has_timestamp()) {
+    encoder.set_timestamp(payload.timestamp());
+  }
+  sparkplug::wire::Metric metric;
+  for (const auto& pb_metric : payload.metrics()) {
+    if (!sparkplug::detail::to_wire_metric(pb_metric, metric)) {
+      return false;
+    }
+    encoder.add_metric(metric);
+  }
+  if (payload.has_seq()) {
+    encoder.set_seq(payload.seq());
+  }
+  return true;
+}
+
+using Encoding = sparkplug::PayloadBuilder::Encoding;
+
+// Builds with Encoding::Wire, then checks the bytes against SerializeToArray of the
+// same payload (payload() moves the recorded metrics into the protobuf message)
+void check_wire_builder(sparkplug::PayloadBuilder& builder) {
+  assert(builder.encoding() == Encoding::Wire);
+  std::vector<uint8_t> wire_bytes;
+  builder.build_into(wire_bytes);
+  assert(builder.encoded_size() == wire_bytes.size());
+  assert(builder.build() == wire_bytes);
+
+  std::vector<uint8_t> span_bytes(wire_bytes.size());
+  [[maybe_unused]] auto written = builder.build_into(std::span<uint8_t>(span_bytes));
+  assert(written.has_value() && *written == wire_bytes.size());
+  assert(span_bytes == wire_bytes);
+
+  assert(wire_bytes == protobuf_bytes(builder.payload()));
+  assert(builder.encoded_size() == wire_bytes.size());
+}
+
+// Encodes the builder's payload with both encoders and checks the bytes match
+void check_conformance(const sparkplug::PayloadBuilder& builder) {
+  sparkplug::wire::Encoder encoder;
+  [[maybe_unused]] bool loaded = load_encoder(builder.payload(), encoder);
+  assert(loaded);
+
+  std::vector<uint8_t> wire_bytes;
+  encoder.encode_into(wire_bytes);
+  assert(wire_bytes == protobuf_bytes(builder.payload()));
+  assert(encoder.encoded_size() == wire_bytes.size());
+
+  std::vector<uint8_t> span_bytes(wire_bytes.size());
+  [[maybe_unused]] auto written = encoder.encode_into(std::span<uint8_t>(span_bytes));
+  assert(written.has_value() && *written == wire_bytes.size());
+  assert(span_bytes == wire_bytes);
+}
+
+} // namespace
+
+void test_varint_size() {
+  assert(sparkplug::wire::varint_size(0) == 1);
+  assert(sparkplug::wire::varint_size(127) == 1);
+  assert(sparkplug::wire::varint_size(128) == 2);
+  assert(sparkplug::wire::varint_size(16383) == 2);
+  assert(sparkplug::wire::varint_size(16384) == 3);
+  assert(sparkplug::wire::varint_size(std::numeric_limits<uint32_t>::max()) == 5);
+  assert(sparkplug::wire::varint_size(std::numeric_limits<uint64_t>::max()) == 10);
+
+  std::cout << "[OK] Varint size computation\n";
+}
+
+void test_all_scalar_types() {
+  sparkplug::PayloadBuilder builder({.encoding = Encoding::Wire});
+  builder.add_metric("int8", static_cast<int8_t>(-128));
+  builder.add_metric("int16", static_cast<int16_t>(-32768));
+  builder.add_metric("int32", std::numeric_limits<int32_t>::min());
+  builder.add_metric("int64", std::numeric_limits<int64_t>::min());
+  builder.add_metric("uint8", static_cast<uint8_t>(255));
+  builder.add_metric("uint16", static_cast<uint16_t>(65535));
+  builder.add_metric("uint32", std::numeric_limits<uint32_t>::max());
+  builder.add_metric("uint64", std::numeric_limits<uint64_t>::max());
+  builder.add_metric("float", -123.456f);
+  builder.add_metric("double", 2.718281828459045);
+  builder.add_metric("bool_true", true);
+  builder.add_metric("bool_false", false);
+  builder.add_metric("string", "RUNNING");
+  builder.add_metric("empty_string", "");
+  builder.set_seq(42);
+
+  check_wire_builder(builder);
+  check_conformance(builder);
+
+  std::cout << "[OK] All scalar types encode identically\n";
+}
+
+void test_alias_and_timestamps() {
+  sparkplug::PayloadBuilder builder({.encoding = Encoding::Wire});
+  builder.set_timestamp(1700000000000ULL);
+  builder.add_metric_with_alias("Temperature", 1, 20.5, 1700000000001ULL);
+  builder.add_metric_by_alias(2, 101.3);
+  builder.add_metric_by_alias(300, static_cast<int32_t>(7), 0);
+  builder.add_metric_by_alias(std::numeric_limits<uint64_t>::max(), true);
+  builder.set_seq(255);
+
+  check_wire_builder(builder);
+  check_conformance(builder);
+
+  std::cout << "[OK] Aliases, metric and payload timestamps encode identically\n";
+}
+
+void test_flags_and_bytes() {
+  sparkplug::PayloadBuilder builder;
+  auto& payload = builder.mutable_payload();
+
+  auto* historical = payload.add_metrics();
+  historical->set_name("Historical");
+  historical->set_datatype(std::to_underlying(sparkplug::DataType::Double));
+  historical->set_is_historical(true);
+  historical->set_is_transient(false);
+  historical->set_double_value(1.0);
+
+  auto* null_metric = payload.add_metrics();
+  null_metric->set_alias(9);
+  null_metric->set_datatype(std::to_underlying(sparkplug::DataType::Int32));
+  null_metric->set_is_null(true);
+
+  auto* bytes = payload.add_metrics();
+  bytes->set_name("Blob");
+  bytes->set_datatype(std::to_underlying(sparkplug::DataType::Bytes));
+  bytes->set_bytes_value(std::string(300, '\x7f'));
+
+  auto* long_name = payload.add_metrics();
+  long_name->set_name(std::string(200, 'n'));
+  long_name->set_string_value(std::string(20000, 's'));
+
+  check_conformance(builder);
+
+  std::cout << "[OK] Flags, null values, bytes and long fields encode identically\n";
+}
+
+void test_empty_payload() {
+  sparkplug::PayloadBuilder builder({.encoding = Encoding::Wire});
+  check_wire_builder(builder);
+  check_conformance(builder);
+
+  sparkplug::PayloadBuilder no_timestamp;
+  no_timestamp.mutable_payload().clear_timestamp();
+  check_conformance(no_timestamp);
+
+  std::cout << "[OK] Empty payload encodes identically\n";
+}
+
+void test_unsupported_content() {
+  sparkplug::PayloadBuilder builder;
+  auto* dataset_metric = builder.mutable_payload().add_metrics();
+  dataset_metric->set_name("Table");
+  dataset_metric->mutable_dataset_value()->set_num_of_columns(1);
+
+  sparkplug::PayloadBuilder empty_name;
+  empty_name.mutable_payload().add_metrics()->set_name("");
+
+  // Both need libprotobuf: a message value, and an explicitly set empty name
+  sparkplug::wire::Encoder encoder;
+  assert(!load_encoder(builder.payload(), encoder));
+  assert(!load_encoder(empty_name.payload(), encoder));
+
+  std::cout << "[OK] Content the encoder cannot represent is reported\n";
+}
+
+void test_wire_builder_fallback() {
+  std::vector<int32_t> samples{1, -2, 3};
+  auto fill = [&](sparkplug::PayloadBuilder& builder) {
+    builder.set_timestamp(1700000000000ULL);
+    for (uint64_t alias = 0; alias < 200; alias++) {
+      builder.add_metric_by_alias(alias, std::string(alias, 'x'), 1700000000000ULL);
+    }
+    builder.add_metric_with_alias("Samples", 300, samples, 1700000000000ULL);
+    builder.add_metric_by_alias(301, 1.5, 1700000000000ULL);
+    builder.set_seq(9);
+  };
+
+  // The array moves the recorded metrics into the message, in order, after the text
+  // buffer has grown (and moved) several times
+  sparkplug::PayloadBuilder wire({.encoding = Encoding::Wire});
+  fill(wire);
+  sparkplug::PayloadBuilder protobuf;
+  fill(protobuf);
+  assert(wire.build() == protobuf.build());
+  assert(wire.encoded_size() == protobuf.encoded_size());
+  assert(wire.payload().metrics_size() == 202);
+
+  // Copies and moves keep what was recorded
+  sparkplug::PayloadBuilder recorded({.encoding = Encoding::Wire});
+  recorded.add_metric("Status", "RUNNING", 1700000000000ULL);
+  sparkplug::PayloadBuilder copy(recorded);
+  sparkplug::PayloadBuilder moved(std::move(recorded));
+  assert(copy.build() == moved.build());
+  check_wire_builder(copy);
+
+  // Switching an empty payload takes effect at once; a filled one keeps libprotobuf
+  sparkplug::PayloadBuilder switched;
+  switched.set_encoding(Encoding::Wire).add_metric_by_alias(1, true);
+  check_wire_builder(switched);
+  switched.reset().add_metric_by_alias(1, false);
+  switched.set_encoding(Encoding::Protobuf);
+  assert(switched.payload().metrics(0).boolean_value() == false);
+
+  std::cout << "[OK] Wire builder falls back to libprotobuf with identical bytes\n";
+}
+
+void test_encoder_direct() {
+  sparkplug::wire::Encoder encoder;
+  encoder.set_timestamp(1700000000000ULL).set_seq(3);
+  encoder.add_metric({.alias = 1,
+                      .timestamp = 1700000000000ULL,
+                      .datatype = sparkplug::DataType::Double,
+                      .value = 20.5});
+  encoder.add_metric({.name = "Status",
+                      .datatype = sparkplug::DataType::String,
+                      .value = std::string_view("OK")});
+  assert(encoder.metric_count() == 2);
+
+  org::eclipse::tahu::protobuf::Payload payload;
+  payload.set_timestamp(1700000000000ULL);
+  payload.set_seq(3);
+  auto* first = payload.add_metrics();
+  first->set_alias(1);
+  first->set_timestamp(1700000000000ULL);
+  first->set_datatype(std::to_underlying(sparkplug::DataType::Double));
+  first->set_double_value(20.5);
+  auto* second = payload.add_metrics();
+  second->set_name("Status");
+  second->set_datatype(std::to_underlying(sparkplug::DataType::String));
+  second->set_string_value("OK");
+
+  auto expected = protobuf_bytes(payload);
+  assert(encoder.encoded_size() == expected.size());
+
+  std::vector<uint8_t> buffer;
+  encoder.encode_into(buffer);
+  assert(buffer == expected);
+
+  std::vector<uint8_t> too_small(expected.size() - 1);
+  [[maybe_unused]] auto result = encoder.encode_into(std::span<uint8_t>(too_small));
+  assert(!result.has_value());
+
+  encoder.clear();
+  assert(encoder.metric_count() == 0);
+  assert(encoder.encoded_size() == 0);
+
+  std::cout << "[OK] Encoder used directly matches SerializeToArray\n";
+}
+
+int main() {
+  std::cout << "=== Wire Encoder Conformance Tests ===\n\n";
+
+  test_varint_size();
+  test_all_scalar_types();
+  test_alias_and_timestamps();
+  test_flags_and_bytes();
+  test_empty_payload();
+  test_unsupported_content();
+  test_wire_builder_fallback();
+  test_encoder_direct();
+
+  std::cout << "\n=== All wire encoder tests passed! ===\n";
+  return 0;
+}
@@ -0,0 +1,91 @@
+// tests/topic_parse_reference.hpp
+// The topic parser TopicView::parse replaced, shared by tests/test_topic_parse.cpp
+// (behaviour) and tests/bench/bench_topic_parse.cpp (speed)
+#pragma once
+
+#include <format>
+#include <ranges>
+#include <string>
+#include <string_view>
+
+#include <sparkplug/topic.hpp>
+
+namespace topic_parse_reference {
+
+using ParseResult = sparkplug::stdx::expected<sparkplug::TopicView, std::string>;
+
+inline ParseResult reference_parse(std::string_view topic_str) {
+  using sparkplug::MessageType;
+  using sparkplug::TopicView;
+
+  auto parts = topic_str | std::views::split('/') | std::views::transform([](auto&& rng) {
+                 return std::string_view(rng.begin(),
+                                         std::ranges::distance(rng.begin(), rng.end()));
+               });
+  auto it = parts.begin();
+  auto end = parts.end();
+
+  if (it == end) {
+    return sparkplug::stdx::unexpected("Invalid topic format");
+  }
+  std::string_view part0 = *it++;
+  if (it == end) {
+    return sparkplug::stdx::unexpected("Invalid topic format");
+  }
+  std::string_view part1 = *it++;
+
+  if (part0 != sparkplug::NAMESPACE) {
+    return sparkplug::stdx::unexpected("Invalid Sparkplug B topic");
+  }
+  if (part1 == "STATE") {
+    if (it == end) {
+      return sparkplug::stdx::unexpected("STATE topic requires host_id");
+    }
+    return TopicView{.group_id = {},
+                     .message_type = MessageType::STATE,
+                     .edge_node_id = *it,
+                     .device_id = {}};
+  }
+
+  if (it == end) {
+    return sparkplug::stdx::unexpected("Invalid Sparkplug B topic");
+  }
+  std::string_view part2 = *it++;
+  if (it == end) {
+    return sparkplug::stdx::unexpected("Invalid Sparkplug B topic");
+  }
+  std::string_view part3 = *it++;
+
+  MessageType type;
+  if (part2 == "NBIRTH")
+    type = MessageType::NBIRTH;
+  else if (part2 == "NDEATH")
+    type = MessageType::NDEATH;
+  else if (part2 == "DBIRTH")
+    type = MessageType::DBIRTH;
+  else if (part2 == "DDEATH")
+    type = MessageType::DDEATH;
+  else if (part2 == "NDATA")
+    type = MessageType::NDATA;
+  else if (part2 == "DDATA")
+    type = MessageType::DDATA;
+  else if (part2 == "NCMD")
+    type = MessageType::NCMD;
+  else if (part2 == "DCMD")
+    type = MessageType::DCMD;
+  else if (part2 == "STATE")
+    type = MessageType::STATE;
+  else
+    return sparkplug::stdx::unexpected(std::format("Unknown message type: {}", part2));
+
+  std::string_view device_id;
+  if (it != end) {
+    device_id = *it;
+  }
+  return TopicView{.group_id = part1,
+                   .message_type = type,
+                   .edge_node_id = part3,
+                   .device_id = device_id};
+}
+
+} // namespace topic_parse_reference